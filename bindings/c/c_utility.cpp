@@ -63,8 +63,9 @@ void convertUTF8ToUTF16 (const NPUTF8 *UTF8Chars, int UTF8Length, NPUTF16 **UTF1
 void coerceValueToNPVariantStringType (KJS::ExecState *exec, const KJS::Value &value, NPVariant *result)
 {
     UString ustring = value.toString(exec);
-    CString cstring = ustring.UTF8String();
-    NPString string = { (const NPUTF8 *)cstring.c_str(), cstring.size() };
+    int length;
+    const char *utf8 = ustring.cachedUTF8Data(length);
+    NPString string = { (const NPUTF8 *)utf8, length };
     NPN_InitializeVariantWithStringCopy (result, &string);
 }
 
@@ -75,8 +76,9 @@ void convertValueToNPVariant (KJS::ExecState *exec, const KJS::Value &value, NPV
     
     if (type == StringType) {
         UString ustring = value.toString(exec);
-        CString cstring = ustring.UTF8String();
-        NPString string = { (const NPUTF8 *)cstring.c_str(), cstring.size() };
+        int length;
+        const char *utf8 = ustring.cachedUTF8Data(length);
+        NPString string = { (const NPUTF8 *)utf8, length };
         NPN_InitializeVariantWithStringCopy (result, &string );
     }
     else if (type == NumberType) {
@@ -61,9 +61,8 @@ public:
     }
     
     const char *UTF8String() const { 
-        if (_utf8String.c_str() == 0)
-            _utf8String = _ustring.UTF8String();
-        return _utf8String.c_str();
+        int length;
+        return _ustring.cachedUTF8Data(length);
     }
     const jchar *uchars() const { return (const jchar *)_ustring.data(); }
     int length() const { return _ustring.size(); }
@@ -71,7 +70,6 @@ public:
     
 private:
     UString _ustring;
-    mutable CString _utf8String;
 };
 
 class JavaParameter : public Parameter
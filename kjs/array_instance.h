@@ -31,6 +31,7 @@ namespace KJS {
   public:
     ArrayInstanceImp(ObjectImp *proto, unsigned initialLength);
     ArrayInstanceImp(ObjectImp *proto, const List &initialValues);
+    ArrayInstanceImp(const ArrayInstanceImp &other);
     ~ArrayInstanceImp();
 
     virtual Value get(ExecState *exec, const Identifier &propertyName) const;
@@ -44,6 +45,7 @@ namespace KJS {
     virtual ReferenceList propList(ExecState *exec, bool recursive);
 
     virtual void mark();
+    virtual void cloneReferences(ObjectCloner &cloner);
 
     virtual const ClassInfo *classInfo() const { return &info; }
     static const ClassInfo info;
@@ -28,10 +28,12 @@
 #include "array_object.h"
 #include "internal.h"
 #include "error_object.h"
+#include "object_cloner.h"
 
 #include "array_object.lut.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 using namespace KJS;
@@ -65,6 +67,17 @@ ArrayInstanceImp::ArrayInstanceImp(ObjectImp *proto, const List &list)
   }
 }
 
+ArrayInstanceImp::ArrayInstanceImp(const ArrayInstanceImp &other)
+  : ObjectImp(other)
+  , length(other.length)
+  , storageLength(other.storageLength)
+  , capacity(other.capacity)
+  , storage(capacity ? (ValueImp **)calloc(capacity, sizeof(ValueImp *)) : 0)
+{
+  if (storageLength)
+    memcpy(storage, other.storage, sizeof(ValueImp *) * storageLength);
+}
+
 ArrayInstanceImp::~ArrayInstanceImp()
 {
   free(storage);
@@ -274,6 +287,14 @@ void ArrayInstanceImp::mark()
   }
 }
 
+void ArrayInstanceImp::cloneReferences(ObjectCloner &cloner)
+{
+  ObjectImp::cloneReferences(cloner);
+  unsigned l = storageLength;
+  for (unsigned i = 0; i < l; ++i)
+    storage[i] = cloner.clone(storage[i]);
+}
+
 static ExecState *execForCompareByStringForQSort;
 
 static int compareByStringForQSort(const void *a, const void *b)
@@ -459,20 +480,24 @@ Value ArrayProtoFuncImp::call(ExecState *exec, Object &thisObj, const List &args
 
   case Join: {
     UString separator = ",";
-    UString str = "";
+    StringBuilder str;
 
     if (args.size() > 0)
       separator = args[0].toString(exec);
+    // at least the separators and a character per element, unless the
+    // array is mostly holes
+    if (length > 1 && length < 0x10000)
+      str.reserve((length - 1) * (separator.size() + 1) + 1);
     for (unsigned int k = 0; k < length; k++) {
       if (k >= 1)
-        str += separator;
+        str.append(separator);
       Value element = thisObj.get(exec,k);
       if (element.type() != UndefinedType && element.type() != NullType)
-        str += element.toString(exec);
+        str.append(element.toString(exec));
       if ( exec->hadException() )
 	break;
     }
-    result = String(str);
+    result = String(str.release());
     break;
   }
   case Concat: {
@@ -31,6 +31,7 @@ namespace KJS {
   public:
     ArrayPrototypeImp(ExecState *exec,
                       ObjectPrototypeImp *objProto);
+    virtual ObjectImp *clone() const { return new ArrayPrototypeImp(*this); }
     Value get(ExecState *exec, const Identifier &p) const;
     virtual const ClassInfo *classInfo() const { return &info; }
     static const ClassInfo info;
@@ -54,6 +55,7 @@ namespace KJS {
     ArrayObjectImp(ExecState *exec,
                    FunctionPrototypeImp *funcProto,
                    ArrayPrototypeImp *arrayProto);
+    virtual ObjectImp *clone() const { return new ArrayObjectImp(*this); }
 
     virtual bool implementsConstruct() const;
     virtual Object construct(ExecState *exec, const List &args);
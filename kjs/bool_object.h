@@ -46,6 +46,7 @@ namespace KJS {
     BooleanPrototypeImp(ExecState *exec,
                         ObjectPrototypeImp *objectProto,
                         FunctionPrototypeImp *funcProto);
+    virtual ObjectImp *clone() const { return new BooleanPrototypeImp(*this); }
   };
 
   /**
@@ -58,6 +59,7 @@ namespace KJS {
   public:
     BooleanProtoFuncImp(ExecState *exec,
                         FunctionPrototypeImp *funcProto, int i, int len);
+    virtual ObjectImp *clone() const { return new BooleanProtoFuncImp(*this); }
 
     virtual bool implementsCall() const;
     virtual Value call(ExecState *exec, Object &thisObj, const List &args);
@@ -77,6 +79,7 @@ namespace KJS {
   public:
     BooleanObjectImp(ExecState *exec, FunctionPrototypeImp *funcProto,
                      BooleanPrototypeImp *booleanProto);
+    virtual ObjectImp *clone() const { return new BooleanObjectImp(*this); }
 
     virtual bool implementsConstruct() const;
     virtual Object construct(ExecState *exec, const List &args);
@@ -0,0 +1,391 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "character_scanner.h"
+
+#include "cpu_features.h"
+
+#if KJS_X86_VECTOR
+#include <immintrin.h>
+#endif
+
+using namespace KJS;
+
+// Each kind of run is described by a class that tells which characters
+// end it: one at a time, and as a bit mask for a vector of UTF-16 units or
+// bytes at once, as produced by the movemask instructions. The mask has two
+// bits for each UTF-16 unit and one for each byte.
+//
+// In Latin-1 and UTF-8 text the runs stop at the same ASCII characters.
+// Bytes of a UTF-8 sequence are never ASCII, so they cannot be mistaken
+// for one. Only no-break spaces are left to the lexer, since they take two
+// bytes in UTF-8.
+
+#if KJS_X86_VECTOR
+
+static inline KJS_TARGET_SSE2 __m128i equal(__m128i v, unsigned short c)
+{
+  return _mm_cmpeq_epi16(v, _mm_set1_epi16(c));
+}
+
+// whether low <= v <= high, without signed compares
+static inline KJS_TARGET_SSE2 __m128i between(__m128i v, unsigned short low, unsigned short high)
+{
+  __m128i offset = _mm_sub_epi16(v, _mm_set1_epi16(low));
+  return _mm_cmpeq_epi16(_mm_subs_epu16(offset, _mm_set1_epi16(high - low)), _mm_setzero_si128());
+}
+
+static inline KJS_TARGET_AVX2 __m256i equal(__m256i v, unsigned short c)
+{
+  return _mm256_cmpeq_epi16(v, _mm256_set1_epi16(c));
+}
+
+static inline KJS_TARGET_AVX2 __m256i between(__m256i v, unsigned short low, unsigned short high)
+{
+  __m256i offset = _mm256_sub_epi16(v, _mm256_set1_epi16(low));
+  return _mm256_cmpeq_epi16(_mm256_subs_epu16(offset, _mm256_set1_epi16(high - low)), _mm256_setzero_si256());
+}
+
+static inline KJS_TARGET_SSE2 __m128i equalBytes(__m128i v, unsigned char c)
+{
+  return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+static inline KJS_TARGET_SSE2 __m128i betweenBytes(__m128i v, unsigned char low, unsigned char high)
+{
+  __m128i offset = _mm_sub_epi8(v, _mm_set1_epi8(low));
+  return _mm_cmpeq_epi8(_mm_subs_epu8(offset, _mm_set1_epi8(high - low)), _mm_setzero_si128());
+}
+
+static inline KJS_TARGET_AVX2 __m256i equalBytes(__m256i v, unsigned char c)
+{
+  return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+
+static inline KJS_TARGET_AVX2 __m256i betweenBytes(__m256i v, unsigned char low, unsigned char high)
+{
+  __m256i offset = _mm256_sub_epi8(v, _mm256_set1_epi8(low));
+  return _mm256_cmpeq_epi8(_mm256_subs_epu8(offset, _mm256_set1_epi8(high - low)), _mm256_setzero_si256());
+}
+
+#endif
+
+struct WhiteSpaceRun {
+  WhiteSpaceRun(unsigned short) { }
+  bool ends(unsigned short c) const
+  {
+    return !(c == ' ' || c == '\t' || c == 0x0b || c == 0x0c || c == 0xa0);
+  }
+  bool ends(unsigned char c) const
+  {
+    return !(c == ' ' || c == '\t' || c == 0x0b || c == 0x0c);
+  }
+#if KJS_X86_VECTOR
+  KJS_TARGET_SSE2 unsigned int ends(__m128i v) const
+  {
+    __m128i space = _mm_or_si128(_mm_or_si128(equal(v, ' '), equal(v, '\t')),
+                                 _mm_or_si128(between(v, 0x0b, 0x0c), equal(v, 0xa0)));
+    return ~_mm_movemask_epi8(space) & 0xffff;
+  }
+  KJS_TARGET_AVX2 unsigned int ends(__m256i v) const
+  {
+    __m256i space = _mm256_or_si256(_mm256_or_si256(equal(v, ' '), equal(v, '\t')),
+                                    _mm256_or_si256(between(v, 0x0b, 0x0c), equal(v, 0xa0)));
+    return ~_mm256_movemask_epi8(space);
+  }
+  KJS_TARGET_SSE2 unsigned int endsBytes(__m128i v) const
+  {
+    __m128i space = _mm_or_si128(_mm_or_si128(equalBytes(v, ' '), equalBytes(v, '\t')), betweenBytes(v, 0x0b, 0x0c));
+    return ~_mm_movemask_epi8(space) & 0xffff;
+  }
+  KJS_TARGET_AVX2 unsigned int endsBytes(__m256i v) const
+  {
+    __m256i space = _mm256_or_si256(_mm256_or_si256(equalBytes(v, ' '), equalBytes(v, '\t')), betweenBytes(v, 0x0b, 0x0c));
+    return ~_mm256_movemask_epi8(space);
+  }
+#endif
+};
+
+struct LineRun {
+  LineRun(unsigned short) { }
+  bool ends(unsigned short c) const
+  {
+    return c == '\n' || c == '\r' || c == 0;
+  }
+#if KJS_X86_VECTOR
+  KJS_TARGET_SSE2 unsigned int ends(__m128i v) const
+  {
+    return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(equal(v, '\n'), equal(v, '\r')), equal(v, 0)));
+  }
+  KJS_TARGET_AVX2 unsigned int ends(__m256i v) const
+  {
+    return _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(equal(v, '\n'), equal(v, '\r')), equal(v, 0)));
+  }
+  KJS_TARGET_SSE2 unsigned int endsBytes(__m128i v) const
+  {
+    return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(equalBytes(v, '\n'), equalBytes(v, '\r')), equalBytes(v, 0)));
+  }
+  KJS_TARGET_AVX2 unsigned int endsBytes(__m256i v) const
+  {
+    return _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(equalBytes(v, '\n'), equalBytes(v, '\r')),
+                                                equalBytes(v, 0)));
+  }
+#endif
+};
+
+struct CommentRun {
+  CommentRun(unsigned short) { }
+  bool ends(unsigned short c) const
+  {
+    return c == '*' || c == '\n' || c == '\r' || c == 0;
+  }
+#if KJS_X86_VECTOR
+  KJS_TARGET_SSE2 unsigned int ends(__m128i v) const
+  {
+    __m128i line = _mm_or_si128(_mm_or_si128(equal(v, '\n'), equal(v, '\r')), equal(v, 0));
+    return _mm_movemask_epi8(_mm_or_si128(line, equal(v, '*')));
+  }
+  KJS_TARGET_AVX2 unsigned int ends(__m256i v) const
+  {
+    __m256i line = _mm256_or_si256(_mm256_or_si256(equal(v, '\n'), equal(v, '\r')), equal(v, 0));
+    return _mm256_movemask_epi8(_mm256_or_si256(line, equal(v, '*')));
+  }
+  KJS_TARGET_SSE2 unsigned int endsBytes(__m128i v) const
+  {
+    __m128i line = _mm_or_si128(_mm_or_si128(equalBytes(v, '\n'), equalBytes(v, '\r')), equalBytes(v, 0));
+    return _mm_movemask_epi8(_mm_or_si128(line, equalBytes(v, '*')));
+  }
+  KJS_TARGET_AVX2 unsigned int endsBytes(__m256i v) const
+  {
+    __m256i line = _mm256_or_si256(_mm256_or_si256(equalBytes(v, '\n'), equalBytes(v, '\r')), equalBytes(v, 0));
+    return _mm256_movemask_epi8(_mm256_or_si256(line, equalBytes(v, '*')));
+  }
+#endif
+};
+
+struct IdentifierRun {
+  IdentifierRun(unsigned short) { }
+  bool ends(unsigned short c) const
+  {
+    return !(((c | 0x20) >= 'a' && (c | 0x20) <= 'z')
+             || (c >= '0' && c <= '9') || c == '$' || c == '_');
+  }
+#if KJS_X86_VECTOR
+  // setting bit 5 maps upper case letters to lower case ones and nothing
+  // else into 'a'..'z'
+  KJS_TARGET_SSE2 unsigned int ends(__m128i v) const
+  {
+    __m128i letter = between(_mm_or_si128(v, _mm_set1_epi16(0x20)), 'a', 'z');
+    __m128i other = _mm_or_si128(between(v, '0', '9'), _mm_or_si128(equal(v, '$'), equal(v, '_')));
+    return ~_mm_movemask_epi8(_mm_or_si128(letter, other)) & 0xffff;
+  }
+  KJS_TARGET_AVX2 unsigned int ends(__m256i v) const
+  {
+    __m256i letter = between(_mm256_or_si256(v, _mm256_set1_epi16(0x20)), 'a', 'z');
+    __m256i other = _mm256_or_si256(between(v, '0', '9'), _mm256_or_si256(equal(v, '$'), equal(v, '_')));
+    return ~_mm256_movemask_epi8(_mm256_or_si256(letter, other));
+  }
+  KJS_TARGET_SSE2 unsigned int endsBytes(__m128i v) const
+  {
+    __m128i letter = betweenBytes(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z');
+    __m128i other = _mm_or_si128(betweenBytes(v, '0', '9'), _mm_or_si128(equalBytes(v, '$'), equalBytes(v, '_')));
+    return ~_mm_movemask_epi8(_mm_or_si128(letter, other)) & 0xffff;
+  }
+  KJS_TARGET_AVX2 unsigned int endsBytes(__m256i v) const
+  {
+    __m256i letter = betweenBytes(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 'z');
+    __m256i other = _mm256_or_si256(betweenBytes(v, '0', '9'), _mm256_or_si256(equalBytes(v, '$'), equalBytes(v, '_')));
+    return ~_mm256_movemask_epi8(_mm256_or_si256(letter, other));
+  }
+#endif
+};
+
+struct StringRun {
+  StringRun(unsigned short q) : quote(q) { }
+  bool ends(unsigned short c) const
+  {
+    return c == quote || c == '\\' || c == '\n' || c == '\r' || c == 0;
+  }
+#if KJS_X86_VECTOR
+  KJS_TARGET_SSE2 unsigned int ends(__m128i v) const
+  {
+    __m128i line = _mm_or_si128(_mm_or_si128(equal(v, '\n'), equal(v, '\r')), equal(v, 0));
+    return _mm_movemask_epi8(_mm_or_si128(line, _mm_or_si128(equal(v, quote), equal(v, '\\'))));
+  }
+  KJS_TARGET_AVX2 unsigned int ends(__m256i v) const
+  {
+    __m256i line = _mm256_or_si256(_mm256_or_si256(equal(v, '\n'), equal(v, '\r')), equal(v, 0));
+    return _mm256_movemask_epi8(_mm256_or_si256(line, _mm256_or_si256(equal(v, quote), equal(v, '\\'))));
+  }
+  KJS_TARGET_SSE2 unsigned int endsBytes(__m128i v) const
+  {
+    __m128i line = _mm_or_si128(_mm_or_si128(equalBytes(v, '\n'), equalBytes(v, '\r')), equalBytes(v, 0));
+    return _mm_movemask_epi8(_mm_or_si128(line, _mm_or_si128(equalBytes(v, quote), equalBytes(v, '\\'))));
+  }
+  KJS_TARGET_AVX2 unsigned int endsBytes(__m256i v) const
+  {
+    __m256i line = _mm256_or_si256(_mm256_or_si256(equalBytes(v, '\n'), equalBytes(v, '\r')), equalBytes(v, 0));
+    return _mm256_movemask_epi8(_mm256_or_si256(line, _mm256_or_si256(equalBytes(v, quote), equalBytes(v, '\\'))));
+  }
+#endif
+  unsigned short quote;
+};
+
+// the character the runs look at, as unsigned short or unsigned char
+static inline unsigned short unit(const UChar &c)
+{
+  return c.uc;
+}
+
+static inline unsigned char unit(char c)
+{
+  return c;
+}
+
+template <class Char, class Run>
+static inline unsigned int scanScalar(const Char *code, unsigned int i, unsigned int length, const Run &run)
+{
+  for (; i < length; i++) {
+    if (run.ends(unit(code[i])))
+      return i;
+  }
+  return length;
+}
+
+#if KJS_X86_VECTOR
+
+template <class Run>
+static KJS_TARGET_SSE2 unsigned int scanSSE2(const UChar *code, unsigned int i, unsigned int length, Run run)
+{
+  for (; i + 8 <= length; i += 8) {
+    unsigned int mask = run.ends(_mm_loadu_si128(reinterpret_cast<const __m128i *>(code + i)));
+    if (mask)
+      return i + (__builtin_ctz(mask) >> 1);
+  }
+  return scanScalar(code, i, length, run);
+}
+
+template <class Run>
+static KJS_TARGET_AVX2 unsigned int scanAVX2(const UChar *code, unsigned int i, unsigned int length, Run run)
+{
+  for (; i + 16 <= length; i += 16) {
+    unsigned int mask = run.ends(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(code + i)));
+    if (mask)
+      return i + (__builtin_ctz(mask) >> 1);
+  }
+  // the rest is shorter than a vector, so it is probably short enough to
+  // not be worth switching to the smaller registers
+  return scanScalar(code, i, length, run);
+}
+
+template <class Run>
+static KJS_TARGET_SSE2 unsigned int scanSSE2(const char *code, unsigned int i, unsigned int length, Run run)
+{
+  for (; i + 16 <= length; i += 16) {
+    unsigned int mask = run.endsBytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(code + i)));
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+  return scanScalar(code, i, length, run);
+}
+
+template <class Run>
+static KJS_TARGET_AVX2 unsigned int scanAVX2(const char *code, unsigned int i, unsigned int length, Run run)
+{
+  for (; i + 32 <= length; i += 32) {
+    unsigned int mask = run.endsBytes(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(code + i)));
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+  return scanScalar(code, i, length, run);
+}
+
+#endif
+
+template <class Run, class Char>
+static inline unsigned int scan(const Char *code, unsigned int start, unsigned int length, unsigned short quote)
+{
+  Run run(quote);
+#if KJS_X86_VECTOR
+  switch (CPUFeatures::vectorLevel()) {
+  case CPUFeatures::UseAVX2:
+    return scanAVX2(code, start, length, run);
+  case CPUFeatures::UseSSE2:
+    return scanSSE2(code, start, length, run);
+  default:
+    break;
+  }
+#endif
+  return scanScalar(code, start, length, run);
+}
+
+unsigned int CharacterScanner::skipWhiteSpace(const UChar *code, unsigned int start, unsigned int length)
+{
+  return scan<WhiteSpaceRun>(code, start, length, 0);
+}
+
+unsigned int CharacterScanner::findLineEnd(const UChar *code, unsigned int start, unsigned int length)
+{
+  return scan<LineRun>(code, start, length, 0);
+}
+
+unsigned int CharacterScanner::findCommentStop(const UChar *code, unsigned int start, unsigned int length)
+{
+  return scan<CommentRun>(code, start, length, 0);
+}
+
+unsigned int CharacterScanner::findIdentifierEnd(const UChar *code, unsigned int start, unsigned int length)
+{
+  return scan<IdentifierRun>(code, start, length, 0);
+}
+
+unsigned int CharacterScanner::findStringStop(const UChar *code, unsigned int start, unsigned int length,
+                                              unsigned short quote)
+{
+  return scan<StringRun>(code, start, length, quote);
+}
+
+unsigned int CharacterScanner::skipWhiteSpace(const char *code, unsigned int start, unsigned int length)
+{
+  return scan<WhiteSpaceRun>(code, start, length, 0);
+}
+
+unsigned int CharacterScanner::findLineEnd(const char *code, unsigned int start, unsigned int length)
+{
+  return scan<LineRun>(code, start, length, 0);
+}
+
+unsigned int CharacterScanner::findCommentStop(const char *code, unsigned int start, unsigned int length)
+{
+  return scan<CommentRun>(code, start, length, 0);
+}
+
+unsigned int CharacterScanner::findIdentifierEnd(const char *code, unsigned int start, unsigned int length)
+{
+  return scan<IdentifierRun>(code, start, length, 0);
+}
+
+unsigned int CharacterScanner::findStringStop(const char *code, unsigned int start, unsigned int length,
+                                              unsigned short quote)
+{
+  return scan<StringRun>(code, start, length, quote);
+}
@@ -0,0 +1,83 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef _KJS_CHARACTER_SCANNER_H_
+#define _KJS_CHARACTER_SCANNER_H_
+
+#include "ustring.h"
+
+namespace KJS {
+
+  /**
+   * @internal
+   *
+   * Finds where runs of characters end for the @ref Lexer. With SSE2 or
+   * AVX2, picked at runtime through @ref CPUFeatures, 8 or 16 characters
+   * are checked at once; otherwise they are checked one by one.
+   *
+   * Each function looks at code[start] up to code[length - 1] and returns
+   * the index of the first character that ends the run, or length if the
+   * run goes on to the end of the code. A null character ends every run
+   * except the one of white space, just like the end of the code does.
+   *
+   * The overloads for Latin-1 or UTF-8 text take code as bytes and stop at
+   * the same ASCII characters. Since the bytes of a UTF-8 sequence are
+   * never ASCII, start may point into the middle of one. Runs of white
+   * space stop at any byte that is not ASCII.
+   */
+  class CharacterScanner {
+  public:
+    /**
+     * Skips spaces, tabs, vertical tabs, form feeds and no-break spaces.
+     */
+    static unsigned int skipWhiteSpace(const UChar *code, unsigned int start, unsigned int length);
+    /**
+     * Finds the end of a single line comment: a line terminator.
+     */
+    static unsigned int findLineEnd(const UChar *code, unsigned int start, unsigned int length);
+    /**
+     * Finds the next '*' or line terminator in a multi line comment.
+     */
+    static unsigned int findCommentStop(const UChar *code, unsigned int start, unsigned int length);
+    /**
+     * Finds the end of an identifier: anything but letters, digits, '$'
+     * and '_'.
+     */
+    static unsigned int findIdentifierEnd(const UChar *code, unsigned int start, unsigned int length);
+    /**
+     * Finds the next quote, backslash or line terminator in a string
+     * literal delimited by quote.
+     */
+    static unsigned int findStringStop(const UChar *code, unsigned int start, unsigned int length,
+                                       unsigned short quote);
+
+    static unsigned int skipWhiteSpace(const char *code, unsigned int start, unsigned int length);
+    static unsigned int findLineEnd(const char *code, unsigned int start, unsigned int length);
+    static unsigned int findCommentStop(const char *code, unsigned int start, unsigned int length);
+    static unsigned int findIdentifierEnd(const char *code, unsigned int start, unsigned int length);
+    static unsigned int findStringStop(const char *code, unsigned int start, unsigned int length,
+                                       unsigned short quote);
+  };
+
+}; // namespace
+
+#endif
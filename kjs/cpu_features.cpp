@@ -0,0 +1,74 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "cpu_features.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#if KJS_X86_VECTOR
+#include <cpuid.h>
+#endif
+
+using namespace KJS;
+
+int CPUFeatures::features = 0;
+static pthread_once_t featuresOnce = PTHREAD_ONCE_INIT;
+
+void CPUFeatures::detect()
+{
+  int found = Detected;
+
+#if KJS_X86_VECTOR
+  if (!getenv("KJS_NO_VECTOR")) {
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int maxLeaf = __get_cpuid_max(0, 0);
+    if (maxLeaf >= 1) {
+      __cpuid(1, eax, ebx, ecx, edx);
+      if (edx & (1 << 26))
+        found |= SSE2;
+
+      // AVX2 also needs the operating system to save the upper halves of
+      // the vector registers (OSXSAVE, then XCR0 bits 1 and 2)
+      bool osSavesAVX = false;
+      if ((ecx & (1 << 27)) && (ecx & (1 << 28))) {
+        unsigned int xcr0, xcr0High;
+        __asm__ volatile ("xgetbv" : "=a" (xcr0), "=d" (xcr0High) : "c" (0));
+        osSavesAVX = (xcr0 & 6) == 6;
+      }
+      if (osSavesAVX && maxLeaf >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        if (ebx & (1 << 5))
+          found |= AVX2;
+      }
+    }
+  }
+#endif
+
+  __atomic_store_n(&features, found, __ATOMIC_RELAXED);
+}
+
+int CPUFeatures::detectOnce()
+{
+  pthread_once(&featuresOnce, detect);
+  return __atomic_load_n(&features, __ATOMIC_RELAXED);
+}
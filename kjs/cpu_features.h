@@ -0,0 +1,95 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef _KJS_CPU_FEATURES_H_
+#define _KJS_CPU_FEATURES_H_
+
+// Vector code for x86 is compiled with per-function target attributes, so
+// that the library itself does not need to be built for a newer CPU than
+// the one it runs on. The compiler has to support those attributes.
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) \
+    && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define KJS_X86_VECTOR 1
+#define KJS_TARGET_SSE2 __attribute__((target("sse2")))
+#define KJS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define KJS_X86_VECTOR 0
+#endif
+
+namespace KJS {
+
+  /**
+   * @internal
+   *
+   * The vector instruction sets the processor and the operating system
+   * support, checked once and then cached. Setting the environment variable
+   * KJS_NO_VECTOR turns all of them off, which selects the scalar code.
+   *
+   * Any thread may ask. Once the features are known, asking costs one
+   * load, so code can pick its path on every call.
+   */
+  class CPUFeatures {
+  public:
+    enum VectorLevel { Scalar, UseSSE2, UseAVX2 };
+
+    static bool hasSSE2() { return currentFeatures() & SSE2; }
+    static bool hasAVX2() { return currentFeatures() & AVX2; }
+    /**
+     * The widest vectors to use.
+     */
+    static VectorLevel vectorLevel()
+    {
+      int found = currentFeatures();
+      return (found & AVX2) ? UseAVX2 : (found & SSE2) ? UseSSE2 : Scalar;
+    }
+
+  private:
+    enum { Detected = 1 << 0, SSE2 = 1 << 1, AVX2 = 1 << 2 };
+
+    // The features are written once, and depend on nothing else, so a
+    // relaxed load that sees them can use them.
+    static int currentFeatures()
+    {
+      int found = __atomic_load_n(&features, __ATOMIC_RELAXED);
+      return found ? found : detectOnce();
+    }
+    static int detectOnce();
+    static void detect();
+    static int features;
+  };
+
+#if KJS_X86_VECTOR
+  /**
+   * @internal
+   *
+   * Empty types that pick the SSE2 or the AVX2 overloads of the vector
+   * helpers in code written once for both. Passing a vector for that
+   * instead would change the calling convention of functions that are not
+   * compiled for AVX.
+   */
+  struct SSE2Vector { enum { size = 16 }; };
+  struct AVX2Vector { enum { size = 32 }; };
+#endif
+
+}; // namespace
+
+#endif
@@ -46,6 +46,7 @@ namespace KJS {
   class DatePrototypeImp : public DateInstanceImp {
   public:
     DatePrototypeImp(ExecState *exec, ObjectPrototypeImp *objectProto);
+    virtual ObjectImp *clone() const { return new DatePrototypeImp(*this); }
     Value get(ExecState *exec, const Identifier &p) const;
     virtual const ClassInfo *classInfo() const { return &info; }
     static const ClassInfo info;
@@ -89,6 +90,7 @@ namespace KJS {
     DateObjectImp(ExecState *exec,
                   FunctionPrototypeImp *funcProto,
                   DatePrototypeImp *dateProto);
+    virtual ObjectImp *clone() const { return new DateObjectImp(*this); }
 
     virtual bool implementsConstruct() const;
     virtual Object construct(ExecState *exec, const List &args);
@@ -109,6 +111,7 @@ namespace KJS {
   public:
     DateObjectFuncImp(ExecState *exec, FunctionPrototypeImp *funcProto,
                       int i, int len);
+    virtual ObjectImp *clone() const { return new DateObjectFuncImp(*this); }
 
     virtual bool implementsCall() const;
     virtual Value call(ExecState *exec, Object &thisObj, const List &args);
@@ -181,6 +181,14 @@
 #define dtoa kjs_dtoa
 #define freedtoa kjs_freedtoa
 
+/* The parser reads numbers too, and may run on a thread of its own (see
+ * ParsedProgram), so the free lists and the powers of 5 are locked. */
+#include <pthread.h>
+#define MULTIPLE_THREADS
+static pthread_mutex_t dtoa_locks[2] = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER };
+#define ACQUIRE_DTOA_LOCK(n)	pthread_mutex_lock(&dtoa_locks[n])
+#define FREE_DTOA_LOCK(n)	pthread_mutex_unlock(&dtoa_locks[n])
+
 
 
 #ifndef Long
@@ -26,6 +26,7 @@
 #include "interpreter.h"
 #include "operations.h"
 #include "error_object.h"
+#include "object_cloner.h"
 //#include "debugger.h"
 
 using namespace KJS;
@@ -179,3 +180,9 @@ void NativeErrorImp::mark()
   if (proto && !proto->marked())
     proto->mark();
 }
+
+void NativeErrorImp::cloneReferences(ObjectCloner &cloner)
+{
+  ObjectImp::cloneReferences(cloner);
+  proto = cloner.clone(proto);
+}
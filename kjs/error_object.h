@@ -32,11 +32,13 @@ namespace KJS {
     ErrorPrototypeImp(ExecState *exec,
                       ObjectPrototypeImp *objectProto,
                       FunctionPrototypeImp *funcProto);
+    virtual ObjectImp *clone() const { return new ErrorPrototypeImp(*this); }
   };
 
   class ErrorProtoFuncImp : public InternalFunctionImp {
   public:
     ErrorProtoFuncImp(ExecState *exec, FunctionPrototypeImp *funcProto);
+    virtual ObjectImp *clone() const { return new ErrorProtoFuncImp(*this); }
     virtual bool implementsCall() const;
     virtual Value call(ExecState *exec, Object &thisObj, const List &args);
   };
@@ -45,6 +47,7 @@ namespace KJS {
   public:
     ErrorObjectImp(ExecState *exec, FunctionPrototypeImp *funcProto,
                    ErrorPrototypeImp *errorProto);
+    virtual ObjectImp *clone() const { return new ErrorObjectImp(*this); }
 
     virtual bool implementsConstruct() const;
     virtual Object construct(ExecState *exec, const List &args);
@@ -61,6 +64,7 @@ namespace KJS {
   public:
     NativeErrorPrototypeImp(ExecState *exec, ErrorPrototypeImp *errorProto,
                             ErrorType et, UString name, UString message);
+    virtual ObjectImp *clone() const { return new NativeErrorPrototypeImp(*this); }
   private:
     ErrorType errType;
   };
@@ -69,6 +73,8 @@ namespace KJS {
   public:
     NativeErrorImp(ExecState *exec, FunctionPrototypeImp *funcProto,
                    const Object &prot);
+    virtual ObjectImp *clone() const { return new NativeErrorImp(*this); }
+    virtual void cloneReferences(ObjectCloner &cloner);
 
     virtual bool implementsConstruct() const;
     virtual Object construct(ExecState *exec, const List &args);
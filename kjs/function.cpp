@@ -29,6 +29,8 @@
 #include "lexer.h"
 #include "nodes.h"
 #include "operations.h"
+#include "program_cache.h"
+#include "source_provider.h"
 #include "debugger.h"
 #include "context.h"
 
@@ -265,8 +267,7 @@ DeclaredFunctionImp::DeclaredFunctionImp(ExecState *exec, const Identifier &n,
 
 DeclaredFunctionImp::~DeclaredFunctionImp()
 {
-  if ( body->deref() )
-    delete body;
+  body->deref();
 }
 
 bool DeclaredFunctionImp::implementsConstruct() const
@@ -409,26 +410,28 @@ bool GlobalFuncImp::implementsCall() const
 
 static Value encode(ExecState *exec, const List &args, const char *do_not_escape)
 {
-  UString r = "", s, str = args[0].toString(exec);
+  static const char hexDigits[] = "0123456789ABCDEF";
+  UString str = args[0].toString(exec);
   CString cstr = str.UTF8String();
   const char *p = cstr.c_str();
+  StringBuilder r(cstr.size());
   for (int k = 0; k < cstr.size(); k++, p++) {
     char c = *p;
     if (c && strchr(do_not_escape, c)) {
       r.append(c);
     } else {
-      char tmp[4];
-      sprintf(tmp, "%%%02X", (unsigned char)c);
-      r += tmp;
+      char tmp[3] = { '%', hexDigits[(unsigned char)c >> 4], hexDigits[c & 0xF] };
+      r.append(tmp, 3);
     }
   }
-  return String(r);
+  return String(r.release());
 }
 
 static Value decode(ExecState *exec, const List &args, const char *do_not_unescape, bool strict)
 {
-  UString s = "", str = args[0].toString(exec);
+  UString str = args[0].toString(exec);
   int k = 0, len = str.size();
+  StringBuilder s(len);
   const UChar *d = str.data();
   UChar u;
   while (k < len) {
@@ -490,7 +493,7 @@ static Value decode(ExecState *exec, const List &args, const char *do_not_unesca
     k++;
     s.append(c);
   }
-  return String(s);
+  return String(s.release());
 }
 
 Value GlobalFuncImp::call(ExecState *exec, Object &/*thisObj*/, const List &args)
@@ -526,7 +529,16 @@ Value GlobalFuncImp::call(ExecState *exec, Object &/*thisObj*/, const List &args
       int sid;
       int errLine;
       UString errMsg;
-      ProgramNode *progNode = Parser::parse(UString(), 0, s.data(),s.size(),&sid,&errLine,&errMsg);
+      // statement callbacks identify the source by the id of the parse, so
+      // don't hand out cached trees while a debugger is attached
+      ProgramNode *progNode;
+      InterpreterImp *interp = exec->dynamicInterpreter()->imp();
+      SourceProvider *source = SourceProvider::create(s);
+      if (interp->debugger())
+        progNode = Parser::parse(UString(), 0, source, &sid, &errLine, &errMsg);
+      else
+        progNode = interp->codeCache(EvalCode)->parse(UString(), 0, source, &sid, &errLine, &errMsg);
+      source->deref();
 
       // no program node means a syntax occurred
       if (!progNode) {
@@ -556,8 +568,7 @@ Value GlobalFuncImp::call(ExecState *exec, Object &/*thisObj*/, const List &args
       if (newExec.hadException())
         exec->setException(newExec.exception());
 
-      if ( progNode->deref() )
-          delete progNode;
+      progNode->deref();
       if (c.complType() == ReturnValue)
 	  return c.value();
       // ### setException() on throw?
@@ -124,6 +124,7 @@ namespace KJS {
   class GlobalFuncImp : public InternalFunctionImp {
   public:
     GlobalFuncImp(ExecState *exec, FunctionPrototypeImp *funcProto, int i, int len);
+    virtual ObjectImp *clone() const { return new GlobalFuncImp(*this); }
     virtual bool implementsCall() const;
     virtual Value call(ExecState *exec, Object &thisObj, const List &args);
     virtual CodeType codeType() const;
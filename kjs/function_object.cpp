@@ -28,6 +28,8 @@
 #include "lexer.h"
 #include "debugger.h"
 #include "object.h"
+#include "program_cache.h"
+#include "source_provider.h"
 
 #include <assert.h>
 #include <stdio.h>
@@ -97,6 +99,11 @@ Value FunctionProtoFuncImp::call(ExecState *exec, Object &thisObj, const List &a
     if (thisObj.inherits(&DeclaredFunctionImp::info)) {
        DeclaredFunctionImp *fi = static_cast<DeclaredFunctionImp*>
                                  (thisObj.imp());
+       // the text as it was written if the function has one, which those
+       // made by the Function constructor do not
+       UString text = fi->body->sourceText();
+       if (!text.isNull())
+         return String(text);
        return String("function " + fi->name().ustring() + "(" +
          fi->parameterString() + ") " + fi->body->toString());
     } else if (thisObj.inherits(&FunctionImp::info) &&
@@ -211,10 +218,18 @@ Object FunctionObjectImp::construct(ExecState *exec, const List &args)
   int sid;
   int errLine;
   UString errMsg;
-  ProgramNode *progNode = Parser::parse(UString(), 0, body.data(),body.size(),&sid,&errLine,&errMsg);
+  // the debugger wants to see every source being parsed, so bypass the cache
+  InterpreterImp *interp = exec->dynamicInterpreter()->imp();
+  Debugger *dbg = interp->debugger();
+  ProgramNode *progNode;
+  SourceProvider *source = SourceProvider::create(body);
+  if (dbg)
+    progNode = Parser::parse(UString(), 0, source, &sid, &errLine, &errMsg);
+  else
+    progNode = interp->codeCache(FunctionCode)->parse(UString(), 0, source, &sid, &errLine, &errMsg);
+  source->deref();
 
   // notify debugger that source has been parsed
-  Debugger *dbg = exec->dynamicInterpreter()->imp()->debugger();
   if (dbg) {
     bool cont = dbg->sourceParsed(exec,sid,body,errLine);
     if (!cont) {
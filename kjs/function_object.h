@@ -38,6 +38,7 @@ namespace KJS {
   public:
     FunctionPrototypeImp(ExecState *exec);
     virtual ~FunctionPrototypeImp();
+    virtual ObjectImp *clone() const { return new FunctionPrototypeImp(*this); }
 
     virtual bool implementsCall() const;
     virtual Value call(ExecState *exec, Object &thisObj, const List &args);
@@ -53,6 +54,7 @@ namespace KJS {
   public:
     FunctionProtoFuncImp(ExecState *exec,
                         FunctionPrototypeImp *funcProto, int i, int len);
+    virtual ObjectImp *clone() const { return new FunctionProtoFuncImp(*this); }
 
     virtual bool implementsCall() const;
     virtual Value call(ExecState *exec, Object &thisObj, const List &args);
@@ -71,6 +73,7 @@ namespace KJS {
   public:
     FunctionObjectImp(ExecState *exec, FunctionPrototypeImp *funcProto);
     virtual ~FunctionObjectImp();
+    virtual ObjectImp *clone() const { return new FunctionObjectImp(*this); }
 
     virtual bool implementsConstruct() const;
     virtual Object construct(ExecState *exec, const List &args);
@@ -35,6 +35,10 @@
 
 #include "identifier.h"
 
+#include <assert.h>
+#include <pthread.h>
+#include <string.h>
+
 #define DUMP_STATISTICS 0
 
 namespace KJS {
@@ -57,16 +61,335 @@ IdentifierStatisticsExitLogger::~IdentifierStatisticsExitLogger()
 
 #endif
 
-const int _minTableSize = 64;
+// The table is split into shards picked by the top bits of the hash, each
+// an open-addressed table of its own behind its own lock, so that threads
+// interning different names seldom wait for each other.
+//
+// A string is taken out of the table by the thread that drops its count to
+// 0, and until that thread gets the lock the string is still found there.
+// So the add functions take their reference under the lock, and never one
+// on a string whose count is already 0: such a string gets replaced by a new
+// one in the same slot, and remove() then finds nothing of its own to take
+// out.
+const int _shardBits = 4;
+const int _shardCount = 1 << _shardBits;
+const int _minTableSize = 16;
+
+struct Identifier::Shard {
+    pthread_mutex_t lock;
+    UString::Rep **table;
+    int tableSize;
+    int tableSizeMask;
+    int keyCount;
+};
+
+Identifier::Shard Identifier::_shards[_shardCount];
+static pthread_once_t shardsOnce = PTHREAD_ONCE_INIT;
+
+class Identifier::ShardLocker {
+public:
+    ShardLocker(Shard &shard) : _shard(shard) { pthread_mutex_lock(&_shard.lock); }
+    ~ShardLocker() { pthread_mutex_unlock(&_shard.lock); }
+private:
+    Shard &_shard;
+};
+
+inline void Identifier::insert(Shard &shard, UString::Rep *key)
+{
+    unsigned hash = key->hash();
+    
+    int i = hash & shard.tableSizeMask;
+#if DUMP_STATISTICS
+    ++numProbes;
+    numCollisions += shard.table[i] != 0;
+#endif
+    while (shard.table[i])
+        i = (i + 1) & shard.tableSizeMask;
+    
+    shard.table[i] = key;
+}
+
+void Identifier::rehash(Shard &shard, int newTableSize)
+{
+    int oldTableSize = shard.tableSize;
+    UString::Rep **oldTable = shard.table;
+
+    shard.tableSize = newTableSize;
+    shard.tableSizeMask = newTableSize - 1;
+    shard.table = (UString::Rep **)calloc(newTableSize, sizeof(UString::Rep *));
+
+    for (int i = 0; i != oldTableSize; ++i)
+        if (UString::Rep *key = oldTable[i])
+            insert(shard, key);
+
+    free(oldTable);
+}
+
+void Identifier::expand(Shard &shard)
+{
+    rehash(shard, shard.tableSize == 0 ? _minTableSize : shard.tableSize * 2);
+}
+
+void Identifier::shrink(Shard &shard)
+{
+    rehash(shard, shard.tableSize / 2);
+}
+
+// Puts a new key where the caller found room for it, with the lock held.
+void Identifier::addAt(Shard &shard, int i, UString::Rep *r)
+{
+    shard.table[i] = r;
+    ++shard.keyCount;
+    
+    if (shard.keyCount * 2 >= shard.tableSize)
+        expand(shard);
+}
+
+// Takes a reference to a string found in the table, unless it is being
+// destroyed.
+inline bool Identifier::refIfAlive(UString::Rep *r)
+{
+    int rc = __atomic_load_n(&r->rc, __ATOMIC_RELAXED);
+    while (rc != 0)
+        if (__atomic_compare_exchange_n(&r->rc, &rc, rc + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return true;
+    return false;
+}
+
+// Names of the built-in objects, properties and functions, with their
+// hashes as UString::Rep::computeHash() works them out. The table starts
+// out holding these for good, so scripts and the objects set up for every
+// interpreter find them without allocating or hashing.
+#define KJS_IDENTIFIER_EACH_BUILTIN(macro) \
+    macro("Array", 0x98fbca23U) \
+    macro("Boolean", 0xd6fa9c70U) \
+    macro("Date", 0x1501c0a9U) \
+    macro("E", 0xab7e6518U) \
+    macro("Error", 0x01f68613U) \
+    macro("EvalError", 0x66a4105fU) \
+    macro("Function", 0xc3b32c7fU) \
+    macro("Infinity", 0xb40533ddU) \
+    macro("LN10", 0x9fa3e7caU) \
+    macro("LN2", 0xc8db0eecU) \
+    macro("LOG10E", 0x805f61ceU) \
+    macro("LOG2E", 0x11443259U) \
+    macro("MAX_VALUE", 0xea78079eU) \
+    macro("MIN_VALUE", 0x022cb6afU) \
+    macro("Math", 0xd6fef1c9U) \
+    macro("NEGATIVE_INFINITY", 0x44e1161aU) \
+    macro("NaN", 0x85acbd5dU) \
+    macro("Number", 0x498c6dbfU) \
+    macro("Object", 0x424fb1c5U) \
+    macro("PI", 0x9fd0f43cU) \
+    macro("POSITIVE_INFINITY", 0xef6016bdU) \
+    macro("RangeError", 0x215e8486U) \
+    macro("ReferenceError", 0xd3775da9U) \
+    macro("RegExp", 0xb56971a6U) \
+    macro("SQRT1_2", 0x6db1d5cdU) \
+    macro("SQRT2", 0xb38a9221U) \
+    macro("String", 0x6c06291eU) \
+    macro("SyntaxError", 0x9e418824U) \
+    macro("TypeError", 0x8406877fU) \
+    macro("URIError", 0x16b90a34U) \
+    macro("__proto__", 0xcdc4b67eU) \
+    macro("abs", 0xf385fab5U) \
+    macro("acos", 0x67dda214U) \
+    macro("anchor", 0xa6e258bbU) \
+    macro("apply", 0x14b928a0U) \
+    macro("arguments", 0x6e67fb24U) \
+    macro("asin", 0x430bd2f4U) \
+    macro("atan", 0x0fa2145eU) \
+    macro("atan2", 0x83401514U) \
+    macro("big", 0xbfb4fb19U) \
+    macro("blink", 0x82b92ba8U) \
+    macro("bold", 0x436a4380U) \
+    macro("call", 0x443f2553U) \
+    macro("callee", 0x380a350dU) \
+    macro("ceil", 0xa3a169cdU) \
+    macro("charAt", 0xac5e90a0U) \
+    macro("charCodeAt", 0xacc5871dU) \
+    macro("concat", 0x43918c5bU) \
+    macro("constructor", 0xb5168533U) \
+    macro("cos", 0x4cd94e56U) \
+    macro("decodeURI", 0x42b45b7eU) \
+    macro("decodeURIComponent", 0xdea47528U) \
+    macro("encodeURI", 0x39ce9a51U) \
+    macro("encodeURIComponent", 0xaedb5182U) \
+    macro("escape", 0xd5eb3337U) \
+    macro("eval", 0x69df0acdU) \
+    macro("exec", 0xbf52b1edU) \
+    macro("exp", 0xacedbf23U) \
+    macro("fixed", 0xa106f1c0U) \
+    macro("floor", 0x05d89166U) \
+    macro("fontcolor", 0x9aed39d7U) \
+    macro("fontsize", 0xc9e1acb0U) \
+    macro("getDate", 0xa89a8cc7U) \
+    macro("getDay", 0x429f40d5U) \
+    macro("getFullYear", 0x7c6b71c8U) \
+    macro("getHours", 0xac8e8d1bU) \
+    macro("getMilliseconds", 0xf3652d48U) \
+    macro("getMinutes", 0xf4f8e643U) \
+    macro("getMonth", 0xb3c01529U) \
+    macro("getSeconds", 0x7d42570eU) \
+    macro("getTime", 0x9e63444fU) \
+    macro("getTimezoneOffset", 0xe9fa3a31U) \
+    macro("getUTCDate", 0x01a83ccfU) \
+    macro("getUTCDay", 0x250d23c4U) \
+    macro("getUTCFullYear", 0x9c33af9bU) \
+    macro("getUTCHours", 0xec5596f8U) \
+    macro("getUTCMilliseconds", 0x5a4d5293U) \
+    macro("getUTCMinutes", 0xd8299337U) \
+    macro("getUTCMonth", 0x10438076U) \
+    macro("getUTCSeconds", 0x98ed9e0dU) \
+    macro("getYear", 0x26b74a85U) \
+    macro("global", 0x4a67cc89U) \
+    macro("ignoreCase", 0x801cc033U) \
+    macro("index", 0x380dce0bU) \
+    macro("indexOf", 0x6d244554U) \
+    macro("input", 0x411f2357U) \
+    macro("isFinite", 0x377a1af8U) \
+    macro("isNaN", 0x32ee5ab2U) \
+    macro("italics", 0x04c91cdbU) \
+    macro("join", 0xd30c4760U) \
+    macro("lastIndex", 0xb9d40808U) \
+    macro("lastIndexOf", 0x851f0537U) \
+    macro("length", 0xf8ec99caU) \
+    macro("link", 0x9165da39U) \
+    macro("log", 0xe8adbb92U) \
+    macro("match", 0x0a07a4d9U) \
+    macro("max", 0xf96bd523U) \
+    macro("message", 0xc7a15c53U) \
+    macro("min", 0x913955a3U) \
+    macro("multiline", 0xa65c345bU) \
+    macro("name", 0xc5df0d43U) \
+    macro("parseFloat", 0xadfe2057U) \
+    macro("parseInt", 0x0cbdc631U) \
+    macro("pop", 0xb92c3672U) \
+    macro("pow", 0x5a9481d4U) \
+    macro("prototype", 0xee9ead1dU) \
+    macro("push", 0xbcafb133U) \
+    macro("random", 0x1f6aa0dfU) \
+    macro("replace", 0xcf09155fU) \
+    macro("reverse", 0x51ae6982U) \
+    macro("round", 0xd4d2a1ddU) \
+    macro("search", 0x4ccbe063U) \
+    macro("setDate", 0x6eb76444U) \
+    macro("setFullYear", 0xcea62e1fU) \
+    macro("setHours", 0x6aaceca2U) \
+    macro("setMilliseconds", 0x3f500ce8U) \
+    macro("setMinutes", 0xa5640cceU) \
+    macro("setMonth", 0x235032aaU) \
+    macro("setSeconds", 0xc34048bcU) \
+    macro("setTime", 0x03af2029U) \
+    macro("setUTCDate", 0xed15f474U) \
+    macro("setUTCFullYear", 0x2cfdd8a2U) \
+    macro("setUTCHours", 0x35f6d28dU) \
+    macro("setUTCMilliseconds", 0x71bcfae7U) \
+    macro("setUTCMinutes", 0x82b65cd1U) \
+    macro("setUTCMonth", 0x780c65eaU) \
+    macro("setUTCSeconds", 0xc6a8d651U) \
+    macro("setYear", 0x6d9a592aU) \
+    macro("shift", 0x58f94c3eU) \
+    macro("sin", 0x9e0cd36dU) \
+    macro("slice", 0x722c69a6U) \
+    macro("small", 0x84a70415U) \
+    macro("sort", 0x2669013aU) \
+    macro("source", 0x3df2535bU) \
+    macro("splice", 0xc133ad28U) \
+    macro("split", 0x88d275d3U) \
+    macro("sqrt", 0x0cc29d54U) \
+    macro("strike", 0xecfe7610U) \
+    macro("sub", 0xdaa55e70U) \
+    macro("substr", 0xb0a56b23U) \
+    macro("substring", 0xa69c7240U) \
+    macro("sup", 0xc9a841feU) \
+    macro("tan", 0x90e6616bU) \
+    macro("test", 0xbb5ef48fU) \
+    macro("toDateString", 0x5292492bU) \
+    macro("toGMTString", 0x2d29512eU) \
+    macro("toLocaleDateString", 0xb8a01397U) \
+    macro("toLocaleString", 0x64a83a20U) \
+    macro("toLocaleTimeString", 0xc9d8e5b8U) \
+    macro("toLowerCase", 0x036c857eU) \
+    macro("toString", 0x1c723805U) \
+    macro("toTimeString", 0xc4e66fe0U) \
+    macro("toUTCString", 0xb7f8d692U) \
+    macro("toUpperCase", 0x682f1834U) \
+    macro("undefined", 0xf4f6d4e4U) \
+    macro("unescape", 0xccc0ab83U) \
+    macro("unshift", 0xd14091daU) \
+    macro("valueOf", 0x75973860U)
+
+void Identifier::addBuiltin(const char *c, unsigned hash)
+{
+    assert(hash == UString::Rep::computeHash(c));
+    
+    int length = strlen(c);
+    char *d = static_cast<char *>(malloc(length));
+    memcpy(d, c, length);
+    
+    // The reference createLatin1() hands back is never given up.
+    UString::Rep *r = UString::Rep::createLatin1(d, length);
+    r->isIdentifier = 1;
+    r->_hash = hash;
+    
+    Shard &shard = _shards[hash >> (32 - _shardBits)];
+    insert(shard, r);
+    ++shard.keyCount;
+    if (shard.keyCount * 2 >= shard.tableSize)
+        expand(shard);
+}
+
+void Identifier::initializeShards()
+{
+    for (int i = 0; i != _shardCount; ++i) {
+        pthread_mutex_init(&_shards[i].lock, 0);
+        expand(_shards[i]);
+    }
+    
+    #define ADD_BUILTIN(string, hash) addBuiltin(string, hash);
+    KJS_IDENTIFIER_EACH_BUILTIN(ADD_BUILTIN)
+    #undef ADD_BUILTIN
+}
+
+inline Identifier::Shard &Identifier::shardFor(unsigned hash)
+{
+    pthread_once(&shardsOnce, initializeShards);
+    return _shards[hash >> (32 - _shardBits)];
+}
+
+// Identifiers hold their characters in 8 bits when they can, so these
+// compare either kind with either kind.
 
-UString::Rep **Identifier::_table;
-int Identifier::_tableSize;
-int Identifier::_tableSizeMask;
-int Identifier::_keyCount;
+static inline unsigned short charCode(UChar c)
+{
+    return c.uc;
+}
+
+static inline unsigned short charCode(char c)
+{
+    return static_cast<unsigned char>(c);
+}
+
+template <class CharType1, class CharType2>
+static bool equalChars(const CharType1 *d, const CharType2 *s, int length)
+{
+    for (int i = 0; i != length; ++i)
+        if (charCode(d[i]) != charCode(s[i]))
+            return false;
+    return true;
+}
 
 bool Identifier::equal(UString::Rep *r, const char *s)
 {
     int length = r->len;
+    if (r->isLatin1()) {
+        const char *d = r->latin1Data();
+        for (int i = 0; i != length; ++i)
+            if (d[i] != s[i] || !s[i])
+                return false;
+        return s[length] == 0;
+    }
     const UChar *d = r->data();
     for (int i = 0; i != length; ++i)
         if (d[i].uc != (unsigned char)s[i])
@@ -78,11 +401,9 @@ bool Identifier::equal(UString::Rep *r, const UChar *s, int length)
 {
     if (r->len != length)
         return false;
-    const UChar *d = r->data();
-    for (int i = 0; i != length; ++i)
-        if (d[i].uc != s[i].uc)
-            return false;
-    return true;
+    if (r->isLatin1())
+        return equalChars(r->latin1Data(), s, length);
+    return equalChars(r->data(), s, length);
 }
 
 bool Identifier::equal(UString::Rep *r, UString::Rep *b)
@@ -90,206 +411,209 @@ bool Identifier::equal(UString::Rep *r, UString::Rep *b)
     int length = r->len;
     if (length != b->len)
         return false;
-    const UChar *d = r->data();
-    const UChar *s = b->data();
-    for (int i = 0; i != length; ++i)
-        if (d[i].uc != s[i].uc)
-            return false;
-    return true;
+    if (r->isLatin1()) {
+        if (b->isLatin1())
+            return memcmp(r->latin1Data(), b->latin1Data(), length) == 0;
+        return equalChars(r->latin1Data(), b->data(), length);
+    }
+    if (b->isLatin1())
+        return equalChars(r->data(), b->latin1Data(), length);
+    return equalChars(r->data(), b->data(), length);
 }
 
 UString::Rep *Identifier::add(const char *c)
 {
-    if (!c)
+    if (!c) {
+        UString::Rep::null.ref();
         return &UString::Rep::null;
+    }
     int length = strlen(c);
-    if (length == 0)
+    if (length == 0) {
+        UString::Rep::empty.ref();
         return &UString::Rep::empty;
+    }
     
-    if (!_table)
-        expand();
-    
-    unsigned hash = UString::Rep::computeHash(c);
+    unsigned hash = UString::Rep::computeHash(c, length);
+    Shard &shard = shardFor(hash);
+    ShardLocker locker(shard);
     
-    int i = hash & _tableSizeMask;
+    int i = hash & shard.tableSizeMask;
 #if DUMP_STATISTICS
     ++numProbes;
-    numCollisions += _table[i] && !equal(_table[i], c);
+    numCollisions += shard.table[i] && !equal(shard.table[i], c);
 #endif
-    while (UString::Rep *key = _table[i]) {
-        if (equal(key, c))
-            return key;
-        i = (i + 1) & _tableSizeMask;
+    UString::Rep *key;
+    while ((key = shard.table[i])) {
+        if (equal(key, c)) {
+            if (refIfAlive(key))
+                return key;
+            break;
+        }
+        i = (i + 1) & shard.tableSizeMask;
     }
     
-    UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * length));
-    for (int j = 0; j != length; j++)
-        d[j] = c[j];
+    char *d = static_cast<char *>(malloc(length));
+    memcpy(d, c, length);
     
-    UString::Rep *r = UString::Rep::create(d, length);
+    UString::Rep *r = UString::Rep::createLatin1(d, length);
     r->isIdentifier = 1;
-    r->rc = 0;
     r->_hash = hash;
     
-    _table[i] = r;
-    ++_keyCount;
-    
-    if (_keyCount * 2 >= _tableSize)
-        expand();
+    if (key)
+        shard.table[i] = r;
+    else
+        addAt(shard, i, r);
     
     return r;
 }
 
 UString::Rep *Identifier::add(const UChar *s, int length)
 {
-    if (length == 0)
+    if (length == 0) {
+        UString::Rep::empty.ref();
         return &UString::Rep::empty;
-    
-    if (!_table)
-        expand();
+    }
     
     unsigned hash = UString::Rep::computeHash(s, length);
+    Shard &shard = shardFor(hash);
+    ShardLocker locker(shard);
     
-    int i = hash & _tableSizeMask;
+    int i = hash & shard.tableSizeMask;
 #if DUMP_STATISTICS
     ++numProbes;
-    numCollisions += _table[i] && !equal(_table[i], s, length);
+    numCollisions += shard.table[i] && !equal(shard.table[i], s, length);
 #endif
-    while (UString::Rep *key = _table[i]) {
-        if (equal(key, s, length))
-            return key;
-        i = (i + 1) & _tableSizeMask;
+    UString::Rep *key;
+    while ((key = shard.table[i])) {
+        if (equal(key, s, length)) {
+            if (refIfAlive(key))
+                return key;
+            break;
+        }
+        i = (i + 1) & shard.tableSizeMask;
     }
     
-    UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * length));
+    bool latin1 = true;
     for (int j = 0; j != length; j++)
-        d[j] = s[j];
+        if (s[j].uc > 0xFF)
+            latin1 = false;
     
-    UString::Rep *r = UString::Rep::create(d, length);
+    UString::Rep *r;
+    if (latin1) {
+        char *d = static_cast<char *>(malloc(length));
+        for (int j = 0; j != length; j++)
+            d[j] = static_cast<char>(s[j].uc);
+        r = UString::Rep::createLatin1(d, length);
+    } else {
+        UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * length));
+        memcpy(d, s, sizeof(UChar) * length);
+        r = UString::Rep::create(d, length);
+    }
     r->isIdentifier = 1;
-    r->rc = 0;
     r->_hash = hash;
     
-    _table[i] = r;
-    ++_keyCount;
-    
-    if (_keyCount * 2 >= _tableSize)
-        expand();
+    if (key)
+        shard.table[i] = r;
+    else
+        addAt(shard, i, r);
     
     return r;
 }
 
 UString::Rep *Identifier::add(UString::Rep *r)
 {
-    if (r->isIdentifier)
+    // the caller holds a reference to r, so an identifier cannot be going
+    if (r->isIdentifier) {
+        r->ref();
         return r;
-    if (r->len == 0)
+    }
+    if (r->len == 0) {
+        UString::Rep::empty.ref();
         return &UString::Rep::empty;
-    
-    if (!_table)
-        expand();
+    }
     
     unsigned hash = r->hash();
+    Shard &shard = shardFor(hash);
+    ShardLocker locker(shard);
     
-    int i = hash & _tableSizeMask;
+    int i = hash & shard.tableSizeMask;
 #if DUMP_STATISTICS
     ++numProbes;
-    numCollisions += _table[i] && !equal(_table[i], r);
+    numCollisions += shard.table[i] && !equal(shard.table[i], r);
 #endif
-    while (UString::Rep *key = _table[i]) {
-        if (equal(key, r))
-            return key;
-        i = (i + 1) & _tableSizeMask;
+    UString::Rep *key;
+    while ((key = shard.table[i])) {
+        if (equal(key, r)) {
+            if (refIfAlive(key))
+                return key;
+            break;
+        }
+        i = (i + 1) & shard.tableSizeMask;
     }
     
     r->isIdentifier = 1;
+    r->ref();
     
-    _table[i] = r;
-    ++_keyCount;
-    
-    if (_keyCount * 2 >= _tableSize)
-        expand();
+    if (key)
+        shard.table[i] = r;
+    else
+        addAt(shard, i, r);
     
     return r;
 }
 
-inline void Identifier::insert(UString::Rep *key)
-{
-    unsigned hash = key->hash();
-    
-    int i = hash & _tableSizeMask;
-#if DUMP_STATISTICS
-    ++numProbes;
-    numCollisions += _table[i] != 0;
-#endif
-    while (_table[i])
-        i = (i + 1) & _tableSizeMask;
-    
-    _table[i] = key;
-}
-
 void Identifier::remove(UString::Rep *r)
 {
     unsigned hash = r->hash();
+    Shard &shard = shardFor(hash);
+    ShardLocker locker(shard);
+    
+    // nothing can have taken a reference since the count dropped to 0
+    assert(r->rc == 0);
     
     UString::Rep *key;
     
-    int i = hash & _tableSizeMask;
+    int i = hash & shard.tableSizeMask;
 #if DUMP_STATISTICS
     ++numProbes;
-    numCollisions += _table[i] && equal(_table[i], r);
+    numCollisions += shard.table[i] && shard.table[i] != r;
 #endif
-    while ((key = _table[i])) {
-        if (equal(key, r))
+    while ((key = shard.table[i])) {
+        if (key == r)
             break;
-        i = (i + 1) & _tableSizeMask;
+        i = (i + 1) & shard.tableSizeMask;
     }
+    // an add() may have put a new string in its place already
     if (!key)
         return;
     
-    _table[i] = 0;
-    --_keyCount;
+    shard.table[i] = 0;
+    --shard.keyCount;
     
-    if (_keyCount * 6 < _tableSize && _tableSize > _minTableSize) {
-        shrink();
+    if (shard.keyCount * 6 < shard.tableSize && shard.tableSize > _minTableSize) {
+        shrink(shard);
         return;
     }
     
     // Reinsert all the items to the right in the same cluster.
     while (1) {
-        i = (i + 1) & _tableSizeMask;
-        key = _table[i];
+        i = (i + 1) & shard.tableSizeMask;
+        key = shard.table[i];
         if (!key)
             break;
-        _table[i] = 0;
-        insert(key);
+        shard.table[i] = 0;
+        insert(shard, key);
     }
 }
 
-void Identifier::expand()
-{
-    rehash(_tableSize == 0 ? _minTableSize : _tableSize * 2);
-}
-
-void Identifier::shrink()
-{
-    rehash(_tableSize / 2);
-}
-
-void Identifier::rehash(int newTableSize)
+void Identifier::widen(UString::Rep *r)
 {
-    int oldTableSize = _tableSize;
-    UString::Rep **oldTable = _table;
-
-    _tableSize = newTableSize;
-    _tableSizeMask = newTableSize - 1;
-    _table = (UString::Rep **)calloc(newTableSize, sizeof(UString::Rep *));
-
-    for (int i = 0; i != oldTableSize; ++i)
-        if (UString::Rep *key = oldTable[i])
-            insert(key);
-
-    free(oldTable);
+    Shard &shard = shardFor(r->hash());
+    ShardLocker locker(shard);
+    
+    // another thread may have got here first
+    if (r->latin1)
+        r->widenBuffer();
 }
 
 const Identifier &Identifier::null()
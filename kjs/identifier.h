@@ -26,15 +26,23 @@
 
 namespace KJS {
 
+    /**
+     * A string interned in a table shared by all interpreters, so that
+     * identifiers with the same characters share one @ref UString::Rep and
+     * compare by pointer. Identifiers may be made, compared and dropped on
+     * several threads at once without the interpreter lock. Reading their
+     * characters, as @ref data() does, still needs the lock, since that
+     * can convert the characters of an identifier other threads are using.
+     */
     class Identifier {
         friend class PropertyMap;
     public:
         static void init();
 
         Identifier() { }
-        Identifier(const char *s) : _ustring(add(s)) { }
-        Identifier(const UChar *s, int length) : _ustring(add(s, length)) { }
-        explicit Identifier(const UString &s) : _ustring(add(s.rep)) { }
+        Identifier(const char *s) : _ustring(add(s), UString::Adopt) { }
+        Identifier(const UChar *s, int length) : _ustring(add(s, length), UString::Adopt) { }
+        explicit Identifier(const UString &s) : _ustring(add(s.rep), UString::Adopt) { }
         
         const UString &ustring() const { return _ustring; }
         DOM::DOMString string() const;
@@ -64,6 +72,13 @@ namespace KJS {
         friend bool operator==(const Identifier &, const char *);
     
         static void remove(UString::Rep *);
+        /**
+         * @internal
+         *
+         * Converts the characters of an identifier to UTF-16 under the lock
+         * that other threads compare them under.
+         */
+        static void widen(UString::Rep *);
 
     private:
         UString _ustring;
@@ -77,20 +92,26 @@ namespace KJS {
         static bool equal(const Identifier &a, const char *b)
             { return equal(a._ustring.rep, b); }
         
+        // these return the string with a reference taken for the caller
         static UString::Rep *add(const char *);
         static UString::Rep *add(const UChar *, int length);
         static UString::Rep *add(UString::Rep *);
         
-        static void insert(UString::Rep *);
+        struct Shard;
+        class ShardLocker;
         
-        static void rehash(int newTableSize);
-        static void expand();
-        static void shrink();
+        static Shard &shardFor(unsigned hash);
+        static void initializeShards();
+        static void addBuiltin(const char *, unsigned hash);
+        static void addAt(Shard &, int i, UString::Rep *);
+        static bool refIfAlive(UString::Rep *);
+        static void insert(Shard &, UString::Rep *);
+        
+        static void rehash(Shard &, int newTableSize);
+        static void expand(Shard &);
+        static void shrink(Shard &);
 
-        static UString::Rep **_table;
-        static int _tableSize;
-        static int _tableSizeMask;
-        static int _keyCount;
+        static Shard _shards[];
     };
     
     inline bool operator==(const Identifier &a, const Identifier &b)
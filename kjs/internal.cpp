@@ -41,20 +41,27 @@
 #include "interpreter_map.h"
 #include "lexer.h"
 #include "math_object.h"
+#include "node_arena.h"
 #include "nodes.h"
 #include "number_object.h"
 #include "object.h"
+#include "object_cloner.h"
 #include "object_object.h"
 #include "operations.h"
+#include "parser.h"
+#include "program_cache.h"
+#include "protect.h"
 #include "regexp_object.h"
+#include "source_provider.h"
 #include "string_object.h"
 
 #define I18N_NOOP(s) s
 
-extern int kjsyyparse();
-
 using namespace KJS;
 
+// size limit of each of the per-interpreter eval and Function constructor caches
+static const size_t codeCacheBudget = 1024 * 1024;
+
 #if !APPLE_CHANGES
 
 namespace KJS {
@@ -78,6 +85,8 @@ namespace KJS {
 static pthread_once_t interpreterLockOnce = PTHREAD_ONCE_INIT;
 static pthread_mutex_t interpreterLock;
 static int interpreterLockCount = 0;
+// only meaningful while interpreterLockCount is not 0
+static pthread_t interpreterLockOwner;
 
 static void initializeInterpreterLock()
 {
@@ -93,6 +102,7 @@ static inline void lockInterpreter()
 {
   pthread_once(&interpreterLockOnce, initializeInterpreterLock);
   pthread_mutex_lock(&interpreterLock);
+  interpreterLockOwner = pthread_self();
   interpreterLockCount++;
 }
 
@@ -432,44 +442,211 @@ void ContextImp::mark()
 
 // ------------------------------ Parser ---------------------------------------
 
-ProgramNode *Parser::progNode = 0;
-int Parser::sid = 0;
+bool Parser::lazyFunctionBodies = true;
+bool Parser::optimizeTrees = true;
+
+static pthread_once_t parserKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t parserKey;
+static pthread_mutex_t sourceIdLock = PTHREAD_MUTEX_INITIALIZER;
+static int lastSourceId = 0;
+
+// the parser and lexer of a thread hold strings and source providers that
+// scripts share, so they are dropped under the interpreter lock like other
+// things scripts use
+static void deleteParser(void *parser)
+{
+  Interpreter::lock();
+  delete static_cast<Parser *>(parser);
+  Interpreter::unlock();
+}
+
+static void createParserKey()
+{
+  pthread_key_create(&parserKey, deleteParser);
+}
+
+Parser::Parser()
+  : progNode(0), sid(-1), nodeCount(0), arena(0), currentCode(0), currentCode8(0),
+    currentEncoding(Latin1Encoding), currentLength(0), currentProvider(0), currentOffset(0)
+{
+}
+
+Parser *Parser::curr()
+{
+  pthread_once(&parserKeyOnce, createParserKey);
+  Parser *parser = static_cast<Parser *>(pthread_getspecific(parserKey));
+  if (!parser) {
+    parser = new Parser();
+    pthread_setspecific(parserKey, parser);
+  }
+  return parser;
+}
+
+void Parser::deleteCurr()
+{
+  pthread_once(&parserKeyOnce, createParserKey);
+  if (void *parser = pthread_getspecific(parserKey))
+    deleteParser(parser);
+  pthread_setspecific(parserKey, 0);
+  Lexer::deleteCurr();
+}
+
+int Parser::newSourceId()
+{
+  pthread_mutex_lock(&sourceIdLock);
+  int id = ++lastSourceId;
+  pthread_mutex_unlock(&sourceIdLock);
+  return id;
+}
 
 ProgramNode *Parser::parse(const UString &sourceURL, int startingLineNumber,
                            const UChar *code, unsigned int length, int *sourceId,
 			   int *errLine, UString *errMsg)
+{
+  int id = newSourceId();
+  if (sourceId)
+    *sourceId = id;
+  Parser *parser = curr();
+  parser->currentProvider = 0;
+  parser->currentOffset = 0;
+  parser->setCode(sourceURL, startingLineNumber, code, length);
+  return parser->parseCode(id, errLine, errMsg);
+}
+
+ProgramNode *Parser::parse(const UString &sourceURL, int startingLineNumber,
+                           const char *code, unsigned int length, TextEncoding encoding,
+                           int *sourceId, int *errLine, UString *errMsg)
+{
+  int id = newSourceId();
+  if (sourceId)
+    *sourceId = id;
+  Parser *parser = curr();
+  parser->currentProvider = 0;
+  parser->currentOffset = 0;
+  parser->setCode(sourceURL, startingLineNumber, code, length, encoding);
+  return parser->parseCode(id, errLine, errMsg);
+}
+
+ProgramNode *Parser::parse(const UString &sourceURL, int startingLineNumber, SourceProvider *source,
+                           int *sourceId, int *errLine, UString *errMsg)
+{
+  int id = newSourceId();
+  if (sourceId)
+    *sourceId = id;
+  Parser *parser = curr();
+  source->ref();
+  parser->currentProvider = source;
+  parser->currentOffset = 0;
+  if (source->characters())
+    parser->setCode(sourceURL, startingLineNumber, source->characters(), source->length());
+  else
+    parser->setCode(sourceURL, startingLineNumber, source->bytes(), source->length(), source->encoding());
+  return parser->parseCode(id, errLine, errMsg);
+}
+
+ProgramNode *Parser::parseFunctionBody(const UString &sourceURL, const LazyFunctionBody &body)
+{
+  // nested bodies and functions refer to the same provider
+  Parser *parser = curr();
+  SourceProvider *source = body.source;
+  source->ref();
+  parser->currentProvider = source;
+  parser->currentOffset = body.start;
+  if (source->characters())
+    parser->setCode(sourceURL, body.startingLineNumber, source->characters() + body.start, body.length);
+  else
+    parser->setCode(sourceURL, body.startingLineNumber, source->bytes() + body.start, body.length,
+                    source->encoding());
+  return parser->parseCode(body.sourceId, 0, 0);
+}
+
+SourceProvider *Parser::source()
+{
+  if (!currentProvider) {
+    if (currentCode8)
+      currentProvider = SourceProvider::create(currentCode8, currentLength, currentEncoding);
+    else
+      currentProvider = SourceProvider::create(UString(currentCode, currentLength));
+  }
+  return currentProvider;
+}
+
+FunctionBodyNode *Parser::lazyFunctionBody(int start, int length, int line, bool hasFunctionDeclarations)
+{
+  LazyFunctionBody body;
+  body.source = source();
+  body.start = currentOffset + start;
+  body.length = length;
+  body.startingLineNumber = line - 1;
+  body.sourceId = sid;
+  body.hasFunctionDeclarations = hasFunctionDeclarations;
+  return new FunctionBodyNode(body);
+}
+
+void Parser::setFunctionSource(FunctionBodyNode *body, int start, int end)
+{
+  body->setSource(source(), currentOffset + start, currentOffset + end);
+}
+
+void Parser::setCode(const UString &sourceURL, int startingLineNumber, const UChar *code, unsigned int length)
+{
+  Lexer::curr()->setCode(sourceURL, startingLineNumber, code, length);
+  currentCode = code;
+  currentCode8 = 0;
+  currentLength = length;
+}
+
+void Parser::setCode(const UString &sourceURL, int startingLineNumber, const char *code, unsigned int length,
+                     TextEncoding encoding)
+{
+  Lexer::curr()->setCode(sourceURL, startingLineNumber, code, length, encoding);
+  currentCode = 0;
+  currentCode8 = code;
+  currentEncoding = encoding;
+  currentLength = length;
+}
+
+ProgramNode *Parser::parseCode(int sourceId, int *errLine, UString *errMsg)
 {
   if (errLine)
     *errLine = -1;
   if (errMsg)
     *errMsg = 0;
   
-  Lexer::curr()->setCode(sourceURL, startingLineNumber, code, length);
+  Lexer *lexer = Lexer::curr();
   progNode = 0;
-  sid++;
-  if (sourceId)
-    *sourceId = sid;
-  // Enable this (and the #define YYDEBUG in grammar.y) to debug a parse error
-  //extern int kjsyydebug;
-  //kjsyydebug=1;
-  int parseError = kjsyyparse();
-  Lexer::curr()->doneParsing();
+  nodeCount = 0;
+  arena = new NodeArena;
+  sid = sourceId;
+  progNode = DescentParser::parse(this, lexer);
+  bool parseError = !progNode;
+  if (!parseError && optimizeTrees) {
+    Optimizer optimizer;
+    progNode->optimize(optimizer);
+  }
+  lexer->doneParsing();
   ProgramNode *prog = progNode;
+  NodeArena *nodes = arena;
   progNode = 0;
+  arena = 0;
   sid = -1;
+  currentCode = 0;
+  currentCode8 = 0;
+  currentLength = 0;
+  // the nodes hold references of their own
+  if (currentProvider)
+    currentProvider->deref();
+  currentProvider = 0;
 
   if (parseError) {
-    int eline = Lexer::curr()->lineNo();
+    int eline = lexer->lineNo();
     if (errLine)
       *errLine = eline;
     if (errMsg)
       *errMsg = "Parse error";
-    if (prog) {
-      // must ref and deref to clean up properly
-      prog->ref();
-      prog->deref();
-      delete prog;
-    }
+    // frees whatever was built before the error
+    nodes->ref();
+    nodes->deref();
     return 0;
   }
 
@@ -558,7 +735,10 @@ InterpreterImp::InterpreterImp(Interpreter *interp, const Object &glob)
   global = glob;
   globExec = new ExecState(m_interpreter,0);
   dbg = 0;
+  m_pendingBuiltins = 0;
   m_compatMode = Interpreter::NativeMode;
+  m_evalCodeCache = new ProgramCache(codeCacheBudget);
+  m_functionCodeCache = new ProgramCache(codeCacheBudget);
 
   // initialize properties of the global object
   initGlobalObject();
@@ -582,11 +762,65 @@ void InterpreterImp::unlock()
   unlockInterpreter();
 }
 
- void InterpreterImp::initGlobalObject()
+int InterpreterImp::dropLock()
+{
+  if (interpreterLockCount == 0 || !pthread_equal(interpreterLockOwner, pthread_self()))
+    return 0;
+
+  int depth = interpreterLockCount;
+  for (int i = 0; i < depth; i++)
+    unlockInterpreter();
+  return depth;
+}
+
+void InterpreterImp::restoreLock(int depth)
+{
+  for (int i = 0; i < depth; i++)
+    lockInterpreter();
+}
+
+// Copies of the built-in objects of the first interpreter, made right after
+// they were created and before any script could change them.
+struct BuiltinsSnapshot {
+  SavedBuiltinsInternal builtins;
+  // holds the properties that were put on the global object
+  ProtectedObject global;
+  // The snapshot keeps these alive after globalClear() has replaced them, so
+  // they have to be swapped for the current ones when copying.
+  ProtectedValue undefined;
+  ProtectedValue null;
+  ProtectedValue trueValue;
+  ProtectedValue falseValue;
+  ProtectedValue nan;
+};
+
+static BuiltinsSnapshot *builtinsSnapshot = 0;
+static bool builtinsSnapshotEnabled = true;
+// set once the built-ins turned out not to be copyable
+static bool builtinsSnapshotFailed = false;
+
+void InterpreterImp::initGlobalObject()
 {
   Identifier::init();
-  
-  // Contructor prototype objects (Object.prototype, Array.prototype etc)
+
+  if (builtinsSnapshot && copyBuiltinsSnapshot())
+    return;
+
+  // Only a global object without properties of its own can be told apart
+  // from the built-ins put on it.
+  bool takeSnapshot = builtinsSnapshotEnabled && !builtinsSnapshot && !builtinsSnapshotFailed
+    && !static_cast<ObjectImp*>(global.imp())->hasDirectProperties();
+
+  createBuiltins();
+
+  if (takeSnapshot)
+    takeBuiltinsSnapshot();
+}
+
+void InterpreterImp::createBuiltins()
+{
+  // Contructor prototype objects (Object.prototype, Function.prototype).
+  // The others are created by createLazyBuiltins().
 
   FunctionPrototypeImp *funcProto = new FunctionPrototypeImp(globExec);
   b_FunctionPrototype = Object(funcProto);
@@ -594,93 +828,42 @@ void InterpreterImp::unlock()
   b_ObjectPrototype = Object(objProto);
   funcProto->setPrototype(b_ObjectPrototype);
 
-  ArrayPrototypeImp *arrayProto = new ArrayPrototypeImp(globExec,objProto);
-  b_ArrayPrototype = Object(arrayProto);
-  StringPrototypeImp *stringProto = new StringPrototypeImp(globExec,objProto);
-  b_StringPrototype = Object(stringProto);
-  BooleanPrototypeImp *booleanProto = new BooleanPrototypeImp(globExec,objProto,funcProto);
-  b_BooleanPrototype = Object(booleanProto);
-  NumberPrototypeImp *numberProto = new NumberPrototypeImp(globExec,objProto,funcProto);
-  b_NumberPrototype = Object(numberProto);
-  DatePrototypeImp *dateProto = new DatePrototypeImp(globExec,objProto);
-  b_DatePrototype = Object(dateProto);
-  RegExpPrototypeImp *regexpProto = new RegExpPrototypeImp(globExec,objProto,funcProto);
-  b_RegExpPrototype = Object(regexpProto);
-  ErrorPrototypeImp *errorProto = new ErrorPrototypeImp(globExec,objProto,funcProto);
-  b_ErrorPrototype = Object(errorProto);
-
   static_cast<ObjectImp*>(global.imp())->setPrototype(b_ObjectPrototype);
 
-  // Constructors (Object, Array, etc.)
+  // Constructors (Object, Function)
   b_Object = Object(new ObjectObjectImp(globExec, objProto, funcProto));
   b_Function = Object(new FunctionObjectImp(globExec, funcProto));
-  b_Array = Object(new ArrayObjectImp(globExec, funcProto, arrayProto));
-  b_String = Object(new StringObjectImp(globExec, funcProto, stringProto));
-  b_Boolean = Object(new BooleanObjectImp(globExec, funcProto, booleanProto));
-  b_Number = Object(new NumberObjectImp(globExec, funcProto, numberProto));
-  b_Date = Object(new DateObjectImp(globExec, funcProto, dateProto));
-  b_RegExp = Object(new RegExpObjectImp(globExec, funcProto, regexpProto));
-  b_Error = Object(new ErrorObjectImp(globExec, funcProto, errorProto));
-
-  // Error object prototypes
-  b_evalErrorPrototype = Object(new NativeErrorPrototypeImp(globExec,errorProto,EvalError,
-                                                            "EvalError","EvalError"));
-  b_rangeErrorPrototype = Object(new NativeErrorPrototypeImp(globExec,errorProto,RangeError,
-                                                            "RangeError","RangeError"));
-  b_referenceErrorPrototype = Object(new NativeErrorPrototypeImp(globExec,errorProto,ReferenceError,
-                                                            "ReferenceError","ReferenceError"));
-  b_syntaxErrorPrototype = Object(new NativeErrorPrototypeImp(globExec,errorProto,SyntaxError,
-                                                            "SyntaxError","SyntaxError"));
-  b_typeErrorPrototype = Object(new NativeErrorPrototypeImp(globExec,errorProto,TypeError,
-                                                            "TypeError","TypeError"));
-  b_uriErrorPrototype = Object(new NativeErrorPrototypeImp(globExec,errorProto,URIError,
-                                                            "URIError","URIError"));
-
-  // Error objects
-  b_evalError = Object(new NativeErrorImp(globExec,funcProto,b_evalErrorPrototype));
-  b_rangeError = Object(new NativeErrorImp(globExec,funcProto,b_rangeErrorPrototype));
-  b_referenceError = Object(new NativeErrorImp(globExec,funcProto,b_referenceErrorPrototype));
-  b_syntaxError = Object(new NativeErrorImp(globExec,funcProto,b_syntaxErrorPrototype));
-  b_typeError = Object(new NativeErrorImp(globExec,funcProto,b_typeErrorPrototype));
-  b_uriError = Object(new NativeErrorImp(globExec,funcProto,b_uriErrorPrototype));
+
+  m_pendingBuiltins = (1 << NumLazyBuiltins) - 1;
 
   // ECMA 15.3.4.1
   funcProto->put(globExec,"constructor", b_Function, DontEnum);
 
+  // Like the functions that lookupOrCreateFunction() puts on the prototypes
+  // on first use, the other constructors are put on the global object when
+  // they are first read. Until then their properties hold the number of the
+  // group that has to be created, see createLazyGlobalProperty().
   global.put(globExec,"Object", b_Object, DontEnum);
   global.put(globExec,"Function", b_Function, DontEnum);
-  global.put(globExec,"Array", b_Array, DontEnum);
-  global.put(globExec,"Boolean", b_Boolean, DontEnum);
-  global.put(globExec,"String", b_String, DontEnum);
-  global.put(globExec,"Number", b_Number, DontEnum);
-  global.put(globExec,"Date", b_Date, DontEnum);
-  global.put(globExec,"RegExp", b_RegExp, DontEnum);
-  global.put(globExec,"Error", b_Error, DontEnum);
+  global.put(globExec,"Array", Number(ArrayBuiltins), DontEnum | LazyBuiltin);
+  global.put(globExec,"Boolean", Number(BooleanBuiltins), DontEnum | LazyBuiltin);
+  global.put(globExec,"String", Number(StringBuiltins), DontEnum | LazyBuiltin);
+  global.put(globExec,"Number", Number(NumberBuiltins), DontEnum | LazyBuiltin);
+  global.put(globExec,"Date", Number(DateBuiltins), DontEnum | LazyBuiltin);
+  global.put(globExec,"RegExp", Number(RegExpBuiltins), DontEnum | LazyBuiltin);
+  global.put(globExec,"Error", Number(ErrorBuiltins), DontEnum | LazyBuiltin);
   // Using Internal for those to have something != 0
   // (see kjs_window). Maybe DontEnum would be ok too ?
-  global.put(globExec,"EvalError",b_evalError, Internal);
-  global.put(globExec,"RangeError",b_rangeError, Internal);
-  global.put(globExec,"ReferenceError",b_referenceError, Internal);
-  global.put(globExec,"SyntaxError",b_syntaxError, Internal);
-  global.put(globExec,"TypeError",b_typeError, Internal);
-  global.put(globExec,"URIError",b_uriError, Internal);
+  global.put(globExec,"EvalError", Number(EvalErrorBuiltins), Internal | LazyBuiltin);
+  global.put(globExec,"RangeError", Number(RangeErrorBuiltins), Internal | LazyBuiltin);
+  global.put(globExec,"ReferenceError", Number(ReferenceErrorBuiltins), Internal | LazyBuiltin);
+  global.put(globExec,"SyntaxError", Number(SyntaxErrorBuiltins), Internal | LazyBuiltin);
+  global.put(globExec,"TypeError", Number(TypeErrorBuiltins), Internal | LazyBuiltin);
+  global.put(globExec,"URIError", Number(URIErrorBuiltins), Internal | LazyBuiltin);
 
   // Set the "constructor" property of all builtin constructors
   objProto->put(globExec, "constructor", b_Object, DontEnum | DontDelete | ReadOnly);
   funcProto->put(globExec, "constructor", b_Function, DontEnum | DontDelete | ReadOnly);
-  arrayProto->put(globExec, "constructor", b_Array, DontEnum | DontDelete | ReadOnly);
-  booleanProto->put(globExec, "constructor", b_Boolean, DontEnum | DontDelete | ReadOnly);
-  stringProto->put(globExec, "constructor", b_String, DontEnum | DontDelete | ReadOnly);
-  numberProto->put(globExec, "constructor", b_Number, DontEnum | DontDelete | ReadOnly);
-  dateProto->put(globExec, "constructor", b_Date, DontEnum | DontDelete | ReadOnly);
-  regexpProto->put(globExec, "constructor", b_RegExp, DontEnum | DontDelete | ReadOnly);
-  errorProto->put(globExec, "constructor", b_Error, DontEnum | DontDelete | ReadOnly);
-  b_evalErrorPrototype.put(globExec, "constructor", b_evalError, DontEnum | DontDelete | ReadOnly);
-  b_rangeErrorPrototype.put(globExec, "constructor", b_rangeError, DontEnum | DontDelete | ReadOnly);
-  b_referenceErrorPrototype.put(globExec, "constructor", b_referenceError, DontEnum | DontDelete | ReadOnly);
-  b_syntaxErrorPrototype.put(globExec, "constructor", b_syntaxError, DontEnum | DontDelete | ReadOnly);
-  b_typeErrorPrototype.put(globExec, "constructor", b_typeError, DontEnum | DontDelete | ReadOnly);
-  b_uriErrorPrototype.put(globExec, "constructor", b_uriError, DontEnum | DontDelete | ReadOnly);
 
   // built-in values
   global.put(globExec, "NaN",        Number(NaN), DontEnum|DontDelete);
@@ -704,7 +887,251 @@ void InterpreterImp::unlock()
 #endif
 
   // built-in objects
-  global.put(globExec,"Math", Object(new MathObjectImp(globExec,objProto)), DontEnum);
+  global.put(globExec,"Math", Number(MathBuiltins), DontEnum | LazyBuiltin);
+}
+
+void InterpreterImp::createLazyBuiltins(LazyBuiltins group)
+{
+  m_pendingBuiltins &= ~(1 << group);
+
+  ObjectPrototypeImp *objProto = static_cast<ObjectPrototypeImp *>(b_ObjectPrototype.imp());
+  FunctionPrototypeImp *funcProto = static_cast<FunctionPrototypeImp *>(b_FunctionPrototype.imp());
+
+  switch (group) {
+  case ArrayBuiltins: {
+    ArrayPrototypeImp *arrayProto = new ArrayPrototypeImp(globExec,objProto);
+    b_ArrayPrototype = Object(arrayProto);
+    b_Array = Object(new ArrayObjectImp(globExec, funcProto, arrayProto));
+    arrayProto->put(globExec, "constructor", b_Array, DontEnum | DontDelete | ReadOnly);
+    break;
+  }
+  case BooleanBuiltins: {
+    BooleanPrototypeImp *booleanProto = new BooleanPrototypeImp(globExec,objProto,funcProto);
+    b_BooleanPrototype = Object(booleanProto);
+    b_Boolean = Object(new BooleanObjectImp(globExec, funcProto, booleanProto));
+    booleanProto->put(globExec, "constructor", b_Boolean, DontEnum | DontDelete | ReadOnly);
+    break;
+  }
+  case StringBuiltins: {
+    StringPrototypeImp *stringProto = new StringPrototypeImp(globExec,objProto);
+    b_StringPrototype = Object(stringProto);
+    b_String = Object(new StringObjectImp(globExec, funcProto, stringProto));
+    stringProto->put(globExec, "constructor", b_String, DontEnum | DontDelete | ReadOnly);
+    break;
+  }
+  case NumberBuiltins: {
+    NumberPrototypeImp *numberProto = new NumberPrototypeImp(globExec,objProto,funcProto);
+    b_NumberPrototype = Object(numberProto);
+    b_Number = Object(new NumberObjectImp(globExec, funcProto, numberProto));
+    numberProto->put(globExec, "constructor", b_Number, DontEnum | DontDelete | ReadOnly);
+    break;
+  }
+  case DateBuiltins: {
+    DatePrototypeImp *dateProto = new DatePrototypeImp(globExec,objProto);
+    b_DatePrototype = Object(dateProto);
+    b_Date = Object(new DateObjectImp(globExec, funcProto, dateProto));
+    dateProto->put(globExec, "constructor", b_Date, DontEnum | DontDelete | ReadOnly);
+    break;
+  }
+  case RegExpBuiltins: {
+    RegExpPrototypeImp *regexpProto = new RegExpPrototypeImp(globExec,objProto,funcProto);
+    b_RegExpPrototype = Object(regexpProto);
+    b_RegExp = Object(new RegExpObjectImp(globExec, funcProto, regexpProto));
+    regexpProto->put(globExec, "constructor", b_RegExp, DontEnum | DontDelete | ReadOnly);
+    break;
+  }
+  case ErrorBuiltins: {
+    ErrorPrototypeImp *errorProto = new ErrorPrototypeImp(globExec,objProto,funcProto);
+    b_ErrorPrototype = Object(errorProto);
+    b_Error = Object(new ErrorObjectImp(globExec, funcProto, errorProto));
+    errorProto->put(globExec, "constructor", b_Error, DontEnum | DontDelete | ReadOnly);
+    break;
+  }
+  case EvalErrorBuiltins:
+    createNativeErrorBuiltins(b_evalErrorPrototype, b_evalError, EvalError, "EvalError");
+    break;
+  case RangeErrorBuiltins:
+    createNativeErrorBuiltins(b_rangeErrorPrototype, b_rangeError, RangeError, "RangeError");
+    break;
+  case ReferenceErrorBuiltins:
+    createNativeErrorBuiltins(b_referenceErrorPrototype, b_referenceError, ReferenceError, "ReferenceError");
+    break;
+  case SyntaxErrorBuiltins:
+    createNativeErrorBuiltins(b_syntaxErrorPrototype, b_syntaxError, SyntaxError, "SyntaxError");
+    break;
+  case TypeErrorBuiltins:
+    createNativeErrorBuiltins(b_typeErrorPrototype, b_typeError, TypeError, "TypeError");
+    break;
+  case URIErrorBuiltins:
+    createNativeErrorBuiltins(b_uriErrorPrototype, b_uriError, URIError, "URIError");
+    break;
+  case MathBuiltins:
+  case NumLazyBuiltins:
+    // Math is not kept here, see createLazyGlobalProperty()
+    break;
+  }
+}
+
+void InterpreterImp::createNativeErrorBuiltins(ProtectedObject &prototype, ProtectedObject &constructor,
+                                               ErrorType type, const char *name)
+{
+  ErrorPrototypeImp *errorProto = static_cast<ErrorPrototypeImp *>(builtinErrorPrototype().imp());
+  FunctionPrototypeImp *funcProto = static_cast<FunctionPrototypeImp *>(b_FunctionPrototype.imp());
+
+  prototype = Object(new NativeErrorPrototypeImp(globExec,errorProto,type,name,name));
+  constructor = Object(new NativeErrorImp(globExec,funcProto,prototype));
+  prototype.put(globExec, "constructor", constructor, DontEnum | DontDelete | ReadOnly);
+}
+
+Value InterpreterImp::createLazyGlobalProperty(ObjectImp *glob, const Identifier &propertyName, ValueImp *placeholder)
+{
+  Object value;
+  switch (SimpleNumber::value(placeholder)) {
+  case ArrayBuiltins: value = builtinArray(); break;
+  case BooleanBuiltins: value = builtinBoolean(); break;
+  case StringBuiltins: value = builtinString(); break;
+  case NumberBuiltins: value = builtinNumber(); break;
+  case DateBuiltins: value = builtinDate(); break;
+  case RegExpBuiltins: value = builtinRegExp(); break;
+  case ErrorBuiltins: value = builtinError(); break;
+  case EvalErrorBuiltins: value = builtinEvalError(); break;
+  case RangeErrorBuiltins: value = builtinRangeError(); break;
+  case ReferenceErrorBuiltins: value = builtinReferenceError(); break;
+  case SyntaxErrorBuiltins: value = builtinSyntaxError(); break;
+  case TypeErrorBuiltins: value = builtinTypeError(); break;
+  case URIErrorBuiltins: value = builtinURIError(); break;
+  case MathBuiltins:
+    m_pendingBuiltins &= ~(1 << MathBuiltins);
+    value = Object(new MathObjectImp(globExec, static_cast<ObjectPrototypeImp *>(b_ObjectPrototype.imp())));
+    break;
+  default:
+    assert(0);
+    return Undefined();
+  }
+
+  // keeps the attributes and the position of the placeholder
+  glob->putDirect(propertyName, value.imp());
+  return value;
+}
+
+void InterpreterImp::takeBuiltinsSnapshot()
+{
+  ObjectImp *glob = static_cast<ObjectImp*>(global.imp());
+  ObjectImp *globalProperties = new ObjectImp();
+
+  BuiltinsSnapshot *snapshot = new BuiltinsSnapshot;
+  snapshot->global = Object(globalProperties);
+  snapshot->undefined = Value(UndefinedImp::staticUndefined);
+  snapshot->null = Value(NullImp::staticNull);
+  snapshot->trueValue = Value(BooleanImp::staticTrue);
+  snapshot->falseValue = Value(BooleanImp::staticFalse);
+  snapshot->nan = Value(NumberImp::staticNaN);
+
+  ObjectCloner cloner;
+  cloner.map(glob, globalProperties);
+
+  SavedBuiltins current;
+  saveBuiltins(current);
+  cloneBuiltins(*current._internal, snapshot->builtins, cloner);
+  globalProperties->cloneProperties(glob, cloner);
+  globalProperties->setPrototype(Value(cloner.clone(glob->prototype().imp())));
+
+  if (!cloner.finish()) {
+    delete snapshot;
+    builtinsSnapshotFailed = true;
+    return;
+  }
+  builtinsSnapshot = snapshot;
+}
+
+bool InterpreterImp::copyBuiltinsSnapshot()
+{
+  BuiltinsSnapshot *snapshot = builtinsSnapshot;
+  ObjectImp *glob = static_cast<ObjectImp*>(global.imp());
+  ObjectImp *globalProperties = static_cast<ObjectImp*>(snapshot->global.imp());
+
+  ObjectCloner cloner;
+  cloner.map(globalProperties, glob);
+  cloner.map(snapshot->undefined.imp(), UndefinedImp::staticUndefined);
+  cloner.map(snapshot->null.imp(), NullImp::staticNull);
+  cloner.map(snapshot->trueValue.imp(), BooleanImp::staticTrue);
+  cloner.map(snapshot->falseValue.imp(), BooleanImp::staticFalse);
+  cloner.map(snapshot->nan.imp(), NumberImp::staticNaN);
+
+  SavedBuiltins copy;
+  copy._internal = new SavedBuiltinsInternal;
+  cloneBuiltins(snapshot->builtins, *copy._internal, cloner);
+  glob->cloneProperties(globalProperties, cloner);
+  glob->setPrototype(Value(cloner.clone(globalProperties->prototype().imp())));
+
+  if (!cloner.finish()) {
+    // leaves whatever was copied onto the global object to be overwritten
+    // by createBuiltins()
+    clearBuiltinsSnapshot();
+    builtinsSnapshotFailed = true;
+    return false;
+  }
+  restoreBuiltins(copy);
+  return true;
+}
+
+void InterpreterImp::cloneBuiltins(const SavedBuiltinsInternal &from, SavedBuiltinsInternal &to, ObjectCloner &cloner)
+{
+  to.b_Object = Object(cloner.clone(from.b_Object.imp()));
+  to.b_Function = Object(cloner.clone(from.b_Function.imp()));
+  to.b_Array = Object(cloner.clone(from.b_Array.imp()));
+  to.b_Boolean = Object(cloner.clone(from.b_Boolean.imp()));
+  to.b_String = Object(cloner.clone(from.b_String.imp()));
+  to.b_Number = Object(cloner.clone(from.b_Number.imp()));
+  to.b_Date = Object(cloner.clone(from.b_Date.imp()));
+  to.b_RegExp = Object(cloner.clone(from.b_RegExp.imp()));
+  to.b_Error = Object(cloner.clone(from.b_Error.imp()));
+
+  to.b_ObjectPrototype = Object(cloner.clone(from.b_ObjectPrototype.imp()));
+  to.b_FunctionPrototype = Object(cloner.clone(from.b_FunctionPrototype.imp()));
+  to.b_ArrayPrototype = Object(cloner.clone(from.b_ArrayPrototype.imp()));
+  to.b_BooleanPrototype = Object(cloner.clone(from.b_BooleanPrototype.imp()));
+  to.b_StringPrototype = Object(cloner.clone(from.b_StringPrototype.imp()));
+  to.b_NumberPrototype = Object(cloner.clone(from.b_NumberPrototype.imp()));
+  to.b_DatePrototype = Object(cloner.clone(from.b_DatePrototype.imp()));
+  to.b_RegExpPrototype = Object(cloner.clone(from.b_RegExpPrototype.imp()));
+  to.b_ErrorPrototype = Object(cloner.clone(from.b_ErrorPrototype.imp()));
+
+  to.b_evalError = Object(cloner.clone(from.b_evalError.imp()));
+  to.b_rangeError = Object(cloner.clone(from.b_rangeError.imp()));
+  to.b_referenceError = Object(cloner.clone(from.b_referenceError.imp()));
+  to.b_syntaxError = Object(cloner.clone(from.b_syntaxError.imp()));
+  to.b_typeError = Object(cloner.clone(from.b_typeError.imp()));
+  to.b_uriError = Object(cloner.clone(from.b_uriError.imp()));
+
+  to.b_evalErrorPrototype = Object(cloner.clone(from.b_evalErrorPrototype.imp()));
+  to.b_rangeErrorPrototype = Object(cloner.clone(from.b_rangeErrorPrototype.imp()));
+  to.b_referenceErrorPrototype = Object(cloner.clone(from.b_referenceErrorPrototype.imp()));
+  to.b_syntaxErrorPrototype = Object(cloner.clone(from.b_syntaxErrorPrototype.imp()));
+  to.b_typeErrorPrototype = Object(cloner.clone(from.b_typeErrorPrototype.imp()));
+  to.b_uriErrorPrototype = Object(cloner.clone(from.b_uriErrorPrototype.imp()));
+
+  to.pendingBuiltins = from.pendingBuiltins;
+}
+
+void InterpreterImp::setUsesBuiltinsSnapshot(bool use)
+{
+  builtinsSnapshotEnabled = use;
+  if (!use)
+    clearBuiltinsSnapshot();
+}
+
+bool InterpreterImp::usesBuiltinsSnapshot()
+{
+  return builtinsSnapshotEnabled;
+}
+
+void InterpreterImp::clearBuiltinsSnapshot()
+{
+  lockInterpreter();
+  delete builtinsSnapshot;
+  builtinsSnapshot = 0;
+  unlockInterpreter();
 }
 
 InterpreterImp::~InterpreterImp()
@@ -723,6 +1150,11 @@ void InterpreterImp::clear()
 #if APPLE_CHANGES
   lockInterpreter();
 #endif
+  delete m_evalCodeCache;
+  m_evalCodeCache = 0;
+  delete m_functionCodeCache;
+  m_functionCodeCache = 0;
+
   next->prev = prev;
   prev->next = next;
   s_hook = next;
@@ -739,6 +1171,12 @@ void InterpreterImp::clear()
 #endif
 }
 
+ProgramCache *InterpreterImp::codeCache(CodeType type) const
+{
+  assert(type == EvalCode || type == FunctionCode);
+  return type == EvalCode ? m_evalCodeCache : m_functionCodeCache;
+}
+
 void InterpreterImp::mark()
 {
   //if (exVal && !exVal->marked())
@@ -763,24 +1201,67 @@ void InterpreterImp::mark()
 bool InterpreterImp::checkSyntax(const UString &code)
 {
   // Parser::parse() returns 0 in a syntax error occurs, so we just check for that
-  ProgramNode *progNode = Parser::parse(UString(), 0, code.data(),code.size(),0,0,0);
+  SourceProvider *source = SourceProvider::create(code);
+  ProgramNode *progNode = Parser::parse(UString(), 0, source, 0, 0, 0);
+  source->deref();
   bool ok = (progNode != 0);
   if (progNode) {
     // must ref and deref to clean up properly
     progNode->ref();
     progNode->deref();
-    delete progNode;
   }
   return ok;
 }
 
 Completion InterpreterImp::evaluate(const UString &code, const Value &thisV, const UString &sourceURL, int startingLineNumber)
+{
+  SourceProvider *source = SourceProvider::create(code);
+  Completion res = evaluate(source, thisV, sourceURL, startingLineNumber);
+  source->deref();
+  return res;
+}
+
+Completion InterpreterImp::evaluate(const char *code, unsigned int length, TextEncoding encoding, const Value &thisV,
+                                    const UString &sourceURL, int startingLineNumber)
+{
+  // the functions of the program may outlive the caller's buffer
+  SourceProvider *source = SourceProvider::create(code, length, encoding);
+  Completion res = evaluate(source, thisV, sourceURL, startingLineNumber);
+  source->deref();
+  return res;
+}
+
+Completion InterpreterImp::evaluate(SourceProvider *source, const Value &thisV, const UString &sourceURL, int startingLineNumber)
+{
+  // parse the source code
+  int sid;
+  int errLine;
+  UString errMsg;
+  // the debugger wants to see every source being parsed, so bypass the cache
+  ProgramNode *progNode;
+  if (dbg)
+    progNode = Parser::parse(sourceURL, startingLineNumber, source, &sid, &errLine, &errMsg);
+  else
+    progNode = ProgramCache::shared()->parse(sourceURL, startingLineNumber, source, &sid, &errLine, &errMsg);
+
+  return evaluate(progNode, sid, errLine, errMsg, source, thisV, sourceURL);
+}
+
+Completion InterpreterImp::evaluate(ProgramNode *progNode, int sid, int errLine, const UString &errMsg,
+                                    SourceProvider *source, const Value &thisV, const UString &sourceURL)
 {
 #if APPLE_CHANGES
   lockInterpreter();
 #endif
+  // a tree fresh from the parser has no references yet, and is freed by
+  // the deref() on the way out
+  if (progNode)
+    progNode->ref();
+
   // prevent against infinite recursion
   if (recursion >= 20) {
+    if (progNode)
+      progNode->deref();
 #if APPLE_CHANGES
     Completion result = Completion(Throw,Error::create(globExec,GeneralError,"Recursion too deep"));
     unlockInterpreter();
@@ -789,25 +1270,18 @@ Completion InterpreterImp::evaluate(const UString &code, const Value &thisV, con
     return Completion(Throw,Error::create(globExec,GeneralError,"Recursion too deep"));
 #endif
   }
-  
-  // parse the source code
-  int sid;
-  int errLine;
-  UString errMsg;
-  ProgramNode *progNode = Parser::parse(sourceURL, startingLineNumber, code.data(),code.size(),&sid,&errLine,&errMsg);
 
   // notify debugger that source has been parsed
   if (dbg) {
-    bool cont = dbg->sourceParsed(globExec,sid,code,errLine);
-    if (!cont)
+    bool cont = dbg->sourceParsed(globExec,sid,source->toUString(),errLine);
+    if (!cont) {
+      if (progNode)
+        progNode->deref();
 #if APPLE_CHANGES
-      {
-	unlockInterpreter();
-	return Completion(Break);
-      }
-#else
-      return Completion(Break);
+      unlockInterpreter();
 #endif
+      return Completion(Break);
+    }
   }
   
   // no program node means a syntax error occurred
@@ -823,7 +1297,6 @@ Completion InterpreterImp::evaluate(const UString &code, const Value &thisV, con
   globExec->clearException();
 
   recursion++;
-  progNode->ref();
 
   Object &globalObj = globalObject();
   Object thisObj = globalObject();
@@ -850,8 +1323,7 @@ Completion InterpreterImp::evaluate(const UString &code, const Value &thisV, con
     res = progNode->execute(&newExec);
   }
 
-  if (progNode->deref())
-    delete progNode;
+  progNode->deref();
   recursion--;
 
 #if APPLE_CHANGES
@@ -906,6 +1378,8 @@ void InterpreterImp::saveBuiltins (SavedBuiltins &builtins) const
   builtins._internal->b_syntaxErrorPrototype = b_syntaxErrorPrototype;
   builtins._internal->b_typeErrorPrototype = b_typeErrorPrototype;
   builtins._internal->b_uriErrorPrototype = b_uriErrorPrototype;
+
+  builtins._internal->pendingBuiltins = m_pendingBuiltins;
 }
 
 void InterpreterImp::restoreBuiltins (const SavedBuiltins &builtins)
@@ -947,6 +1421,8 @@ void InterpreterImp::restoreBuiltins (const SavedBuiltins &builtins)
   b_syntaxErrorPrototype = builtins._internal->b_syntaxErrorPrototype;
   b_typeErrorPrototype = builtins._internal->b_typeErrorPrototype;
   b_uriErrorPrototype = builtins._internal->b_uriErrorPrototype;
+
+  m_pendingBuiltins = builtins._internal->pendingBuiltins;
 }
 
 InterpreterImp *InterpreterImp::interpreterWithGlobalObject(ObjectImp *global)
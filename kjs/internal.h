@@ -41,9 +41,13 @@ namespace KJS {
 
   class ProgramNode;
   class FunctionBodyNode;
+  class NodeArena;
+  struct LazyFunctionBody;
   class FunctionPrototypeImp;
   class FunctionImp;
   class Debugger;
+  class ObjectCloner;
+  class SourceProvider;
 
   // ---------------------------------------------------------------------------
   //                            Primitive impls
@@ -199,21 +203,99 @@ namespace KJS {
    * @internal
    *
    * Parses ECMAScript source code and converts into ProgramNode objects, which
-   * represent the root of a parse tree. This class provides a conveniant workaround
-   * for the problem of the bison parser working in a static context.
+   * represent the root of a parse tree. Every thread has a Parser of its own
+   * holding the state of the parse it runs, see @ref curr(), so scripts can be
+   * parsed on several threads at once.
    */
   class Parser {
   public:
     static ProgramNode *parse(const UString &sourceURL, int startingLineNumber,
                               const UChar *code, unsigned int length, int *sourceId = 0,
 			      int *errLine = 0, UString *errMsg = 0);
+    /**
+     * Parses Latin-1 or UTF-8 text as it is, without converting all of it
+     * to UTF-16 first.
+     */
+    static ProgramNode *parse(const UString &sourceURL, int startingLineNumber,
+                              const char *code, unsigned int length, TextEncoding encoding,
+                              int *sourceId = 0, int *errLine = 0, UString *errMsg = 0);
+    /**
+     * Parses the text of source. Lazily parsed function bodies and the text
+     * of the functions refer to source instead of copies of the text. The
+     * overloads above make a copy once it is needed.
+     */
+    static ProgramNode *parse(const UString &sourceURL, int startingLineNumber, SourceProvider *source,
+                              int *sourceId = 0, int *errLine = 0, UString *errMsg = 0);
+    /**
+     * Parses a function body that was only checked at first, see
+     * @ref lazyFunctionBody(). Returns a program holding its statements, or
+     * 0 on a parse error.
+     */
+    static ProgramNode *parseFunctionBody(const UString &sourceURL, const LazyFunctionBody &body);
 
-    static ProgramNode *progNode;
-    static int sid;
+    /**
+     * Returns the parser of the calling thread.
+     */
+    static Parser *curr();
+    /**
+     * Deletes the parser and the lexer of the calling thread. They hold on
+     * to strings, so a thread that parsed with the interpreter lock held
+     * should call this before giving the lock up for good.
+     */
+    static void deleteCurr();
+    /**
+     * Returns an id for a new source; may be called on any thread.
+     */
+    static int newSourceId();
+
+    // used by the DescentParser: the body of a function that is parsed
+    // when it is first called is found from offset start on, for length
+    // characters, in the code handed to the lexer; line is where it starts
+    FunctionBodyNode *lazyFunctionBody(int start, int length, int line, bool hasFunctionDeclarations);
+    // the function with body is found from offset start up to end
+    void setFunctionSource(FunctionBodyNode *body, int start, int end);
+
+    ProgramNode *progNode;
+    // id of the source being parsed, -1 outside of a parse
+    int sid;
+    // number of nodes created by the last parse
+    unsigned nodeCount;
+    // where the nodes being created are allocated, see Node::operator new
+    NodeArena *arena;
+    // whether bodies of functions are parsed when they are first called
+    static bool lazyFunctionBodies;
+    // whether parsed trees are simplified by the Optimizer before they
+    // are handed out
+    static bool optimizeTrees;
+
+  private:
+    Parser();
+
+    // hand the code to the lexer, for parseCode() to parse
+    void setCode(const UString &sourceURL, int startingLineNumber, const UChar *code, unsigned int length);
+    void setCode(const UString &sourceURL, int startingLineNumber, const char *code, unsigned int length,
+                 TextEncoding encoding);
+    ProgramNode *parseCode(int sourceId, int *errLine, UString *errMsg);
+
+    // the provider of the text being parsed, made from currentCode or
+    // currentCode8 by source() if the parse was not given one
+    SourceProvider *source();
+
+    const UChar *currentCode;
+    const char *currentCode8;
+    TextEncoding currentEncoding;
+    unsigned int currentLength;
+    // referenced until the parse is done
+    SourceProvider *currentProvider;
+    // where the text handed to the lexer starts in the provider
+    int currentOffset;
   };
 
   class SavedBuiltinsInternal {
     friend class InterpreterImp;
+  public:
+    SavedBuiltinsInternal() : pendingBuiltins(0) { }
+
   private:
     ProtectedObject b_Object;
     ProtectedObject b_Function;
@@ -248,6 +330,8 @@ namespace KJS {
     ProtectedObject b_syntaxErrorPrototype;
     ProtectedObject b_typeErrorPrototype;
     ProtectedObject b_uriErrorPrototype;
+
+    int pendingBuiltins;
   };
 
   class InterpreterImp {
@@ -266,52 +350,94 @@ namespace KJS {
     static void lock();
     static void unlock();
     static int lockCount();
+    // Releases the lock completely if the calling thread holds it, so that
+    // it can wait for another thread that needs it. Returns what to pass to
+    // restoreLock() afterwards.
+    static int dropLock();
+    static void restoreLock(int depth);
+
+    static void setUsesBuiltinsSnapshot(bool);
+    static bool usesBuiltinsSnapshot();
+    static void clearBuiltinsSnapshot();
 
     void mark();
 
     ExecState *globalExec() { return globExec; }
     bool checkSyntax(const UString &code);
     Completion evaluate(const UString &code, const Value &thisV, const UString &sourceURL, int startingLineNumber);
+    Completion evaluate(const char *code, unsigned int length, TextEncoding encoding, const Value &thisV,
+                        const UString &sourceURL, int startingLineNumber);
+    Completion evaluate(SourceProvider *source, const Value &thisV, const UString &sourceURL, int startingLineNumber);
+    // runs a program that has already been parsed; progNode is 0 after a syntax error
+    Completion evaluate(ProgramNode *progNode, int sid, int errLine, const UString &errMsg,
+                        SourceProvider *source, const Value &thisV, const UString &sourceURL);
     Debugger *debugger() const { return dbg; }
     void setDebugger(Debugger *d);
 
+    /**
+     * Groups of built-in objects that are only created when first used,
+     * either through one of the builtin accessors or by a script reading the
+     * global property that holds the constructor.
+     */
+    enum LazyBuiltins { ArrayBuiltins, BooleanBuiltins, StringBuiltins, NumberBuiltins,
+                        DateBuiltins, RegExpBuiltins, ErrorBuiltins,
+                        EvalErrorBuiltins, RangeErrorBuiltins, ReferenceErrorBuiltins,
+                        SyntaxErrorBuiltins, TypeErrorBuiltins, URIErrorBuiltins,
+                        MathBuiltins, NumLazyBuiltins };
+
     Object builtinObject() const { return b_Object; }
     Object builtinFunction() const { return b_Function; }
-    Object builtinArray() const { return b_Array; }
-    Object builtinBoolean() const { return b_Boolean; }
-    Object builtinString() const { return b_String; }
-    Object builtinNumber() const { return b_Number; }
-    Object builtinDate() const { return b_Date; }
-    Object builtinRegExp() const { return b_RegExp; }
-    Object builtinError() const { return b_Error; }
+    Object builtinArray() const { needBuiltins(ArrayBuiltins); return b_Array; }
+    Object builtinBoolean() const { needBuiltins(BooleanBuiltins); return b_Boolean; }
+    Object builtinString() const { needBuiltins(StringBuiltins); return b_String; }
+    Object builtinNumber() const { needBuiltins(NumberBuiltins); return b_Number; }
+    Object builtinDate() const { needBuiltins(DateBuiltins); return b_Date; }
+    Object builtinRegExp() const { needBuiltins(RegExpBuiltins); return b_RegExp; }
+    Object builtinError() const { needBuiltins(ErrorBuiltins); return b_Error; }
 
     Object builtinObjectPrototype() const { return b_ObjectPrototype; }
     Object builtinFunctionPrototype() const { return b_FunctionPrototype; }
-    Object builtinArrayPrototype() const { return b_ArrayPrototype; }
-    Object builtinBooleanPrototype() const { return b_BooleanPrototype; }
-    Object builtinStringPrototype() const { return b_StringPrototype; }
-    Object builtinNumberPrototype() const { return b_NumberPrototype; }
-    Object builtinDatePrototype() const { return b_DatePrototype; }
-    Object builtinRegExpPrototype() const { return b_RegExpPrototype; }
-    Object builtinErrorPrototype() const { return b_ErrorPrototype; }
-
-    Object builtinEvalError() const { return b_evalError; }
-    Object builtinRangeError() const { return b_rangeError; }
-    Object builtinReferenceError() const { return b_referenceError; }
-    Object builtinSyntaxError() const { return b_syntaxError; }
-    Object builtinTypeError() const { return b_typeError; }
-    Object builtinURIError() const { return b_uriError; }
-
-    Object builtinEvalErrorPrototype() const { return b_evalErrorPrototype; }
-    Object builtinRangeErrorPrototype() const { return b_rangeErrorPrototype; }
-    Object builtinReferenceErrorPrototype() const { return b_referenceErrorPrototype; }
-    Object builtinSyntaxErrorPrototype() const { return b_syntaxErrorPrototype; }
-    Object builtinTypeErrorPrototype() const { return b_typeErrorPrototype; }
-    Object builtinURIErrorPrototype() const { return b_uriErrorPrototype; }
+    Object builtinArrayPrototype() const { needBuiltins(ArrayBuiltins); return b_ArrayPrototype; }
+    Object builtinBooleanPrototype() const { needBuiltins(BooleanBuiltins); return b_BooleanPrototype; }
+    Object builtinStringPrototype() const { needBuiltins(StringBuiltins); return b_StringPrototype; }
+    Object builtinNumberPrototype() const { needBuiltins(NumberBuiltins); return b_NumberPrototype; }
+    Object builtinDatePrototype() const { needBuiltins(DateBuiltins); return b_DatePrototype; }
+    Object builtinRegExpPrototype() const { needBuiltins(RegExpBuiltins); return b_RegExpPrototype; }
+    Object builtinErrorPrototype() const { needBuiltins(ErrorBuiltins); return b_ErrorPrototype; }
+
+    Object builtinEvalError() const { needBuiltins(EvalErrorBuiltins); return b_evalError; }
+    Object builtinRangeError() const { needBuiltins(RangeErrorBuiltins); return b_rangeError; }
+    Object builtinReferenceError() const { needBuiltins(ReferenceErrorBuiltins); return b_referenceError; }
+    Object builtinSyntaxError() const { needBuiltins(SyntaxErrorBuiltins); return b_syntaxError; }
+    Object builtinTypeError() const { needBuiltins(TypeErrorBuiltins); return b_typeError; }
+    Object builtinURIError() const { needBuiltins(URIErrorBuiltins); return b_uriError; }
+
+    Object builtinEvalErrorPrototype() const { needBuiltins(EvalErrorBuiltins); return b_evalErrorPrototype; }
+    Object builtinRangeErrorPrototype() const { needBuiltins(RangeErrorBuiltins); return b_rangeErrorPrototype; }
+    Object builtinReferenceErrorPrototype() const { needBuiltins(ReferenceErrorBuiltins); return b_referenceErrorPrototype; }
+    Object builtinSyntaxErrorPrototype() const { needBuiltins(SyntaxErrorBuiltins); return b_syntaxErrorPrototype; }
+    Object builtinTypeErrorPrototype() const { needBuiltins(TypeErrorBuiltins); return b_typeErrorPrototype; }
+    Object builtinURIErrorPrototype() const { needBuiltins(URIErrorBuiltins); return b_uriErrorPrototype; }
+
+    // Does not create the Date prototype; no object can have it as its
+    // prototype before it exists.
+    bool isBuiltinDatePrototype(const ValueImp *v) const { return v == b_DatePrototype.imp(); }
+
+    /**
+     * Replaces a placeholder that @ref initGlobalObject() put on the global
+     * object with the built-in object it stands for, creating that first if
+     * needed. Called by @ref ObjectImp::get().
+     */
+    Value createLazyGlobalProperty(ObjectImp *glob, const Identifier &propertyName, ValueImp *placeholder);
 
     void setCompatMode(Interpreter::CompatMode mode) { m_compatMode = mode; }
     Interpreter::CompatMode compatMode() const { return m_compatMode; }
 
+    // Trees parsed from strings at runtime. eval() code runs in the calling
+    // context while Function constructor code becomes a function body, so the
+    // two are kept apart.
+    ProgramCache *codeCache(CodeType type) const;
+
     // Chained list of interpreters (ring)
     static InterpreterImp* firstInterpreter() { return s_hook; }
     InterpreterImp *nextInterpreter() const { return next; }
@@ -326,6 +452,16 @@ namespace KJS {
 
   private:
     void clear();
+    void createBuiltins();
+    void needBuiltins(LazyBuiltins group) const
+      { if (m_pendingBuiltins & (1 << group)) const_cast<InterpreterImp *>(this)->createLazyBuiltins(group); }
+    void createLazyBuiltins(LazyBuiltins group);
+    void createNativeErrorBuiltins(ProtectedObject &prototype, ProtectedObject &constructor,
+                                   ErrorType type, const char *name);
+    void takeBuiltinsSnapshot();
+    bool copyBuiltinsSnapshot();
+    static void cloneBuiltins(const SavedBuiltinsInternal &from, SavedBuiltinsInternal &to, ObjectCloner &cloner);
+
     Interpreter *m_interpreter;
     ProtectedObject global;
     Debugger *dbg;
@@ -368,9 +504,15 @@ namespace KJS {
     ProtectedObject b_typeErrorPrototype;
     ProtectedObject b_uriErrorPrototype;
 
+    // bit set of the LazyBuiltins groups that have not been created yet
+    int m_pendingBuiltins;
+
     ExecState *globExec;
     Interpreter::CompatMode m_compatMode;
 
+    ProgramCache *m_evalCodeCache;
+    ProgramCache *m_functionCodeCache;
+
     // Chained list of interpreters (ring) - for collector
     static InterpreterImp* s_hook;
     InterpreterImp *next, *prev;
@@ -37,6 +37,7 @@
 #include "error_object.h"
 #include "nodes.h"
 #include "context.h"
+#include "parsed_program.h"
 
 using namespace KJS;
 
@@ -120,22 +121,50 @@ Completion Interpreter::evaluate(const UString &code, const Value &thisV, const
   return evaluate(UString(), 0, code, thisV);
 }
 
-Completion Interpreter::evaluate(const UString &sourceURL, int startingLineNumber, const UString &code, const Value &thisV)
+static void printException(InterpreterImp *rep, const UString &sourceURL, const Completion &comp)
 {
-  Completion comp = rep->evaluate(code,thisV, sourceURL, startingLineNumber);
-
 #if APPLE_CHANGES
-  if (shouldPrintExceptions() && comp.complType() == Throw) {
-    lock();
+  if (Interpreter::shouldPrintExceptions() && comp.complType() == Throw) {
+    Interpreter::lock();
     ExecState *exec = rep->globalExec();
     char *f = strdup(sourceURL.ascii());
     const char *message = comp.value().toObject(exec).toString(exec).ascii();
     printf("%s:%s\n", f, message);
     free(f);
-    unlock();
+    Interpreter::unlock();
   }
 #endif
+}
+
+Completion Interpreter::evaluate(const UString &sourceURL, int startingLineNumber, const UString &code, const Value &thisV)
+{
+  Completion comp = rep->evaluate(code,thisV, sourceURL, startingLineNumber);
+  printException(rep, sourceURL, comp);
+  return comp;
+}
 
+Completion Interpreter::evaluate(const UString &sourceURL, int startingLineNumber, const char *code, unsigned int length,
+                                 TextEncoding encoding, const Value &thisV)
+{
+  Completion comp = rep->evaluate(code, length, encoding, thisV, sourceURL, startingLineNumber);
+  printException(rep, sourceURL, comp);
+  return comp;
+}
+
+Completion Interpreter::evaluate(const UString &sourceURL, int startingLineNumber, SourceProvider *source,
+                                 const Value &thisV)
+{
+  Completion comp = rep->evaluate(source, thisV, sourceURL, startingLineNumber);
+  printException(rep, sourceURL, comp);
+  return comp;
+}
+
+Completion Interpreter::evaluate(const ParsedProgram &program, const Value &thisV)
+{
+  UString sourceURL = program.sourceURL();
+  Completion comp = rep->evaluate(program.programNode(), program.sourceId(), program.errorLine(),
+                                  program.errorMessage(), program.source(), thisV, sourceURL);
+  printException(rep, sourceURL, comp);
   return comp;
 }
 
@@ -304,17 +333,30 @@ Interpreter::CompatMode Interpreter::compatMode() const
   return rep->compatMode();
 }
 
+ProgramCache *Interpreter::evalCodeCache() const
+{
+  return rep->codeCache(EvalCode);
+}
+
+ProgramCache *Interpreter::functionCodeCache() const
+{
+  return rep->codeCache(FunctionCode);
+}
+
 #ifdef KJS_DEBUG_MEM
 #include "lexer.h"
+#include "program_cache.h"
 void Interpreter::finalCheck()
 {
   fprintf(stderr,"Interpreter::finalCheck()\n");
+  InterpreterImp::clearBuiltinsSnapshot();
   // Garbage collect - as many times as necessary
   // (we could delete an object which was holding another object, so
   // the deref() will happen too late for deleting the impl of the 2nd object).
   while( Collector::collect() )
     ;
 
+  ProgramCache::shared()->clear();
   Node::finalCheck();
   Collector::finalCheck();
   Lexer::globalClear();
@@ -346,6 +388,31 @@ void Interpreter::restoreBuiltins (const SavedBuiltins &builtins)
   rep->restoreBuiltins(builtins);
 }
 
+void Interpreter::setUsesBuiltinsSnapshot(bool use)
+{
+  InterpreterImp::setUsesBuiltinsSnapshot(use);
+}
+
+bool Interpreter::usesBuiltinsSnapshot()
+{
+  return InterpreterImp::usesBuiltinsSnapshot();
+}
+
+void Interpreter::setParsesFunctionBodiesLazily(bool lazily)
+{
+  Parser::lazyFunctionBodies = lazily;
+}
+
+bool Interpreter::parsesFunctionBodiesLazily()
+{
+  return Parser::lazyFunctionBodies;
+}
+
+void Interpreter::discardUnusedFunctionBodies()
+{
+  FunctionBodyNode::discardUnusedBodies();
+}
+
 SavedBuiltins::SavedBuiltins() : 
   _internal(0)
 {
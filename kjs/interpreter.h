@@ -34,6 +34,9 @@ namespace KJS {
 
   class ContextImp;
   class InterpreterImp;
+  class ProgramCache;
+  class ParsedProgram;
+  class SourceProvider;
 
   /**
    * Represents an execution context, as specified by section 10 of the ECMA
@@ -200,6 +203,34 @@ namespace KJS {
      */
     Completion evaluate(const UString &sourceURL, int startingLineNumber, const UString &code, const Value &thisV = Value());
 
+    /**
+     * Evaluates code given as Latin-1 or UTF-8 text of length bytes, such as
+     * the contents of a file mapped into memory. The lexer reads the bytes
+     * directly, so the script is never converted to UTF-16 as a whole; only
+     * names and string literals are. The functions of the script may
+     * outlive the call, so the code is copied; use a @ref SourceProvider to
+     * avoid that. Otherwise the same as the evaluate() above.
+     */
+    Completion evaluate(const UString &sourceURL, int startingLineNumber, const char *code, unsigned int length,
+                        TextEncoding encoding, const Value &thisV = Value());
+
+    /**
+     * Evaluates the text of source, which may be a file mapped into memory
+     * or a buffer of the caller. The program and its functions keep
+     * references to source instead of copies of the text, so a script run
+     * by many interpreters is in memory only once. Otherwise the same as
+     * the evaluate() above.
+     */
+    Completion evaluate(const UString &sourceURL, int startingLineNumber, SourceProvider *source,
+                        const Value &thisV = Value());
+
+    /**
+     * Runs a program that was parsed ahead of time, maybe on another thread.
+     * Waits for the parse to finish first if necessary. Otherwise the same
+     * as the evaluate() above.
+     */
+    Completion evaluate(const ParsedProgram &program, const Value &thisV = Value());
+
 	// Overload of evaluate to keep JavaScriptGlue both source and binary compatible.
 	Completion evaluate(const UString &code, const Value &thisV = Value(), const UString &sourceFilename = UString());
 
@@ -333,6 +364,17 @@ namespace KJS {
     void setCompatMode(CompatMode mode);
     CompatMode compatMode() const;
 
+    /**
+     * Returns the cache of code parsed by eval() in this interpreter. Use it to
+     * adjust the size limit or to read the hit statistics.
+     */
+    ProgramCache *evalCodeCache() const;
+    /**
+     * Returns the cache of function bodies parsed by the Function constructor
+     * in this interpreter.
+     */
+    ProgramCache *functionCodeCache() const;
+
     /**
      * Called by InterpreterImp during the mark phase of the garbage collector
      * Default implementation does nothing, this exist for classes that reimplement Interpreter.
@@ -361,6 +403,38 @@ namespace KJS {
 
     void saveBuiltins (SavedBuiltins &) const;
     void restoreBuiltins (const SavedBuiltins &);
+
+    /**
+     * Controls how the built-in objects of new interpreters are set up. When
+     * enabled, which is the default, the first interpreter created keeps a
+     * private copy of its freshly created built-ins, and later interpreters
+     * get copies of that instead of running all the constructors again. The
+     * copies are complete and independent; a script changing String.prototype
+     * in one interpreter does not affect any other. Disabling it also frees
+     * the copy.
+     */
+    static void setUsesBuiltinsSnapshot(bool);
+    static bool usesBuiltinsSnapshot();
+
+    /**
+     * Controls whether the bodies of functions are parsed when the function
+     * is first called. When enabled, which is the default, the parser only
+     * checks the syntax of a function body and remembers where it is, and
+     * the tree is built on the first call. Syntax errors are still reported
+     * when the script is parsed. Functions written right after an opening
+     * parenthesis, which are usually called at once, are always parsed in
+     * full.
+     */
+    static void setParsesFunctionBodiesLazily(bool);
+    static bool parsesFunctionBodiesLazily();
+
+    /**
+     * Frees the trees of lazily parsed function bodies that have not been
+     * called since the previous call of this function. A function whose tree
+     * was freed is parsed again when it is called. Meant to be called
+     * periodically, or when memory is low.
+     */
+    static void discardUnusedFunctionBodies();
     
   private:
     InterpreterImp *rep;
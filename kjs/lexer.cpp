@@ -29,6 +29,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
 
 #include "value.h"
 #include "object.h"
@@ -36,34 +37,41 @@
 #include "interpreter.h"
 #include "nodes.h"
 #include "lexer.h"
+#include "character_scanner.h"
 #include "identifier.h"
+#include "number_format.h"
 #include "lookup.h"
 #include "internal.h"
 
-// we can't specify the namespace in yacc's C output, so do it here
 using namespace KJS;
 
-static Lexer *currLexer = 0;
-
-#ifndef KDE_USE_FINAL
-#include "grammar.h"
-#endif
-
+#include "tokens.h"
 #include "lexer.lut.h"
 
-extern YYLTYPE kjsyylloc; // global bison variable holding token info
+// every thread has a lexer of its own, so that scripts can be parsed on
+// several threads at once
+static pthread_once_t lexerKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t lexerKey;
 
-// a bridge for yacc from the C world to C++
-int kjsyylex()
+// see deleteParser()
+static void deleteLexer(void *lexer)
 {
-  return Lexer::curr()->lex();
+  Interpreter::lock();
+  delete static_cast<Lexer *>(lexer);
+  Interpreter::unlock();
+}
+
+static void createLexerKey()
+{
+  pthread_key_create(&lexerKey, deleteLexer);
 }
 
 Lexer::Lexer()
-  : yylineno(1),
+  : preparsing(false), yylineno(1),
     size8(128), size16(128), restrKeyword(false),
-    eatNextIdentifier(false), stackToken(-1), lastToken(-1), pos(0),
-    code(0), length(0),
+    eatNextIdentifier(false), stackToken(-1), lastToken(-1),
+    pos(0), pos1(1), pos2(2), pos3(3), readPos(4),
+    code(0), code8(0), utf8(false), length(0),
 #ifndef KJS_PURE_ECMA
     bol(true),
 #endif
@@ -74,7 +82,6 @@ Lexer::Lexer()
   // allocate space for read buffers
   buffer8 = new char[size8];
   buffer16 = new UChar[size16];
-  currLexer = this;
 }
 
 Lexer::~Lexer()
@@ -86,22 +93,56 @@ Lexer::~Lexer()
 
 Lexer *Lexer::curr()
 {
-  if (!currLexer) {
-    // create singleton instance
-    currLexer = new Lexer();
+  pthread_once(&lexerKeyOnce, createLexerKey);
+  Lexer *lexer = static_cast<Lexer *>(pthread_getspecific(lexerKey));
+  if (!lexer) {
+    lexer = new Lexer();
+    pthread_setspecific(lexerKey, lexer);
   }
-  return currLexer;
+  return lexer;
+}
+
+void Lexer::deleteCurr()
+{
+  pthread_once(&lexerKeyOnce, createLexerKey);
+  if (void *lexer = pthread_getspecific(lexerKey))
+    deleteLexer(lexer);
+  pthread_setspecific(lexerKey, 0);
 }
 
 #ifdef KJS_DEBUG_MEM
 void Lexer::globalClear()
 {
-  delete currLexer;
-  currLexer = 0L;
+  deleteCurr();
 }
 #endif
 
 void Lexer::setCode(const UString &sourceURL, int startingLineNumber, const UChar *c, unsigned int len)
+{
+  reset(sourceURL, startingLineNumber);
+  code = c;
+  code8 = 0;
+  utf8 = false;
+  length = len;
+
+  // read first characters
+  jumpTo(0);
+}
+
+void Lexer::setCode(const UString &sourceURL, int startingLineNumber, const char *c, unsigned int len,
+                    TextEncoding encoding)
+{
+  reset(sourceURL, startingLineNumber);
+  code = 0;
+  code8 = c;
+  utf8 = encoding == UTF8Encoding;
+  length = len;
+
+  // read first characters
+  jumpTo(0);
+}
+
+void Lexer::reset(const UString &sourceURL, int startingLineNumber)
 {
   yylineno = 1 + startingLineNumber;
   m_sourceURL = sourceURL;
@@ -110,33 +151,79 @@ void Lexer::setCode(const UString &sourceURL, int startingLineNumber, const UCha
   eatNextIdentifier = false;
   stackToken = -1;
   lastToken = -1;
-  pos = 0;
-  code = c;
-  length = len;
+  preparsing = false;
   skipLF = false;
   skipCR = false;
 #ifndef KJS_PURE_ECMA
   bol = true;
 #endif
+}
 
-  // read first characters
-  current = (length > 0) ? code[0].uc : 0;
-  next1 = (length > 1) ? code[1].uc : 0;
-  next2 = (length > 2) ? code[2].uc : 0;
-  next3 = (length > 3) ? code[3].uc : 0;
+inline unsigned short Lexer::read()
+{
+  unsigned int p = readPos++;
+  if (p >= length)
+    return 0;
+  if (code)
+    return code[p].uc;
+  unsigned char c = code8[p];
+  if (c < 0x80 || !utf8)
+    return c;
+  return readUTF8(p);
+}
+
+// Characters outside the Basic Multilingual Plane take four bytes in UTF-8
+// and two UTF-16 units. The second unit is said to be at the third byte, so
+// that every unit has an offset of its own.
+unsigned short Lexer::readUTF8(unsigned int p)
+{
+  int sequenceLength;
+  int c = decodeUTF8Sequence(code8 + p, length - p, sequenceLength);
+  if (c >= 0x10000) {
+    readPos = p + 2;
+    return 0xd800 | ((c - 0x10000) >> 10);
+  }
+  if (c >= 0) {
+    readPos = p + sequenceLength;
+    return c;
+  }
+  if (p >= 2) {
+    c = decodeUTF8Sequence(code8 + p - 2, length - p + 2, sequenceLength);
+    if (c >= 0x10000) {
+      readPos = p + 2;
+      return 0xdc00 | ((c - 0x10000) & 0x3ff);
+    }
+  }
+  return 0xfffd;
 }
 
 void Lexer::shift(unsigned int p)
 {
   while (p--) {
-    pos++;
+    pos = pos1;
+    pos1 = pos2;
+    pos2 = pos3;
+    pos3 = readPos;
     current = next1;
     next1 = next2;
     next2 = next3;
-    next3 = (pos + 3 < length) ? code[pos+3].uc : 0;
+    next3 = read();
   }
 }
 
+void Lexer::jumpTo(unsigned int p)
+{
+  readPos = p;
+  pos = readPos;
+  current = read();
+  pos1 = readPos;
+  next1 = read();
+  pos2 = readPos;
+  next2 = read();
+  pos3 = readPos;
+  next3 = read();
+}
+
 // called on each new line
 void Lexer::nextLine()
 {
@@ -152,11 +239,12 @@ void Lexer::setDone(State s)
   done = true;
 }
 
-int Lexer::lex()
+int Lexer::lex(TokenValue *value, TokenLocation *location)
 {
   int token = 0;
   state = Start;
   unsigned short stringType = 0; // either single or double quotes
+  unsigned int start = pos;
   pos8 = pos16 = 0;
   done = false;
   terminator = false;
@@ -184,8 +272,12 @@ int Lexer::lex()
     }
     switch (state) {
     case Start:
+      start = pos;
       if (isWhiteSpace()) {
-        // do nothing
+        // skip the whole run
+        jumpTo(code ? CharacterScanner::skipWhiteSpace(code, pos1, length)
+               : CharacterScanner::skipWhiteSpace(code8, pos1, length));
+        continue;
       } else if (current == '/' && next1 == '/') {
         shift(1);
         state = InSingleLineComment;
@@ -252,7 +344,12 @@ int Lexer::lex()
       } else if (current == '\\') {
         state = InEscapeSequence;
       } else {
-        record16(current);
+        // take the characters up to the next one that needs a look
+        unsigned int end = code ? CharacterScanner::findStringStop(code, pos1, length, stringType)
+          : CharacterScanner::findStringStop(code8, pos1, length, stringType);
+        recordCode(pos, end);
+        jumpTo(end);
+        continue;
       }
       break;
     // Escape Sequences inside of strings
@@ -322,6 +419,10 @@ int Lexer::lex()
           state = Start;
       } else if (current == 0) {
         setDone(Eof);
+      } else {
+        jumpTo(code ? CharacterScanner::findLineEnd(code, pos1, length)
+               : CharacterScanner::findLineEnd(code8, pos1, length));
+        continue;
       }
       break;
     case InMultiLineComment:
@@ -332,15 +433,21 @@ int Lexer::lex()
       } else if (current == '*' && next1 == '/') {
         state = Start;
         shift(1);
+      } else {
+        jumpTo(code ? CharacterScanner::findCommentStop(code, pos1, length)
+               : CharacterScanner::findCommentStop(code8, pos1, length));
+        continue;
       }
       break;
-    case InIdentifier:
-      if (isIdentLetter(current) || isDecimalDigit(current)) {
-        record16(current);
-        break;
-      }
+    case InIdentifier: {
+      // the rest of the identifier at once
+      unsigned int end = code ? CharacterScanner::findIdentifierEnd(code, pos, length)
+        : CharacterScanner::findIdentifierEnd(code8, pos, length);
+      recordCode(pos, end);
+      jumpTo(end);
       setDone(Identifier);
       break;
+    }
     case InNum0:
       if (current == 'x' || current == 'X') {
         record8(current);
@@ -442,18 +549,20 @@ int Lexer::lex()
 #endif
 
   double dval = 0;
-  if (state == Number) {
-    dval = strtod(buffer8, 0L);
-  } else if (state == Hex) { // scan hex numbers
-    // TODO: support long unsigned int
-    unsigned int i;
-    sscanf(buffer8, "%x", &i);
-    dval = i;
+  // a function body that is only checked has no use for the values
+  if (preparsing) {
+    if (state == Hex || state == Octal)
+      state = Number;
+  } else if (state == Number) {
+    const char *end;
+    dval = NumberFormat::parseDecimal(buffer8, buffer8 + pos8, end);
+  } else if (state == Hex) { // scan hex numbers, after the 0x
+    const char *end;
+    dval = NumberFormat::parseBinaryRadix(buffer8 + 2, buffer8 + pos8, 16, end);
     state = Number;
   } else if (state == Octal) {   // scan octal number
-    unsigned int ui;
-    sscanf(buffer8, "%o", &ui);
-    dval = ui;
+    const char *end;
+    dval = NumberFormat::parseBinaryRadix(buffer8, buffer8 + pos8, 8, end);
     state = Number;
   }
 
@@ -484,8 +593,12 @@ int Lexer::lex()
 
   restrKeyword = false;
   delimited = false;
-  kjsyylloc.first_line = yylineno; // ???
-  kjsyylloc.last_line = yylineno;
+  if (location) {
+    location->first_line = yylineno; // ???
+    location->last_line = yylineno;
+    location->first_column = start;
+    location->last_column = pos;
+  }
 
   switch (state) {
   case Eof:
@@ -502,10 +615,10 @@ int Lexer::lex()
       // Apply anonymous-function hack below (eat the identifier)
       if (eatNextIdentifier) {
         eatNextIdentifier = false;
-        token = lex();
-        break;
+        return lex(value, location);
       }
-      kjsyylval.ident = makeIdentifier(buffer16, pos16);
+      if (!preparsing)
+        value->ident = makeIdentifier(buffer16, pos16);
       token = IDENT;
       break;
     }
@@ -520,11 +633,13 @@ int Lexer::lex()
       restrKeyword = true;
     break;
   case String:
-    kjsyylval.ustr = makeUString(buffer16, pos16);
+    if (!preparsing)
+      value->ustr = makeUString(buffer16, pos16);
     token = STRING;
     break;
   case Number:
-    kjsyylval.dval = dval;
+    if (!preparsing)
+      value->dval = dval;
     token = NUMBER;
     break;
   case Bad:
@@ -534,6 +649,7 @@ int Lexer::lex()
     assert(!"unhandled numeration value in switch");
     return -1;
   }
+
   lastToken = token;
   return token;
 }
@@ -765,6 +881,36 @@ void Lexer::record8(unsigned short c)
   buffer8[pos8++] = (char) c;
 }
 
+void Lexer::recordCode(unsigned int start, unsigned int end)
+{
+  // enlarge buffer if needed, leaving room for one more as record16(UChar)
+  // does; no character takes more UTF-16 units than UTF-8 bytes
+  unsigned int count = end - start;
+  if (pos16 + count >= size16) {
+    unsigned int newSize = size16;
+    while (pos16 + count >= newSize)
+      newSize *= 2;
+    UChar *tmp = new UChar[newSize];
+    memcpy(tmp, buffer16, pos16 * sizeof(UChar));
+    delete [] buffer16;
+    buffer16 = tmp;
+    size16 = newSize;
+  }
+
+  if (code) {
+    memcpy(buffer16 + pos16, code + start, count * sizeof(UChar));
+    pos16 += count;
+  } else if (!utf8) {
+    for (unsigned int i = start; i < end; i++)
+      buffer16[pos16++].uc = static_cast<unsigned char>(code8[i]);
+  } else {
+    // may start at the second half of a character, see readUTF8()
+    readPos = start;
+    while (readPos < end)
+      buffer16[pos16++].uc = read();
+  }
+}
+
 void Lexer::record16(UChar c)
 {
   // enlarge buffer if full
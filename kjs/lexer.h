@@ -32,17 +32,33 @@ namespace KJS {
 
   class RegExp;
 
+  union TokenValue;
+  struct TokenLocation;
+
   class Lexer {
   public:
     Lexer();
     ~Lexer();
     static Lexer *curr();
+    // deletes the lexer of the calling thread; the next curr() makes a new one
+    static void deleteCurr();
 
     void setCode(const UString &sourceURL, int startingLineNumber, const UChar *c, unsigned int len);
-    int lex();
+    /**
+     * Reads Latin-1 or UTF-8 text of len bytes as it is. Only the contents
+     * of identifiers, strings and regular expressions are converted to
+     * UTF-16. Positions like bodyStart are then offsets in bytes.
+     */
+    void setCode(const UString &sourceURL, int startingLineNumber, const char *c, unsigned int len,
+                 TextEncoding encoding);
+    /**
+     * Reads the next token, see tokens.h. Its value and its location are
+     * stored in value and location.
+     */
+    int lex(TokenValue *value, TokenLocation *location);
 
     int lineNo() const { return yylineno; }
-    UString sourceURL() const { return m_sourceURL; }
+    const UString &sourceURL() const { return m_sourceURL; }
 
     bool prevTerminator() const { return terminator; }
 
@@ -73,7 +89,13 @@ namespace KJS {
     bool scanRegExp();
     UString pattern, flags;
 
+    // set while the parser only checks a function body, which needs no
+    // values of the tokens, see DescentParser::skipFunctionBody()
+    bool preparsing;
+
   private:
+    void reset(const UString &sourceURL, int startingLineNumber);
+
     int yylineno;
     UString m_sourceURL;
     bool done;
@@ -93,8 +115,16 @@ namespace KJS {
 
     State state;
     void setDone(State s);
-    unsigned int pos;
+    // offsets of current and the following characters in the code
+    unsigned int pos, pos1, pos2, pos3;
+    // offset of the character after next3
+    unsigned int readPos;
     void shift(unsigned int p);
+    // moves on to code[p], which may be far ahead
+    void jumpTo(unsigned int p);
+    // the character at readPos, moving readPos past it
+    unsigned short read();
+    unsigned short readUTF8(unsigned int p);
     void nextLine();
     int lookupKeyword(const char *);
 
@@ -129,11 +159,16 @@ namespace KJS {
 
     void record8(unsigned short c);
     void record16(UChar c);
+    // records the characters from offset start up to end
+    void recordCode(unsigned int start, unsigned int end);
 
     KJS::Identifier *makeIdentifier(UChar *buffer, unsigned int pos);
     UString *makeUString(UChar *buffer, unsigned int pos);
 
     const UChar *code;
+    // the code as bytes instead, if it was given in Latin-1 or UTF-8
+    const char *code8;
+    bool utf8;
     unsigned int length;
     int yycolumn;
 #ifndef KJS_PURE_ECMA
@@ -39,8 +39,17 @@ static bool keysMatch(const UChar *c, unsigned len, const char *s)
   return *s == 0;
 }
 
-const HashEntry* Lookup::findEntry( const struct HashTable *table,
-                              const UChar *c, unsigned int len )
+static bool keysMatch(const char *c, unsigned len, const char *s)
+{
+  for (unsigned i = 0; i != len; i++, c++, s++)
+    if (!*s || *c != *s)
+      return false;
+  return *s == 0;
+}
+
+template <class CharType>
+static const HashEntry *findEntryInTable(const struct HashTable *table,
+                                         const CharType *c, unsigned int len)
 {
 #ifndef NDEBUG
   if (table->type != 2) {
@@ -49,7 +58,7 @@ const HashEntry* Lookup::findEntry( const struct HashTable *table,
   }
 #endif
 
-  int h = hash(c, len) % table->hashSize;
+  int h = Lookup::hash(c, len) % table->hashSize;
   const HashEntry *e = &table->entries[h];
 
   // empty bucket ?
@@ -67,9 +76,24 @@ const HashEntry* Lookup::findEntry( const struct HashTable *table,
   return 0;
 }
 
+const HashEntry* Lookup::findEntry( const struct HashTable *table,
+                              const UChar *c, unsigned int len )
+{
+  return findEntryInTable(table, c, len);
+}
+
+const HashEntry* Lookup::findEntry( const struct HashTable *table,
+                              const char *c, unsigned int len )
+{
+  return findEntryInTable(table, c, len);
+}
+
 const HashEntry* Lookup::findEntry( const struct HashTable *table,
                                 const Identifier &s )
 {
+  // property names are mostly held in 8 bits, keep them that way
+  if (const char *c = s.ustring().latin1Data())
+    return findEntry( table, c, s.size() );
   return findEntry( table, s.data(), s.size() );
 }
 
@@ -84,7 +108,10 @@ int Lookup::find(const struct HashTable *table,
 
 int Lookup::find(const struct HashTable *table, const Identifier &s)
 {
-  return find(table, s.data(), s.size());
+  const HashEntry *entry = findEntry( table, s );
+  if (entry)
+    return entry->value;
+  return -1;
 }
 
 unsigned int Lookup::hash(const UChar *c, unsigned int len)
@@ -97,8 +124,19 @@ unsigned int Lookup::hash(const UChar *c, unsigned int len)
   return val;
 }
 
+unsigned int Lookup::hash(const char *c, unsigned int len)
+{
+  unsigned int val = 0;
+  for (unsigned int i = 0; i < len; i++)
+    val += (unsigned char)c[i];
+
+  return val;
+}
+
 unsigned int Lookup::hash(const Identifier &key)
 {
+  if (const char *c = key.ustring().latin1Data())
+    return hash(c, key.size());
   return hash(key.data(), key.size());
 }
 
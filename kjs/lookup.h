@@ -110,12 +110,15 @@ namespace KJS {
                                       const Identifier &s);
     static const HashEntry* findEntry(const struct HashTable *table,
                                       const UChar *c, unsigned int len);
+    static const HashEntry* findEntry(const struct HashTable *table,
+                                      const char *c, unsigned int len);
 
     /**
      * Calculate the hash value for a given key
      */
     static unsigned int hash(const Identifier &key);
     static unsigned int hash(const UChar *c, unsigned int len);
+    static unsigned int hash(const char *c, unsigned int len);
     static unsigned int hash(const char *s);
   };
 
@@ -31,6 +31,7 @@ namespace KJS {
   public:
     MathObjectImp(ExecState *exec,
                   ObjectPrototypeImp *objProto);
+    virtual ObjectImp *clone() const { return new MathObjectImp(*this); }
     Value get(ExecState *exec, const Identifier &p) const;
     Value getValueProperty(ExecState *exec, int token) const;
     virtual const ClassInfo *classInfo() const { return &info; }
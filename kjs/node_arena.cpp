@@ -0,0 +1,109 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "node_arena.h"
+
+#include "nodes.h"
+
+#include <stdlib.h>
+
+using namespace KJS;
+
+// Small scripts like the ones passed to eval() get a small first block,
+// big ones end up with blocks of the maximum size.
+const size_t initialBlockSize = 1024;
+const size_t maximumBlockSize = 32 * 1024;
+
+// Every node is preceded by its size, so that the nodes of a block can be
+// found again when they are destroyed. Sizes are kept multiples of the
+// alignment, which is enough for the doubles in the nodes.
+const size_t alignment = 8;
+const size_t headerSize = alignment;
+
+static inline size_t roundUp(size_t size)
+{
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+struct NodeArena::Block {
+  Block *next;
+  // where the nodes of this block end
+  char *top;
+  size_t capacity;
+
+  char *begin() { return reinterpret_cast<char *>(this) + roundUp(sizeof(Block)); }
+};
+
+NodeArena::NodeArena()
+  : blocks(0), position(0), end(0), totalSize(sizeof(NodeArena)), refcount(0)
+{
+}
+
+NodeArena::~NodeArena()
+{
+  if (blocks)
+    blocks->top = position;
+
+  Block *next;
+  for (Block *block = blocks; block; block = next) {
+    for (char *p = block->begin(); p < block->top; ) {
+      size_t size = *reinterpret_cast<size_t *>(p);
+      reinterpret_cast<Node *>(p + headerSize)->~Node();
+      p += headerSize + size;
+    }
+    next = block->next;
+    free(block);
+  }
+}
+
+void NodeArena::newBlock(size_t minimumSize)
+{
+  size_t capacity = blocks ? blocks->capacity * 2 : initialBlockSize;
+  if (capacity > maximumBlockSize)
+    capacity = maximumBlockSize;
+  size_t needed = roundUp(sizeof(Block)) + minimumSize;
+  if (capacity < needed)
+    capacity = needed;
+
+  Block *block = static_cast<Block *>(malloc(capacity));
+  if (blocks)
+    blocks->top = position;
+  block->next = blocks;
+  block->capacity = capacity;
+  blocks = block;
+  totalSize += capacity;
+
+  position = block->begin();
+  end = reinterpret_cast<char *>(block) + capacity;
+}
+
+void *NodeArena::allocate(size_t size)
+{
+  size = roundUp(size);
+  if (static_cast<size_t>(end - position) < headerSize + size)
+    newBlock(headerSize + size);
+
+  *reinterpret_cast<size_t *>(position) = size;
+  void *node = position + headerSize;
+  position += headerSize + size;
+  return node;
+}
@@ -0,0 +1,76 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef _KJS_NODE_ARENA_H_
+#define _KJS_NODE_ARENA_H_
+
+#include <stddef.h>
+
+namespace KJS {
+
+  /**
+   * @internal
+   *
+   * Holds the nodes of one parse. Nodes are allocated one after the other
+   * from large blocks, and all of them are destroyed together when the
+   * last reference to the arena goes away. The trees of a program and of
+   * the functions in it share their arena, so any @ref FunctionBodyNode
+   * that is still referenced keeps the whole tree alive.
+   */
+  class NodeArena {
+  public:
+    NodeArena();
+
+    /**
+     * Returns memory for a node of the given size. The node must be
+     * constructed right away; it will be destroyed with the arena.
+     */
+    void *allocate(size_t size);
+
+    void ref() { refcount++; }
+    void deref() { if (!--refcount) delete this; }
+
+    /**
+     * The number of bytes held by the arena.
+     */
+    size_t size() const { return totalSize; }
+
+  private:
+    ~NodeArena();
+
+    struct Block;
+    void newBlock(size_t minimumSize);
+
+    Block *blocks;
+    char *position;
+    char *end;
+    size_t totalSize;
+    unsigned int refcount;
+
+    // disallow assignment
+    NodeArena &operator=(const NodeArena &);
+    NodeArena(const NodeArena &);
+  };
+
+}; // namespace
+
+#endif
@@ -27,6 +27,8 @@
 //#include <iostream>
 #include <math.h>
 #include <assert.h>
+#include <limits.h>
+#include <string.h>
 #ifdef KJS_DEBUG_MEM
 #include <stdio.h>
 #include <typeinfo>
@@ -42,7 +44,9 @@
 #include "types.h"
 #include "interpreter.h"
 #include "lexer.h"
+#include "node_arena.h"
 #include "operations.h"
+#include "source_provider.h"
 #include "ustring.h"
 
 using namespace KJS;
@@ -84,13 +88,111 @@ using namespace KJS;
 std::list<Node *> * Node::s_nodes = 0L;
 #endif
 
+// Fast paths of the arithmetic and comparison operators for two numbers.
+// Integers held as SimpleNumber immediates are computed without any call;
+// other numbers at least skip the conversions to primitives of the generic
+// functions in operations.cpp, which handle all other operands.
+
+static inline bool bothNumbers(const Value &v1, const Value &v2)
+{
+  return v1.type() == NumberType && v2.type() == NumberType;
+}
+
+// Sums of immediates are exact, but a number is a double: a sum that needs
+// more than 53 bits is rounded the way adding the doubles would round it.
+// Number() makes a NumberImp if the result does not fit an immediate.
+static inline Value integerResult(long l)
+{
+  double d = static_cast<double>(l);
+  if (static_cast<long>(d) == l)
+    return Number(l);
+  return Number(d);
+}
+
+static inline Value fastAdd(ExecState *exec, const Value &v1, const Value &v2, char oper)
+{
+  ValueImp *i1 = v1.imp();
+  ValueImp *i2 = v2.imp();
+  if (SimpleNumber::is(i1) && SimpleNumber::is(i2)) {
+    // immediates leave bits to spare in a long, so this cannot overflow
+    long l1 = SimpleNumber::value(i1);
+    long l2 = SimpleNumber::value(i2);
+    return integerResult(oper == '+' ? l1 + l2 : l1 - l2);
+  }
+  if (bothNumbers(v1, v2)) {
+    double n1 = v1.toNumber(exec);
+    double n2 = v2.toNumber(exec);
+    return Number(oper == '+' ? n1 + n2 : n1 - n2);
+  }
+  return add(exec, v1, v2, oper);
+}
+
+static inline Value fastMult(ExecState *exec, const Value &v1, const Value &v2, char oper)
+{
+  ValueImp *i1 = v1.imp();
+  ValueImp *i2 = v2.imp();
+  if (SimpleNumber::is(i1) && SimpleNumber::is(i2)) {
+    long l1 = SimpleNumber::value(i1);
+    long l2 = SimpleNumber::value(i2);
+    // products may overflow and quotients are fractions, so these are done
+    // with doubles like the generic code does
+    if (oper == '*')
+      return Number(static_cast<double>(l1) * static_cast<double>(l2));
+    if (oper == '/')
+      return Number(static_cast<double>(l1) / static_cast<double>(l2));
+    // the remainder takes the sign of l1, and is -0 if l1 is negative
+    if (l1 >= 0 && l2 > 0)
+      return Number(l1 % l2);
+    return Number(fmod(static_cast<double>(l1), static_cast<double>(l2)));
+  }
+  return mult(exec, v1, v2, oper);
+}
+
+// returns 1 if the comparison is true, 0 if it is false and -1 if the
+// operands are not both numbers
+static inline int fastLess(ExecState *exec, const Value &v1, const Value &v2, bool orEqual)
+{
+  ValueImp *i1 = v1.imp();
+  ValueImp *i2 = v2.imp();
+  if (SimpleNumber::is(i1) && SimpleNumber::is(i2)) {
+    long l1 = SimpleNumber::value(i1);
+    long l2 = SimpleNumber::value(i2);
+    return orEqual ? l1 <= l2 : l1 < l2;
+  }
+  if (bothNumbers(v1, v2)) {
+    // comparisons with NaN are false, as relation() has them
+    double n1 = v1.toNumber(exec);
+    double n2 = v2.toNumber(exec);
+    return orEqual ? n1 <= n2 : n1 < n2;
+  }
+  return -1;
+}
+
+// returns 1 if the numbers are equal, 0 if they are not and -1 if the
+// operands are not both numbers
+static inline int fastEqual(ExecState *exec, const Value &v1, const Value &v2)
+{
+  ValueImp *i1 = v1.imp();
+  ValueImp *i2 = v2.imp();
+  if (SimpleNumber::is(i1) && SimpleNumber::is(i2))
+    return i1 == i2;
+  if (bothNumbers(v1, v2))
+    return v1.toNumber(exec) == v2.toNumber(exec);
+  return -1;
+}
+
 // ------------------------------ Node -----------------------------------------
 
+void *Node::operator new(size_t size)
+{
+  Parser *parser = Parser::curr();
+  parser->nodeCount++;
+  return parser->arena->allocate(size);
+}
+
 Node::Node()
+  : line(Lexer::curr()->lineNo()), sourceURL(Lexer::curr()->sourceURL())
 {
-  line = Lexer::curr()->lineNo();
-  sourceURL = Lexer::curr()->sourceURL();
-  refcount = 0;
 #ifdef KJS_DEBUG_MEM
   if (!s_nodes)
     s_nodes = new std::list<Node *>;
@@ -118,7 +220,7 @@ void Node::finalCheck()
   fprintf( stderr, "Node::finalCheck(): list count       : %d\n", (int)s_nodes.size() );
   std::list<Node *>::iterator it = s_nodes->begin();
   for ( uint i = 0; it != s_nodes->end() ; ++it, ++i )
-    fprintf( stderr, "[%d] Still having node %p (%s) (refcount %d)\n", i, (void*)*it, typeid( **it ).name(), (*it)->refcount );
+    fprintf( stderr, "[%d] Still having node %p (%s)\n", i, (void*)*it, typeid( **it ).name() );
   delete s_nodes;
   s_nodes = 0L;
 }
@@ -216,14 +318,19 @@ Value BooleanNode::evaluate(ExecState */*exec*/)
 
 Value NumberNode::evaluate(ExecState */*exec*/)
 {
-  return Number(value);
+  // numbers and strings never change, so one value serves every evaluation
+  if (cachedValue.isNull())
+    cachedValue = Number(value);
+  return cachedValue;
 }
 
 // ------------------------------ StringNode -----------------------------------
 
 Value StringNode::evaluate(ExecState */*exec*/)
 {
-  return String(value);
+  if (cachedValue.isNull())
+    cachedValue = String(value);
+  return cachedValue;
 }
 
 // ------------------------------ RegExpNode -----------------------------------
@@ -282,20 +389,6 @@ Reference ResolveNode::evaluateReference(ExecState *exec)
 
 // ------------------------------ GroupNode ------------------------------------
 
-void GroupNode::ref()
-{
-  Node::ref();
-  if ( group )
-    group->ref();
-}
-
-bool GroupNode::deref()
-{
-  if ( group && group->deref() )
-    delete group;
-  return Node::deref();
-}
-
 // ECMA 11.1.6
 Value GroupNode::evaluate(ExecState *exec)
 {
@@ -304,28 +397,6 @@ Value GroupNode::evaluate(ExecState *exec)
 
 // ------------------------------ ElementNode ----------------------------------
 
-void ElementNode::ref()
-{
-  for (ElementNode *n = this; n; n = n->list) {
-    n->Node::ref();
-    if (n->node)
-      n->node->ref();
-  }
-}
-
-bool ElementNode::deref()
-{
-  ElementNode *next;
-  for (ElementNode *n = this; n; n = next) {
-    next = n->list;
-    if (n->node && n->node->deref())
-      delete n->node;
-    if (n != this && n->Node::deref())
-      delete n;
-  }
-  return Node::deref();
-}
-
 // ECMA 11.1.4
 Value ElementNode::evaluate(ExecState *exec)
 {
@@ -342,20 +413,6 @@ Value ElementNode::evaluate(ExecState *exec)
 
 // ------------------------------ ArrayNode ------------------------------------
 
-void ArrayNode::ref()
-{
-  Node::ref();
-  if ( element )
-    element->ref();
-}
-
-bool ArrayNode::deref()
-{
-  if ( element && element->deref() )
-    delete element;
-  return Node::deref();
-}
-
 // ECMA 11.1.4
 Value ArrayNode::evaluate(ExecState *exec)
 {
@@ -380,20 +437,6 @@ Value ArrayNode::evaluate(ExecState *exec)
 
 // ------------------------------ ObjectLiteralNode ----------------------------
 
-void ObjectLiteralNode::ref()
-{
-  Node::ref();
-  if ( list )
-    list->ref();
-}
-
-bool ObjectLiteralNode::deref()
-{
-  if ( list && list->deref() )
-    delete list;
-  return Node::deref();
-}
-
 // ECMA 11.1.5
 Value ObjectLiteralNode::evaluate(ExecState *exec)
 {
@@ -405,32 +448,6 @@ Value ObjectLiteralNode::evaluate(ExecState *exec)
 
 // ------------------------------ PropertyValueNode ----------------------------
 
-void PropertyValueNode::ref()
-{
-  for (PropertyValueNode *n = this; n; n = n->list) {
-    n->Node::ref();
-    if (n->name)
-      n->name->ref();
-    if (n->assign)
-      n->assign->ref();
-  }
-}
-
-bool PropertyValueNode::deref()
-{
-  PropertyValueNode *next;
-  for (PropertyValueNode *n = this; n; n = next) {
-    next = n->list;
-    if ( n->name && n->name->deref() )
-      delete n->name;
-    if ( n->assign && n->assign->deref() )
-      delete n->assign;
-    if (n != this && n->Node::deref() )
-      delete n;
-  }
-  return Node::deref();
-}
-
 // ECMA 11.1.5
 Value PropertyValueNode::evaluate(ExecState *exec)
 {
@@ -466,24 +483,6 @@ Value PropertyNode::evaluate(ExecState */*exec*/)
 
 // ------------------------------ AccessorNode1 --------------------------------
 
-void AccessorNode1::ref()
-{
-  Node::ref();
-  if ( expr1 )
-    expr1->ref();
-  if ( expr2 )
-    expr2->ref();
-}
-
-bool AccessorNode1::deref()
-{
-  if ( expr1 && expr1->deref() )
-    delete expr1;
-  if ( expr2 && expr2->deref() )
-    delete expr2;
-  return Node::deref();
-}
-
 // ECMA 11.2.1a
 Value AccessorNode1::evaluate(ExecState *exec)
 {
@@ -507,20 +506,6 @@ Reference AccessorNode1::evaluateReference(ExecState *exec)
 
 // ------------------------------ AccessorNode2 --------------------------------
 
-void AccessorNode2::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool AccessorNode2::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 11.2.1b
 Value AccessorNode2::evaluate(ExecState *exec)
 {
@@ -537,28 +522,6 @@ Reference AccessorNode2::evaluateReference(ExecState *exec)
 
 // ------------------------------ ArgumentListNode -----------------------------
 
-void ArgumentListNode::ref()
-{
-  for (ArgumentListNode *n = this; n; n = n->list) {
-    n->Node::ref();
-    if (n->expr)
-      n->expr->ref();
-  }
-}
-
-bool ArgumentListNode::deref()
-{
-  ArgumentListNode *next;
-  for (ArgumentListNode *n = this; n; n = next) {
-    next = n->list;
-    if (n->expr && n->expr->deref())
-      delete n->expr;
-    if (n != this && n->Node::deref())
-      delete n;
-  }
-  return Node::deref();
-}
-
 Value ArgumentListNode::evaluate(ExecState */*exec*/)
 {
   assert(0);
@@ -581,20 +544,6 @@ List ArgumentListNode::evaluateList(ExecState *exec)
 
 // ------------------------------ ArgumentsNode --------------------------------
 
-void ArgumentsNode::ref()
-{
-  Node::ref();
-  if ( list )
-    list->ref();
-}
-
-bool ArgumentsNode::deref()
-{
-  if ( list && list->deref() )
-    delete list;
-  return Node::deref();
-}
-
 Value ArgumentsNode::evaluate(ExecState */*exec*/)
 {
   assert(0);
@@ -614,24 +563,6 @@ List ArgumentsNode::evaluateList(ExecState *exec)
 
 // ECMA 11.2.2
 
-void NewExprNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-  if ( args )
-    args->ref();
-}
-
-bool NewExprNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  if ( args && args->deref() )
-    delete args;
-  return Node::deref();
-}
-
 Value NewExprNode::evaluate(ExecState *exec)
 {
   Value v = expr->evaluate(exec);
@@ -659,24 +590,6 @@ Value NewExprNode::evaluate(ExecState *exec)
 
 // ------------------------------ FunctionCallNode -----------------------------
 
-void FunctionCallNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-  if ( args )
-    args->ref();
-}
-
-bool FunctionCallNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  if ( args && args->deref() )
-    delete args;
-  return Node::deref();
-}
-
 // ECMA 11.2.3
 Value FunctionCallNode::evaluate(ExecState *exec)
 {
@@ -728,26 +641,19 @@ Value FunctionCallNode::evaluate(ExecState *exec)
 
 // ------------------------------ PostfixNode ----------------------------------
 
-void PostfixNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool PostfixNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 11.3
 Value PostfixNode::evaluate(ExecState *exec)
 {
   Reference ref = expr->evaluateReference(exec);
   KJS_CHECKEXCEPTIONVALUE
   Value v = ref.getValue(exec);
+  ValueImp *imp = v.imp();
+  if (SimpleNumber::is(imp)) {
+    long l = SimpleNumber::value(imp);
+    ref.putValue(exec, integerResult(oper == OpPlusPlus ? l + 1 : l - 1));
+    return v;
+  }
+
   Number n = v.toNumber(exec);
 
   double newValue = (oper == OpPlusPlus) ? n.value() + 1 : n.value() - 1;
@@ -760,20 +666,6 @@ Value PostfixNode::evaluate(ExecState *exec)
 
 // ------------------------------ DeleteNode -----------------------------------
 
-void DeleteNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool DeleteNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 11.4.1
 Value DeleteNode::evaluate(ExecState *exec)
 {
@@ -784,20 +676,6 @@ Value DeleteNode::evaluate(ExecState *exec)
 
 // ------------------------------ VoidNode -------------------------------------
 
-void VoidNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool VoidNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 11.4.2
 Value VoidNode::evaluate(ExecState *exec)
 {
@@ -809,20 +687,6 @@ Value VoidNode::evaluate(ExecState *exec)
 
 // ------------------------------ TypeOfNode -----------------------------------
 
-void TypeOfNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool TypeOfNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 11.4.3
 Value TypeOfNode::evaluate(ExecState *exec)
 {
@@ -865,26 +729,20 @@ Value TypeOfNode::evaluate(ExecState *exec)
 
 // ------------------------------ PrefixNode -----------------------------------
 
-void PrefixNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool PrefixNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 11.4.4 and 11.4.5
 Value PrefixNode::evaluate(ExecState *exec)
 {
   Reference ref = expr->evaluateReference(exec);
   KJS_CHECKEXCEPTIONVALUE
   Value v = ref.getValue(exec);
+  ValueImp *imp = v.imp();
+  if (SimpleNumber::is(imp)) {
+    long l = SimpleNumber::value(imp);
+    Value n2 = integerResult(oper == OpPlusPlus ? l + 1 : l - 1);
+    ref.putValue(exec, n2);
+    return n2;
+  }
+
   Number n = v.toNumber(exec);
 
   double newValue = (oper == OpPlusPlus) ? n.value() + 1 : n.value() - 1;
@@ -897,20 +755,6 @@ Value PrefixNode::evaluate(ExecState *exec)
 
 // ------------------------------ UnaryPlusNode --------------------------------
 
-void UnaryPlusNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool UnaryPlusNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 11.4.6
 Value UnaryPlusNode::evaluate(ExecState *exec)
 {
@@ -922,20 +766,6 @@ Value UnaryPlusNode::evaluate(ExecState *exec)
 
 // ------------------------------ NegateNode -----------------------------------
 
-void NegateNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool NegateNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 11.4.7
 Value NegateNode::evaluate(ExecState *exec)
 {
@@ -950,20 +780,6 @@ Value NegateNode::evaluate(ExecState *exec)
 
 // ------------------------------ BitwiseNotNode -------------------------------
 
-void BitwiseNotNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool BitwiseNotNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 11.4.8
 Value BitwiseNotNode::evaluate(ExecState *exec)
 {
@@ -976,20 +792,6 @@ Value BitwiseNotNode::evaluate(ExecState *exec)
 
 // ------------------------------ LogicalNotNode -------------------------------
 
-void LogicalNotNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool LogicalNotNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 11.4.9
 Value LogicalNotNode::evaluate(ExecState *exec)
 {
@@ -1002,24 +804,6 @@ Value LogicalNotNode::evaluate(ExecState *exec)
 
 // ------------------------------ MultNode -------------------------------------
 
-void MultNode::ref()
-{
-  Node::ref();
-  if ( term1 )
-    term1->ref();
-  if ( term2 )
-    term2->ref();
-}
-
-bool MultNode::deref()
-{
-  if ( term1 && term1->deref() )
-    delete term1;
-  if ( term2 && term2->deref() )
-    delete term2;
-  return Node::deref();
-}
-
 // ECMA 11.5
 Value MultNode::evaluate(ExecState *exec)
 {
@@ -1029,29 +813,11 @@ Value MultNode::evaluate(ExecState *exec)
   Value v2 = term2->evaluate(exec);
   KJS_CHECKEXCEPTIONVALUE
 
-  return mult(exec,v1, v2, oper);
+  return fastMult(exec, v1, v2, oper);
 }
 
 // ------------------------------ AddNode --------------------------------------
 
-void AddNode::ref()
-{
-  Node::ref();
-  if ( term1 )
-    term1->ref();
-  if ( term2 )
-    term2->ref();
-}
-
-bool AddNode::deref()
-{
-  if ( term1 && term1->deref() )
-    delete term1;
-  if ( term2 && term2->deref() )
-    delete term2;
-  return Node::deref();
-}
-
 // ECMA 11.6
 Value AddNode::evaluate(ExecState *exec)
 {
@@ -1061,29 +827,11 @@ Value AddNode::evaluate(ExecState *exec)
   Value v2 = term2->evaluate(exec);
   KJS_CHECKEXCEPTIONVALUE
 
-  return add(exec,v1, v2, oper);
+  return fastAdd(exec, v1, v2, oper);
 }
 
 // ------------------------------ ShiftNode ------------------------------------
 
-void ShiftNode::ref()
-{
-  Node::ref();
-  if ( term1 )
-    term1->ref();
-  if ( term2 )
-    term2->ref();
-}
-
-bool ShiftNode::deref()
-{
-  if ( term1 && term1->deref() )
-    delete term1;
-  if ( term2 && term2->deref() )
-    delete term2;
-  return Node::deref();
-}
-
 // ECMA 11.7
 Value ShiftNode::evaluate(ExecState *exec)
 {
@@ -1115,24 +863,6 @@ Value ShiftNode::evaluate(ExecState *exec)
 
 // ------------------------------ RelationalNode -------------------------------
 
-void RelationalNode::ref()
-{
-  Node::ref();
-  if ( expr1 )
-    expr1->ref();
-  if ( expr2 )
-    expr2->ref();
-}
-
-bool RelationalNode::deref()
-{
-  if ( expr1 && expr1->deref() )
-    delete expr1;
-  if ( expr2 && expr2->deref() )
-    delete expr2;
-  return Node::deref();
-}
-
 // ECMA 11.8
 Value RelationalNode::evaluate(ExecState *exec)
 {
@@ -1142,7 +872,15 @@ Value RelationalNode::evaluate(ExecState *exec)
   KJS_CHECKEXCEPTIONVALUE
 
   bool b;
-  if (oper == OpLess || oper == OpGreaterEq) {
+  int fast = -1;
+  if (oper == OpLess || oper == OpLessEq)
+    fast = fastLess(exec, v1, v2, oper == OpLessEq);
+  else if (oper == OpGreater || oper == OpGreaterEq)
+    fast = fastLess(exec, v2, v1, oper == OpGreaterEq);
+
+  if (fast >= 0) {
+    b = fast;
+  } else if (oper == OpLess || oper == OpGreaterEq) {
     int r = relation(exec, v1, v2);
     if (r < 0)
       b = false;
@@ -1184,24 +922,6 @@ Value RelationalNode::evaluate(ExecState *exec)
 
 // ------------------------------ EqualNode ------------------------------------
 
-void EqualNode::ref()
-{
-  Node::ref();
-  if ( expr1 )
-    expr1->ref();
-  if ( expr2 )
-    expr2->ref();
-}
-
-bool EqualNode::deref()
-{
-  if ( expr1 && expr1->deref() )
-    delete expr1;
-  if ( expr2 && expr2->deref() )
-    delete expr2;
-  return Node::deref();
-}
-
 // ECMA 11.9
 Value EqualNode::evaluate(ExecState *exec)
 {
@@ -1211,7 +931,11 @@ Value EqualNode::evaluate(ExecState *exec)
   KJS_CHECKEXCEPTIONVALUE
 
   bool result;
-  if (oper == OpEqEq || oper == OpNotEq) {
+  int fast = fastEqual(exec, v1, v2);
+  if (fast >= 0) {
+    // numbers are equal in the same way for all four operators
+    result = (oper == OpEqEq || oper == OpStrEq) ? fast : !fast;
+  } else if (oper == OpEqEq || oper == OpNotEq) {
     // == and !=
     bool eq = equal(exec,v1, v2);
     result = oper == OpEqEq ? eq : !eq;
@@ -1225,24 +949,6 @@ Value EqualNode::evaluate(ExecState *exec)
 
 // ------------------------------ BitOperNode ----------------------------------
 
-void BitOperNode::ref()
-{
-  Node::ref();
-  if ( expr1 )
-    expr1->ref();
-  if ( expr2 )
-    expr2->ref();
-}
-
-bool BitOperNode::deref()
-{
-  if ( expr1 && expr1->deref() )
-    delete expr1;
-  if ( expr2 && expr2->deref() )
-    delete expr2;
-  return Node::deref();
-}
-
 // ECMA 11.10
 Value BitOperNode::evaluate(ExecState *exec)
 {
@@ -1265,24 +971,6 @@ Value BitOperNode::evaluate(ExecState *exec)
 
 // ------------------------------ BinaryLogicalNode ----------------------------
 
-void BinaryLogicalNode::ref()
-{
-  Node::ref();
-  if ( expr1 )
-    expr1->ref();
-  if ( expr2 )
-    expr2->ref();
-}
-
-bool BinaryLogicalNode::deref()
-{
-  if ( expr1 && expr1->deref() )
-    delete expr1;
-  if ( expr2 && expr2->deref() )
-    delete expr2;
-  return Node::deref();
-}
-
 // ECMA 11.11
 Value BinaryLogicalNode::evaluate(ExecState *exec)
 {
@@ -1300,28 +988,6 @@ Value BinaryLogicalNode::evaluate(ExecState *exec)
 
 // ------------------------------ ConditionalNode ------------------------------
 
-void ConditionalNode::ref()
-{
-  Node::ref();
-  if ( expr1 )
-    expr1->ref();
-  if ( expr2 )
-    expr2->ref();
-  if ( logical )
-    logical->ref();
-}
-
-bool ConditionalNode::deref()
-{
-  if ( expr1 && expr1->deref() )
-    delete expr1;
-  if ( expr2 && expr2->deref() )
-    delete expr2;
-  if ( logical && logical->deref() )
-    delete logical;
-  return Node::deref();
-}
-
 // ECMA 11.12
 Value ConditionalNode::evaluate(ExecState *exec)
 {
@@ -1340,24 +1006,6 @@ Value ConditionalNode::evaluate(ExecState *exec)
 
 // ------------------------------ AssignNode -----------------------------------
 
-void AssignNode::ref()
-{
-  Node::ref();
-  if ( left )
-    left->ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool AssignNode::deref()
-{
-  if ( left && left->deref() )
-    delete left;
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 11.13
 Value AssignNode::evaluate(ExecState *exec)
 {
@@ -1376,16 +1024,16 @@ Value AssignNode::evaluate(ExecState *exec)
     unsigned int ui;
     switch (oper) {
     case OpMultEq:
-      v = mult(exec, v1, v2, '*');
+      v = fastMult(exec, v1, v2, '*');
       break;
     case OpDivEq:
-      v = mult(exec, v1, v2, '/');
+      v = fastMult(exec, v1, v2, '/');
       break;
     case OpPlusEq:
-      v = add(exec, v1, v2, '+');
+      v = fastAdd(exec, v1, v2, '+');
       break;
     case OpMinusEq:
-      v = add(exec, v1, v2, '-');
+      v = fastAdd(exec, v1, v2, '-');
       break;
     case OpLShift:
       i1 = v1.toInt32(exec);
@@ -1436,24 +1084,6 @@ Value AssignNode::evaluate(ExecState *exec)
 
 // ------------------------------ CommaNode ------------------------------------
 
-void CommaNode::ref()
-{
-  Node::ref();
-  if ( expr1 )
-    expr1->ref();
-  if ( expr2 )
-    expr2->ref();
-}
-
-bool CommaNode::deref()
-{
-  if ( expr1 && expr1->deref() )
-    delete expr1;
-  if ( expr2 && expr2->deref() )
-    delete expr2;
-  return Node::deref();
-}
-
 // ECMA 11.14
 Value CommaNode::evaluate(ExecState *exec)
 {
@@ -1480,28 +1110,6 @@ StatListNode::StatListNode(StatListNode *l, StatementNode *s)
   setLoc(l->firstLine(), s->lastLine(), l->sourceId());
 }
 
-void StatListNode::ref()
-{
-  for (StatListNode *n = this; n; n = n->list) {
-    n->Node::ref();
-    if (n->statement)
-      n->statement->ref();
-  }
-}
-
-bool StatListNode::deref()
-{
-  StatListNode *next;
-  for (StatListNode *n = this; n; n = next) {
-    next = n->list;
-    if (n->statement && n->statement->deref())
-      delete n->statement;
-    if (n != this && n->Node::deref())
-      delete n;
-  }
-  return Node::deref();
-}
-
 // ECMA 12.1
 Completion StatListNode::execute(ExecState *exec)
 {
@@ -1546,20 +1154,6 @@ void StatListNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ AssignExprNode -------------------------------
 
-void AssignExprNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool AssignExprNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 12.2
 Value AssignExprNode::evaluate(ExecState *exec)
 {
@@ -1573,20 +1167,6 @@ VarDeclNode::VarDeclNode(const Identifier &id, AssignExprNode *in)
 {
 }
 
-void VarDeclNode::ref()
-{
-  Node::ref();
-  if ( init )
-    init->ref();
-}
-
-bool VarDeclNode::deref()
-{
-  if ( init && init->deref() )
-    delete init;
-  return Node::deref();
-}
-
 // ECMA 12.2
 Value VarDeclNode::evaluate(ExecState *exec)
 {
@@ -1627,28 +1207,6 @@ void VarDeclNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ VarDeclListNode ------------------------------
 
-void VarDeclListNode::ref()
-{
-  for (VarDeclListNode *n = this; n; n = n->list) {
-    n->Node::ref();
-    if (n->var)
-      n->var->ref();
-  }
-}
-
-bool VarDeclListNode::deref()
-{
-  VarDeclListNode *next;
-  for (VarDeclListNode *n = this; n; n = next) {
-    next = n->list;
-    if (n->var && n->var->deref())
-      delete n->var;
-    if (n != this && n->Node::deref())
-      delete n;
-  }
-  return Node::deref();
-}
-
 
 // ECMA 12.2
 Value VarDeclListNode::evaluate(ExecState *exec)
@@ -1668,20 +1226,6 @@ void VarDeclListNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ VarStatementNode -----------------------------
 
-void VarStatementNode::ref()
-{
-  Node::ref();
-  if ( list )
-    list->ref();
-}
-
-bool VarStatementNode::deref()
-{
-  if ( list && list->deref() )
-    delete list;
-  return Node::deref();
-}
-
 // ECMA 12.2
 Completion VarStatementNode::execute(ExecState *exec)
 {
@@ -1711,20 +1255,6 @@ BlockNode::BlockNode(SourceElementsNode *s)
   }
 }
 
-void BlockNode::ref()
-{
-  Node::ref();
-  if ( source )
-    source->ref();
-}
-
-bool BlockNode::deref()
-{
-  if ( source && source->deref() )
-    delete source;
-  return Node::deref();
-}
-
 // ECMA 12.1
 Completion BlockNode::execute(ExecState *exec)
 {
@@ -1752,20 +1282,6 @@ Completion EmptyStatementNode::execute(ExecState */*exec*/)
 
 // ------------------------------ ExprStatementNode ----------------------------
 
-void ExprStatementNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool ExprStatementNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 12.4
 Completion ExprStatementNode::execute(ExecState *exec)
 {
@@ -1779,28 +1295,6 @@ Completion ExprStatementNode::execute(ExecState *exec)
 
 // ------------------------------ IfNode ---------------------------------------
 
-void IfNode::ref()
-{
-  Node::ref();
-  if ( statement1 )
-    statement1->ref();
-  if ( statement2 )
-    statement2->ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool IfNode::deref()
-{
-  if ( statement1 && statement1->deref() )
-    delete statement1;
-  if ( statement2 && statement2->deref() )
-    delete statement2;
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 12.5
 Completion IfNode::execute(ExecState *exec)
 {
@@ -1832,24 +1326,6 @@ void IfNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ DoWhileNode ----------------------------------
 
-void DoWhileNode::ref()
-{
-  Node::ref();
-  if ( statement )
-    statement->ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool DoWhileNode::deref()
-{
-  if ( statement && statement->deref() )
-    delete statement;
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 12.6.1
 Completion DoWhileNode::execute(ExecState *exec)
 {
@@ -1884,24 +1360,6 @@ void DoWhileNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ WhileNode ------------------------------------
 
-void WhileNode::ref()
-{
-  Node::ref();
-  if ( statement )
-    statement->ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool WhileNode::deref()
-{
-  if ( statement && statement->deref() )
-    delete statement;
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 12.6.2
 Completion WhileNode::execute(ExecState *exec)
 {
@@ -1943,32 +1401,6 @@ void WhileNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ ForNode --------------------------------------
 
-void ForNode::ref()
-{
-  Node::ref();
-  if ( statement )
-    statement->ref();
-  if ( expr1 )
-    expr1->ref();
-  if ( expr2 )
-    expr2->ref();
-  if ( expr3 )
-    expr3->ref();
-}
-
-bool ForNode::deref()
-{
-  if ( statement && statement->deref() )
-    delete statement;
-  if ( expr1 && expr1->deref() )
-    delete expr1;
-  if ( expr2 && expr2->deref() )
-    delete expr2;
-  if ( expr3 && expr3->deref() )
-    delete expr3;
-  return Node::deref();
-}
-
 // ECMA 12.6.3
 Completion ForNode::execute(ExecState *exec)
 {
@@ -2029,36 +1461,6 @@ ForInNode::ForInNode(const Identifier &i, AssignExprNode *in, Node *e, Statement
   lexpr = new ResolveNode(ident);
 }
 
-void ForInNode::ref()
-{
-  Node::ref();
-  if ( statement )
-    statement->ref();
-  if ( expr )
-    expr->ref();
-  if ( lexpr )
-    lexpr->ref();
-  if ( init )
-    init->ref();
-  if ( varDecl )
-    varDecl->ref();
-}
-
-bool ForInNode::deref()
-{
-  if ( statement && statement->deref() )
-    delete statement;
-  if ( expr && expr->deref() )
-    delete expr;
-  if ( lexpr && lexpr->deref() )
-    delete lexpr;
-  if ( init && init->deref() )
-    delete init;
-  if ( varDecl && varDecl->deref() )
-    delete varDecl;
-  return Node::deref();
-}
-
 // ECMA 12.6.4
 Completion ForInNode::execute(ExecState *exec)
 {
@@ -2155,20 +1557,6 @@ Completion BreakNode::execute(ExecState *exec)
 
 // ------------------------------ ReturnNode -----------------------------------
 
-void ReturnNode::ref()
-{
-  Node::ref();
-  if ( value )
-    value->ref();
-}
-
-bool ReturnNode::deref()
-{
-  if ( value && value->deref() )
-    delete value;
-  return Node::deref();
-}
-
 // ECMA 12.9
 Completion ReturnNode::execute(ExecState *exec)
 {
@@ -2185,24 +1573,6 @@ Completion ReturnNode::execute(ExecState *exec)
 
 // ------------------------------ WithNode -------------------------------------
 
-void WithNode::ref()
-{
-  Node::ref();
-  if ( statement )
-    statement->ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool WithNode::deref()
-{
-  if ( statement && statement->deref() )
-    delete statement;
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 12.10
 Completion WithNode::execute(ExecState *exec)
 {
@@ -2226,24 +1596,6 @@ void WithNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ CaseClauseNode -------------------------------
 
-void CaseClauseNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-  if ( list )
-    list->ref();
-}
-
-bool CaseClauseNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  if ( list && list->deref() )
-    delete list;
-  return Node::deref();
-}
-
 // ECMA 12.11
 Value CaseClauseNode::evaluate(ExecState *exec)
 {
@@ -2270,28 +1622,6 @@ void CaseClauseNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ ClauseListNode -------------------------------
 
-void ClauseListNode::ref()
-{
-  for (ClauseListNode *n = this; n; n = n->nx) {
-    n->Node::ref();
-    if (n->cl)
-      n->cl->ref();
-  }
-}
-
-bool ClauseListNode::deref()
-{
-  ClauseListNode *next;
-  for (ClauseListNode *n = this; n; n = next) {
-    next = n->nx;
-    if (n->cl && n->cl->deref())
-      delete n->cl;
-    if (n != this && n->Node::deref())
-      delete n;
-  }
-  return Node::deref();
-}
-
 Value ClauseListNode::evaluate(ExecState */*exec*/)
 {
   /* should never be called */
@@ -2307,6 +1637,250 @@ void ClauseListNode::processVarDecls(ExecState *exec)
       n->cl->processVarDecls(exec);
 }
 
+// ------------------------------ SwitchTable ----------------------------------
+
+namespace KJS {
+  // Finds the clauses of a switch whose label strictly equals a value, for a
+  // switch whose labels are all literals. Numbers that are integers close
+  // together are looked up in an array, anything else in a hash table.
+  class SwitchTable {
+  public:
+    // returns 0 if one of the labels is not a literal
+    static SwitchTable *create(ClauseListNode *list1, ClauseListNode *list2);
+    ~SwitchTable();
+
+    // sets before to the first clause with the value before the default
+    // clause and after to the first one after it, or to 0
+    void find(ExecState *exec, const Value &v, ClauseListNode *&before, ClauseListNode *&after) const;
+
+  private:
+    struct Entry {
+      Constant label;
+      ClauseListNode *before;
+      ClauseListNode *after;
+    };
+
+    SwitchTable(int clauseCount);
+    bool add(ClauseListNode *clause, bool afterDefault);
+    Entry **lookup(const Constant &label) const;
+    void makeDense();
+
+    Entry *entries;
+    int count;
+    // open addressing, the size is a power of two at least twice count
+    Entry **buckets;
+    int bucketMask;
+    // if all labels are integers in a small range; dense[i] has the label
+    // denseMin + i
+    Entry **dense;
+    int denseMin;
+    int denseSize;
+  };
+};
+
+// casting a double that does not fit in an int is undefined, so the range
+// is checked first
+static inline bool isInt(double d)
+{
+  return d >= INT_MIN && d <= INT_MAX && d == static_cast<int>(d);
+}
+
+static unsigned hashConstant(const Constant &c)
+{
+  switch (c.type) {
+  case NumberType: {
+    // integers hash to themselves so that close labels spread out
+    if (isInt(c.number))
+      return static_cast<unsigned>(static_cast<int>(c.number));
+    unsigned words[2];
+    memcpy(words, &c.number, sizeof(words));
+    return words[0] ^ (words[1] * 31);
+  }
+  case StringType: {
+    unsigned h = 0;
+    for (int i = 0; i < c.string.size(); i++)
+      h = h * 31 + c.string[i].uc;
+    return h;
+  }
+  case BooleanType:
+    return c.boolean;
+  default:
+    return 0;
+  }
+}
+
+static bool sameConstant(const Constant &c1, const Constant &c2)
+{
+  if (c1.type != c2.type)
+    return false;
+  switch (c1.type) {
+  case NumberType:
+    return c1.number == c2.number;
+  case StringType:
+    return c1.string == c2.string;
+  case BooleanType:
+    return c1.boolean == c2.boolean;
+  default:
+    return true;
+  }
+}
+
+SwitchTable::SwitchTable(int clauseCount)
+  : count(0), dense(0), denseMin(0), denseSize(0)
+{
+  entries = new Entry[clauseCount];
+  int size = 8;
+  while (size < 2 * clauseCount)
+    size *= 2;
+  buckets = new Entry *[size];
+  memset(buckets, 0, size * sizeof(Entry *));
+  bucketMask = size - 1;
+}
+
+SwitchTable::~SwitchTable()
+{
+  delete [] entries;
+  delete [] buckets;
+  delete [] dense;
+}
+
+SwitchTable *SwitchTable::create(ClauseListNode *list1, ClauseListNode *list2)
+{
+  int clauseCount = 0;
+  for (ClauseListNode *l = list1; l; l = l->next())
+    clauseCount++;
+  for (ClauseListNode *l = list2; l; l = l->next())
+    clauseCount++;
+  if (clauseCount == 0)
+    return 0;
+
+  SwitchTable *table = new SwitchTable(clauseCount);
+  for (ClauseListNode *l = list1; l; l = l->next()) {
+    if (!table->add(l, false)) {
+      delete table;
+      return 0;
+    }
+  }
+  for (ClauseListNode *l = list2; l; l = l->next()) {
+    if (!table->add(l, true)) {
+      delete table;
+      return 0;
+    }
+  }
+  table->makeDense();
+  return table;
+}
+
+bool SwitchTable::add(ClauseListNode *clause, bool afterDefault)
+{
+  Constant label;
+  if (!clause->clause()->expression()->constantValue(label))
+    return false;
+  if (label.type == NumberType) {
+    // NaN equals nothing, and -0 === 0
+    if (isNaN(label.number))
+      return true;
+    if (label.number == 0)
+      label.number = 0;
+  }
+
+  Entry **bucket = lookup(label);
+  Entry *entry = *bucket;
+  if (!entry) {
+    entry = &entries[count++];
+    entry->label = label;
+    entry->before = 0;
+    entry->after = 0;
+    *bucket = entry;
+  }
+  // the first clause with a label wins, as when they are tried in order
+  if (afterDefault) {
+    if (!entry->after)
+      entry->after = clause;
+  } else if (!entry->before) {
+    entry->before = clause;
+  }
+  return true;
+}
+
+SwitchTable::Entry **SwitchTable::lookup(const Constant &label) const
+{
+  unsigned i = hashConstant(label) & bucketMask;
+  while (buckets[i] && !sameConstant(buckets[i]->label, label))
+    i = (i + 1) & bucketMask;
+  return &buckets[i];
+}
+
+void SwitchTable::makeDense()
+{
+  if (count == 0)
+    return;
+  double min = 0, max = 0;
+  for (int i = 0; i < count; i++) {
+    const Constant &label = entries[i].label;
+    if (label.type != NumberType || !isInt(label.number))
+      return;
+    if (i == 0 || label.number < min)
+      min = label.number;
+    if (i == 0 || label.number > max)
+      max = label.number;
+  }
+  // at most about half of the array is left empty
+  if (max - min >= 2 * count + 8)
+    return;
+
+  denseMin = static_cast<int>(min);
+  denseSize = static_cast<int>(max - min) + 1;
+  dense = new Entry *[denseSize];
+  memset(dense, 0, denseSize * sizeof(Entry *));
+  for (int i = 0; i < count; i++)
+    dense[static_cast<int>(entries[i].label.number) - denseMin] = &entries[i];
+}
+
+void SwitchTable::find(ExecState *exec, const Value &v, ClauseListNode *&before, ClauseListNode *&after) const
+{
+  before = 0;
+  after = 0;
+
+  Constant key;
+  key.type = v.type();
+  switch (key.type) {
+  case NumberType:
+    key.number = v.toNumber(exec);
+    if (dense) {
+      double index = key.number - denseMin;
+      if (index >= 0 && index < denseSize && isInt(index)) {
+        if (const Entry *entry = dense[static_cast<int>(index)]) {
+          before = entry->before;
+          after = entry->after;
+        }
+      }
+      return;
+    }
+    if (isNaN(key.number))
+      return;
+    if (key.number == 0)
+      key.number = 0;
+    break;
+  case StringType:
+    key.string = v.toString(exec);
+    break;
+  case BooleanType:
+    key.boolean = v.toBoolean(exec);
+    break;
+  case NullType:
+    break;
+  default:
+    // undefined and objects are never strictly equal to a literal
+    return;
+  }
+
+  if (const Entry *entry = *lookup(key)) {
+    before = entry->before;
+    after = entry->after;
+  }
+}
+
 // ------------------------------ CaseBlockNode --------------------------------
 
 CaseBlockNode::CaseBlockNode(ClauseListNode *l1, CaseClauseNode *d,
@@ -2327,30 +1901,16 @@ CaseBlockNode::CaseBlockNode(ClauseListNode *l1, CaseClauseNode *d,
   } else {
     list2 = 0;
   }
-}
- 
-void CaseBlockNode::ref()
-{
-  Node::ref();
-  if ( def )
-    def->ref();
-  if ( list1 )
-    list1->ref();
-  if ( list2 )
-    list2->ref();
+
+  table = 0;
+  triedTable = false;
 }
 
-bool CaseBlockNode::deref()
+CaseBlockNode::~CaseBlockNode()
 {
-  if ( def && def->deref() )
-    delete def;
-  if ( list1 && list1->deref() )
-    delete list1;
-  if ( list2 && list2->deref() )
-    delete list2;
-  return Node::deref();
+  delete table;
 }
-
+ 
 Value CaseBlockNode::evaluate(ExecState */*exec*/)
 {
   /* should never be called */
@@ -2366,6 +1926,36 @@ Completion CaseBlockNode::evalBlock(ExecState *exec, const Value& input)
   ClauseListNode *a = list1, *b = list2;
   CaseClauseNode *clause;
 
+  if (!triedTable) {
+    table = SwitchTable::create(list1, list2);
+    triedTable = true;
+  }
+  if (table) {
+    // the labels are all literals, so looking the input up finds the same
+    // clauses as evaluating and comparing them one by one
+    table->find(exec, input, a, b);
+    for (; a; a = a->next()) {
+      res = a->clause()->evalStatements(exec);
+      if (res.complType() != Normal)
+        return res;
+    }
+    if (!b) {
+      if (def) {
+        res = def->evalStatements(exec);
+        if (res.complType() != Normal)
+          return res;
+      }
+      b = list2;
+    }
+    for (; b; b = b->next()) {
+      res = b->clause()->evalStatements(exec);
+      if (res.complType() != Normal)
+        return res;
+    }
+    KJS_CHECKEXCEPTION
+    return Completion(Normal);
+  }
+
     while (a) {
       clause = a->clause();
       a = a->next();
@@ -2432,24 +2022,6 @@ void CaseBlockNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ SwitchNode -----------------------------------
 
-void SwitchNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-  if ( block )
-    block->ref();
-}
-
-bool SwitchNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  if ( block && block->deref() )
-    delete block;
-  return Node::deref();
-}
-
 // ECMA 12.11
 Completion SwitchNode::execute(ExecState *exec)
 {
@@ -2472,20 +2044,6 @@ void SwitchNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ LabelNode ------------------------------------
 
-void LabelNode::ref()
-{
-  Node::ref();
-  if ( statement )
-    statement->ref();
-}
-
-bool LabelNode::deref()
-{
-  if ( statement && statement->deref() )
-    delete statement;
-  return Node::deref();
-}
-
 // ECMA 12.12
 Completion LabelNode::execute(ExecState *exec)
 {
@@ -2511,20 +2069,6 @@ void LabelNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ ThrowNode ------------------------------------
 
-void ThrowNode::ref()
-{
-  Node::ref();
-  if ( expr )
-    expr->ref();
-}
-
-bool ThrowNode::deref()
-{
-  if ( expr && expr->deref() )
-    delete expr;
-  return Node::deref();
-}
-
 // ECMA 12.13
 Completion ThrowNode::execute(ExecState *exec)
 {
@@ -2541,20 +2085,6 @@ Completion ThrowNode::execute(ExecState *exec)
 
 // ------------------------------ CatchNode ------------------------------------
 
-void CatchNode::ref()
-{
-  Node::ref();
-  if ( block )
-    block->ref();
-}
-
-bool CatchNode::deref()
-{
-  if ( block && block->deref() )
-    delete block;
-  return Node::deref();
-}
-
 Completion CatchNode::execute(ExecState */*exec*/)
 {
   // should never be reached. execute(exec, arg) is used instead
@@ -2585,20 +2115,6 @@ void CatchNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ FinallyNode ----------------------------------
 
-void FinallyNode::ref()
-{
-  Node::ref();
-  if ( block )
-    block->ref();
-}
-
-bool FinallyNode::deref()
-{
-  if ( block && block->deref() )
-    delete block;
-  return Node::deref();
-}
-
 // ECMA 12.14
 Completion FinallyNode::execute(ExecState *exec)
 {
@@ -2612,28 +2128,6 @@ void FinallyNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ TryNode --------------------------------------
 
-void TryNode::ref()
-{
-  Node::ref();
-  if ( block )
-    block->ref();
-  if ( _final )
-    _final->ref();
-  if ( _catch )
-    _catch->ref();
-}
-
-bool TryNode::deref()
-{
-  if ( block && block->deref() )
-    delete block;
-  if ( _final && _final->deref() )
-    delete _final;
-  if ( _catch && _catch->deref() )
-    delete _catch;
-  return Node::deref();
-}
-
 // ECMA 12.14
 Completion TryNode::execute(ExecState *exec)
 {
@@ -2672,23 +2166,6 @@ void TryNode::processVarDecls(ExecState *exec)
 
 // ------------------------------ ParameterNode --------------------------------
 
-void ParameterNode::ref()
-{
-  for (ParameterNode *n = this; n; n = n->next)
-    n->Node::ref();
-}
-
-bool ParameterNode::deref()
-{
-  ParameterNode *next;
-  for (ParameterNode *n = this; n; n = next) {
-    next = n->next;
-    if (n != this && n->Node::deref())
-      delete n;
-  }
-  return Node::deref();
-}
-
 // ECMA 13
 Value ParameterNode::evaluate(ExecState */*exec*/)
 {
@@ -2697,39 +2174,150 @@ Value ParameterNode::evaluate(ExecState */*exec*/)
 
 // ------------------------------ FunctionBodyNode -----------------------------
 
+FunctionBodyNode *FunctionBodyNode::parsedLazyBodies = 0;
+
 FunctionBodyNode::FunctionBodyNode(SourceElementsNode *s)
-  : BlockNode(s)
+  : BlockNode(s), arena(Parser::curr()->arena), lazy(0), sourceProvider(0), sourceStart(0), sourceEnd(0)
 {
   setLoc(-1, -1, -1);
   //fprintf(stderr,"FunctionBodyNode::FunctionBodyNode %p\n",this);
 }
 
-void FunctionBodyNode::processFuncDecl(ExecState *exec)
+FunctionBodyNode::FunctionBodyNode(const LazyFunctionBody &body)
+  : BlockNode(0), arena(Parser::curr()->arena), lazy(new LazyFunctionBody(body)),
+    sourceProvider(0), sourceStart(0), sourceEnd(0)
 {
-  if (source)
-    source->processFuncDecl(exec);
+  setLoc(-1, -1, -1);
+  lazy->source->ref();
+  lazy->program = 0;
+  lazy->activeCount = 0;
+  lazy->recentlyUsed = false;
+  lazy->prev = 0;
+  lazy->next = 0;
 }
 
-// ------------------------------ FuncDeclNode ---------------------------------
+FunctionBodyNode::~FunctionBodyNode()
+{
+  if (lazy) {
+    discardLazyBody();
+    lazy->source->deref();
+    delete lazy;
+  }
+  if (sourceProvider)
+    sourceProvider->deref();
+}
+
+void FunctionBodyNode::setSource(SourceProvider *source, int start, int end)
+{
+  source->ref();
+  if (sourceProvider)
+    sourceProvider->deref();
+  sourceProvider = source;
+  sourceStart = start;
+  sourceEnd = end;
+}
+
+UString FunctionBodyNode::sourceText() const
+{
+  if (!sourceProvider)
+    return UString();
+  return sourceProvider->substring(sourceStart, sourceEnd);
+}
+
+void FunctionBodyNode::ref()
+{
+  arena->ref();
+}
+
+void FunctionBodyNode::deref()
+{
+  arena->deref();
+}
+
+// The tree of a lazy body has an arena of its own, so that it can be
+// dropped no matter how often the body itself is referenced.
+bool FunctionBodyNode::parseLazyBody()
+{
+  if (!lazy || lazy->program)
+    return true;
+
+  ProgramNode *prog = Parser::parseFunctionBody(sourceURL, *lazy);
+  if (!prog)
+    return false;
+
+  prog->ref();
+  lazy->program = prog;
+  source = prog->source;
+
+  lazy->prev = 0;
+  lazy->next = parsedLazyBodies;
+  if (parsedLazyBodies)
+    parsedLazyBodies->lazy->prev = this;
+  parsedLazyBodies = this;
+  return true;
+}
+
+void FunctionBodyNode::discardLazyBody()
+{
+  if (!lazy->program)
+    return;
+
+  if (lazy->prev)
+    lazy->prev->lazy->next = lazy->next;
+  else
+    parsedLazyBodies = lazy->next;
+  if (lazy->next)
+    lazy->next->lazy->prev = lazy->prev;
+
+  source = 0;
+  lazy->program->deref();
+  lazy->program = 0;
+}
+
+void FunctionBodyNode::discardUnusedBodies()
+{
+  FunctionBodyNode *next;
+  for (FunctionBodyNode *n = parsedLazyBodies; n; n = next) {
+    next = n->lazy->next;
+    if (n->lazy->activeCount == 0 && !n->lazy->recentlyUsed)
+      n->discardLazyBody();
+    else
+      n->lazy->recentlyUsed = false;
+  }
+}
+
+Completion FunctionBodyNode::execute(ExecState *exec)
+{
+  if (!lazy)
+    return BlockNode::execute(exec);
 
-void FuncDeclNode::ref()
+  if (!parseLazyBody())
+    return Completion(Throw, throwError(exec, SyntaxError, "Parse error in function body"));
+
+  lazy->recentlyUsed = true;
+  lazy->activeCount++;
+  Completion c = BlockNode::execute(exec);
+  lazy->activeCount--;
+  return c;
+}
+
+void FunctionBodyNode::processVarDecls(ExecState *exec)
 {
-  Node::ref();
-  if ( param )
-    param->ref();
-  if ( body )
-    body->ref();
+  // a parse error is reported by execute()
+  if (parseLazyBody())
+    BlockNode::processVarDecls(exec);
 }
 
-bool FuncDeclNode::deref()
+void FunctionBodyNode::processFuncDecl(ExecState *exec)
 {
-  if ( param && param->deref() )
-    delete param;
-  if ( body && body->deref() )
-    delete body;
-  return Node::deref();
+  if (lazy && (!lazy->hasFunctionDeclarations || !parseLazyBody()))
+    return;
+  if (source)
+    source->processFuncDecl(exec);
 }
 
+// ------------------------------ FuncDeclNode ---------------------------------
+
 // ECMA 13
 void FuncDeclNode::processFuncDecl(ExecState *exec)
 {
@@ -2765,24 +2353,6 @@ void FuncDeclNode::processFuncDecl(ExecState *exec)
 
 // ------------------------------ FuncExprNode ---------------------------------
 
-void FuncExprNode::ref()
-{
-  Node::ref();
-  if ( param )
-    param->ref();
-  if ( body )
-    body->ref();
-}
-
-bool FuncExprNode::deref()
-{
-  if ( param && param->deref() )
-    delete param;
-  if ( body && body->deref() )
-    delete body;
-  return Node::deref();
-}
-
 
 // ECMA 13
 Value FuncExprNode::evaluate(ExecState *exec)
@@ -2815,28 +2385,6 @@ SourceElementsNode::SourceElementsNode(SourceElementsNode *s1, StatementNode *s2
   setLoc(s1->firstLine(), s2->lastLine(), s1->sourceId());
 }
 
-void SourceElementsNode::ref()
-{
-  for (SourceElementsNode *n = this; n; n = n->elements) {
-    n->Node::ref();
-    if (n->element)
-      n->element->ref();
-  }
-}
-
-bool SourceElementsNode::deref()
-{
-  SourceElementsNode *next;
-  for (SourceElementsNode *n = this; n; n = next) {
-    next = n->elements;
-    if (n->element && n->element->deref())
-      delete n->element;
-    if (n != this && n->Node::deref())
-      delete n;
-  }
-  return Node::deref();
-}
-
 // ECMA 14
 Completion SourceElementsNode::execute(ExecState *exec)
 {
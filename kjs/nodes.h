@@ -38,7 +38,13 @@ namespace KJS {
   class RegExp;
   class SourceElementsNode;
   class ProgramNode;
+  class NodeArena;
   class SourceStream;
+  class SnapshotWriter;
+  class Optimizer;
+  struct Constant;
+  class SwitchTable;
+  class SourceProvider;
   class PropertyValueNode;
   class PropertyNode;
 
@@ -81,18 +87,30 @@ namespace KJS {
     virtual Reference evaluateReference(ExecState *exec);
     UString toString() const;
     virtual void streamTo(SourceStream &s) const = 0;
+    virtual void writeTo(SnapshotWriter &s) const = 0;
     virtual void processVarDecls(ExecState */*exec*/) {}
     int lineNo() const { return line; }
 
-  public:
-    // reference counting mechanism
-    virtual void ref() { refcount++; }
-#ifdef KJS_DEBUG_MEM
-    virtual bool deref() { assert( refcount > 0 ); return (!--refcount); }
-#else
-    virtual bool deref() { return (!--refcount); }
-#endif
-
+    /**
+     * Simplifies the tree below the node once it is parsed and returns the
+     * node to use in its place, which is the node itself unless the node
+     * could be computed while parsing. See @ref Optimizer.
+     */
+    virtual Node *optimize(Optimizer &/*o*/) { return this; }
+    /**
+     * Stores the value of the node in c if the node is a literal the
+     * @ref Optimizer can compute with: null, a boolean, a number or a
+     * string.
+     */
+    virtual bool constantValue(Constant &/*c*/) const { return false; }
+
+    /**
+     * Nodes are allocated from the @ref NodeArena of the parse that creates
+     * them and are only freed together with it; the trees are kept alive by
+     * referencing their @ref FunctionBodyNode or @ref ProgramNode.
+     */
+    static void *operator new(size_t size);
+    static void operator delete(void */*node*/) { }
 
 #ifdef KJS_DEBUG_MEM
     static void finalCheck();
@@ -103,9 +121,10 @@ namespace KJS {
     Value throwError(ExecState *exec, ErrorType e, const char *msg, Identifier label);
     int line;
     UString sourceURL;
-    unsigned int refcount;
     virtual int sourceId() const { return -1; }
   private:
+    friend class SnapshotReader;
+    friend class Optimizer;
 #ifdef KJS_DEBUG_MEM
     // List of all nodes, for debugging purposes. Don't remove!
     static std::list<Node *> *s_nodes;
@@ -125,6 +144,7 @@ namespace KJS {
     bool hitStatement(ExecState *exec);
     bool abortStatement(ExecState *exec);
     virtual Completion execute(ExecState *exec) = 0;
+    virtual StatementNode *optimize(Optimizer &/*o*/) { return this; }
     void pushLabel(const Identifier &id) { ls.push(id); }
     virtual void processFuncDecl(ExecState *exec);
   protected:
@@ -141,6 +161,8 @@ namespace KJS {
     NullNode() {}
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual bool constantValue(Constant &c) const;
   };
 
   class BooleanNode : public Node {
@@ -148,6 +170,8 @@ namespace KJS {
     BooleanNode(bool v) : value(v) {}
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual bool constantValue(Constant &c) const;
   private:
     bool value;
   };
@@ -157,8 +181,13 @@ namespace KJS {
     NumberNode(double v) : value(v) { }
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual bool constantValue(Constant &c) const;
   private:
     double value;
+    // the value is only made when the node is first evaluated, since
+    // parsing may happen without the interpreter lock
+    ProtectedValue cachedValue;
   };
 
   class StringNode : public Node {
@@ -166,8 +195,11 @@ namespace KJS {
     StringNode(const UString *v) { value = *v; }
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual bool constantValue(Constant &c) const;
   private:
     UString value;
+    ProtectedValue cachedValue;
   };
 
   class RegExpNode : public Node {
@@ -176,6 +208,7 @@ namespace KJS {
       : pattern(p), flags(f) { }
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
   private:
     UString pattern, flags;
   };
@@ -185,6 +218,7 @@ namespace KJS {
     ThisNode() {}
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
   };
 
   class ResolveNode : public Node {
@@ -193,6 +227,7 @@ namespace KJS {
     Value evaluate(ExecState *exec);
     virtual Reference evaluateReference(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
   private:
     Identifier ident;
   };
@@ -200,10 +235,10 @@ namespace KJS {
   class GroupNode : public Node {
   public:
     GroupNode(Node *g) : group(g) { }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const { group->streamTo(s); }
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *group;
   };
@@ -214,10 +249,10 @@ namespace KJS {
     ElementNode(int e, Node *n) : list(this), elision(e), node(n) { }
     ElementNode(ElementNode *l, int e, Node *n)
       : list(l->list), elision(e), node(n) { l->list = this; }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     friend class ArrayNode;
     ElementNode *list;
@@ -232,10 +267,10 @@ namespace KJS {
       : element(ele->list), elision(0), opt(false) { ele->list = 0; }
     ArrayNode(int eli, ElementNode *ele)
       : element(ele->list), elision(eli), opt(true) { ele->list = 0; }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     ElementNode *element;
     int elision;
@@ -249,10 +284,10 @@ namespace KJS {
       : name(n), assign(a), list(this) { }
     PropertyValueNode(PropertyNode *n, Node *a, PropertyValueNode *l)
       : name(n), assign(a), list(l->list) { l->list = this; }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     friend class ObjectLiteralNode;
     PropertyNode *name;
@@ -264,10 +299,10 @@ namespace KJS {
   public:
     ObjectLiteralNode() : list(0) { }
     ObjectLiteralNode(PropertyValueNode *l) : list(l->list) { l->list = 0; }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     PropertyValueNode *list;
   };
@@ -278,6 +313,7 @@ namespace KJS {
     PropertyNode(const Identifier &s) : str(s) { }
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
   private:
     double numeric;
     Identifier str;
@@ -286,11 +322,11 @@ namespace KJS {
   class AccessorNode1 : public Node {
   public:
     AccessorNode1(Node *e1, Node *e2) : expr1(e1), expr2(e2) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual Reference evaluateReference(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr1;
     Node *expr2;
@@ -299,11 +335,11 @@ namespace KJS {
   class AccessorNode2 : public Node {
   public:
     AccessorNode2(Node *e, const Identifier &s) : expr(e), ident(s) { }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual Reference evaluateReference(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
     Identifier ident;
@@ -315,11 +351,11 @@ namespace KJS {
     ArgumentListNode(Node *e) : list(this), expr(e) { }
     ArgumentListNode(ArgumentListNode *l, Node *e)
       : list(l->list), expr(e) { l->list = this; }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     List evaluateList(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     friend class ArgumentsNode;
     ArgumentListNode *list;
@@ -331,11 +367,11 @@ namespace KJS {
     ArgumentsNode() : list(0) { }
     ArgumentsNode(ArgumentListNode *l)
       : list(l->list) { l->list = 0; }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     List evaluateList(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     ArgumentListNode *list;
   };
@@ -344,10 +380,10 @@ namespace KJS {
   public:
     NewExprNode(Node *e) : expr(e), args(0) {}
     NewExprNode(Node *e, ArgumentsNode *a) : expr(e), args(a) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
     ArgumentsNode *args;
@@ -356,10 +392,10 @@ namespace KJS {
   class FunctionCallNode : public Node {
   public:
     FunctionCallNode(Node *e, ArgumentsNode *a) : expr(e), args(a) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
     ArgumentsNode *args;
@@ -368,10 +404,10 @@ namespace KJS {
   class PostfixNode : public Node {
   public:
     PostfixNode(Node *e, Operator o) : expr(e), oper(o) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
     Operator oper;
@@ -380,10 +416,10 @@ namespace KJS {
   class DeleteNode : public Node {
   public:
     DeleteNode(Node *e) : expr(e) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
   };
@@ -391,10 +427,10 @@ namespace KJS {
   class VoidNode : public Node {
   public:
     VoidNode(Node *e) : expr(e) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
   };
@@ -402,10 +438,10 @@ namespace KJS {
   class TypeOfNode : public Node {
   public:
     TypeOfNode(Node *e) : expr(e) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
   };
@@ -413,10 +449,10 @@ namespace KJS {
   class PrefixNode : public Node {
   public:
     PrefixNode(Operator o, Node *e) : oper(o), expr(e) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Operator oper;
     Node *expr;
@@ -425,10 +461,10 @@ namespace KJS {
   class UnaryPlusNode : public Node {
   public:
     UnaryPlusNode(Node *e) : expr(e) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
   };
@@ -436,10 +472,10 @@ namespace KJS {
   class NegateNode : public Node {
   public:
     NegateNode(Node *e) : expr(e) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
   };
@@ -447,10 +483,10 @@ namespace KJS {
   class BitwiseNotNode : public Node {
   public:
     BitwiseNotNode(Node *e) : expr(e) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
   };
@@ -458,10 +494,10 @@ namespace KJS {
   class LogicalNotNode : public Node {
   public:
     LogicalNotNode(Node *e) : expr(e) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
   };
@@ -469,10 +505,10 @@ namespace KJS {
   class MultNode : public Node {
   public:
     MultNode(Node *t1, Node *t2, char op) : term1(t1), term2(t2), oper(op) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *term1, *term2;
     char oper;
@@ -481,10 +517,10 @@ namespace KJS {
   class AddNode : public Node {
   public:
     AddNode(Node *t1, Node *t2, char op) : term1(t1), term2(t2), oper(op) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *term1, *term2;
     char oper;
@@ -494,10 +530,10 @@ namespace KJS {
   public:
     ShiftNode(Node *t1, Operator o, Node *t2)
       : term1(t1), term2(t2), oper(o) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *term1, *term2;
     Operator oper;
@@ -507,10 +543,10 @@ namespace KJS {
   public:
     RelationalNode(Node *e1, Operator o, Node *e2) :
       expr1(e1), expr2(e2), oper(o) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr1, *expr2;
     Operator oper;
@@ -520,10 +556,10 @@ namespace KJS {
   public:
     EqualNode(Node *e1, Operator o, Node *e2)
       : expr1(e1), expr2(e2), oper(o) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr1, *expr2;
     Operator oper;
@@ -533,10 +569,10 @@ namespace KJS {
   public:
     BitOperNode(Node *e1, Operator o, Node *e2) :
       expr1(e1), expr2(e2), oper(o) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr1, *expr2;
     Operator oper;
@@ -549,10 +585,10 @@ namespace KJS {
   public:
     BinaryLogicalNode(Node *e1, Operator o, Node *e2) :
       expr1(e1), expr2(e2), oper(o) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr1, *expr2;
     Operator oper;
@@ -565,10 +601,10 @@ namespace KJS {
   public:
     ConditionalNode(Node *l, Node *e1, Node *e2) :
       logical(l), expr1(e1), expr2(e2) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *logical, *expr1, *expr2;
   };
@@ -576,10 +612,10 @@ namespace KJS {
   class AssignNode : public Node {
   public:
     AssignNode(Node *l, Operator o, Node *e) : left(l), oper(o), expr(e) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *left;
     Operator oper;
@@ -589,10 +625,10 @@ namespace KJS {
   class CommaNode : public Node {
   public:
     CommaNode(Node *e1, Node *e2) : expr1(e1), expr2(e2) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr1, *expr2;
   };
@@ -602,11 +638,11 @@ namespace KJS {
     // list pointer is tail of a circular list, cracked in the CaseClauseNode ctor
     StatListNode(StatementNode *s);
     StatListNode(StatListNode *l, StatementNode *s);
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     friend class CaseClauseNode;
     StatementNode *statement;
@@ -616,10 +652,10 @@ namespace KJS {
   class AssignExprNode : public Node {
   public:
     AssignExprNode(Node *e) : expr(e) {}
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
   };
@@ -627,11 +663,11 @@ namespace KJS {
   class VarDeclNode : public Node {
   public:
     VarDeclNode(const Identifier &id, AssignExprNode *in);
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Identifier ident;
     AssignExprNode *init;
@@ -643,11 +679,11 @@ namespace KJS {
     VarDeclListNode(VarDeclNode *v) : list(this), var(v) {}
     VarDeclListNode(VarDeclListNode *l, VarDeclNode *v)
       : list(l->list), var(v) { l->list = this; }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     friend class ForNode;
     friend class VarStatementNode;
@@ -659,11 +695,11 @@ namespace KJS {
   public:
     VarStatementNode(VarDeclListNode *l)
       : list(l->list) { l->list = 0; }
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     VarDeclListNode *list;
   };
@@ -671,11 +707,11 @@ namespace KJS {
   class BlockNode : public StatementNode {
   public:
     BlockNode(SourceElementsNode *s);
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   protected:
     SourceElementsNode *source;
   };
@@ -685,15 +721,16 @@ namespace KJS {
     EmptyStatementNode() { } // debug
     virtual Completion execute(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
   };
 
   class ExprStatementNode : public StatementNode {
   public:
     ExprStatementNode(Node *e) : expr(e) { }
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     Node *expr;
   };
@@ -702,11 +739,11 @@ namespace KJS {
   public:
     IfNode(Node *e, StatementNode *s1, StatementNode *s2)
       : expr(e), statement1(s1), statement2(s2) {}
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     Node *expr;
     StatementNode *statement1, *statement2;
@@ -715,11 +752,11 @@ namespace KJS {
   class DoWhileNode : public StatementNode {
   public:
     DoWhileNode(StatementNode *s, Node *e) : statement(s), expr(e) {}
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     StatementNode *statement;
     Node *expr;
@@ -728,11 +765,11 @@ namespace KJS {
   class WhileNode : public StatementNode {
   public:
     WhileNode(Node *e, StatementNode *s) : expr(e), statement(s) {}
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     Node *expr;
     StatementNode *statement;
@@ -744,11 +781,11 @@ namespace KJS {
       expr1(e1), expr2(e2), expr3(e3), statement(s) {}
     ForNode(VarDeclListNode *e1, Node *e2, Node *e3, StatementNode *s) :
       expr1(e1->list), expr2(e2), expr3(e3), statement(s) { e1->list = 0; }
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     Node *expr1, *expr2, *expr3;
     StatementNode *statement;
@@ -758,11 +795,11 @@ namespace KJS {
   public:
     ForInNode(Node *l, Node *e, StatementNode *s);
     ForInNode(const Identifier &i, AssignExprNode *in, Node *e, StatementNode *s);
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     Identifier ident;
     AssignExprNode *init;
@@ -777,6 +814,7 @@ namespace KJS {
     ContinueNode(const Identifier &i) : ident(i) { }
     virtual Completion execute(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
   private:
     Identifier ident;
   };
@@ -787,6 +825,7 @@ namespace KJS {
     BreakNode(const Identifier &i) : ident(i) { }
     virtual Completion execute(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
   private:
     Identifier ident;
   };
@@ -794,10 +833,10 @@ namespace KJS {
   class ReturnNode : public StatementNode {
   public:
     ReturnNode(Node *v) : value(v) {}
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     Node *value;
   };
@@ -805,11 +844,11 @@ namespace KJS {
   class WithNode : public StatementNode {
   public:
     WithNode(Node *e, StatementNode *s) : expr(e), statement(s) {}
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     Node *expr;
     StatementNode *statement;
@@ -820,12 +859,14 @@ namespace KJS {
     CaseClauseNode(Node *e) : expr(e), list(0) { }
     CaseClauseNode(Node *e, StatListNode *l)
       : expr(e), list(l->list) { l->list = 0; }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     Completion evalStatements(ExecState *exec);
+    // the expression of the label, 0 for the default clause
+    Node *expression() const { return expr; }
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     Node *expr;
     StatListNode *list;
@@ -837,13 +878,13 @@ namespace KJS {
     ClauseListNode(CaseClauseNode *c) : cl(c), nx(this) { }
     ClauseListNode(ClauseListNode *n, CaseClauseNode *c)
       : cl(c), nx(n->nx) { n->nx = this; }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     CaseClauseNode *clause() const { return cl; }
     ClauseListNode *next() const { return nx; }
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     friend class CaseBlockNode;
     CaseClauseNode *cl;
@@ -853,26 +894,30 @@ namespace KJS {
   class CaseBlockNode : public Node {
   public:
     CaseBlockNode(ClauseListNode *l1, CaseClauseNode *d, ClauseListNode *l2);
-    virtual void ref();
-    virtual bool deref();
+    virtual ~CaseBlockNode();
     Value evaluate(ExecState *exec);
     Completion evalBlock(ExecState *exec, const Value& input);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     ClauseListNode *list1;
     CaseClauseNode *def;
     ClauseListNode *list2;
+    // made when the switch first runs if all the labels are literals
+    SwitchTable *table;
+    bool triedTable;
   };
 
   class SwitchNode : public StatementNode {
   public:
     SwitchNode(Node *e, CaseBlockNode *b) : expr(e), block(b) { }
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     Node *expr;
     CaseBlockNode *block;
@@ -881,11 +926,11 @@ namespace KJS {
   class LabelNode : public StatementNode {
   public:
     LabelNode(const Identifier &l, StatementNode *s) : label(l), statement(s) { }
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     Identifier label;
     StatementNode *statement;
@@ -894,10 +939,10 @@ namespace KJS {
   class ThrowNode : public StatementNode {
   public:
     ThrowNode(Node *e) : expr(e) {}
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     Node *expr;
   };
@@ -905,12 +950,12 @@ namespace KJS {
   class CatchNode : public StatementNode {
   public:
     CatchNode(const Identifier &i, StatementNode *b) : ident(i), block(b) {}
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     Completion execute(ExecState *exec, const Value &arg);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     Identifier ident;
     StatementNode *block;
@@ -919,11 +964,11 @@ namespace KJS {
   class FinallyNode : public StatementNode {
   public:
     FinallyNode(StatementNode *b) : block(b) {}
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     StatementNode *block;
   };
@@ -936,11 +981,11 @@ namespace KJS {
       : block(b), _catch(0), _final(f) {}
     TryNode(StatementNode *b, CatchNode *c, FinallyNode *f)
       : block(b), _catch(c), _final(f) {}
-    virtual void ref();
-    virtual bool deref();
     virtual Completion execute(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     StatementNode *block;
     CatchNode *_catch;
@@ -953,12 +998,11 @@ namespace KJS {
     ParameterNode(const Identifier &i) : id(i), next(this) { }
     ParameterNode(ParameterNode *list, const Identifier &i)
       : id(i), next(list->next) { list->next = this; }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     Identifier ident() { return id; }
     ParameterNode *nextParam() { return next; }
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
   private:
     friend class FuncDeclNode;
     friend class FuncExprNode;
@@ -966,11 +1010,79 @@ namespace KJS {
     ParameterNode *next;
   };
 
+  /**
+   * @internal
+   *
+   * Where to find the text of a function body that was only checked for
+   * syntax errors, see @ref DescentParser.
+   */
+  struct LazyFunctionBody {
+    // the whole script the body was found in, referenced by the body node;
+    // start and length are offsets in it
+    SourceProvider *source;
+    int start;
+    int length;
+    int startingLineNumber;
+    int sourceId;
+    bool hasFunctionDeclarations;
+
+    // the tree of the body while it is parsed
+    ProgramNode *program;
+    // calls of the function that are still running
+    int activeCount;
+    bool recentlyUsed;
+    // list of the bodies that are currently parsed
+    FunctionBodyNode *prev;
+    FunctionBodyNode *next;
+  };
+
   // inherited by ProgramNode
   class FunctionBodyNode : public BlockNode {
   public:
     FunctionBodyNode(SourceElementsNode *s);
+    /**
+     * Creates a body that is parsed when it is first needed.
+     */
+    FunctionBodyNode(const LazyFunctionBody &body);
+    virtual ~FunctionBodyNode();
+    /**
+     * References the arena of the tree the body belongs to. The tree and
+     * everything in it is freed when the last reference is dropped.
+     */
+    void ref();
+    void deref();
+    virtual Completion execute(ExecState *exec);
+    virtual void processVarDecls(ExecState *exec);
     void processFuncDecl(ExecState *exec);
+    virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
+
+    /**
+     * Sets where the whole function is found in the text of source, from
+     * "function" up to the closing brace.
+     */
+    void setSource(SourceProvider *source, int start, int end);
+    /**
+     * The text of the function as it was written, or a null string if it is
+     * not known, like for functions made by the Function constructor.
+     */
+    UString sourceText() const;
+
+    /**
+     * Throws away the trees of lazily parsed bodies that have not run since
+     * the last call. They are parsed again if they are called later.
+     */
+    static void discardUnusedBodies();
+  private:
+    bool parseLazyBody();
+    void discardLazyBody();
+
+    NodeArena *arena;
+    LazyFunctionBody *lazy;
+    SourceProvider *sourceProvider;
+    int sourceStart, sourceEnd;
+    static FunctionBodyNode *parsedLazyBodies;
   };
 
   class FuncDeclNode : public StatementNode {
@@ -979,12 +1091,12 @@ namespace KJS {
       : ident(i), param(0), body(b) { }
     FuncDeclNode(const Identifier &i, ParameterNode *p, FunctionBodyNode *b)
       : ident(i), param(p->next), body(b) { p->next = 0; }
-    virtual void ref();
-    virtual bool deref();
     Completion execute(ExecState */*exec*/)
       { /* empty */ return Completion(); }
     void processFuncDecl(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     Identifier ident;
     ParameterNode *param;
@@ -996,10 +1108,10 @@ namespace KJS {
     FuncExprNode(FunctionBodyNode *b) : param(0), body(b) { }
     FuncExprNode(ParameterNode *p, FunctionBodyNode *b)
       : param(p->next), body(b) { p->next = 0; }
-    virtual void ref();
-    virtual bool deref();
     Value evaluate(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual Node *optimize(Optimizer &o);
   private:
     ParameterNode *param;
     FunctionBodyNode *body;
@@ -1011,12 +1123,12 @@ namespace KJS {
     // list pointer is tail of a circular list, cracked in the BlockNode (or subclass) ctor
     SourceElementsNode(StatementNode *s1);
     SourceElementsNode(SourceElementsNode *s1, StatementNode *s2);
-    virtual void ref();
-    virtual bool deref();
     Completion execute(ExecState *exec);
     void processFuncDecl(ExecState *exec);
     virtual void processVarDecls(ExecState *exec);
     virtual void streamTo(SourceStream &s) const;
+    virtual void writeTo(SnapshotWriter &s) const;
+    virtual StatementNode *optimize(Optimizer &o);
   private:
     friend class BlockNode;
     StatementNode *element; // 'this' element
@@ -1026,6 +1138,60 @@ namespace KJS {
   class ProgramNode : public FunctionBodyNode {
   public:
     ProgramNode(SourceElementsNode *s);
+    virtual void writeTo(SnapshotWriter &s) const;
+  };
+
+  /**
+   * @internal
+   *
+   * The value of a literal node, see @ref Node::constantValue. The
+   * conversions follow those of NullImp, BooleanImp, NumberImp and
+   * StringImp, which the nodes use when they are evaluated. No Value is
+   * made, since the parser may run without the interpreter lock and before
+   * any interpreter exists.
+   */
+  struct Constant {
+    Type type;
+    bool boolean;
+    double number;
+    UString string;
+
+    bool toBoolean() const;
+    double toNumber() const;
+    UString toString() const;
+    int32_t toInt32() const;
+    uint32_t toUInt32() const;
+  };
+
+  /**
+   * @internal
+   *
+   * Simplifies the trees built by the parsers before they run. Operators
+   * whose operands are all literals are computed, like 60*60*1000 or
+   * "a" + "b", and so are &&, || and ?: with a literal condition. if
+   * statements with a literal condition are replaced by the branch that
+   * runs.
+   *
+   * Only null, booleans, numbers and strings are computed, with the same
+   * conversions the nodes use when they are evaluated, so the results are
+   * the same and no exception can happen.
+   *
+   * Each node optimizes its children with @ref Node::optimize and replaces
+   * them with what that returns.
+   */
+  class Optimizer {
+  public:
+    Optimizer() : declarations(0) { }
+
+    // literal nodes to use in place of replaced, on the same line
+    static Node *number(double d, Node *replaced);
+    static Node *string(const UString &s, Node *replaced);
+    static Node *boolean(bool b, Node *replaced);
+
+    // number of var and function declarations optimized so far in the
+    // current function; a branch that declares any is never dropped, since
+    // its variables exist whether it runs or not
+    int declarations;
   };
 
 }; // namespace
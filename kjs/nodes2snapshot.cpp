@@ -0,0 +1,1395 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "nodes.h"
+#include "program_snapshot.h"
+#include "source_provider.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace KJS {
+  // Tags of the node types in a snapshot. Changing this list or the layout
+  // written by any writeTo() requires a new ProgramSnapshot format version.
+  enum SnapshotTag {
+    NoNodeTag,
+    NullTag,
+    BooleanTag,
+    NumberTag,
+    StringTag,
+    RegExpTag,
+    ThisTag,
+    ResolveTag,
+    GroupTag,
+    ElementTag,
+    ArrayTag,
+    PropertyValueTag,
+    ObjectLiteralTag,
+    PropertyTag,
+    Accessor1Tag,
+    Accessor2Tag,
+    ArgumentListTag,
+    ArgumentsTag,
+    NewExprTag,
+    FunctionCallTag,
+    PostfixTag,
+    DeleteTag,
+    VoidTag,
+    TypeOfTag,
+    PrefixTag,
+    UnaryPlusTag,
+    NegateTag,
+    BitwiseNotTag,
+    LogicalNotTag,
+    MultTag,
+    AddTag,
+    ShiftTag,
+    RelationalTag,
+    EqualTag,
+    BitOperTag,
+    BinaryLogicalTag,
+    ConditionalTag,
+    AssignTag,
+    CommaTag,
+    StatListTag,
+    AssignExprTag,
+    VarDeclTag,
+    VarDeclListTag,
+    VarStatementTag,
+    BlockTag,
+    EmptyStatementTag,
+    ExprStatementTag,
+    IfTag,
+    DoWhileTag,
+    WhileTag,
+    ForTag,
+    ForInTag,
+    ContinueTag,
+    BreakTag,
+    ReturnTag,
+    WithTag,
+    CaseClauseTag,
+    ClauseListTag,
+    CaseBlockTag,
+    SwitchTag,
+    LabelTag,
+    ThrowTag,
+    CatchTag,
+    FinallyTag,
+    TryTag,
+    ParameterTag,
+    FunctionBodyTag,
+    FuncDeclTag,
+    FuncExprTag,
+    SourceElementsTag,
+    ProgramTag,
+    LazyFunctionBodyTag
+  };
+};
+
+using namespace KJS;
+
+// ------------------------------ SnapshotWriter -------------------------------
+
+SnapshotWriter::SnapshotWriter() : _buffer(0), _size(0), _capacity(0)
+{
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+  free(_buffer);
+}
+
+void SnapshotWriter::writeBytes(const void *data, size_t size)
+{
+  if (_size + size > _capacity) {
+    _capacity = (_size + size) * 2 + 256;
+    _buffer = static_cast<char *>(realloc(_buffer, _capacity));
+  }
+  memcpy(_buffer + _size, data, size);
+  _size += size;
+}
+
+void SnapshotWriter::writeString(const UString &s)
+{
+  // a length of -1 tells a null string from an empty one
+  if (s.isNull()) {
+    writeInt(-1);
+    return;
+  }
+  writeInt(s.size());
+  if (const char *c = s.latin1Data()) {
+    // snapshots hold UTF-16, but the string should stay in 8 bits
+    for (int i = 0; i < s.size(); i++) {
+      UChar u(static_cast<unsigned char>(c[i]));
+      writeBytes(&u, sizeof(UChar));
+    }
+    return;
+  }
+  writeBytes(s.data(), s.size() * sizeof(UChar));
+}
+
+void SnapshotWriter::writeHeader(unsigned char tag, const Node *n)
+{
+  writeByte(tag);
+  writeLocation(n);
+}
+
+void SnapshotWriter::writeHeader(unsigned char tag, const StatementNode *n)
+{
+  writeByte(tag);
+  writeLocation(n);
+}
+
+void SnapshotWriter::writeLocation(const Node *n)
+{
+  writeInt(n->lineNo());
+}
+
+void SnapshotWriter::writeLocation(const StatementNode *n)
+{
+  writeInt(n->lineNo());
+  writeInt(n->firstLine());
+  writeInt(n->lastLine());
+  writeBool(n->sourceId() != -1);
+}
+
+void SnapshotWriter::writeNode(const Node *n)
+{
+  if (n)
+    n->writeTo(*this);
+  else
+    writeByte(NoNodeTag);
+}
+
+// ------------------------------ Node::writeTo --------------------------------
+
+void NullNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(NullTag, this);
+}
+
+void BooleanNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(BooleanTag, this);
+  s.writeBool(value);
+}
+
+void NumberNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(NumberTag, this);
+  s.writeDouble(value);
+}
+
+void StringNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(StringTag, this);
+  s.writeString(value);
+}
+
+void RegExpNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(RegExpTag, this);
+  s.writeString(pattern);
+  s.writeString(flags);
+}
+
+void ThisNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ThisTag, this);
+}
+
+void ResolveNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ResolveTag, this);
+  s.writeIdentifier(ident);
+}
+
+void GroupNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(GroupTag, this);
+  s.writeNode(group);
+}
+
+// Lists are written from their first element on, the reader returns them in
+// the circular form the parser builds so that the owner's constructor can
+// crack them as usual.
+
+void ElementNode::writeTo(SnapshotWriter &s) const
+{
+  int count = 0;
+  for (const ElementNode *n = this; n; n = n->list)
+    count++;
+
+  s.writeByte(ElementTag);
+  s.writeInt(count);
+  for (const ElementNode *n = this; n; n = n->list) {
+    s.writeLocation(n);
+    s.writeInt(n->elision);
+    s.writeNode(n->node);
+  }
+}
+
+void ArrayNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ArrayTag, this);
+  s.writeInt(elision);
+  s.writeBool(opt);
+  s.writeNode(element);
+}
+
+void PropertyValueNode::writeTo(SnapshotWriter &s) const
+{
+  int count = 0;
+  for (const PropertyValueNode *n = this; n; n = n->list)
+    count++;
+
+  s.writeByte(PropertyValueTag);
+  s.writeInt(count);
+  for (const PropertyValueNode *n = this; n; n = n->list) {
+    s.writeLocation(n);
+    s.writeNode(n->name);
+    s.writeNode(n->assign);
+  }
+}
+
+void ObjectLiteralNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ObjectLiteralTag, this);
+  s.writeNode(list);
+}
+
+void PropertyNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(PropertyTag, this);
+  s.writeBool(str.isNull());
+  if (str.isNull())
+    s.writeDouble(numeric);
+  else
+    s.writeIdentifier(str);
+}
+
+void AccessorNode1::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(Accessor1Tag, this);
+  s.writeNode(expr1);
+  s.writeNode(expr2);
+}
+
+void AccessorNode2::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(Accessor2Tag, this);
+  s.writeNode(expr);
+  s.writeIdentifier(ident);
+}
+
+void ArgumentListNode::writeTo(SnapshotWriter &s) const
+{
+  int count = 0;
+  for (const ArgumentListNode *n = this; n; n = n->list)
+    count++;
+
+  s.writeByte(ArgumentListTag);
+  s.writeInt(count);
+  for (const ArgumentListNode *n = this; n; n = n->list) {
+    s.writeLocation(n);
+    s.writeNode(n->expr);
+  }
+}
+
+void ArgumentsNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ArgumentsTag, this);
+  s.writeNode(list);
+}
+
+void NewExprNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(NewExprTag, this);
+  s.writeNode(expr);
+  s.writeNode(args);
+}
+
+void FunctionCallNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(FunctionCallTag, this);
+  s.writeNode(expr);
+  s.writeNode(args);
+}
+
+void PostfixNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(PostfixTag, this);
+  s.writeNode(expr);
+  s.writeInt(oper);
+}
+
+void DeleteNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(DeleteTag, this);
+  s.writeNode(expr);
+}
+
+void VoidNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(VoidTag, this);
+  s.writeNode(expr);
+}
+
+void TypeOfNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(TypeOfTag, this);
+  s.writeNode(expr);
+}
+
+void PrefixNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(PrefixTag, this);
+  s.writeInt(oper);
+  s.writeNode(expr);
+}
+
+void UnaryPlusNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(UnaryPlusTag, this);
+  s.writeNode(expr);
+}
+
+void NegateNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(NegateTag, this);
+  s.writeNode(expr);
+}
+
+void BitwiseNotNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(BitwiseNotTag, this);
+  s.writeNode(expr);
+}
+
+void LogicalNotNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(LogicalNotTag, this);
+  s.writeNode(expr);
+}
+
+void MultNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(MultTag, this);
+  s.writeNode(term1);
+  s.writeNode(term2);
+  s.writeByte(oper);
+}
+
+void AddNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(AddTag, this);
+  s.writeNode(term1);
+  s.writeNode(term2);
+  s.writeByte(oper);
+}
+
+void ShiftNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ShiftTag, this);
+  s.writeNode(term1);
+  s.writeInt(oper);
+  s.writeNode(term2);
+}
+
+void RelationalNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(RelationalTag, this);
+  s.writeNode(expr1);
+  s.writeInt(oper);
+  s.writeNode(expr2);
+}
+
+void EqualNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(EqualTag, this);
+  s.writeNode(expr1);
+  s.writeInt(oper);
+  s.writeNode(expr2);
+}
+
+void BitOperNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(BitOperTag, this);
+  s.writeNode(expr1);
+  s.writeInt(oper);
+  s.writeNode(expr2);
+}
+
+void BinaryLogicalNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(BinaryLogicalTag, this);
+  s.writeNode(expr1);
+  s.writeInt(oper);
+  s.writeNode(expr2);
+}
+
+void ConditionalNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ConditionalTag, this);
+  s.writeNode(logical);
+  s.writeNode(expr1);
+  s.writeNode(expr2);
+}
+
+void AssignNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(AssignTag, this);
+  s.writeNode(left);
+  s.writeInt(oper);
+  s.writeNode(expr);
+}
+
+void CommaNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(CommaTag, this);
+  s.writeNode(expr1);
+  s.writeNode(expr2);
+}
+
+void StatListNode::writeTo(SnapshotWriter &s) const
+{
+  int count = 0;
+  for (const StatListNode *n = this; n; n = n->list)
+    count++;
+
+  s.writeByte(StatListTag);
+  s.writeInt(count);
+  for (const StatListNode *n = this; n; n = n->list) {
+    s.writeLocation(n);
+    s.writeNode(n->statement);
+  }
+}
+
+void AssignExprNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(AssignExprTag, this);
+  s.writeNode(expr);
+}
+
+void VarDeclNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(VarDeclTag, this);
+  s.writeIdentifier(ident);
+  s.writeNode(init);
+}
+
+void VarDeclListNode::writeTo(SnapshotWriter &s) const
+{
+  int count = 0;
+  for (const VarDeclListNode *n = this; n; n = n->list)
+    count++;
+
+  s.writeByte(VarDeclListTag);
+  s.writeInt(count);
+  for (const VarDeclListNode *n = this; n; n = n->list) {
+    s.writeLocation(n);
+    s.writeNode(n->var);
+  }
+}
+
+void VarStatementNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(VarStatementTag, this);
+  s.writeNode(list);
+}
+
+void BlockNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(BlockTag, this);
+  s.writeNode(source);
+}
+
+void EmptyStatementNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(EmptyStatementTag, this);
+}
+
+void ExprStatementNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ExprStatementTag, this);
+  s.writeNode(expr);
+}
+
+void IfNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(IfTag, this);
+  s.writeNode(expr);
+  s.writeNode(statement1);
+  s.writeNode(statement2);
+}
+
+void DoWhileNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(DoWhileTag, this);
+  s.writeNode(statement);
+  s.writeNode(expr);
+}
+
+void WhileNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(WhileTag, this);
+  s.writeNode(expr);
+  s.writeNode(statement);
+}
+
+void ForNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ForTag, this);
+  s.writeNode(expr1);
+  s.writeNode(expr2);
+  s.writeNode(expr3);
+  s.writeNode(statement);
+}
+
+void ForInNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ForInTag, this);
+  // the declaration and the reference of the "var" form are recreated by
+  // the constructor
+  s.writeBool(varDecl != 0);
+  if (varDecl) {
+    s.writeIdentifier(ident);
+    s.writeNode(init);
+  } else
+    s.writeNode(lexpr);
+  s.writeNode(expr);
+  s.writeNode(statement);
+}
+
+void ContinueNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ContinueTag, this);
+  s.writeIdentifier(ident);
+}
+
+void BreakNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(BreakTag, this);
+  s.writeIdentifier(ident);
+}
+
+void ReturnNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ReturnTag, this);
+  s.writeNode(value);
+}
+
+void WithNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(WithTag, this);
+  s.writeNode(expr);
+  s.writeNode(statement);
+}
+
+void CaseClauseNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(CaseClauseTag, this);
+  s.writeNode(expr);
+  s.writeNode(list);
+}
+
+void ClauseListNode::writeTo(SnapshotWriter &s) const
+{
+  int count = 0;
+  for (const ClauseListNode *n = this; n; n = n->nx)
+    count++;
+
+  s.writeByte(ClauseListTag);
+  s.writeInt(count);
+  for (const ClauseListNode *n = this; n; n = n->nx) {
+    s.writeLocation(n);
+    s.writeNode(n->cl);
+  }
+}
+
+void CaseBlockNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(CaseBlockTag, this);
+  s.writeNode(list1);
+  s.writeNode(def);
+  s.writeNode(list2);
+}
+
+void SwitchNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(SwitchTag, this);
+  s.writeNode(expr);
+  s.writeNode(block);
+}
+
+void LabelNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(LabelTag, this);
+  s.writeIdentifier(label);
+  s.writeNode(statement);
+}
+
+void ThrowNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ThrowTag, this);
+  s.writeNode(expr);
+}
+
+void CatchNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(CatchTag, this);
+  s.writeIdentifier(ident);
+  s.writeNode(block);
+}
+
+void FinallyNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(FinallyTag, this);
+  s.writeNode(block);
+}
+
+void TryNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(TryTag, this);
+  s.writeNode(block);
+  s.writeNode(_catch);
+  s.writeNode(_final);
+}
+
+void ParameterNode::writeTo(SnapshotWriter &s) const
+{
+  int count = 0;
+  for (const ParameterNode *n = this; n; n = n->next)
+    count++;
+
+  s.writeByte(ParameterTag);
+  s.writeInt(count);
+  for (const ParameterNode *n = this; n; n = n->next) {
+    s.writeLocation(n);
+    s.writeIdentifier(n->id);
+  }
+}
+
+// The text of a lazy body and of the whole function are stored as offsets in
+// the source the program was parsed from, which the reader is given again.
+void FunctionBodyNode::writeTo(SnapshotWriter &s) const
+{
+  // a lazy body is stored unparsed, whether it has been parsed yet or not
+  if (lazy) {
+    s.writeHeader(LazyFunctionBodyTag, this);
+    s.writeInt(lazy->start);
+    s.writeInt(lazy->length);
+    s.writeInt(lazy->startingLineNumber);
+    s.writeBool(lazy->hasFunctionDeclarations);
+  } else {
+    s.writeHeader(FunctionBodyTag, this);
+    s.writeNode(source);
+  }
+  s.writeInt(sourceProvider ? sourceStart : -1);
+  s.writeInt(sourceEnd);
+}
+
+void FuncDeclNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(FuncDeclTag, this);
+  s.writeIdentifier(ident);
+  s.writeNode(param);
+  s.writeNode(body);
+}
+
+void FuncExprNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(FuncExprTag, this);
+  s.writeNode(param);
+  s.writeNode(body);
+}
+
+void SourceElementsNode::writeTo(SnapshotWriter &s) const
+{
+  int count = 0;
+  for (const SourceElementsNode *n = this; n; n = n->elements)
+    count++;
+
+  s.writeByte(SourceElementsTag);
+  s.writeInt(count);
+  for (const SourceElementsNode *n = this; n; n = n->elements) {
+    s.writeLocation(n);
+    s.writeNode(n->element);
+  }
+}
+
+void ProgramNode::writeTo(SnapshotWriter &s) const
+{
+  s.writeHeader(ProgramTag, this);
+  s.writeNode(source);
+}
+
+// ------------------------------ SnapshotReader -------------------------------
+
+SnapshotReader::SnapshotReader(const char *data, size_t size, const UString &sourceURL, int sourceId,
+                               SourceProvider *source)
+  : _data(data), _size(size), _position(0), _failed(false),
+    _sourceURL(sourceURL), _sourceId(sourceId), _source(source)
+{
+}
+
+void SnapshotReader::readBytes(void *data, size_t size)
+{
+  if (_failed || size > _size - _position) {
+    _failed = true;
+    memset(data, 0, size);
+    return;
+  }
+  memcpy(data, _data + _position, size);
+  _position += size;
+}
+
+unsigned char SnapshotReader::readByte()
+{
+  unsigned char b;
+  readBytes(&b, 1);
+  return b;
+}
+
+int SnapshotReader::readInt()
+{
+  int i;
+  readBytes(&i, sizeof(i));
+  return i;
+}
+
+double SnapshotReader::readDouble()
+{
+  double d;
+  readBytes(&d, sizeof(d));
+  return d;
+}
+
+UString SnapshotReader::readString()
+{
+  int length = readInt();
+  if (length < 0)
+    return UString();
+  if (_failed || (size_t)length > (_size - _position) / sizeof(UChar)) {
+    _failed = true;
+    return UString();
+  }
+  UString s(reinterpret_cast<const UChar *>(current()), length);
+  _position += length * sizeof(UChar);
+  return s;
+}
+
+Identifier SnapshotReader::readIdentifier()
+{
+  int length = readInt();
+  if (length < 0)
+    return Identifier();
+  if (_failed || (size_t)length > (_size - _position) / sizeof(UChar)) {
+    _failed = true;
+    return Identifier();
+  }
+  UString s(reinterpret_cast<const UChar *>(current()), length);
+  _position += length * sizeof(UChar);
+  return Identifier(s);
+}
+
+unsigned char SnapshotReader::peekTag() const
+{
+  return _position < _size ? (unsigned char)_data[_position] : (unsigned char)NoNodeTag;
+}
+
+SnapshotReader::Location SnapshotReader::readLocation()
+{
+  Location loc;
+  loc.line = readInt();
+  loc.firstLine = readInt();
+  loc.lastLine = readInt();
+  loc.hasSourceId = readBool();
+  return loc;
+}
+
+Node *SnapshotReader::finish(Node *n, int line)
+{
+  n->line = line;
+  n->sourceURL = _sourceURL;
+  return n;
+}
+
+StatementNode *SnapshotReader::finish(StatementNode *n, const Location &loc)
+{
+  finish(static_cast<Node *>(n), loc.line);
+  n->setLoc(loc.firstLine, loc.lastLine, loc.hasSourceId ? _sourceId : -1);
+  return n;
+}
+
+ProgramNode *SnapshotReader::readProgram()
+{
+  if (peekTag() != ProgramTag) {
+    _failed = true;
+    return 0;
+  }
+  return static_cast<ProgramNode *>(readNode());
+}
+
+StatementNode *SnapshotReader::readStatement()
+{
+  return static_cast<StatementNode *>(readNode());
+}
+
+bool SnapshotReader::isRange(int start, int end) const
+{
+  return start >= 0 && start <= end && (unsigned int)end <= _source->length();
+}
+
+Node *SnapshotReader::readNode()
+{
+  unsigned char tag = readByte();
+  if (_failed)
+    return 0;
+
+  switch (tag) {
+  case NoNodeTag:
+    return 0;
+  case NullTag: {
+    int line = readLine();
+    return finish(new NullNode(), line);
+  }
+  case BooleanTag: {
+    int line = readLine();
+    bool value = readBool();
+    return finish(new BooleanNode(value), line);
+  }
+  case NumberTag: {
+    int line = readLine();
+    double value = readDouble();
+    return finish(new NumberNode(value), line);
+  }
+  case StringTag: {
+    int line = readLine();
+    UString value = readString();
+    return finish(new StringNode(&value), line);
+  }
+  case RegExpTag: {
+    int line = readLine();
+    UString pattern = readString();
+    UString flags = readString();
+    return finish(new RegExpNode(pattern, flags), line);
+  }
+  case ThisTag: {
+    int line = readLine();
+    return finish(new ThisNode(), line);
+  }
+  case ResolveTag: {
+    int line = readLine();
+    Identifier ident = readIdentifier();
+    return finish(new ResolveNode(ident), line);
+  }
+  case GroupTag: {
+    int line = readLine();
+    Node *group = readNode();
+    return finish(new GroupNode(group), line);
+  }
+  case ElementTag: {
+    int count = readInt();
+    ElementNode *list = 0;
+    for (int i = 0; i < count && !_failed; i++) {
+      int line = readLine();
+      int elision = readInt();
+      Node *node = readNode();
+      list = list ? new ElementNode(list, elision, node) : new ElementNode(elision, node);
+      finish(list, line);
+    }
+    return list;
+  }
+  case ArrayTag: {
+    int line = readLine();
+    int elision = readInt();
+    bool opt = readBool();
+    ElementNode *element = static_cast<ElementNode *>(readNode());
+    ArrayNode *n;
+    if (!element)
+      n = new ArrayNode(elision);
+    else if (opt)
+      n = new ArrayNode(elision, element);
+    else
+      n = new ArrayNode(element);
+    return finish(n, line);
+  }
+  case PropertyValueTag: {
+    int count = readInt();
+    PropertyValueNode *list = 0;
+    for (int i = 0; i < count && !_failed; i++) {
+      int line = readLine();
+      PropertyNode *name = static_cast<PropertyNode *>(readNode());
+      Node *assign = readNode();
+      list = list ? new PropertyValueNode(name, assign, list) : new PropertyValueNode(name, assign);
+      finish(list, line);
+    }
+    return list;
+  }
+  case ObjectLiteralTag: {
+    int line = readLine();
+    PropertyValueNode *list = static_cast<PropertyValueNode *>(readNode());
+    return finish(list ? new ObjectLiteralNode(list) : new ObjectLiteralNode(), line);
+  }
+  case PropertyTag: {
+    int line = readLine();
+    if (readBool()) {
+      double numeric = readDouble();
+      return finish(new PropertyNode(numeric), line);
+    }
+    Identifier str = readIdentifier();
+    return finish(new PropertyNode(str), line);
+  }
+  case Accessor1Tag: {
+    int line = readLine();
+    Node *expr1 = readNode();
+    Node *expr2 = readNode();
+    return finish(new AccessorNode1(expr1, expr2), line);
+  }
+  case Accessor2Tag: {
+    int line = readLine();
+    Node *expr = readNode();
+    Identifier ident = readIdentifier();
+    return finish(new AccessorNode2(expr, ident), line);
+  }
+  case ArgumentListTag: {
+    int count = readInt();
+    ArgumentListNode *list = 0;
+    for (int i = 0; i < count && !_failed; i++) {
+      int line = readLine();
+      Node *expr = readNode();
+      list = list ? new ArgumentListNode(list, expr) : new ArgumentListNode(expr);
+      finish(list, line);
+    }
+    return list;
+  }
+  case ArgumentsTag: {
+    int line = readLine();
+    ArgumentListNode *list = static_cast<ArgumentListNode *>(readNode());
+    return finish(list ? new ArgumentsNode(list) : new ArgumentsNode(), line);
+  }
+  case NewExprTag: {
+    int line = readLine();
+    Node *expr = readNode();
+    ArgumentsNode *args = static_cast<ArgumentsNode *>(readNode());
+    return finish(new NewExprNode(expr, args), line);
+  }
+  case FunctionCallTag: {
+    int line = readLine();
+    Node *expr = readNode();
+    ArgumentsNode *args = static_cast<ArgumentsNode *>(readNode());
+    return finish(new FunctionCallNode(expr, args), line);
+  }
+  case PostfixTag: {
+    int line = readLine();
+    Node *expr = readNode();
+    Operator oper = static_cast<Operator>(readInt());
+    return finish(new PostfixNode(expr, oper), line);
+  }
+  case DeleteTag: {
+    int line = readLine();
+    Node *expr = readNode();
+    return finish(new DeleteNode(expr), line);
+  }
+  case VoidTag: {
+    int line = readLine();
+    Node *expr = readNode();
+    return finish(new VoidNode(expr), line);
+  }
+  case TypeOfTag: {
+    int line = readLine();
+    Node *expr = readNode();
+    return finish(new TypeOfNode(expr), line);
+  }
+  case PrefixTag: {
+    int line = readLine();
+    Operator oper = static_cast<Operator>(readInt());
+    Node *expr = readNode();
+    return finish(new PrefixNode(oper, expr), line);
+  }
+  case UnaryPlusTag: {
+    int line = readLine();
+    Node *expr = readNode();
+    return finish(new UnaryPlusNode(expr), line);
+  }
+  case NegateTag: {
+    int line = readLine();
+    Node *expr = readNode();
+    return finish(new NegateNode(expr), line);
+  }
+  case BitwiseNotTag: {
+    int line = readLine();
+    Node *expr = readNode();
+    return finish(new BitwiseNotNode(expr), line);
+  }
+  case LogicalNotTag: {
+    int line = readLine();
+    Node *expr = readNode();
+    return finish(new LogicalNotNode(expr), line);
+  }
+  case MultTag: {
+    int line = readLine();
+    Node *term1 = readNode();
+    Node *term2 = readNode();
+    char oper = readByte();
+    return finish(new MultNode(term1, term2, oper), line);
+  }
+  case AddTag: {
+    int line = readLine();
+    Node *term1 = readNode();
+    Node *term2 = readNode();
+    char oper = readByte();
+    return finish(new AddNode(term1, term2, oper), line);
+  }
+  case ShiftTag: {
+    int line = readLine();
+    Node *term1 = readNode();
+    Operator oper = static_cast<Operator>(readInt());
+    Node *term2 = readNode();
+    return finish(new ShiftNode(term1, oper, term2), line);
+  }
+  case RelationalTag: {
+    int line = readLine();
+    Node *expr1 = readNode();
+    Operator oper = static_cast<Operator>(readInt());
+    Node *expr2 = readNode();
+    return finish(new RelationalNode(expr1, oper, expr2), line);
+  }
+  case EqualTag: {
+    int line = readLine();
+    Node *expr1 = readNode();
+    Operator oper = static_cast<Operator>(readInt());
+    Node *expr2 = readNode();
+    return finish(new EqualNode(expr1, oper, expr2), line);
+  }
+  case BitOperTag: {
+    int line = readLine();
+    Node *expr1 = readNode();
+    Operator oper = static_cast<Operator>(readInt());
+    Node *expr2 = readNode();
+    return finish(new BitOperNode(expr1, oper, expr2), line);
+  }
+  case BinaryLogicalTag: {
+    int line = readLine();
+    Node *expr1 = readNode();
+    Operator oper = static_cast<Operator>(readInt());
+    Node *expr2 = readNode();
+    return finish(new BinaryLogicalNode(expr1, oper, expr2), line);
+  }
+  case ConditionalTag: {
+    int line = readLine();
+    Node *logical = readNode();
+    Node *expr1 = readNode();
+    Node *expr2 = readNode();
+    return finish(new ConditionalNode(logical, expr1, expr2), line);
+  }
+  case AssignTag: {
+    int line = readLine();
+    Node *left = readNode();
+    Operator oper = static_cast<Operator>(readInt());
+    Node *expr = readNode();
+    return finish(new AssignNode(left, oper, expr), line);
+  }
+  case CommaTag: {
+    int line = readLine();
+    Node *expr1 = readNode();
+    Node *expr2 = readNode();
+    return finish(new CommaNode(expr1, expr2), line);
+  }
+  case StatListTag: {
+    int count = readInt();
+    StatListNode *list = 0;
+    for (int i = 0; i < count && !_failed; i++) {
+      Location loc = readLocation();
+      StatementNode *statement = readStatement();
+      if (!statement)
+        _failed = true;
+      if (_failed)
+        break;
+      list = list ? new StatListNode(list, statement) : new StatListNode(statement);
+      finish(list, loc);
+    }
+    return list;
+  }
+  case AssignExprTag: {
+    int line = readLine();
+    Node *expr = readNode();
+    return finish(new AssignExprNode(expr), line);
+  }
+  case VarDeclTag: {
+    int line = readLine();
+    Identifier ident = readIdentifier();
+    AssignExprNode *init = static_cast<AssignExprNode *>(readNode());
+    return finish(new VarDeclNode(ident, init), line);
+  }
+  case VarDeclListTag: {
+    int count = readInt();
+    VarDeclListNode *list = 0;
+    for (int i = 0; i < count && !_failed; i++) {
+      int line = readLine();
+      VarDeclNode *var = static_cast<VarDeclNode *>(readNode());
+      list = list ? new VarDeclListNode(list, var) : new VarDeclListNode(var);
+      finish(list, line);
+    }
+    return list;
+  }
+  case VarStatementTag: {
+    Location loc = readLocation();
+    VarDeclListNode *list = static_cast<VarDeclListNode *>(readNode());
+    if (!list) {
+      _failed = true;
+      return 0;
+    }
+    return finish(new VarStatementNode(list), loc);
+  }
+  case BlockTag: {
+    Location loc = readLocation();
+    SourceElementsNode *source = static_cast<SourceElementsNode *>(readNode());
+    return finish(new BlockNode(source), loc);
+  }
+  case EmptyStatementTag: {
+    Location loc = readLocation();
+    return finish(new EmptyStatementNode(), loc);
+  }
+  case ExprStatementTag: {
+    Location loc = readLocation();
+    Node *expr = readNode();
+    return finish(new ExprStatementNode(expr), loc);
+  }
+  case IfTag: {
+    Location loc = readLocation();
+    Node *expr = readNode();
+    StatementNode *statement1 = readStatement();
+    StatementNode *statement2 = readStatement();
+    return finish(new IfNode(expr, statement1, statement2), loc);
+  }
+  case DoWhileTag: {
+    Location loc = readLocation();
+    StatementNode *statement = readStatement();
+    Node *expr = readNode();
+    return finish(new DoWhileNode(statement, expr), loc);
+  }
+  case WhileTag: {
+    Location loc = readLocation();
+    Node *expr = readNode();
+    StatementNode *statement = readStatement();
+    return finish(new WhileNode(expr, statement), loc);
+  }
+  case ForTag: {
+    Location loc = readLocation();
+    bool varDecls = peekTag() == VarDeclListTag;
+    Node *expr1 = readNode();
+    Node *expr2 = readNode();
+    Node *expr3 = readNode();
+    StatementNode *statement = readStatement();
+    ForNode *n;
+    if (varDecls)
+      n = new ForNode(static_cast<VarDeclListNode *>(expr1), expr2, expr3, statement);
+    else
+      n = new ForNode(expr1, expr2, expr3, statement);
+    return finish(n, loc);
+  }
+  case ForInTag: {
+    Location loc = readLocation();
+    if (readBool()) {
+      Identifier ident = readIdentifier();
+      AssignExprNode *init = static_cast<AssignExprNode *>(readNode());
+      Node *expr = readNode();
+      StatementNode *statement = readStatement();
+      return finish(new ForInNode(ident, init, expr, statement), loc);
+    }
+    Node *lexpr = readNode();
+    Node *expr = readNode();
+    StatementNode *statement = readStatement();
+    return finish(new ForInNode(lexpr, expr, statement), loc);
+  }
+  case ContinueTag: {
+    Location loc = readLocation();
+    Identifier ident = readIdentifier();
+    return finish(new ContinueNode(ident), loc);
+  }
+  case BreakTag: {
+    Location loc = readLocation();
+    Identifier ident = readIdentifier();
+    return finish(new BreakNode(ident), loc);
+  }
+  case ReturnTag: {
+    Location loc = readLocation();
+    Node *value = readNode();
+    return finish(new ReturnNode(value), loc);
+  }
+  case WithTag: {
+    Location loc = readLocation();
+    Node *expr = readNode();
+    StatementNode *statement = readStatement();
+    return finish(new WithNode(expr, statement), loc);
+  }
+  case CaseClauseTag: {
+    int line = readLine();
+    Node *expr = readNode();
+    StatListNode *list = static_cast<StatListNode *>(readNode());
+    return finish(list ? new CaseClauseNode(expr, list) : new CaseClauseNode(expr), line);
+  }
+  case ClauseListTag: {
+    int count = readInt();
+    ClauseListNode *list = 0;
+    for (int i = 0; i < count && !_failed; i++) {
+      int line = readLine();
+      CaseClauseNode *clause = static_cast<CaseClauseNode *>(readNode());
+      list = list ? new ClauseListNode(list, clause) : new ClauseListNode(clause);
+      finish(list, line);
+    }
+    return list;
+  }
+  case CaseBlockTag: {
+    int line = readLine();
+    ClauseListNode *list1 = static_cast<ClauseListNode *>(readNode());
+    CaseClauseNode *def = static_cast<CaseClauseNode *>(readNode());
+    ClauseListNode *list2 = static_cast<ClauseListNode *>(readNode());
+    return finish(new CaseBlockNode(list1, def, list2), line);
+  }
+  case SwitchTag: {
+    Location loc = readLocation();
+    Node *expr = readNode();
+    CaseBlockNode *block = static_cast<CaseBlockNode *>(readNode());
+    return finish(new SwitchNode(expr, block), loc);
+  }
+  case LabelTag: {
+    Location loc = readLocation();
+    Identifier label = readIdentifier();
+    StatementNode *statement = readStatement();
+    if (!statement) {
+      _failed = true;
+      return 0;
+    }
+    // done by the parser for labelled statements
+    statement->pushLabel(label);
+    return finish(new LabelNode(label, statement), loc);
+  }
+  case ThrowTag: {
+    Location loc = readLocation();
+    Node *expr = readNode();
+    return finish(new ThrowNode(expr), loc);
+  }
+  case CatchTag: {
+    Location loc = readLocation();
+    Identifier ident = readIdentifier();
+    StatementNode *block = readStatement();
+    return finish(new CatchNode(ident, block), loc);
+  }
+  case FinallyTag: {
+    Location loc = readLocation();
+    StatementNode *block = readStatement();
+    return finish(new FinallyNode(block), loc);
+  }
+  case TryTag: {
+    Location loc = readLocation();
+    StatementNode *block = readStatement();
+    CatchNode *_catch = static_cast<CatchNode *>(readNode());
+    FinallyNode *_final = static_cast<FinallyNode *>(readNode());
+    return finish(new TryNode(block, _catch, _final), loc);
+  }
+  case ParameterTag: {
+    int count = readInt();
+    ParameterNode *list = 0;
+    for (int i = 0; i < count && !_failed; i++) {
+      int line = readLine();
+      Identifier id = readIdentifier();
+      list = list ? new ParameterNode(list, id) : new ParameterNode(id);
+      finish(list, line);
+    }
+    return list;
+  }
+  case FunctionBodyTag:
+  case LazyFunctionBodyTag: {
+    Location loc = readLocation();
+    FunctionBodyNode *body;
+    if (tag == FunctionBodyTag) {
+      SourceElementsNode *source = static_cast<SourceElementsNode *>(readNode());
+      body = new FunctionBodyNode(source);
+    } else {
+      LazyFunctionBody lazy;
+      lazy.source = _source;
+      lazy.start = readInt();
+      lazy.length = readInt();
+      lazy.startingLineNumber = readInt();
+      lazy.hasFunctionDeclarations = readBool();
+      lazy.sourceId = _sourceId;
+      if (!isRange(lazy.start, lazy.start + lazy.length)) {
+        _failed = true;
+        return 0;
+      }
+      body = new FunctionBodyNode(lazy);
+    }
+    int start = readInt();
+    int end = readInt();
+    if (start >= 0) {
+      if (!isRange(start, end)) {
+        _failed = true;
+        return 0;
+      }
+      body->setSource(_source, start, end);
+    }
+    return finish(body, loc);
+  }
+  case FuncDeclTag: {
+    Location loc = readLocation();
+    Identifier ident = readIdentifier();
+    ParameterNode *param = static_cast<ParameterNode *>(readNode());
+    FunctionBodyNode *body = static_cast<FunctionBodyNode *>(readNode());
+    FuncDeclNode *n = param ? new FuncDeclNode(ident, param, body) : new FuncDeclNode(ident, body);
+    return finish(n, loc);
+  }
+  case FuncExprTag: {
+    int line = readLine();
+    ParameterNode *param = static_cast<ParameterNode *>(readNode());
+    FunctionBodyNode *body = static_cast<FunctionBodyNode *>(readNode());
+    return finish(param ? new FuncExprNode(param, body) : new FuncExprNode(body), line);
+  }
+  case SourceElementsTag: {
+    int count = readInt();
+    SourceElementsNode *list = 0;
+    for (int i = 0; i < count && !_failed; i++) {
+      Location loc = readLocation();
+      StatementNode *element = readStatement();
+      if (!element)
+        _failed = true;
+      if (_failed)
+        break;
+      list = list ? new SourceElementsNode(list, element) : new SourceElementsNode(element);
+      finish(list, loc);
+    }
+    return list;
+  }
+  case ProgramTag: {
+    Location loc = readLocation();
+    SourceElementsNode *source = static_cast<SourceElementsNode *>(readNode());
+    return finish(new ProgramNode(source), loc);
+  }
+  }
+
+  // unknown tag
+  _failed = true;
+  return 0;
+}
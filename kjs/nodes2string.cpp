@@ -33,7 +33,7 @@ namespace KJS {
       Endl, Indent, Unindent
     };
 
-    UString toString() const { return str; }
+    UString toString() { return str.release(); }
     SourceStream& operator<<(const Identifier &);
     SourceStream& operator<<(const UString &);
     SourceStream& operator<<(const char *);
@@ -41,7 +41,7 @@ namespace KJS {
     SourceStream& operator<<(Format f);
     SourceStream& operator<<(const Node *);
   private:
-    UString str; /* TODO: buffer */
+    StringBuilder str;
     UString ind;
   };
 };
@@ -50,25 +50,25 @@ using namespace KJS;
 
 SourceStream& SourceStream::operator<<(char c)
 {
-  str += UString(c);
+  str.append(c);
   return *this;
 }
 
 SourceStream& SourceStream::operator<<(const char *s)
 {
-  str += UString(s);
+  str.append(s);
   return *this;
 }
 
 SourceStream& SourceStream::operator<<(const UString &s)
 {
-  str += s;
+  str.append(s);
   return *this;
 }
 
 SourceStream& SourceStream::operator<<(const Identifier &s)
 {
-  str += s.ustring();
+  str.append(s.ustring());
   return *this;
 }
 
@@ -83,7 +83,8 @@ SourceStream& SourceStream::operator<<(Format f)
 {
   switch (f) {
     case Endl:
-      str += "\n" + ind;
+      str.append('\n');
+      str.append(ind);
       break;
     case Indent:
       ind += "  ";
@@ -424,6 +425,13 @@ void BlockNode::streamTo(SourceStream &s) const
     << source << SourceStream::Unindent << SourceStream::Endl << "}";
 }
 
+void FunctionBodyNode::streamTo(SourceStream &s) const
+{
+  // a body that fails to parse prints as an empty block
+  const_cast<FunctionBodyNode *>(this)->parseLazyBody();
+  BlockNode::streamTo(s);
+}
+
 void EmptyStatementNode::streamTo(SourceStream &s) const
 {
   s << SourceStream::Endl << ";";
@@ -0,0 +1,91 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef _KJS_NUMBER_FORMAT_H_
+#define _KJS_NUMBER_FORMAT_H_
+
+#include "ustring.h"
+
+namespace KJS {
+
+  /**
+   * @internal
+   *
+   * Turns numbers into digits for @ref UString::from() and
+   * Number.prototype.toString(), and digits back into numbers for
+   * @ref UString::toDouble() and the lexer.
+   */
+  class NumberFormat {
+  public:
+    enum { maxShortestDigits = 17 };
+
+    /**
+     * Writes the fewest decimal digits that read back as d, which must be
+     * positive and finite, to digits, followed by a null character. Where
+     * more than one string of that many digits would do, the one closest
+     * to d is picked, as ECMA 9.8.1 asks for. digits needs room for
+     * @ref maxShortestDigits and the null.
+     *
+     * Returns how many digits there are. decimalPoint is set to where the
+     * decimal point goes, counted from the left of the first digit, as
+     * kjs_dtoa() does.
+     *
+     * Most numbers are done in 64-bit integers with the Grisu3 algorithm
+     * by Florian Loitsch; the few where that cannot tell which digits are
+     * the shortest go to kjs_dtoa(), which works it out exactly.
+     */
+    static int shortestDigits(double d, char *digits, int &decimalPoint);
+
+    /**
+     * The number d in the given radix, from 2 to 36, with a sign and a
+     * fraction if it has them, and as many digits of the fraction as it
+     * takes to tell d from the numbers either side of it. d must be
+     * finite.
+     */
+    static UString toRadixString(double d, int radix);
+
+    /**
+     * Reads a decimal number with an optional sign, fraction and exponent
+     * from the characters from s up to end, and rounds it correctly to a
+     * double. Infinity is left to the caller. stop is set to just past
+     * the number, or to s if there is none.
+     *
+     * Numbers of up to 19 significant digits are read into an integer and
+     * scaled by a power of ten in one exact operation when that is small
+     * enough, and with the Eisel-Lemire algorithm otherwise; the few that
+     * are too long, or too close to halfway between two doubles, for
+     * either go to kjs_strtod().
+     */
+    static double parseDecimal(const char *s, const char *end, const char *&stop);
+
+    /**
+     * Reads the digits of a radix that is a power of two, such as 8 or 16,
+     * from the characters from s up to end, and rounds the number they make
+     * correctly to a double, however many there are. stop is set to just
+     * past the last of them.
+     */
+    static double parseBinaryRadix(const char *s, const char *end, int radix, const char *&stop);
+  };
+
+}; // namespace
+
+#endif
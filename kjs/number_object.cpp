@@ -26,6 +26,7 @@
 #include "operations.h"
 #include "number_object.h"
 #include "error_object.h"
+#include "number_format.h"
 
 #include "number_object.lut.h"
 
@@ -95,20 +96,11 @@ Value NumberProtoFuncImp::call(ExecState *exec, Object &thisObj, const List &arg
     double dradix = 10;
     if (!args.isEmpty() && args[0].type() != UndefinedType)
       dradix = args[0].toInteger(exec);
-    if (dradix < 2 || dradix > 36 || dradix == 10)
+    double d = v.toNumber(exec);
+    if (dradix < 2 || dradix > 36 || dradix == 10 || isNaN(d) || isInf(d))
       result = String(v.toString(exec));
-    else {
-      int radix = static_cast<int>(radix);
-      unsigned i = v.toUInt32(exec);
-      char s[33];
-      char *p = s + sizeof(s);
-      *--p = '\0';
-      do {
-        *--p = "0123456789abcdefghijklmnopqrstuvwxyz"[i % radix];
-        i /= radix;
-      } while (i);
-      result = String(p);
-    }
+    else
+      result = String(NumberFormat::toRadixString(d, static_cast<int>(dradix)));
     break;
   }
   case ToLocaleString: /* TODO */
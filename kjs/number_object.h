@@ -46,6 +46,7 @@ namespace KJS {
     NumberPrototypeImp(ExecState *exec,
                        ObjectPrototypeImp *objProto,
                        FunctionPrototypeImp *funcProto);
+    virtual ObjectImp *clone() const { return new NumberPrototypeImp(*this); }
   };
 
   /**
@@ -58,6 +59,7 @@ namespace KJS {
   public:
     NumberProtoFuncImp(ExecState *exec, FunctionPrototypeImp *funcProto,
                        int i, int len);
+    virtual ObjectImp *clone() const { return new NumberProtoFuncImp(*this); }
 
     virtual bool implementsCall() const;
     virtual Value call(ExecState *exec, Object &thisObj, const List &args);
@@ -77,6 +79,7 @@ namespace KJS {
     NumberObjectImp(ExecState *exec,
                     FunctionPrototypeImp *funcProto,
                     NumberPrototypeImp *numberProto);
+    virtual ObjectImp *clone() const { return new NumberObjectImp(*this); }
 
     virtual bool implementsConstruct() const;
     virtual Object construct(ExecState *exec, const List &args);
@@ -38,6 +38,7 @@
 #include "operations.h"
 #include "error_object.h"
 #include "nodes.h"
+#include "object_cloner.h"
 
 namespace KJS {
 
@@ -95,11 +96,37 @@ ObjectImp::ObjectImp()
   _internalValue = 0L;
 }
 
+ObjectImp::ObjectImp(const ObjectImp &other)
+  : ValueImp(), _prop(other._prop), _proto(other._proto),
+    _internalValue(other._internalValue), _scope(other._scope)
+{
+}
+
 ObjectImp::~ObjectImp()
 {
   //fprintf(stderr,"ObjectImp::~ObjectImp %p\n",(void*)this);
 }
 
+ObjectImp *ObjectImp::clone() const
+{
+  return 0;
+}
+
+void ObjectImp::cloneReferences(ObjectCloner &cloner)
+{
+  _prop.cloneValues(cloner);
+  _proto = cloner.clone(_proto);
+  _internalValue = cloner.clone(_internalValue);
+  // none of the built-in objects has a scope
+  if (!_scope.isEmpty())
+    cloner.fail();
+}
+
+void ObjectImp::cloneProperties(const ObjectImp *other, ObjectCloner &cloner)
+{
+  _prop.putClones(other->_prop, cloner);
+}
+
 void ObjectImp::mark()
 {
   //fprintf(stderr,"ObjectImp::mark() %p\n",(void*)this);
@@ -161,9 +188,13 @@ UString ObjectImp::className() const
 
 Value ObjectImp::get(ExecState *exec, const Identifier &propertyName) const
 {
-  ValueImp *imp = getDirect(propertyName);
-  if (imp)
+  int attributes;
+  ValueImp *imp = _prop.get(propertyName, attributes);
+  if (imp) {
+    if (attributes & LazyBuiltin)
+      return getLazyBuiltin(exec, propertyName, imp);
     return Value(imp);
+  }
 
   // non-standard netscape extension
   if (propertyName == specialPrototypePropertyName)
@@ -181,6 +212,17 @@ Value ObjectImp::get(ExecState *exec, unsigned propertyName) const
   return get(exec, Identifier::from(propertyName));
 }
 
+Value ObjectImp::getLazyBuiltin(ExecState *exec, const Identifier &propertyName, ValueImp *placeholder) const
+{
+  // Placeholders are put on global objects only, but the properties of one
+  // may have been saved and restored onto another.
+  ObjectImp *thisObj = const_cast<ObjectImp *>(this);
+  InterpreterImp *interp = InterpreterImp::interpreterWithGlobalObject(thisObj);
+  if (!interp)
+    interp = exec->lexicalInterpreter()->imp();
+  return interp->createLazyGlobalProperty(thisObj, propertyName, placeholder);
+}
+
 // ECMA 8.6.2.2
 void ObjectImp::put(ExecState *exec, const Identifier &propertyName,
                      const Value &value, int attr)
@@ -293,7 +335,7 @@ Value ObjectImp::defaultValue(ExecState *exec, Type hint) const
 {
   if (hint != StringType && hint != NumberType) {
     /* Prefer String for Date objects */
-    if (_proto == exec->lexicalInterpreter()->builtinDatePrototype().imp())
+    if (exec->lexicalInterpreter()->imp()->isBuiltinDatePrototype(_proto))
       hint = StringType;
     else
       hint = NumberType;
@@ -49,6 +49,7 @@ namespace KJS {
   class HashTable;
   class HashEntry;
   class ListImp;
+  class ObjectCloner;
   class ReferenceList;
 
   // ECMA 262-3 8.6.1
@@ -58,7 +59,8 @@ namespace KJS {
                    DontEnum   = 1 << 2, // property doesn't appear in (for .. in ..)
                    DontDelete = 1 << 3, // property can't be deleted
                    Internal   = 1 << 4, // an internal property, set to by pass checks
-                   Function   = 1 << 5 }; // property is a function - only used by static hashtables
+                   Function   = 1 << 5, // property is a function - only used by static hashtables
+                   LazyBuiltin = 1 << 6 }; // value stands for a built-in object that is created on first get()
 
   /**
    * Class Information
@@ -598,10 +600,45 @@ namespace KJS {
     void saveProperties(SavedProperties &p) const { _prop.save(p); }
     void restoreProperties(const SavedProperties &p) { _prop.restore(p); }
 
+    /**
+     * @internal
+     *
+     * Returns a copy of this object that still refers to the same objects as
+     * this one, or 0 if objects of this class can't be copied, which is the
+     * default. Used by @ref ObjectCloner to set up interpreters from a
+     * snapshot of the built-in objects, so it is only implemented by the
+     * classes of those objects.
+     */
+    virtual ObjectImp *clone() const;
+    /**
+     * @internal
+     *
+     * Called on a copy made by @ref clone() to make everything it refers to
+     * point to copies as well. Classes that hold references to other values
+     * outside of the property map must reimplement this and call the base
+     * class implementation.
+     */
+    virtual void cloneReferences(ObjectCloner &cloner);
+    /**
+     * @internal
+     *
+     * Puts copies of the properties of other into this object, replacing
+     * properties that have the same names.
+     */
+    void cloneProperties(const ObjectImp *other, ObjectCloner &cloner);
+    bool hasDirectProperties() const { return !_prop.isEmpty(); }
+
   protected:
+    /**
+     * Copies the properties, prototype, internal value and scope of other.
+     * Only for use by the implementations of @ref clone().
+     */
+    ObjectImp(const ObjectImp &other);
+
     PropertyMap _prop;
   private:
     const HashEntry* findPropertyHashEntry( const Identifier& propertyName ) const;
+    Value getLazyBuiltin(ExecState *exec, const Identifier &propertyName, ValueImp *placeholder) const;
     ValueImp *_proto;
     ValueImp *_internalValue;
     ScopeChain _scope;
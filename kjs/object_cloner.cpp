@@ -0,0 +1,162 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+#include "object_cloner.h"
+
+#include <stdlib.h>
+
+#include "object.h"
+
+namespace KJS {
+
+const int minTableSize = 256;
+
+// Golden ratio - arbitrary start value to avoid mapping all 0's to all 0's
+// or anything like that.
+const unsigned PHI = 0x9e3779b9U;
+
+static inline unsigned computeHash(ValueImp *pointer)
+{
+  unsigned long p = (unsigned long)pointer;
+  unsigned h = PHI ^ (unsigned)p ^ (unsigned)((p >> 16) >> 16);
+  // objects are at least 8 byte aligned, so mix the low bits in from above
+  h ^= (h >> 16);
+  h *= 0x85ebca6bU;
+  h ^= (h >> 13);
+  return h;
+}
+
+ObjectCloner::ObjectCloner()
+  : _table(0), _tableSize(0), _tableSizeMask(0), _keyCount(0),
+    _copies(0), _copyCount(0), _copyCapacity(0), _failed(false)
+{
+}
+
+ObjectCloner::~ObjectCloner()
+{
+  free(_table);
+  free(_copies);
+}
+
+void ObjectCloner::map(ValueImp *from, ValueImp *to)
+{
+  insert(from, to);
+}
+
+ValueImp *ObjectCloner::clone(ValueImp *v)
+{
+  if (!v || SimpleNumber::is(v))
+    return v;
+  if (ValueImp *copy = lookup(v))
+    return copy;
+  if (v->dispatchType() != ObjectType)
+    return v;
+
+  ObjectImp *copy = static_cast<ObjectImp *>(v)->clone();
+  if (!copy) {
+    _failed = true;
+    return v;
+  }
+  insert(v, copy);
+
+  if (_copyCount == _copyCapacity) {
+    _copyCapacity = _copyCapacity ? _copyCapacity * 2 : minTableSize / 2;
+    _copies = (ObjectImp **)realloc(_copies, _copyCapacity * sizeof(ObjectImp *));
+  }
+  _copies[_copyCount++] = copy;
+
+  return copy;
+}
+
+ObjectImp *ObjectCloner::clone(ObjectImp *o)
+{
+  return static_cast<ObjectImp *>(clone(static_cast<ValueImp *>(o)));
+}
+
+bool ObjectCloner::finish()
+{
+  // fixing up a copy can add more copies to the end of the list
+  for (int i = 0; i < _copyCount; ++i)
+    _copies[i]->cloneReferences(*this);
+
+#if !USE_CONSERVATIVE_GC
+  // Until now the copies were roots of the garbage collector, which kept
+  // the collector away from them while they still referred to the originals.
+  for (int i = 0; i < _copyCount; ++i)
+    _copies[i]->setGcAllowed();
+#endif
+
+  return !_failed;
+}
+
+ValueImp *ObjectCloner::lookup(ValueImp *from) const
+{
+  if (!_table)
+    return 0;
+
+  int i = computeHash(from) & _tableSizeMask;
+  while (ValueImp *key = _table[i].from) {
+    if (key == from)
+      return _table[i].to;
+    i = (i + 1) & _tableSizeMask;
+  }
+  return 0;
+}
+
+void ObjectCloner::insert(ValueImp *from, ValueImp *to)
+{
+  if (_keyCount * 2 >= _tableSize)
+    rehash(_tableSize ? _tableSize * 2 : minTableSize);
+
+  int i = computeHash(from) & _tableSizeMask;
+  while (ValueImp *key = _table[i].from) {
+    if (key == from) {
+      _table[i].to = to;
+      return;
+    }
+    i = (i + 1) & _tableSizeMask;
+  }
+  _table[i].from = from;
+  _table[i].to = to;
+  ++_keyCount;
+}
+
+void ObjectCloner::rehash(int newTableSize)
+{
+  Entry *oldTable = _table;
+  int oldTableSize = _tableSize;
+
+  _tableSize = newTableSize;
+  _tableSizeMask = newTableSize - 1;
+  _table = (Entry *)calloc(newTableSize, sizeof(Entry));
+  _keyCount = 0;
+
+  for (int i = 0; i != oldTableSize; ++i) {
+    if (oldTable[i].from)
+      insert(oldTable[i].from, oldTable[i].to);
+  }
+
+  free(oldTable);
+}
+
+} // namespace KJS
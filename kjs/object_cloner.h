@@ -0,0 +1,97 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+#ifndef _KJS_OBJECT_CLONER_H_
+#define _KJS_OBJECT_CLONER_H_
+
+namespace KJS {
+
+  class ObjectImp;
+  class ValueImp;
+
+  /**
+   * @internal
+   *
+   * @short Makes deep copies of graphs of objects.
+   *
+   * Used to set up interpreters from a snapshot of the built-in objects.
+   * @ref clone() copies an object with @ref ObjectImp::clone() the first time
+   * it is asked for it and returns the same copy afterwards; @ref finish()
+   * then makes the references held by the copies point to copies as well,
+   * copying whatever else they refer to. Primitive values are shared, since
+   * they can't be changed, unless @ref map() says otherwise.
+   */
+  class ObjectCloner {
+  public:
+    ObjectCloner();
+    ~ObjectCloner();
+
+    /**
+     * Makes clone() return to instead of a copy of from.
+     */
+    void map(ValueImp *from, ValueImp *to);
+
+    ValueImp *clone(ValueImp *v);
+    ObjectImp *clone(ObjectImp *o);
+
+    /**
+     * Records that an object could not be copied.
+     */
+    void fail() { _failed = true; }
+
+    /**
+     * Fixes up all the copies and hands them over to the garbage collector.
+     * Returns false if some object could not be copied, in which case the
+     * copies are incomplete and must not be used.
+     */
+    bool finish();
+
+  private:
+    struct Entry {
+      ValueImp *from;
+      ValueImp *to;
+    };
+
+    ValueImp *lookup(ValueImp *from) const;
+    void insert(ValueImp *from, ValueImp *to);
+    void rehash(int newTableSize);
+
+    Entry *_table;
+    int _tableSize;
+    int _tableSizeMask;
+    int _keyCount;
+
+    ObjectImp **_copies;
+    int _copyCount;
+    int _copyCapacity;
+
+    bool _failed;
+
+    // not implemented
+    ObjectCloner(const ObjectCloner &);
+    ObjectCloner &operator=(const ObjectCloner &);
+  };
+
+}; // namespace
+
+#endif
@@ -37,6 +37,7 @@ namespace KJS {
   class ObjectPrototypeImp : public ObjectImp {
   public:
     ObjectPrototypeImp(ExecState *exec, FunctionPrototypeImp *funcProto);
+    virtual ObjectImp *clone() const { return new ObjectPrototypeImp(*this); }
   };
 
   /**
@@ -49,6 +50,7 @@ namespace KJS {
   public:
     ObjectProtoFuncImp(ExecState *exec, FunctionPrototypeImp *funcProto,
                        int i, int len);
+    virtual ObjectImp *clone() const { return new ObjectProtoFuncImp(*this); }
 
     virtual bool implementsCall() const;
     virtual Value call(ExecState *exec, Object &thisObj, const List &args);
@@ -69,6 +71,7 @@ namespace KJS {
     ObjectObjectImp(ExecState *exec,
                     ObjectPrototypeImp *objProto,
                     FunctionPrototypeImp *funcProto);
+    virtual ObjectImp *clone() const { return new ObjectObjectImp(*this); }
 
     virtual bool implementsConstruct() const;
     virtual Object construct(ExecState *exec, const List &args);
@@ -0,0 +1,759 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "nodes.h"
+#include "operations.h"
+#include "simple_number.h"
+
+#include <math.h>
+
+using namespace KJS;
+
+bool Constant::toBoolean() const
+{
+  switch (type) {
+  case BooleanType:
+    return boolean;
+  case NumberType:
+    return !(number == 0 || isNaN(number));
+  case StringType:
+    return string.size() > 0;
+  default:
+    return false;
+  }
+}
+
+double Constant::toNumber() const
+{
+  switch (type) {
+  case BooleanType:
+    return boolean ? 1.0 : 0.0;
+  case NumberType:
+    return number;
+  case StringType:
+    return string.toDouble();
+  default:
+    return 0.0;
+  }
+}
+
+UString Constant::toString() const
+{
+  switch (type) {
+  case BooleanType:
+    return boolean ? "true" : "false";
+  case NumberType:
+    // numbers that are held as a SimpleNumber are printed as integers
+    if (SimpleNumber::fits(number))
+      return UString::from(static_cast<long>(number));
+    return UString::from(number);
+  case StringType:
+    return string;
+  default:
+    return "null";
+  }
+}
+
+// see roundValue() and ValueImp::toInt32()
+int32_t Constant::toInt32() const
+{
+  double d = toNumber();
+  if (isNaN(d) || isInf(d))
+    return 0;
+  if (d != 0)
+    d = copysign(floor(fabs(d)), d);
+  double d32 = fmod(d, D32);
+
+  if (d32 >= D32 / 2.0)
+    d32 -= D32;
+  else if (d32 < -D32 / 2.0)
+    d32 += D32;
+
+  return static_cast<int32_t>(d32);
+}
+
+uint32_t Constant::toUInt32() const
+{
+  double d = toNumber();
+  if (isNaN(d) || isInf(d))
+    return 0;
+  if (d != 0)
+    d = copysign(floor(fabs(d)), d);
+  double d32 = fmod(d, D32);
+
+  if (d32 < 0)
+    d32 += D32;
+
+  return static_cast<uint32_t>(d32);
+}
+
+// see equal() in operations.cpp
+static bool equalConstants(const Constant &c1, const Constant &c2)
+{
+  if (c1.type == c2.type) {
+    switch (c1.type) {
+    case NullType:
+      return true;
+    case BooleanType:
+      return c1.boolean == c2.boolean;
+    case StringType:
+      return c1.string == c2.string;
+    default:
+      break;
+    }
+  } else if (c1.type == NullType || c2.type == NullType) {
+    // null only equals undefined, which is not a literal
+    return false;
+  }
+
+  // mixed booleans, numbers and strings compare as numbers
+  double d1 = c1.toNumber();
+  double d2 = c2.toNumber();
+  if (isNaN(d1) || isNaN(d2))
+    return false;
+  return d1 == d2;
+}
+
+// see strictEqual() in operations.cpp
+static bool strictEqualConstants(const Constant &c1, const Constant &c2)
+{
+  if (c1.type != c2.type)
+    return false;
+  switch (c1.type) {
+  case NullType:
+    return true;
+  case BooleanType:
+    return c1.boolean == c2.boolean;
+  case StringType:
+    return c1.string == c2.string;
+  default:
+    if (isNaN(c1.number) || isNaN(c2.number))
+      return false;
+    return c1.number == c2.number;
+  }
+}
+
+// see relation() in operations.cpp
+static int compareConstants(const Constant &c1, const Constant &c2)
+{
+  if (c1.type == StringType && c2.type == StringType)
+    return c1.string < c2.string ? 1 : 0;
+
+  double n1 = c1.toNumber();
+  double n2 = c2.toNumber();
+  if (isNaN(n1) || isNaN(n2))
+    return -1; // means undefined
+  if (n1 == n2)
+    return 0;
+  if (isPosInf(n1))
+    return 0;
+  if (isPosInf(n2))
+    return 1;
+  if (isNegInf(n2))
+    return 0;
+  if (isNegInf(n1))
+    return 1;
+  return (n1 < n2) ? 1 : 0;
+}
+
+// ------------------------------ Optimizer ------------------------------------
+
+Node *Optimizer::number(double d, Node *replaced)
+{
+  Node *n = new NumberNode(d);
+  n->line = replaced->line;
+  n->sourceURL = replaced->sourceURL;
+  return n;
+}
+
+Node *Optimizer::string(const UString &s, Node *replaced)
+{
+  Node *n = new StringNode(&s);
+  n->line = replaced->line;
+  n->sourceURL = replaced->sourceURL;
+  return n;
+}
+
+Node *Optimizer::boolean(bool b, Node *replaced)
+{
+  Node *n = new BooleanNode(b);
+  n->line = replaced->line;
+  n->sourceURL = replaced->sourceURL;
+  return n;
+}
+
+// ------------------------------ literals -------------------------------------
+
+bool NullNode::constantValue(Constant &c) const
+{
+  c.type = NullType;
+  return true;
+}
+
+bool BooleanNode::constantValue(Constant &c) const
+{
+  c.type = BooleanType;
+  c.boolean = value;
+  return true;
+}
+
+bool NumberNode::constantValue(Constant &c) const
+{
+  c.type = NumberType;
+  c.number = value;
+  return true;
+}
+
+bool StringNode::constantValue(Constant &c) const
+{
+  c.type = StringType;
+  c.string = value;
+  return true;
+}
+
+// ------------------------------ expressions ----------------------------------
+
+Node *GroupNode::optimize(Optimizer &o)
+{
+  group = group->optimize(o);
+  // a group around anything else still matters to delete and assignments
+  Constant c;
+  return group->constantValue(c) ? group : this;
+}
+
+Node *ElementNode::optimize(Optimizer &o)
+{
+  for (ElementNode *n = this; n; n = n->list) {
+    if (n->node)
+      n->node = n->node->optimize(o);
+  }
+  return this;
+}
+
+Node *ArrayNode::optimize(Optimizer &o)
+{
+  if (element)
+    element->optimize(o);
+  return this;
+}
+
+Node *PropertyValueNode::optimize(Optimizer &o)
+{
+  for (PropertyValueNode *n = this; n; n = n->list)
+    n->assign = n->assign->optimize(o);
+  return this;
+}
+
+Node *ObjectLiteralNode::optimize(Optimizer &o)
+{
+  if (list)
+    list->optimize(o);
+  return this;
+}
+
+Node *AccessorNode1::optimize(Optimizer &o)
+{
+  expr1 = expr1->optimize(o);
+  expr2 = expr2->optimize(o);
+  return this;
+}
+
+Node *AccessorNode2::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  return this;
+}
+
+Node *ArgumentListNode::optimize(Optimizer &o)
+{
+  for (ArgumentListNode *n = this; n; n = n->list)
+    n->expr = n->expr->optimize(o);
+  return this;
+}
+
+Node *ArgumentsNode::optimize(Optimizer &o)
+{
+  if (list)
+    list->optimize(o);
+  return this;
+}
+
+Node *NewExprNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  if (args)
+    args->optimize(o);
+  return this;
+}
+
+Node *FunctionCallNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  args->optimize(o);
+  return this;
+}
+
+Node *PostfixNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  return this;
+}
+
+Node *DeleteNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  return this;
+}
+
+Node *VoidNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  return this;
+}
+
+Node *TypeOfNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  return this;
+}
+
+Node *PrefixNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  return this;
+}
+
+Node *UnaryPlusNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  Constant c;
+  if (!expr->constantValue(c))
+    return this;
+  return Optimizer::number(c.toNumber(), this);
+}
+
+Node *NegateNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  Constant c;
+  if (!expr->constantValue(c))
+    return this;
+  return Optimizer::number(-c.toNumber(), this);
+}
+
+Node *BitwiseNotNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  Constant c;
+  if (!expr->constantValue(c))
+    return this;
+  return Optimizer::number(~c.toInt32(), this);
+}
+
+Node *LogicalNotNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  Constant c;
+  if (!expr->constantValue(c))
+    return this;
+  return Optimizer::boolean(!c.toBoolean(), this);
+}
+
+Node *MultNode::optimize(Optimizer &o)
+{
+  term1 = term1->optimize(o);
+  term2 = term2->optimize(o);
+  Constant c1, c2;
+  if (!term1->constantValue(c1) || !term2->constantValue(c2))
+    return this;
+
+  double n1 = c1.toNumber();
+  double n2 = c2.toNumber();
+  double result;
+  if (oper == '*')
+    result = n1 * n2;
+  else if (oper == '/')
+    result = n1 / n2;
+  else
+    result = fmod(n1, n2);
+  return Optimizer::number(result, this);
+}
+
+Node *AddNode::optimize(Optimizer &o)
+{
+  term1 = term1->optimize(o);
+  term2 = term2->optimize(o);
+  Constant c1, c2;
+  if (!term1->constantValue(c1) || !term2->constantValue(c2))
+    return this;
+
+  if ((c1.type == StringType || c2.type == StringType) && oper == '+')
+    return Optimizer::string(c1.toString() + c2.toString(), this);
+
+  double n1 = c1.toNumber();
+  double n2 = c2.toNumber();
+  return Optimizer::number(oper == '+' ? n1 + n2 : n1 - n2, this);
+}
+
+Node *ShiftNode::optimize(Optimizer &o)
+{
+  term1 = term1->optimize(o);
+  term2 = term2->optimize(o);
+  Constant c1, c2;
+  if (!term1->constantValue(c1) || !term2->constantValue(c2))
+    return this;
+
+  unsigned int i2 = c2.toUInt32() & 0x1f;
+  long result;
+  if (oper == OpLShift)
+    result = c1.toInt32() << i2;
+  else if (oper == OpRShift)
+    result = c1.toInt32() >> i2;
+  else
+    result = c1.toUInt32() >> i2;
+  return Optimizer::number(static_cast<double>(result), this);
+}
+
+Node *RelationalNode::optimize(Optimizer &o)
+{
+  expr1 = expr1->optimize(o);
+  expr2 = expr2->optimize(o);
+  Constant c1, c2;
+  if (oper == OpIn || oper == OpInstanceOf ||
+      !expr1->constantValue(c1) || !expr2->constantValue(c2))
+    return this;
+
+  int r;
+  if (oper == OpLess || oper == OpGreaterEq) {
+    r = compareConstants(c1, c2);
+    if (r >= 0)
+      r = (oper == OpLess) ? (r == 1) : (r == 0);
+  } else {
+    r = compareConstants(c2, c1);
+    if (r >= 0)
+      r = (oper == OpGreater) ? (r == 1) : (r == 0);
+  }
+  return Optimizer::boolean(r > 0, this);
+}
+
+Node *EqualNode::optimize(Optimizer &o)
+{
+  expr1 = expr1->optimize(o);
+  expr2 = expr2->optimize(o);
+  Constant c1, c2;
+  if (!expr1->constantValue(c1) || !expr2->constantValue(c2))
+    return this;
+
+  bool result;
+  if (oper == OpEqEq || oper == OpNotEq)
+    result = equalConstants(c1, c2) == (oper == OpEqEq);
+  else
+    result = strictEqualConstants(c1, c2) == (oper == OpStrEq);
+  return Optimizer::boolean(result, this);
+}
+
+Node *BitOperNode::optimize(Optimizer &o)
+{
+  expr1 = expr1->optimize(o);
+  expr2 = expr2->optimize(o);
+  Constant c1, c2;
+  if (!expr1->constantValue(c1) || !expr2->constantValue(c2))
+    return this;
+
+  int i1 = c1.toInt32();
+  int i2 = c2.toInt32();
+  int result;
+  if (oper == OpBitAnd)
+    result = i1 & i2;
+  else if (oper == OpBitXOr)
+    result = i1 ^ i2;
+  else
+    result = i1 | i2;
+  return Optimizer::number(result, this);
+}
+
+Node *BinaryLogicalNode::optimize(Optimizer &o)
+{
+  expr1 = expr1->optimize(o);
+  expr2 = expr2->optimize(o);
+  Constant c;
+  if (!expr1->constantValue(c))
+    return this;
+
+  // the value of the first operand if it decides, the second one otherwise
+  bool b = c.toBoolean();
+  if ((!b && oper == OpAnd) || (b && oper == OpOr))
+    return expr1;
+  return expr2;
+}
+
+Node *ConditionalNode::optimize(Optimizer &o)
+{
+  logical = logical->optimize(o);
+  expr1 = expr1->optimize(o);
+  expr2 = expr2->optimize(o);
+  Constant c;
+  if (!logical->constantValue(c))
+    return this;
+  return c.toBoolean() ? expr1 : expr2;
+}
+
+Node *AssignNode::optimize(Optimizer &o)
+{
+  left = left->optimize(o);
+  expr = expr->optimize(o);
+  return this;
+}
+
+Node *CommaNode::optimize(Optimizer &o)
+{
+  expr1 = expr1->optimize(o);
+  expr2 = expr2->optimize(o);
+  return this;
+}
+
+Node *AssignExprNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  return this;
+}
+
+Node *VarDeclNode::optimize(Optimizer &o)
+{
+  o.declarations++;
+  if (init)
+    init->optimize(o);
+  return this;
+}
+
+Node *VarDeclListNode::optimize(Optimizer &o)
+{
+  for (VarDeclListNode *n = this; n; n = n->list)
+    n->var->optimize(o);
+  return this;
+}
+
+Node *CaseClauseNode::optimize(Optimizer &o)
+{
+  if (expr)
+    expr = expr->optimize(o);
+  if (list)
+    list->optimize(o);
+  return this;
+}
+
+Node *ClauseListNode::optimize(Optimizer &o)
+{
+  for (ClauseListNode *n = this; n; n = n->nx)
+    n->cl->optimize(o);
+  return this;
+}
+
+Node *CaseBlockNode::optimize(Optimizer &o)
+{
+  if (list1)
+    list1->optimize(o);
+  if (def)
+    def->optimize(o);
+  if (list2)
+    list2->optimize(o);
+  return this;
+}
+
+Node *FuncExprNode::optimize(Optimizer &o)
+{
+  body->optimize(o);
+  return this;
+}
+
+// ------------------------------ statements -----------------------------------
+
+StatementNode *StatListNode::optimize(Optimizer &o)
+{
+  for (StatListNode *n = this; n; n = n->list)
+    n->statement = n->statement->optimize(o);
+  return this;
+}
+
+StatementNode *VarStatementNode::optimize(Optimizer &o)
+{
+  list->optimize(o);
+  return this;
+}
+
+StatementNode *BlockNode::optimize(Optimizer &o)
+{
+  if (source)
+    source->optimize(o);
+  return this;
+}
+
+StatementNode *ExprStatementNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  return this;
+}
+
+StatementNode *IfNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  int declarations = o.declarations;
+  statement1 = statement1->optimize(o);
+  bool declares1 = o.declarations != declarations;
+  declarations = o.declarations;
+  if (statement2)
+    statement2 = statement2->optimize(o);
+  bool declares2 = o.declarations != declarations;
+
+  Constant c;
+  if (!expr->constantValue(c))
+    return this;
+  if (c.toBoolean()) {
+    if (!declares2)
+      return statement1;
+  } else if (!declares1) {
+    if (statement2)
+      return statement2;
+    StatementNode *empty = new EmptyStatementNode;
+    empty->setLoc(firstLine(), lastLine(), sourceId());
+    return empty;
+  }
+  return this;
+}
+
+StatementNode *DoWhileNode::optimize(Optimizer &o)
+{
+  statement = statement->optimize(o);
+  expr = expr->optimize(o);
+  return this;
+}
+
+StatementNode *WhileNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  statement = statement->optimize(o);
+  return this;
+}
+
+StatementNode *ForNode::optimize(Optimizer &o)
+{
+  if (expr1)
+    expr1 = expr1->optimize(o);
+  if (expr2)
+    expr2 = expr2->optimize(o);
+  if (expr3)
+    expr3 = expr3->optimize(o);
+  statement = statement->optimize(o);
+  return this;
+}
+
+StatementNode *ForInNode::optimize(Optimizer &o)
+{
+  if (varDecl)
+    varDecl->optimize(o);
+  else
+    lexpr = lexpr->optimize(o);
+  expr = expr->optimize(o);
+  statement = statement->optimize(o);
+  return this;
+}
+
+StatementNode *ReturnNode::optimize(Optimizer &o)
+{
+  if (value)
+    value = value->optimize(o);
+  return this;
+}
+
+StatementNode *WithNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  statement = statement->optimize(o);
+  return this;
+}
+
+StatementNode *SwitchNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  block->optimize(o);
+  return this;
+}
+
+StatementNode *LabelNode::optimize(Optimizer &o)
+{
+  statement = statement->optimize(o);
+  return this;
+}
+
+StatementNode *ThrowNode::optimize(Optimizer &o)
+{
+  expr = expr->optimize(o);
+  return this;
+}
+
+StatementNode *CatchNode::optimize(Optimizer &o)
+{
+  block = block->optimize(o);
+  return this;
+}
+
+StatementNode *FinallyNode::optimize(Optimizer &o)
+{
+  block = block->optimize(o);
+  return this;
+}
+
+StatementNode *TryNode::optimize(Optimizer &o)
+{
+  block = block->optimize(o);
+  if (_catch)
+    _catch->optimize(o);
+  if (_final)
+    _final->optimize(o);
+  return this;
+}
+
+StatementNode *FunctionBodyNode::optimize(Optimizer &o)
+{
+  // bodies parsed lazily are optimized when they are parsed
+  if (lazy)
+    return this;
+  // declarations in the body belong to the function, not to the code around it
+  int declarations = o.declarations;
+  BlockNode::optimize(o);
+  o.declarations = declarations;
+  return this;
+}
+
+StatementNode *FuncDeclNode::optimize(Optimizer &o)
+{
+  o.declarations++;
+  body->optimize(o);
+  return this;
+}
+
+StatementNode *SourceElementsNode::optimize(Optimizer &o)
+{
+  for (SourceElementsNode *n = this; n; n = n->elements)
+    n->element = n->element->optimize(o);
+  return this;
+}
@@ -0,0 +1,215 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "parsed_program.h"
+
+#include "internal.h"
+#include "interpreter.h"
+#include "nodes.h"
+#include "program_cache.h"
+#include "source_provider.h"
+
+using namespace KJS;
+
+// The characters of a string move when a string that shares them is
+// appended to, so the parsing thread gets copies of its own.
+static UString copy(const UString &s)
+{
+  if (s.isNull())
+    return UString();
+  if (const char *c = s.latin1Data())
+    return UString(c, s.size(), Latin1Encoding);
+  return UString(s.data(), s.size());
+}
+
+ParsedProgram::ParsedProgram(const UString &sourceURL, int startingLineNumber, const UString &code)
+  : _sourceURL(sourceURL), _startingLineNumber(startingLineNumber), _source(SourceProvider::create(code)),
+    _program(0), _sourceId(-1), _errorLine(-1), _background(false), _finished(false)
+{
+  pthread_mutex_init(&_lock, 0);
+  pthread_cond_init(&_finishedCondition, 0);
+  parse();
+}
+
+ParsedProgram::ParsedProgram(const UString &sourceURL, int startingLineNumber, SourceProvider *source)
+  : _sourceURL(sourceURL), _startingLineNumber(startingLineNumber), _source(source),
+    _program(0), _sourceId(-1), _errorLine(-1), _background(false), _finished(false)
+{
+  _source->ref();
+  pthread_mutex_init(&_lock, 0);
+  pthread_cond_init(&_finishedCondition, 0);
+  parse();
+}
+
+ParsedProgram::ParsedProgram(const UString &sourceURL, int startingLineNumber, SourceProvider *source, bool background)
+  : _sourceURL(copy(sourceURL)), _startingLineNumber(startingLineNumber), _source(source),
+    _program(0), _sourceId(-1), _errorLine(-1), _background(background), _finished(false)
+{
+  pthread_mutex_init(&_lock, 0);
+  pthread_cond_init(&_finishedCondition, 0);
+}
+
+ParsedProgram::~ParsedProgram()
+{
+  if (_background) {
+    waitUntilFinished();
+    pthread_join(_thread, 0);
+  }
+
+  Interpreter::lock();
+  if (_program)
+    _program->deref();
+  _source->deref();
+  Interpreter::unlock();
+
+  pthread_cond_destroy(&_finishedCondition);
+  pthread_mutex_destroy(&_lock);
+}
+
+ParsedProgram *ParsedProgram::parseInBackground(const UString &sourceURL, int startingLineNumber,
+                                                const UString &code)
+{
+  return startParse(new ParsedProgram(sourceURL, startingLineNumber, SourceProvider::create(copy(code)), true));
+}
+
+ParsedProgram *ParsedProgram::parseInBackground(const UString &sourceURL, int startingLineNumber,
+                                                SourceProvider *source)
+{
+  return startParse(new ParsedProgram(sourceURL, startingLineNumber, source->forOtherThread(), true));
+}
+
+ParsedProgram *ParsedProgram::startParse(ParsedProgram *program)
+{
+  if (pthread_create(&program->_thread, 0, parseThread, program) != 0) {
+    // no thread to be had, so parse right here
+    program->_background = false;
+    program->parse();
+  }
+  return program;
+}
+
+void *ParsedProgram::parseThread(void *program)
+{
+  static_cast<ParsedProgram *>(program)->parse();
+  return 0;
+}
+
+void ParsedProgram::parse()
+{
+  if (_background) {
+    // Identifiers and strings can be made on any thread, so the parse runs
+    // without the interpreter lock. The cache of trees cannot, so it is
+    // left out. Nothing else sees the tree until it is handed over below.
+    _program = Parser::parse(_sourceURL, _startingLineNumber, _source,
+                             &_sourceId, &_errorLine, &_errorMessage);
+    if (_program)
+      _program->ref();
+    Parser::deleteCurr();
+  } else {
+    Interpreter::lock();
+    _program = ProgramCache::shared()->parse(_sourceURL, _startingLineNumber, _source,
+                                             &_sourceId, &_errorLine, &_errorMessage);
+    if (_program)
+      _program->ref();
+    Interpreter::unlock();
+  }
+
+  pthread_mutex_lock(&_lock);
+  _finished = true;
+  pthread_cond_broadcast(&_finishedCondition);
+  pthread_mutex_unlock(&_lock);
+}
+
+bool ParsedProgram::isFinished() const
+{
+  pthread_mutex_lock(&_lock);
+  bool finished = _finished;
+  pthread_mutex_unlock(&_lock);
+  return finished;
+}
+
+void ParsedProgram::waitUntilFinished() const
+{
+  if (isFinished())
+    return;
+
+  // the parsing thread takes the interpreter lock to drop its parser
+  int depth = InterpreterImp::dropLock();
+  pthread_mutex_lock(&_lock);
+  while (!_finished)
+    pthread_cond_wait(&_finishedCondition, &_lock);
+  pthread_mutex_unlock(&_lock);
+  InterpreterImp::restoreLock(depth);
+}
+
+bool ParsedProgram::isValid() const
+{
+  waitUntilFinished();
+  return _program != 0;
+}
+
+int ParsedProgram::errorLine() const
+{
+  waitUntilFinished();
+  return _errorLine;
+}
+
+UString ParsedProgram::errorMessage() const
+{
+  waitUntilFinished();
+  return _errorMessage;
+}
+
+UString ParsedProgram::sourceURL() const
+{
+  waitUntilFinished();
+  return _sourceURL;
+}
+
+int ParsedProgram::startingLineNumber() const
+{
+  return _startingLineNumber;
+}
+
+UString ParsedProgram::code() const
+{
+  waitUntilFinished();
+  return _source->toUString();
+}
+
+SourceProvider *ParsedProgram::source() const
+{
+  waitUntilFinished();
+  return _source;
+}
+
+ProgramNode *ParsedProgram::programNode() const
+{
+  waitUntilFinished();
+  return _program;
+}
+
+int ParsedProgram::sourceId() const
+{
+  waitUntilFinished();
+  return _sourceId;
+}
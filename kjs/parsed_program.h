@@ -0,0 +1,137 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef _KJS_PARSED_PROGRAM_H_
+#define _KJS_PARSED_PROGRAM_H_
+
+#include <pthread.h>
+
+#include "ustring.h"
+
+namespace KJS {
+
+  class ProgramNode;
+  class SourceProvider;
+
+  /**
+   * @short A script that was parsed ahead of time.
+   *
+   * The parse can run on a thread of its own, see @ref parseInBackground(),
+   * so that a script is ready by the time it is needed. Any interpreter can
+   * then run the program with @ref Interpreter::evaluate(), as often as it
+   * likes.
+   *
+   * Every thread parses with a lexer and parser state of its own, and
+   * strings and identifiers can be made on any thread. So a background
+   * parse runs without the interpreter lock (see @ref Interpreter::lock()),
+   * alongside threads that run scripts. It does not use the cache of
+   * parsed programs, which needs the lock.
+   */
+  class ParsedProgram {
+  public:
+    /**
+     * Parses code on the calling thread.
+     */
+    ParsedProgram(const UString &sourceURL, int startingLineNumber, const UString &code);
+    /**
+     * Parses the text of source on the calling thread. The program keeps a
+     * reference to source.
+     */
+    ParsedProgram(const UString &sourceURL, int startingLineNumber, SourceProvider *source);
+    /**
+     * Waits for a background parse to finish, then releases the tree.
+     */
+    ~ParsedProgram();
+
+    /**
+     * Starts a new thread that parses code, and returns at once. The
+     * caller owns the returned object. Like the rest of the API, this has
+     * to be called with the interpreter lock held. A source whose text is
+     * in a UString is copied for the thread.
+     */
+    static ParsedProgram *parseInBackground(const UString &sourceURL, int startingLineNumber,
+                                            const UString &code);
+    static ParsedProgram *parseInBackground(const UString &sourceURL, int startingLineNumber,
+                                            SourceProvider *source);
+
+    /**
+     * Returns true once the parse is done. Does not block.
+     */
+    bool isFinished() const;
+    /**
+     * Blocks until the parse is done.
+     */
+    void waitUntilFinished() const;
+
+    /**
+     * Returns true if the code had no syntax errors. This and the accessors
+     * below wait for the parse to finish.
+     */
+    bool isValid() const;
+    int errorLine() const;
+    UString errorMessage() const;
+
+    UString sourceURL() const;
+    int startingLineNumber() const;
+    UString code() const;
+    SourceProvider *source() const;
+
+    /**
+     * @internal
+     *
+     * The tree, or 0 after a syntax error.
+     */
+    ProgramNode *programNode() const;
+    /**
+     * @internal
+     */
+    int sourceId() const;
+
+  private:
+    ParsedProgram(const UString &sourceURL, int startingLineNumber, SourceProvider *source, bool background);
+    static ParsedProgram *startParse(ParsedProgram *program);
+    void parse();
+    static void *parseThread(void *program);
+
+    UString _sourceURL;
+    int _startingLineNumber;
+    SourceProvider *_source;
+
+    ProgramNode *_program;
+    int _sourceId;
+    int _errorLine;
+    UString _errorMessage;
+
+    bool _background;
+    bool _finished;
+    pthread_t _thread;
+    mutable pthread_mutex_t _lock;
+    mutable pthread_cond_t _finishedCondition;
+
+    // not implemented
+    ParsedProgram(const ParsedProgram &);
+    ParsedProgram &operator=(const ParsedProgram &);
+  };
+
+}; // namespace
+
+#endif
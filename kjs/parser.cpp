@@ -0,0 +1,1276 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "parser.h"
+
+#include "internal.h"
+#include "lexer.h"
+#include "node_arena.h"
+#include "nodes.h"
+#include "tokens.h"
+
+using namespace KJS;
+
+// the lookahead has not been read yet
+static const int NoToken = -2;
+
+// Deeper nesting is a syntax error. Keeps parses on the small stacks of
+// secondary threads safe.
+static const int MaxDepth = 1000;
+
+static bool isUnaryOperator(int token)
+{
+  switch (token) {
+  case DELETE:
+  case VOID:
+  case TYPEOF:
+  case PLUSPLUS:
+  case AUTOPLUSPLUS:
+  case MINUSMINUS:
+  case AUTOMINUSMINUS:
+  case '+':
+  case '-':
+  case '~':
+  case '!':
+    return true;
+  default:
+    return false;
+  }
+}
+
+static bool startsExpression(int token)
+{
+  switch (token) {
+  case THIS:
+  case IDENT:
+  case NULLTOKEN:
+  case TRUETOKEN:
+  case FALSETOKEN:
+  case NUMBER:
+  case STRING:
+  case '/':
+  case DIVEQUAL:
+  case '(':
+  case '[':
+  case '{':
+  case FUNCTION:
+  case NEW:
+    return true;
+  default:
+    return isUnaryOperator(token);
+  }
+}
+
+static bool assignmentOperator(int token, Operator &op)
+{
+  switch (token) {
+  case '=':          op = OpEqual; break;
+  case PLUSEQUAL:    op = OpPlusEq; break;
+  case MINUSEQUAL:   op = OpMinusEq; break;
+  case MULTEQUAL:    op = OpMultEq; break;
+  case DIVEQUAL:     op = OpDivEq; break;
+  case LSHIFTEQUAL:  op = OpLShift; break;
+  case RSHIFTEQUAL:  op = OpRShift; break;
+  case URSHIFTEQUAL: op = OpURShift; break;
+  case ANDEQUAL:     op = OpAndEq; break;
+  case XOREQUAL:     op = OpXOrEq; break;
+  case OREQUAL:      op = OpOrEq; break;
+  case MODEQUAL:     op = OpModEq; break;
+  default:
+    return false;
+  }
+  return true;
+}
+
+// binding strength of a binary operator, 0 for other tokens
+static int binaryPrecedence(int token)
+{
+  switch (token) {
+  case OR:
+    return 1;
+  case AND:
+    return 2;
+  case '|':
+    return 3;
+  case '^':
+    return 4;
+  case '&':
+    return 5;
+  case EQEQ:
+  case NE:
+  case STREQ:
+  case STRNEQ:
+    return 6;
+  case '<':
+  case '>':
+  case LE:
+  case GE:
+  case INSTANCEOF:
+  case IN:
+    return 7;
+  case LSHIFT:
+  case RSHIFT:
+  case URSHIFT:
+    return 8;
+  case '+':
+  case '-':
+    return 9;
+  case '*':
+  case '/':
+  case '%':
+    return 10;
+  default:
+    return 0;
+  }
+}
+
+static Node *makeBinary(int token, Node *left, Node *right)
+{
+  switch (token) {
+  case OR:         return new BinaryLogicalNode(left, OpOr, right);
+  case AND:        return new BinaryLogicalNode(left, OpAnd, right);
+  case '|':        return new BitOperNode(left, OpBitOr, right);
+  case '^':        return new BitOperNode(left, OpBitXOr, right);
+  case '&':        return new BitOperNode(left, OpBitAnd, right);
+  case EQEQ:       return new EqualNode(left, OpEqEq, right);
+  case NE:         return new EqualNode(left, OpNotEq, right);
+  case STREQ:      return new EqualNode(left, OpStrEq, right);
+  case STRNEQ:     return new EqualNode(left, OpStrNEq, right);
+  case '<':        return new RelationalNode(left, OpLess, right);
+  case '>':        return new RelationalNode(left, OpGreater, right);
+  case LE:         return new RelationalNode(left, OpLessEq, right);
+  case GE:         return new RelationalNode(left, OpGreaterEq, right);
+  case INSTANCEOF: return new RelationalNode(left, OpInstanceOf, right);
+  case IN:         return new RelationalNode(left, OpIn, right);
+  case LSHIFT:     return new ShiftNode(left, OpLShift, right);
+  case RSHIFT:     return new ShiftNode(left, OpRShift, right);
+  case URSHIFT:    return new ShiftNode(left, OpURShift, right);
+  case '+':        return new AddNode(left, right, '+');
+  case '-':        return new AddNode(left, right, '-');
+  case '*':        return new MultNode(left, right, '*');
+  case '/':        return new MultNode(left, right, '/');
+  default:         return new MultNode(left, right, '%');
+  }
+}
+
+ProgramNode *DescentParser::parse(Parser *parser, Lexer *lexer)
+{
+  DescentParser descent(parser, lexer);
+  return descent.parseProgram();
+}
+
+DescentParser::DescentParser(Parser *p, Lexer *l)
+  : parser(p), lexer(l), token(NoToken), number(0), string(0), ident(0),
+    tokenFirstLine(0), tokenLastLine(0), tokenStart(0), tokenEnd(0), lastLine(0), lastEnd(0),
+    lastToken(0), depth(0), checking(false), lastDeclaration(0)
+{
+}
+
+// Tokens are read only when the parser has to look at them, because nodes
+// pick up their line from the lexer.
+int DescentParser::peek()
+{
+  if (token != NoToken)
+    return token;
+
+  TokenValue value;
+  TokenLocation location;
+  location.first_line = location.last_line = lexer->lineNo();
+  location.first_column = location.last_column = 0;
+  token = lexer->lex(&value, &location);
+  // stop at a token the lexer could not read
+  if (token < 0)
+    token = 0;
+  else if (checking) {
+    // the lexer made no values, the trees are thrown away anyway
+    ident = &Identifier::null();
+    string = &UString::null();
+    number = 0;
+  } else if (token == IDENT)
+    ident = value.ident;
+  else if (token == STRING)
+    string = value.ustr;
+  else if (token == NUMBER)
+    number = value.dval;
+  tokenFirstLine = location.first_line;
+  tokenLastLine = location.last_line;
+  tokenStart = location.first_column;
+  tokenEnd = location.last_column;
+  return token;
+}
+
+void DescentParser::next()
+{
+  lastToken = peek();
+  lastLine = tokenLastLine;
+  lastEnd = tokenEnd;
+  token = NoToken;
+}
+
+bool DescentParser::match(int t)
+{
+  if (peek() != t)
+    return false;
+  next();
+  return true;
+}
+
+// may we automatically insert a semicolon before the lookahead?
+bool DescentParser::automaticSemicolon()
+{
+  int t = peek();
+  return t == '}' || t == 0 || lexer->prevTerminator();
+}
+
+ProgramNode *DescentParser::parseProgram()
+{
+  SourceElementsNode *elements = 0;
+  if (peek() != 0) {
+    elements = parseSourceElements(0);
+    if (!elements)
+      return 0;
+  }
+  return new ProgramNode(elements);
+}
+
+// parses one element or more, up to the end token
+SourceElementsNode *DescentParser::parseSourceElements(int end)
+{
+  SourceElementsNode *elements = 0;
+  do {
+    StatementNode *element = parseSourceElement();
+    if (!element)
+      return 0;
+    elements = elements ? new SourceElementsNode(elements, element) : new SourceElementsNode(element);
+  } while (peek() != end);
+  return elements;
+}
+
+StatementNode *DescentParser::parseSourceElement()
+{
+  if (peek() == FUNCTION)
+    return parseFunctionDeclaration();
+  return parseStatement();
+}
+
+StatementNode *DescentParser::parseStatement()
+{
+  if (depth == MaxDepth)
+    return 0;
+  depth++;
+
+  StatementNode *statement;
+  switch (peek()) {
+  case '{':
+    statement = parseBlock(true);
+    break;
+  case VAR:
+    statement = parseVariableStatement();
+    break;
+  case ';':
+    next();
+    statement = new EmptyStatementNode();
+    break;
+  case IF:
+    statement = parseIfStatement();
+    break;
+  case DO:
+    statement = parseDoWhileStatement();
+    break;
+  case WHILE:
+    statement = parseWhileStatement();
+    break;
+  case FOR:
+    statement = parseForStatement();
+    break;
+  case CONTINUE:
+    statement = parseContinueOrBreakStatement(false);
+    break;
+  case BREAK:
+    statement = parseContinueOrBreakStatement(true);
+    break;
+  case RETURN:
+    statement = parseReturnStatement();
+    break;
+  case WITH:
+    statement = parseWithStatement();
+    break;
+  case SWITCH:
+    statement = parseSwitchStatement();
+    break;
+  case THROW:
+    statement = parseThrowStatement();
+    break;
+  case TRY:
+    statement = parseTryStatement();
+    break;
+  case IDENT: {
+    // a label, or the start of an expression
+    int firstLine = tokenFirstLine;
+    const Identifier *name = ident;
+    next();
+    if (match(':')) {
+      statement = parseStatement();
+      if (statement) {
+        statement->pushLabel(*name);
+        statement = new LabelNode(*name, statement);
+      }
+    } else
+      statement = parseExpressionStatement(new ResolveNode(*name), firstLine);
+    break;
+  }
+  default:
+    statement = parseExpressionStatement(0, tokenFirstLine);
+    break;
+  }
+
+  depth--;
+  return statement;
+}
+
+// inStatement is false for the blocks of try statements
+StatementNode *DescentParser::parseBlock(bool inStatement)
+{
+  next();
+  SourceElementsNode *elements = 0;
+  if (peek() != '}') {
+    elements = parseSourceElements('}');
+    if (!elements)
+      return 0;
+  }
+  int closeLine = tokenFirstLine;
+  next();
+  // Where a statement may start, "{}" could also be an empty object
+  // literal, so the next token is read before the node takes its line
+  // from the lexer.
+  if (inStatement && !elements)
+    peek();
+  StatementNode *block = new BlockNode(elements);
+  block->setLoc(closeLine, lastLine, parser->sid);
+  return block;
+}
+
+StatementNode *DescentParser::parseVariableStatement()
+{
+  int firstLine = tokenFirstLine;
+  next();
+  VarDeclListNode *list = parseVariableDeclarationList(0);
+  if (!list)
+    return 0;
+
+  int listLastLine = lastLine;
+  if (match(';'))
+    listLastLine = lastLine;
+  else if (!automaticSemicolon())
+    return 0;
+  StatementNode *statement = new VarStatementNode(list);
+  statement->setLoc(firstLine, listLastLine, parser->sid);
+  return statement;
+}
+
+// appends declarations to list, which may be 0
+VarDeclListNode *DescentParser::parseVariableDeclarationList(VarDeclListNode *list)
+{
+  do {
+    if (peek() != IDENT)
+      break;
+    const Identifier *name = ident;
+    next();
+    AssignExprNode *init = 0;
+    if (peek() == '=') {
+      init = parseInitializer();
+      if (!init)
+        break;
+    }
+    VarDeclNode *decl = new VarDeclNode(*name, init);
+    list = list ? new VarDeclListNode(list, decl) : new VarDeclListNode(decl);
+    if (!match(','))
+      return list;
+  } while (true);
+
+  return 0;
+}
+
+AssignExprNode *DescentParser::parseInitializer()
+{
+  next();
+  Node *expr = parseAssignment();
+  return expr ? new AssignExprNode(expr) : 0;
+}
+
+// start is the beginning of the expression if the caller already read it
+StatementNode *DescentParser::parseExpressionStatement(Node *start, int firstLine)
+{
+  Node *expr = parseExpression(start);
+  if (!expr)
+    return 0;
+
+  int exprLastLine = lastLine;
+  if (match(';'))
+    exprLastLine = lastLine;
+  else if (!automaticSemicolon())
+    return 0;
+  StatementNode *statement = new ExprStatementNode(expr);
+  statement->setLoc(firstLine, exprLastLine, parser->sid);
+  return statement;
+}
+
+StatementNode *DescentParser::parseIfStatement()
+{
+  int firstLine = tokenFirstLine;
+  next();
+  if (!match('('))
+    return 0;
+  Node *condition = parseExpression();
+  if (!condition)
+    return 0;
+  if (!match(')'))
+    return 0;
+  int headLastLine = lastLine;
+
+  StatementNode *ifTrue = parseStatement();
+  StatementNode *ifFalse = 0;
+  if (ifTrue && match(ELSE)) {
+    ifFalse = parseStatement();
+    if (!ifFalse)
+      return 0;
+  }
+  if (!ifTrue)
+    return 0;
+
+  StatementNode *statement = new IfNode(condition, ifTrue, ifFalse);
+  statement->setLoc(firstLine, headLastLine, parser->sid);
+  return statement;
+}
+
+StatementNode *DescentParser::parseDoWhileStatement()
+{
+  int firstLine = tokenFirstLine;
+  next();
+  StatementNode *body = parseStatement();
+  if (!body)
+    return 0;
+
+  Node *condition = 0;
+  int whileLine = peek() == WHILE ? tokenLastLine : 0;
+  if (match(WHILE) && match('(') && (condition = parseExpression()) && match(')')) {
+    StatementNode *statement = new DoWhileNode(body, condition);
+    statement->setLoc(firstLine, whileLine, parser->sid);
+    return statement;
+  }
+  return 0;
+}
+
+StatementNode *DescentParser::parseWhileStatement()
+{
+  int firstLine = tokenFirstLine;
+  next();
+  if (!match('('))
+    return 0;
+  Node *condition = parseExpression();
+  if (!condition)
+    return 0;
+  if (!match(')'))
+    return 0;
+  int headLastLine = lastLine;
+
+  StatementNode *body = parseStatement();
+  if (!body)
+    return 0;
+  StatementNode *statement = new WhileNode(condition, body);
+  statement->setLoc(firstLine, headLastLine, parser->sid);
+  return statement;
+}
+
+StatementNode *DescentParser::parseForStatement()
+{
+  int firstLine = tokenFirstLine;
+  next();
+  if (!match('('))
+    return 0;
+
+  if (match(VAR)) {
+    if (peek() != IDENT)
+      return 0;
+    const Identifier *name = ident;
+    next();
+    AssignExprNode *init = 0;
+    if (peek() == '=') {
+      init = parseInitializer();
+      if (!init)
+        return 0;
+    }
+    if (peek() == IN)
+      return parseForInRest(0, name, init, firstLine);
+
+    VarDeclListNode *vars = new VarDeclListNode(new VarDeclNode(*name, init));
+    if (match(',')) {
+      vars = parseVariableDeclarationList(vars);
+      if (!vars)
+        return 0;
+    }
+    return parseForRest(0, vars, firstLine);
+  }
+
+  Node *init = 0;
+  if (peek() != ';') {
+    // "for (a.b in c)" starts like an expression
+    Node *left = 0;
+    if (!isUnaryOperator(peek())) {
+      left = parseLeftHandSide(0);
+      if (!left)
+        return 0;
+      if (peek() == IN)
+        return parseForInRest(left, 0, 0, firstLine);
+    }
+    init = parseExpression(left);
+    if (!init)
+      return 0;
+  }
+  return parseForRest(init, 0, firstLine);
+}
+
+// the part of "for (init; condition; update) statement" after init
+StatementNode *DescentParser::parseForRest(Node *init, VarDeclListNode *vars, int firstLine)
+{
+  Node *condition = 0;
+  Node *update = 0;
+  StatementNode *body = 0;
+
+  bool ok = match(';');
+  if (ok && peek() != ';')
+    ok = (condition = parseExpression()) != 0;
+  ok = ok && match(';');
+  if (ok && peek() != ')')
+    ok = (update = parseExpression()) != 0;
+  ok = ok && match(')');
+  int headLastLine = lastLine;
+  if (ok)
+    body = parseStatement();
+  if (!body)
+    return 0;
+
+  StatementNode *statement = vars ? new ForNode(vars, condition, update, body)
+                                  : new ForNode(init, condition, update, body);
+  statement->setLoc(firstLine, headLastLine, parser->sid);
+  return statement;
+}
+
+// the part of "for (left in expr) statement" from "in" on; var is the
+// declared variable if there is one instead of left
+StatementNode *DescentParser::parseForInRest(Node *left, const Identifier *var, AssignExprNode *init, int firstLine)
+{
+  next();
+  Node *expr = parseExpression();
+  StatementNode *body = 0;
+  int headLastLine = 0;
+  if (expr && match(')')) {
+    headLastLine = lastLine;
+    body = parseStatement();
+  }
+  if (!body)
+    return 0;
+
+  StatementNode *statement = var ? new ForInNode(*var, init, expr, body) : new ForInNode(left, expr, body);
+  statement->setLoc(firstLine, headLastLine, parser->sid);
+  return statement;
+}
+
+StatementNode *DescentParser::parseContinueOrBreakStatement(bool isBreak)
+{
+  int firstLine = tokenFirstLine;
+  int keywordLine = tokenLastLine;
+  next();
+  const Identifier *label = 0;
+  if (peek() == IDENT) {
+    label = ident;
+    next();
+  }
+
+  // where the statement ends for the debugger differs between the cases
+  int endLine;
+  if (match(';'))
+    endLine = lastLine;
+  else if (automaticSemicolon())
+    endLine = label ? lastLine : isBreak ? keywordLine : tokenLastLine;
+  else
+    return 0;
+
+  StatementNode *statement;
+  if (isBreak)
+    statement = label ? new BreakNode(*label) : new BreakNode();
+  else
+    statement = label ? new ContinueNode(*label) : new ContinueNode();
+  statement->setLoc(firstLine, endLine, parser->sid);
+  return statement;
+}
+
+StatementNode *DescentParser::parseReturnStatement()
+{
+  int firstLine = tokenFirstLine;
+  next();
+
+  if (startsExpression(peek())) {
+    Node *value = parseExpression();
+    if (!value)
+      return 0;
+    if (!match(';') && !automaticSemicolon())
+      return 0;
+    return new ReturnNode(value);
+  }
+
+  int endLine = lastLine;
+  if (match(';'))
+    endLine = lastLine;
+  else if (!automaticSemicolon())
+    return 0;
+  StatementNode *statement = new ReturnNode(0);
+  statement->setLoc(firstLine, endLine, parser->sid);
+  return statement;
+}
+
+StatementNode *DescentParser::parseWithStatement()
+{
+  int firstLine = tokenFirstLine;
+  next();
+  if (!match('('))
+    return 0;
+  Node *object = parseExpression();
+  if (!object)
+    return 0;
+  if (!match(')'))
+    return 0;
+  int headLastLine = lastLine;
+
+  StatementNode *body = parseStatement();
+  if (!body)
+    return 0;
+  StatementNode *statement = new WithNode(object, body);
+  statement->setLoc(firstLine, headLastLine, parser->sid);
+  return statement;
+}
+
+StatementNode *DescentParser::parseSwitchStatement()
+{
+  int firstLine = tokenFirstLine;
+  next();
+  if (!match('('))
+    return 0;
+  Node *expr = parseExpression();
+  if (!expr)
+    return 0;
+  bool ok = match(')');
+  int headLastLine = lastLine;
+  if (!ok || !match('{'))
+    return 0;
+
+  // the clauses before and after the default clause
+  ClauseListNode *before = 0;
+  ClauseListNode *after = 0;
+  CaseClauseNode *defaultClause = 0;
+  while (ok && peek() != '}') {
+    if (peek() == CASE) {
+      CaseClauseNode *clause = parseCaseClause();
+      if (!clause)
+        ok = false;
+      else if (defaultClause)
+        after = after ? new ClauseListNode(after, clause) : new ClauseListNode(clause);
+      else
+        before = before ? new ClauseListNode(before, clause) : new ClauseListNode(clause);
+    } else if (peek() == DEFAULT && !defaultClause) {
+      next();
+      if (!match(':'))
+        ok = false;
+      else if (peek() == CASE || peek() == DEFAULT || peek() == '}')
+        defaultClause = new CaseClauseNode(0);
+      else {
+        StatListNode *statements = parseStatementList();
+        if (statements)
+          defaultClause = new CaseClauseNode(0, statements);
+        else
+          ok = false;
+      }
+    } else
+      ok = false;
+  }
+
+  if (!ok)
+    return 0;
+  next();
+  StatementNode *statement = new SwitchNode(expr, new CaseBlockNode(before, defaultClause, after));
+  statement->setLoc(firstLine, headLastLine, parser->sid);
+  return statement;
+}
+
+CaseClauseNode *DescentParser::parseCaseClause()
+{
+  next();
+  Node *expr = parseExpression();
+  if (!expr)
+    return 0;
+  if (!match(':'))
+    return 0;
+  if (peek() == CASE || peek() == DEFAULT || peek() == '}')
+    return new CaseClauseNode(expr);
+
+  StatListNode *statements = parseStatementList();
+  if (!statements)
+    return 0;
+  return new CaseClauseNode(expr, statements);
+}
+
+// statements up to the next clause of a switch
+StatListNode *DescentParser::parseStatementList()
+{
+  StatListNode *list = 0;
+  do {
+    StatementNode *statement = parseStatement();
+    if (!statement)
+      return 0;
+    list = list ? new StatListNode(list, statement) : new StatListNode(statement);
+  } while (peek() != CASE && peek() != DEFAULT && peek() != '}');
+  return list;
+}
+
+StatementNode *DescentParser::parseThrowStatement()
+{
+  next();
+  Node *expr = parseExpression();
+  if (!expr)
+    return 0;
+  // unlike the other statements, there is no automatic semicolon here
+  if (!match(';'))
+    return 0;
+  return new ThrowNode(expr);
+}
+
+StatementNode *DescentParser::parseTryStatement()
+{
+  next();
+  if (peek() != '{')
+    return 0;
+  StatementNode *block = parseBlock(false);
+  if (!block)
+    return 0;
+
+  CatchNode *catchNode = 0;
+  FinallyNode *finallyNode = 0;
+  bool ok = true;
+  if (match(CATCH)) {
+    ok = false;
+    if (match('(') && peek() == IDENT) {
+      const Identifier *name = ident;
+      next();
+      if (match(')') && peek() == '{') {
+        StatementNode *catchBlock = parseBlock(false);
+        if (catchBlock) {
+          catchNode = new CatchNode(*name, catchBlock);
+          ok = true;
+        }
+      }
+    }
+  }
+  if (ok && match(FINALLY)) {
+    ok = false;
+    if (peek() == '{') {
+      StatementNode *finallyBlock = parseBlock(false);
+      if (finallyBlock) {
+        finallyNode = new FinallyNode(finallyBlock);
+        ok = true;
+      }
+    }
+  }
+
+  if (!ok || (!catchNode && !finallyNode))
+    return 0;
+  return new TryNode(block, catchNode, finallyNode);
+}
+
+// "function" at the start of a source element begins a declaration, unless
+// there is no name
+StatementNode *DescentParser::parseFunctionDeclaration()
+{
+  int firstLine = tokenFirstLine;
+  int start = tokenStart;
+  next();
+  if (peek() != IDENT) {
+    Node *function = parseFunctionExpression(start, true);
+    if (!function)
+      return 0;
+    return parseExpressionStatement(function, firstLine);
+  }
+
+  const Identifier *name = ident;
+  next();
+  ParameterNode *parameters;
+  FunctionBodyNode *body;
+  if (!parseFunction(start, true, parameters, body))
+    return 0;
+  lastDeclaration = parameters ? new FuncDeclNode(*name, parameters, body) : new FuncDeclNode(*name, body);
+  return lastDeclaration;
+}
+
+// the part of a function expression after "function", which starts at start
+Node *DescentParser::parseFunctionExpression(int start, bool lazy)
+{
+  ParameterNode *parameters;
+  FunctionBodyNode *body;
+  if (!parseFunction(start, lazy, parameters, body))
+    return 0;
+  return parameters ? new FuncExprNode(parameters, body) : new FuncExprNode(body);
+}
+
+// "(parameters) { body }" of the function that starts at start; lazy is
+// whether the body may be parsed when the function is first called
+bool DescentParser::parseFunction(int start, bool lazy, ParameterNode *&parameters, FunctionBodyNode *&body)
+{
+  parameters = 0;
+  body = 0;
+  bool ok = match('(');
+  if (ok && peek() != ')') {
+    do {
+      ok = peek() == IDENT;
+      if (!ok)
+        break;
+      const Identifier *name = ident;
+      next();
+      parameters = parameters ? new ParameterNode(parameters, *name) : new ParameterNode(*name);
+    } while (match(','));
+  }
+  if (ok && match(')'))
+    body = parseFunctionBody(lazy);
+  if (body && !checking)
+    parser->setFunctionSource(body, start, lastEnd);
+
+  return body != 0;
+}
+
+FunctionBodyNode *DescentParser::parseFunctionBody(bool lazy)
+{
+  if (peek() != '{')
+    return 0;
+  if (lazy && !checking && Parser::lazyFunctionBodies)
+    return skipFunctionBody();
+
+  int firstLine = tokenFirstLine;
+  next();
+  SourceElementsNode *elements = 0;
+  if (peek() != '}') {
+    elements = parseSourceElements('}');
+    if (!elements)
+      return 0;
+  }
+  next();
+  FunctionBodyNode *body = new FunctionBodyNode(elements);
+  body->setLoc(firstLine, lastLine, parser->sid);
+  return body;
+}
+
+// Checks the body of a function for syntax errors and returns a body that
+// is parsed when the function is first called. The statements are parsed
+// as usual, but into an arena of their own that is dropped at once, and
+// the lexer leaves out the values of the tokens. Bodies nested in the one
+// being checked are parsed in full.
+FunctionBodyNode *DescentParser::skipFunctionBody()
+{
+  int firstLine = tokenFirstLine;
+  int start = tokenEnd;
+  NodeArena *arena = parser->arena;
+  unsigned nodeCount = parser->nodeCount;
+  parser->arena = new NodeArena;
+  parser->arena->ref();
+  checking = true;
+  lexer->preparsing = true;
+
+  next();
+  bool ok = true;
+  bool hasFunctionDeclarations = false;
+  while (ok && peek() != '}') {
+    StatementNode *element = parseSourceElement();
+    if (!element)
+      ok = false;
+    else if (element == lastDeclaration)
+      hasFunctionDeclarations = true;
+  }
+  int length = tokenStart - start;
+
+  checking = false;
+  lexer->preparsing = false;
+  parser->arena->deref();
+  parser->arena = arena;
+  parser->nodeCount = nodeCount;
+  if (!ok)
+    return 0;
+
+  next();
+  FunctionBodyNode *body = parser->lazyFunctionBody(start, length, firstLine, hasFunctionDeclarations);
+  body->setLoc(firstLine, lastLine, parser->sid);
+  return body;
+}
+
+// start is the beginning of the expression if the caller already read it,
+// see parseMember()
+Node *DescentParser::parseExpression(Node *start)
+{
+  Node *expr = parseAssignment(start);
+  while (expr && match(',')) {
+    Node *right = parseAssignment();
+    if (!right)
+      return 0;
+    expr = new CommaNode(expr, right);
+  }
+  return expr;
+}
+
+Node *DescentParser::parseAssignment(Node *start)
+{
+  bool isLeftHandSide;
+  Node *expr = parseUnary(start, &isLeftHandSide);
+  if (!expr)
+    return 0;
+
+  Operator op;
+  if (isLeftHandSide && assignmentOperator(peek(), op)) {
+    next();
+    depth++;
+    Node *value = depth < MaxDepth ? parseAssignment() : 0;
+    depth--;
+    if (!value)
+      return 0;
+    return new AssignNode(expr, op, value);
+  }
+
+  expr = parseBinary(expr, 0);
+  if (!expr || !match('?'))
+    return expr;
+
+  depth++;
+  Node *ifTrue = depth < MaxDepth ? parseAssignment() : 0;
+  Node *ifFalse = 0;
+  if (ifTrue && match(':'))
+    ifFalse = parseAssignment();
+  depth--;
+  if (!ifFalse)
+    return 0;
+  return new ConditionalNode(expr, ifTrue, ifFalse);
+}
+
+// Precedence climbing: takes the operators that bind tighter than
+// minPrecedence, with left as the first operand.
+Node *DescentParser::parseBinary(Node *left, int minPrecedence)
+{
+  for (;;) {
+    int op = peek();
+    int precedence = binaryPrecedence(op);
+    if (precedence <= minPrecedence)
+      return left;
+    next();
+
+    bool isLeftHandSide;
+    Node *right = parseUnary(0, &isLeftHandSide);
+    if (right)
+      right = parseBinary(right, precedence);
+    if (!right)
+      return 0;
+    left = makeBinary(op, left, right);
+  }
+}
+
+Node *DescentParser::parseUnary(Node *start, bool *isLeftHandSide)
+{
+  *isLeftHandSide = false;
+  if (depth == MaxDepth)
+    return 0;
+  depth++;
+
+  Node *expr;
+  int op = start ? 0 : peek();
+  if (isUnaryOperator(op)) {
+    next();
+    bool operandIsLeftHandSide;
+    expr = parseUnary(0, &operandIsLeftHandSide);
+    if (expr) {
+      switch (op) {
+      case DELETE:
+        expr = new DeleteNode(expr);
+        break;
+      case VOID:
+        expr = new VoidNode(expr);
+        break;
+      case TYPEOF:
+        expr = new TypeOfNode(expr);
+        break;
+      case PLUSPLUS:
+      case AUTOPLUSPLUS:
+        expr = new PrefixNode(OpPlusPlus, expr);
+        break;
+      case MINUSMINUS:
+      case AUTOMINUSMINUS:
+        expr = new PrefixNode(OpMinusMinus, expr);
+        break;
+      case '+':
+        expr = new UnaryPlusNode(expr);
+        break;
+      case '-':
+        expr = new NegateNode(expr);
+        break;
+      case '~':
+        expr = new BitwiseNotNode(expr);
+        break;
+      default:
+        expr = new LogicalNotNode(expr);
+        break;
+      }
+    }
+  } else {
+    expr = parseLeftHandSide(start);
+    if (expr) {
+      // the lexer turns "++" after a line break into AUTOPLUSPLUS
+      if (match(PLUSPLUS))
+        expr = new PostfixNode(expr, OpPlusPlus);
+      else if (match(MINUSMINUS))
+        expr = new PostfixNode(expr, OpMinusMinus);
+      else
+        *isLeftHandSide = true;
+    }
+  }
+
+  depth--;
+  return expr;
+}
+
+Node *DescentParser::parseLeftHandSide(Node *start)
+{
+  Node *expr = parseMember(start);
+  while (expr && peek() == '(') {
+    ArgumentsNode *args = parseArguments();
+    if (!args)
+      return 0;
+    expr = parseAccessors(new FunctionCallNode(expr, args));
+  }
+  return expr;
+}
+
+// A member expression, with any number of "new" in front. If start is not
+// 0, it is a primary or function expression the caller already read.
+Node *DescentParser::parseMember(Node *start)
+{
+  int newCount = 0;
+  Node *expr = start;
+  if (!expr) {
+    while (match(NEW))
+      newCount++;
+    if (peek() == FUNCTION) {
+      // functions right after '(' are usually called at once, so their
+      // bodies are parsed in full
+      bool lazy = lastToken != '(';
+      int start = tokenStart;
+      next();
+      expr = parseFunctionExpression(start, lazy);
+    } else
+      expr = parsePrimary();
+  }
+
+  // each "new" takes the innermost arguments, "new new f()" has just one
+  for (;;) {
+    expr = parseAccessors(expr);
+    if (!expr || !newCount)
+      return expr;
+    newCount--;
+    if (peek() != '(') {
+      expr = new NewExprNode(expr);
+      continue;
+    }
+    ArgumentsNode *args = parseArguments();
+    if (!args)
+      return 0;
+    expr = new NewExprNode(expr, args);
+  }
+}
+
+// "[expr]" and ".name" after expr
+Node *DescentParser::parseAccessors(Node *expr)
+{
+  while (expr) {
+    if (match('[')) {
+      Node *property = parseExpression();
+      if (!property || !match(']'))
+        return 0;
+      expr = new AccessorNode1(expr, property);
+    } else if (match('.')) {
+      if (peek() != IDENT)
+        return 0;
+      const Identifier *name = ident;
+      next();
+      expr = new AccessorNode2(expr, *name);
+    } else
+      break;
+  }
+  return expr;
+}
+
+Node *DescentParser::parsePrimary()
+{
+  switch (peek()) {
+  case THIS:
+    next();
+    return new ThisNode();
+  case IDENT: {
+    const Identifier *name = ident;
+    next();
+    return new ResolveNode(*name);
+  }
+  case NULLTOKEN:
+    next();
+    return new NullNode();
+  case TRUETOKEN:
+    next();
+    return new BooleanNode(true);
+  case FALSETOKEN:
+    next();
+    return new BooleanNode(false);
+  case NUMBER: {
+    double value = number;
+    next();
+    return new NumberNode(value);
+  }
+  case STRING: {
+    const UString *value = string;
+    next();
+    return new StringNode(value);
+  }
+  case '/':
+  case DIVEQUAL: {
+    // a RegExp, the lexer read only its first character or two
+    bool startsWithEqual = peek() == DIVEQUAL;
+    next();
+    if (!lexer->scanRegExp())
+      return 0;
+    return new RegExpNode(startsWithEqual ? UString('=') + lexer->pattern : lexer->pattern, lexer->flags);
+  }
+  case '(': {
+    next();
+    Node *expr = parseExpression();
+    if (!expr)
+      return 0;
+    if (!match(')'))
+      return 0;
+    return new GroupNode(expr);
+  }
+  case '[':
+    return parseArrayLiteral();
+  case '{':
+    return parseObjectLiteral();
+  default:
+    return 0;
+  }
+}
+
+Node *DescentParser::parseArrayLiteral()
+{
+  next();
+  int elision = 0;
+  while (match(','))
+    elision++;
+  if (match(']'))
+    return new ArrayNode(elision);
+
+  ElementNode *elements = 0;
+  for (;;) {
+    Node *element = parseAssignment();
+    if (!element)
+      break;
+    elements = elements ? new ElementNode(elements, elision, element) : new ElementNode(elision, element);
+    if (match(']'))
+      return new ArrayNode(elements);
+    if (!match(','))
+      break;
+
+    elision = 0;
+    while (match(','))
+      elision++;
+    if (match(']'))
+      return new ArrayNode(elision, elements);
+  }
+
+  return 0;
+}
+
+Node *DescentParser::parseObjectLiteral()
+{
+  next();
+  if (match('}'))
+    return new ObjectLiteralNode();
+
+  PropertyValueNode *properties = 0;
+  for (;;) {
+    PropertyNode *name;
+    if (peek() == IDENT) {
+      const Identifier *id = ident;
+      next();
+      name = new PropertyNode(*id);
+    } else if (peek() == STRING) {
+      const UString *s = string;
+      next();
+      name = new PropertyNode(Identifier(*s));
+    } else if (peek() == NUMBER) {
+      double n = number;
+      next();
+      name = new PropertyNode(n);
+    } else
+      break;
+
+    Node *value = 0;
+    if (match(':'))
+      value = parseAssignment();
+    if (!value)
+      break;
+    properties = properties ? new PropertyValueNode(name, value, properties) : new PropertyValueNode(name, value);
+    if (match('}'))
+      return new ObjectLiteralNode(properties);
+    if (!match(','))
+      break;
+  }
+
+  return 0;
+}
+
+ArgumentsNode *DescentParser::parseArguments()
+{
+  next();
+  if (match(')'))
+    return new ArgumentsNode();
+
+  ArgumentListNode *list = 0;
+  for (;;) {
+    Node *arg = parseAssignment();
+    if (!arg)
+      break;
+    list = list ? new ArgumentListNode(list, arg) : new ArgumentListNode(arg);
+    if (match(')'))
+      return new ArgumentsNode(list);
+    if (!match(','))
+      break;
+  }
+
+  return 0;
+}
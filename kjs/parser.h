@@ -0,0 +1,143 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef _KJS_PARSER_H_
+#define _KJS_PARSER_H_
+
+namespace KJS {
+
+  class Identifier;
+  class Lexer;
+  class Parser;
+  class UString;
+
+  class Node;
+  class StatementNode;
+  class SourceElementsNode;
+  class FunctionBodyNode;
+  class ProgramNode;
+  class ArgumentsNode;
+  class ParameterNode;
+  class VarDeclListNode;
+  class AssignExprNode;
+  class CaseClauseNode;
+  class StatListNode;
+
+  /**
+   * @internal
+   *
+   * A hand-written recursive descent parser. It reads tokens from the
+   * @ref Lexer on demand and builds the trees of nodes.h. Binary operators
+   * are parsed by precedence climbing, and semicolons are inserted before
+   * '}', at the end of the code and after a line terminator.
+   *
+   * Bodies of functions that are not called right away are only checked
+   * for syntax errors and parsed when the function is first called, see
+   * @ref Parser::lazyFunctionBodies.
+   *
+   * Use @ref Parser::parse(), which runs this parser.
+   */
+  class DescentParser {
+  public:
+    /**
+     * Parses the code the lexer was set up with. Returns 0 on a syntax
+     * error.
+     */
+    static ProgramNode *parse(Parser *parser, Lexer *lexer);
+
+  private:
+    DescentParser(Parser *parser, Lexer *lexer);
+
+    int peek();
+    void next();
+    bool match(int token);
+    bool automaticSemicolon();
+
+    ProgramNode *parseProgram();
+    SourceElementsNode *parseSourceElements(int end);
+    StatementNode *parseSourceElement();
+    StatementNode *parseStatement();
+    StatementNode *parseBlock(bool inStatement);
+    StatementNode *parseVariableStatement();
+    VarDeclListNode *parseVariableDeclarationList(VarDeclListNode *list);
+    AssignExprNode *parseInitializer();
+    StatementNode *parseExpressionStatement(Node *start, int firstLine);
+    StatementNode *parseIfStatement();
+    StatementNode *parseDoWhileStatement();
+    StatementNode *parseWhileStatement();
+    StatementNode *parseForStatement();
+    StatementNode *parseForRest(Node *init, VarDeclListNode *vars, int firstLine);
+    StatementNode *parseForInRest(Node *left, const Identifier *var, AssignExprNode *init, int firstLine);
+    StatementNode *parseContinueOrBreakStatement(bool isBreak);
+    StatementNode *parseReturnStatement();
+    StatementNode *parseWithStatement();
+    StatementNode *parseSwitchStatement();
+    CaseClauseNode *parseCaseClause();
+    StatListNode *parseStatementList();
+    StatementNode *parseThrowStatement();
+    StatementNode *parseTryStatement();
+    StatementNode *parseFunctionDeclaration();
+
+    Node *parseFunctionExpression(int start, bool lazy);
+    bool parseFunction(int start, bool lazy, ParameterNode *&parameters, FunctionBodyNode *&body);
+    FunctionBodyNode *parseFunctionBody(bool lazy);
+    FunctionBodyNode *skipFunctionBody();
+
+    Node *parseExpression(Node *start = 0);
+    Node *parseAssignment(Node *start = 0);
+    Node *parseBinary(Node *left, int minPrecedence);
+    Node *parseUnary(Node *start, bool *isLeftHandSide);
+    Node *parseLeftHandSide(Node *start);
+    Node *parseMember(Node *start);
+    Node *parseAccessors(Node *expr);
+    Node *parsePrimary();
+    Node *parseArrayLiteral();
+    Node *parseObjectLiteral();
+    ArgumentsNode *parseArguments();
+
+    Parser *parser;
+    Lexer *lexer;
+
+    // the lookahead, read on demand
+    int token;
+    double number;
+    const UString *string;
+    const Identifier *ident;
+    int tokenFirstLine, tokenLastLine;
+    // offsets of the lookahead in the code
+    int tokenStart, tokenEnd;
+    // last line and end of the token that was consumed last
+    int lastLine;
+    int lastEnd;
+    // the token that was consumed last
+    int lastToken;
+    // how deep the statements and expressions being parsed are nested
+    int depth;
+    // whether a function body is only being checked, see skipFunctionBody()
+    bool checking;
+    // the function declaration that was parsed last
+    StatementNode *lastDeclaration;
+  };
+
+}; // namespace
+
+#endif
@@ -0,0 +1,357 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "program_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "internal.h"
+#include "nodes.h"
+#include "program_snapshot.h"
+#include "source_provider.h"
+
+namespace KJS {
+
+const int minTableSize = 64;
+const size_t defaultBudget = 4 * 1024 * 1024;
+
+// Rough average size of a tree node, used to estimate what a cached tree costs.
+const size_t estimatedNodeSize = 64;
+
+struct ProgramCacheEntry {
+  unsigned hash;
+  UString sourceURL;
+  int startingLineNumber;
+  SourceProvider *source;
+  ProgramNode *program;
+  int sourceId;
+  size_t size;
+
+  ProgramCacheEntry *nextInBucket;
+  ProgramCacheEntry *prev;
+  ProgramCacheEntry *next;
+};
+
+// Golden ratio - arbitrary start value to avoid mapping all 0's to all 0's
+// or anything like that.
+const unsigned PHI = 0x9e3779b9U;
+
+// UString::Rep::computeHash() only looks at the ends of the string, which is
+// fine for identifiers but useless for telling apart scripts that share a
+// prologue, so hash everything.
+// This hash algorithm comes from:
+// http://burtleburtle.net/bob/hash/doobs.html
+static unsigned computeHash(const UString &sourceURL, int startingLineNumber, const SourceProvider *source)
+{
+  unsigned h = PHI;
+  h += startingLineNumber;
+  h += (h << 10);
+  h ^= (h >> 6);
+
+  for (int i = 0; i < sourceURL.size(); i++) {
+    h += sourceURL[i].uc;
+    h += (h << 10);
+    h ^= (h >> 6);
+  }
+
+  unsigned int length = source->length();
+  if (const UChar *c = source->characters()) {
+    for (unsigned int i = 0; i < length; i++) {
+      h += c[i].uc;
+      h += (h << 10);
+      h ^= (h >> 6);
+    }
+  } else {
+    const unsigned char *b = reinterpret_cast<const unsigned char *>(source->bytes());
+    for (unsigned int i = 0; i < length; i++) {
+      h += b[i];
+      h += (h << 10);
+      h ^= (h >> 6);
+    }
+  }
+
+  h += (h << 3);
+  h ^= (h >> 11);
+  h += (h << 15);
+
+  return h;
+}
+
+ProgramCache::ProgramCache(size_t budget)
+  : _table(0), _tableSize(0), _tableSizeMask(0), _keyCount(0),
+    _head(0), _tail(0), _size(0), _budget(budget),
+    _hits(0), _misses(0), _evictions(0), _snapshotLoads(0), _snapshotWrites(0)
+{
+}
+
+ProgramCache::~ProgramCache()
+{
+  clear();
+  free(_table);
+}
+
+ProgramCache *ProgramCache::shared()
+{
+  static ProgramCache *cache = new ProgramCache(defaultBudget);
+  return cache;
+}
+
+ProgramNode *ProgramCache::parse(const UString &sourceURL, int startingLineNumber, const UString &code,
+                                 int *sourceId, int *errLine, UString *errMsg)
+{
+  SourceProvider *source = SourceProvider::create(code);
+  ProgramNode *program = parse(sourceURL, startingLineNumber, source, sourceId, errLine, errMsg);
+  source->deref();
+  return program;
+}
+
+ProgramNode *ProgramCache::parse(const UString &sourceURL, int startingLineNumber, SourceProvider *source,
+                                 int *sourceId, int *errLine, UString *errMsg)
+{
+  if (_budget == 0 && _snapshotDirectory.isNull())
+    return Parser::parse(sourceURL, startingLineNumber, source, sourceId, errLine, errMsg);
+
+  unsigned hash = computeHash(sourceURL, startingLineNumber, source);
+  if (ProgramCacheEntry *entry = find(hash, sourceURL, startingLineNumber, source)) {
+    ++_hits;
+    moveToFront(entry);
+    if (sourceId)
+      *sourceId = entry->sourceId;
+    if (errLine)
+      *errLine = -1;
+    if (errMsg)
+      *errMsg = UString();
+    return entry->program;
+  }
+
+  ++_misses;
+  int sid;
+  ProgramNode *program = parseOrLoad(hash, sourceURL, startingLineNumber, source, &sid, errLine, errMsg);
+  if (sourceId)
+    *sourceId = sid;
+  if (!program)
+    return 0;
+
+  size_t textSize = source->characters() ? source->length() * sizeof(UChar) : source->length();
+  size_t size = sizeof(ProgramCacheEntry) + textSize + Parser::curr()->nodeCount * estimatedNodeSize;
+  if (size > _budget)
+    return program;
+
+  ProgramCacheEntry *entry = new ProgramCacheEntry;
+  entry->hash = hash;
+  entry->sourceURL = sourceURL;
+  entry->startingLineNumber = startingLineNumber;
+  entry->source = source;
+  entry->program = program;
+  entry->sourceId = sid;
+  entry->size = size;
+  source->ref();
+  program->ref();
+
+  shrinkTo(_budget - size);
+  insert(entry);
+
+  return program;
+}
+
+ProgramNode *ProgramCache::parseOrLoad(unsigned hash, const UString &sourceURL, int startingLineNumber, SourceProvider *source,
+                                       int *sourceId, int *errLine, UString *errMsg)
+{
+  if (_snapshotDirectory.isNull())
+    return Parser::parse(sourceURL, startingLineNumber, source, sourceId, errLine, errMsg);
+
+  // the file name only spreads the snapshots out, the snapshot itself is
+  // checked against the source
+  char name[32];
+  sprintf(name, "/%08x-%x.kjss", hash, source->length());
+  UString path = _snapshotDirectory + name;
+
+  if (ProgramNode *program = ProgramSnapshot::read(path, sourceURL, startingLineNumber, source, sourceId)) {
+    ++_snapshotLoads;
+    if (errLine)
+      *errLine = -1;
+    if (errMsg)
+      *errMsg = UString();
+    return program;
+  }
+
+  ProgramNode *program = Parser::parse(sourceURL, startingLineNumber, source, sourceId, errLine, errMsg);
+  if (program && ProgramSnapshot::write(path, program, sourceURL, startingLineNumber, source))
+    ++_snapshotWrites;
+  return program;
+}
+
+void ProgramCache::invalidate(const UString &sourceURL)
+{
+  ProgramCacheEntry *next;
+  for (ProgramCacheEntry *entry = _head; entry; entry = next) {
+    next = entry->next;
+    if (entry->sourceURL == sourceURL)
+      remove(entry);
+  }
+}
+
+void ProgramCache::clear()
+{
+  while (_head)
+    remove(_head);
+}
+
+void ProgramCache::setBudget(size_t bytes)
+{
+  _budget = bytes;
+  shrinkTo(bytes);
+}
+
+ProgramCache::Statistics ProgramCache::statistics() const
+{
+  Statistics s;
+  s.hits = _hits;
+  s.misses = _misses;
+  s.evictions = _evictions;
+  s.snapshotLoads = _snapshotLoads;
+  s.snapshotWrites = _snapshotWrites;
+  s.entries = _keyCount;
+  s.size = _size;
+  s.budget = _budget;
+  return s;
+}
+
+void ProgramCache::resetStatistics()
+{
+  _hits = 0;
+  _misses = 0;
+  _evictions = 0;
+  _snapshotLoads = 0;
+  _snapshotWrites = 0;
+}
+
+ProgramCacheEntry *ProgramCache::find(unsigned hash, const UString &sourceURL, int startingLineNumber, const SourceProvider *source) const
+{
+  if (!_table)
+    return 0;
+
+  for (ProgramCacheEntry *entry = _table[hash & _tableSizeMask]; entry; entry = entry->nextInBucket) {
+    if (entry->hash == hash && entry->startingLineNumber == startingLineNumber
+        && entry->sourceURL == sourceURL && entry->source->equals(source))
+      return entry;
+  }
+
+  return 0;
+}
+
+void ProgramCache::insert(ProgramCacheEntry *entry)
+{
+  if (_keyCount >= _tableSize / 2)
+    rehash(_tableSize ? _tableSize * 2 : minTableSize);
+
+  int i = entry->hash & _tableSizeMask;
+  entry->nextInBucket = _table[i];
+  _table[i] = entry;
+  ++_keyCount;
+
+  entry->prev = 0;
+  entry->next = _head;
+  if (_head)
+    _head->prev = entry;
+  else
+    _tail = entry;
+  _head = entry;
+
+  _size += entry->size;
+}
+
+void ProgramCache::remove(ProgramCacheEntry *entry)
+{
+  ProgramCacheEntry **p = &_table[entry->hash & _tableSizeMask];
+  while (*p != entry)
+    p = &(*p)->nextInBucket;
+  *p = entry->nextInBucket;
+  --_keyCount;
+
+  if (entry->prev)
+    entry->prev->next = entry->next;
+  else
+    _head = entry->next;
+  if (entry->next)
+    entry->next->prev = entry->prev;
+  else
+    _tail = entry->prev;
+
+  _size -= entry->size;
+
+  // The program may still be executing; whoever holds the last reference
+  // deletes it.
+  entry->program->deref();
+  entry->source->deref();
+  delete entry;
+}
+
+void ProgramCache::moveToFront(ProgramCacheEntry *entry)
+{
+  if (entry == _head)
+    return;
+
+  entry->prev->next = entry->next;
+  if (entry->next)
+    entry->next->prev = entry->prev;
+  else
+    _tail = entry->prev;
+
+  entry->prev = 0;
+  entry->next = _head;
+  _head->prev = entry;
+  _head = entry;
+}
+
+void ProgramCache::shrinkTo(size_t bytes)
+{
+  while (_tail && _size > bytes) {
+    remove(_tail);
+    ++_evictions;
+  }
+}
+
+void ProgramCache::rehash(int newTableSize)
+{
+  ProgramCacheEntry **oldTable = _table;
+  int oldTableSize = _tableSize;
+
+  _tableSize = newTableSize;
+  _tableSizeMask = newTableSize - 1;
+  _table = (ProgramCacheEntry **)calloc(newTableSize, sizeof(ProgramCacheEntry *));
+
+  for (int i = 0; i != oldTableSize; ++i) {
+    ProgramCacheEntry *next;
+    for (ProgramCacheEntry *entry = oldTable[i]; entry; entry = next) {
+      next = entry->nextInBucket;
+      int j = entry->hash & _tableSizeMask;
+      entry->nextInBucket = _table[j];
+      _table[j] = entry;
+    }
+  }
+
+  free(oldTable);
+}
+
+} // namespace KJS
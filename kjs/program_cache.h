@@ -0,0 +1,148 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef _KJS_PROGRAM_CACHE_H_
+#define _KJS_PROGRAM_CACHE_H_
+
+#include <stddef.h>
+
+#include "ustring.h"
+
+namespace KJS {
+
+  class ProgramNode;
+  class SourceProvider;
+  struct ProgramCacheEntry;
+
+  /**
+   * @short Cache of parsed programs.
+   *
+   * Keeps the parse trees of recently evaluated scripts around so that
+   * evaluating the same source again skips the lexer and the parser. Entries
+   * are keyed by a hash of the complete source text together with the source
+   * URL and starting line number (both end up in the tree), and are verified
+   * against the full source on every hit, unless it comes from the very
+   * same @ref SourceProvider. When the estimated size of the
+   * cached trees exceeds the budget, the least recently used entries are
+   * dropped.
+   *
+   * The cache used by @ref Interpreter::evaluate() is shared by all
+   * interpreters in the process, see @ref shared(). Like the rest of the
+   * interpreter, a cache must only be used with the interpreter lock held.
+   */
+  class ProgramCache {
+  public:
+    struct Statistics {
+      unsigned hits;
+      unsigned misses;
+      unsigned evictions;
+      unsigned snapshotLoads;
+      unsigned snapshotWrites;
+      unsigned entries;
+      size_t size;
+      size_t budget;
+    };
+
+    ProgramCache(size_t budget);
+    ~ProgramCache();
+
+    /**
+     * Returns the process-wide cache used by @ref Interpreter::evaluate().
+     */
+    static ProgramCache *shared();
+
+    /**
+     * Looks the program up and parses it on a miss, with the same contract as
+     * @ref Parser::parse(): the returned node has to be ref()'d by the caller
+     * and deleted once its deref() returns true. Returns 0 on a syntax error,
+     * which is never cached.
+     */
+    ProgramNode *parse(const UString &sourceURL, int startingLineNumber, SourceProvider *source,
+                       int *sourceId = 0, int *errLine = 0, UString *errMsg = 0);
+    ProgramNode *parse(const UString &sourceURL, int startingLineNumber, const UString &code,
+                       int *sourceId = 0, int *errLine = 0, UString *errMsg = 0);
+
+    /**
+     * Drops all entries that were parsed from the given source URL.
+     */
+    void invalidate(const UString &sourceURL);
+    /**
+     * Drops all entries.
+     */
+    void clear();
+
+    /**
+     * Sets the maximum estimated size in bytes of the cached trees. A budget
+     * of 0 disables caching.
+     */
+    void setBudget(size_t bytes);
+    size_t budget() const { return _budget; }
+
+    /**
+     * Sets a directory for @ref ProgramSnapshot files. When set, a miss first
+     * tries to load the program from there and only parses it if there is no
+     * usable snapshot, and every program that had to be parsed is written back
+     * for the next process. A null string, the default, turns this off.
+     */
+    void setSnapshotDirectory(const UString &path) { _snapshotDirectory = path; }
+    UString snapshotDirectory() const { return _snapshotDirectory; }
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+  private:
+    ProgramCacheEntry *find(unsigned hash, const UString &sourceURL, int startingLineNumber, const SourceProvider *source) const;
+    void insert(ProgramCacheEntry *);
+    void remove(ProgramCacheEntry *);
+    void moveToFront(ProgramCacheEntry *);
+    void shrinkTo(size_t bytes);
+    void rehash(int newTableSize);
+    ProgramNode *parseOrLoad(unsigned hash, const UString &sourceURL, int startingLineNumber, SourceProvider *source,
+                             int *sourceId, int *errLine, UString *errMsg);
+
+    ProgramCacheEntry **_table;
+    int _tableSize;
+    int _tableSizeMask;
+    int _keyCount;
+
+    // most recently used entry first
+    ProgramCacheEntry *_head;
+    ProgramCacheEntry *_tail;
+
+    size_t _size;
+    size_t _budget;
+    UString _snapshotDirectory;
+
+    unsigned _hits;
+    unsigned _misses;
+    unsigned _evictions;
+    unsigned _snapshotLoads;
+    unsigned _snapshotWrites;
+
+    // not implemented
+    ProgramCache(const ProgramCache &);
+    ProgramCache &operator=(const ProgramCache &);
+  };
+
+}; // namespace
+
+#endif
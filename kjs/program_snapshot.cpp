@@ -0,0 +1,219 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "program_snapshot.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "internal.h"
+#include "node_arena.h"
+#include "nodes.h"
+#include "source_provider.h"
+
+using namespace KJS;
+
+const int snapshotMagic = 0x4b4a5353; // "KJSS"
+
+// Bump whenever the node tags or the layout of any node change.
+const int snapshotFormatVersion = 3;
+
+const int byteOrderMark = 0x01020304;
+
+// Two different 32 bit hashes of the same bytes, a one-at-a-time hash and
+// FNV-1a, so that a stale snapshot is practically never mistaken for a
+// current one.
+static void computeHash(const void *data, size_t size, int hash[2])
+{
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  unsigned h = 0x9e3779b9U;
+  unsigned f = 2166136261U;
+
+  for (size_t i = 0; i < size; i++) {
+    h += p[i];
+    h += (h << 10);
+    h ^= (h >> 6);
+
+    f ^= p[i];
+    f *= 16777619U;
+  }
+
+  h += (h << 3);
+  h ^= (h >> 11);
+  h += (h << 15);
+
+  hash[0] = h;
+  hash[1] = f;
+}
+
+static void computeHash(const SourceProvider *source, int hash[2])
+{
+  if (source->characters())
+    computeHash(source->characters(), source->length() * sizeof(UChar), hash);
+  else
+    computeHash(source->bytes(), source->length(), hash);
+}
+
+// -1 for UTF-16 text, the TextEncoding otherwise
+static int textKind(const SourceProvider *source)
+{
+  return source->characters() ? -1 : source->encoding();
+}
+
+bool ProgramSnapshot::write(const UString &path, const ProgramNode *program,
+                            const UString &sourceURL, int startingLineNumber, SourceProvider *source)
+{
+  SnapshotWriter payload;
+  payload.writeNode(program);
+
+  int codeHash[2];
+  computeHash(source, codeHash);
+  int payloadHash[2];
+  computeHash(payload.data(), payload.size(), payloadHash);
+
+  SnapshotWriter header;
+  header.writeInt(snapshotMagic);
+  header.writeInt(snapshotFormatVersion);
+  header.writeInt(byteOrderMark);
+  header.writeByte(sizeof(int));
+  header.writeByte(sizeof(double));
+  header.writeByte(sizeof(UChar));
+  header.writeString(sourceURL);
+  header.writeInt(startingLineNumber);
+  header.writeInt(textKind(source));
+  header.writeInt(source->length());
+  header.writeInt(codeHash[0]);
+  header.writeInt(codeHash[1]);
+  header.writeInt(payload.size());
+  header.writeInt(payloadHash[0]);
+  header.writeInt(payloadHash[1]);
+
+  // write to a temporary file first so that readers never see half a snapshot
+  CString finalPath = path.cstring();
+  char tempPath[1024];
+  if (snprintf(tempPath, sizeof(tempPath), "%s.%d.tmp", finalPath.c_str(), (int)getpid()) >= (int)sizeof(tempPath))
+    return false;
+
+  FILE *f = fopen(tempPath, "wb");
+  if (!f)
+    return false;
+  bool ok = fwrite(header.data(), 1, header.size(), f) == header.size()
+    && fwrite(payload.data(), 1, payload.size(), f) == payload.size();
+  if (fclose(f) != 0)
+    ok = false;
+
+  if (ok)
+    ok = rename(tempPath, finalPath.c_str()) == 0;
+  if (!ok)
+    unlink(tempPath);
+  return ok;
+}
+
+static ProgramNode *readSnapshot(SnapshotReader &reader, const UString &sourceURL,
+                                 int startingLineNumber, const SourceProvider *source)
+{
+  if (reader.readInt() != snapshotMagic
+      || reader.readInt() != snapshotFormatVersion
+      || reader.readInt() != byteOrderMark
+      || reader.readByte() != sizeof(int)
+      || reader.readByte() != sizeof(double)
+      || reader.readByte() != sizeof(UChar))
+    return 0;
+
+  if (reader.readString() != sourceURL
+      || reader.readInt() != startingLineNumber
+      || reader.readInt() != textKind(source)
+      || reader.readInt() != (int)source->length())
+    return 0;
+
+  int codeHash[2];
+  computeHash(source, codeHash);
+  if (reader.readInt() != codeHash[0] || reader.readInt() != codeHash[1])
+    return 0;
+
+  int payloadSize = reader.readInt();
+  int payloadHash[2];
+  payloadHash[0] = reader.readInt();
+  payloadHash[1] = reader.readInt();
+  if (reader.failed() || payloadSize <= 0 || (size_t)payloadSize != reader.remaining())
+    return 0;
+
+  int hash[2];
+  computeHash(reader.current(), payloadSize, hash);
+  if (hash[0] != payloadHash[0] || hash[1] != payloadHash[1])
+    return 0;
+
+  ProgramNode *program = reader.readProgram();
+  if (!program || reader.failed() || !reader.atEnd()) {
+    // can only happen if the writer and the reader disagree on the layout
+    return 0;
+  }
+  return program;
+}
+
+ProgramNode *ProgramSnapshot::read(const UString &path, const UString &sourceURL, int startingLineNumber,
+                                   SourceProvider *source, int *sourceId)
+{
+  int fd = open(path.cstring().c_str(), O_RDONLY);
+  if (fd < 0)
+    return 0;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return 0;
+  }
+
+  size_t size = st.st_size;
+  void *data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return 0;
+
+  // statements carry the id of the parse that created them, so take one
+  // the same way Parser::parse() does
+  int sid = Parser::newSourceId();
+  Parser *parser = Parser::curr();
+  parser->nodeCount = 0;
+  NodeArena *arena = new NodeArena;
+  parser->arena = arena;
+
+  SnapshotReader reader(static_cast<const char *>(data), size, sourceURL, sid, source);
+  ProgramNode *program = readSnapshot(reader, sourceURL, startingLineNumber, source);
+
+  parser->arena = 0;
+  munmap(data, size);
+
+  if (!program) {
+    // frees the partially built tree
+    arena->ref();
+    arena->deref();
+  }
+
+  if (program && sourceId)
+    *sourceId = sid;
+  return program;
+}
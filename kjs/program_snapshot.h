@@ -0,0 +1,170 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef _KJS_PROGRAM_SNAPSHOT_H_
+#define _KJS_PROGRAM_SNAPSHOT_H_
+
+#include <stddef.h>
+
+#include "identifier.h"
+#include "ustring.h"
+
+namespace KJS {
+
+  class Node;
+  class StatementNode;
+  class ProgramNode;
+  class SourceProvider;
+
+  /**
+   * @short Binary snapshots of parsed programs.
+   *
+   * A snapshot holds the tree of a program in a compact binary form so that a
+   * later process can rebuild the tree without running the lexer and the
+   * parser. Each snapshot records the format version, the byte order of the
+   * host that wrote it, a hash of the source text it was parsed from and a
+   * checksum of its own contents. @ref read() refuses anything that does not
+   * match exactly, and the caller is expected to fall back to parsing.
+   */
+  class ProgramSnapshot {
+  public:
+    /**
+     * Writes the tree of program to path, replacing any existing file.
+     * sourceURL, startingLineNumber and source must be what the program was
+     * parsed from. Returns false if the file could not be written.
+     */
+    static bool write(const UString &path, const ProgramNode *program,
+                      const UString &sourceURL, int startingLineNumber, SourceProvider *source);
+    /**
+     * Rebuilds the program stored at path. Returns 0 if there is no snapshot,
+     * if it was written by a different version of the library or on a host
+     * with a different byte order, if it is damaged, or if it was not made
+     * from exactly this source. The returned node has the same ownership
+     * rules as the one returned by @ref Parser::parse(). Like a parsed
+     * program, it refers to source for the text of its functions.
+     */
+    static ProgramNode *read(const UString &path, const UString &sourceURL, int startingLineNumber,
+                             SourceProvider *source, int *sourceId = 0);
+  };
+
+  /**
+   * @internal
+   *
+   * Serializes a tree; used by the writeTo() methods of the nodes.
+   */
+  class SnapshotWriter {
+  public:
+    SnapshotWriter();
+    ~SnapshotWriter();
+
+    const char *data() const { return _buffer; }
+    size_t size() const { return _size; }
+
+    void writeBytes(const void *data, size_t size);
+    void writeByte(unsigned char b) { writeBytes(&b, 1); }
+    void writeBool(bool b) { writeByte(b); }
+    void writeInt(int i) { writeBytes(&i, sizeof(i)); }
+    void writeDouble(double d) { writeBytes(&d, sizeof(d)); }
+    void writeString(const UString &s);
+    void writeIdentifier(const Identifier &id) { writeString(id.ustring()); }
+
+    /**
+     * Writes the type tag of a node followed by its location.
+     */
+    void writeHeader(unsigned char tag, const Node *n);
+    void writeHeader(unsigned char tag, const StatementNode *n);
+    /**
+     * Writes the location of one element of a list node.
+     */
+    void writeLocation(const Node *n);
+    void writeLocation(const StatementNode *n);
+    /**
+     * Writes a complete subtree, or a marker for a missing one.
+     */
+    void writeNode(const Node *n);
+
+  private:
+    char *_buffer;
+    size_t _size;
+    size_t _capacity;
+
+    // not implemented
+    SnapshotWriter(const SnapshotWriter &);
+    SnapshotWriter &operator=(const SnapshotWriter &);
+  };
+
+  /**
+   * @internal
+   *
+   * Rebuilds a tree written by @ref SnapshotWriter. Reading past the end of
+   * the data sets the failed flag instead of crashing.
+   */
+  class SnapshotReader {
+  public:
+    SnapshotReader(const char *data, size_t size, const UString &sourceURL, int sourceId,
+                   SourceProvider *source);
+
+    bool failed() const { return _failed; }
+    bool atEnd() const { return _position == _size; }
+    size_t remaining() const { return _size - _position; }
+    const char *current() const { return _data + _position; }
+
+    void readBytes(void *data, size_t size);
+    unsigned char readByte();
+    bool readBool() { return readByte() != 0; }
+    int readInt();
+    double readDouble();
+    UString readString();
+    Identifier readIdentifier();
+
+    Node *readNode();
+    ProgramNode *readProgram();
+
+  private:
+    struct Location {
+      int line;
+      int firstLine;
+      int lastLine;
+      bool hasSourceId;
+    };
+
+    unsigned char peekTag() const;
+    int readLine() { return readInt(); }
+    Location readLocation();
+    Node *finish(Node *n, int line);
+    StatementNode *finish(StatementNode *n, const Location &loc);
+    StatementNode *readStatement();
+    // whether the offsets start up to end lie within the source
+    bool isRange(int start, int end) const;
+
+    const char *_data;
+    size_t _size;
+    size_t _position;
+    bool _failed;
+    UString _sourceURL;
+    int _sourceId;
+    SourceProvider *_source;
+  };
+
+}; // namespace
+
+#endif
@@ -22,6 +22,7 @@
 #include "property_map.h"
 
 #include "object.h"
+#include "object_cloner.h"
 #include "protect.h"
 #include "reference_list.h"
 
@@ -100,6 +101,36 @@ PropertyMap::PropertyMap() : _table(0)
 {
 }
 
+PropertyMap::PropertyMap(const PropertyMap &other) : _table(0)
+{
+    if (!other._table) {
+#if USE_SINGLE_ENTRY
+        _singleEntry = other._singleEntry;
+        if (_singleEntry.key)
+            _singleEntry.key->ref();
+#endif
+        return;
+    }
+
+    copyTable(other._table);
+}
+
+void PropertyMap::copyTable(const Table *other)
+{
+    assert(!_table);
+
+    // Copy the table as it is, deleted-element sentinels and all, so that the
+    // copy keeps the same order of properties.
+    size_t tableSize = sizeof(Table) + (other->size - 1) * sizeof(Entry);
+    _table = (Table *)malloc(tableSize);
+    memcpy(_table, other, tableSize);
+    for (int i = 0; i < _table->size; i++) {
+        UString::Rep *key = _table->entries[i].key;
+        if (key)
+            key->ref();
+    }
+}
+
 PropertyMap::~PropertyMap()
 {
     if (!_table) {
@@ -257,6 +288,7 @@ void PropertyMap::put(const Identifier &name, ValueImp *value, int attributes)
         if (key) {
             if (rep == key) {
                 _singleEntry.value = value;
+                _singleEntry.attributes &= ~LazyBuiltin;
                 return;
             }
         } else {
@@ -284,7 +316,9 @@ void PropertyMap::put(const Identifier &name, ValueImp *value, int attributes)
         if (rep == key) {
             // Put a new value in an existing hash table entry.
             _table->entries[i].value = value;
-            // Attributes are intentionally not updated.
+            // Attributes are intentionally not updated, except that the
+            // value is no longer a placeholder.
+            _table->entries[i].attributes &= ~LazyBuiltin;
             return;
         }
         // If we find the deleted-element sentinel, insert on top of it.
@@ -481,6 +515,82 @@ static int comparePropertyMapEntryIndices(const void *a, const void *b)
     return 0;
 }
 
+void PropertyMap::cloneValues(ObjectCloner &cloner)
+{
+    if (!_table) {
+#if USE_SINGLE_ENTRY
+        if (_singleEntry.key)
+            _singleEntry.value = cloner.clone(_singleEntry.value);
+#endif
+        return;
+    }
+
+    for (int i = 0; i != _table->size; ++i) {
+        Entry &entry = _table->entries[i];
+        // deleted elements have a value of 0
+        if (entry.key && entry.value)
+            entry.value = cloner.clone(entry.value);
+    }
+}
+
+void PropertyMap::putClones(const PropertyMap &other, ObjectCloner &cloner)
+{
+    if (!_table && isEmpty() && other._table) {
+        // nothing to merge with, so take a copy of the whole table
+        copyTable(other._table);
+        cloneValues(cloner);
+        return;
+    }
+
+    if (!other._table) {
+#if USE_SINGLE_ENTRY
+        if (other._singleEntry.key)
+            put(Identifier(other._singleEntry.key), cloner.clone(other._singleEntry.value), other._singleEntry.attributes);
+#endif
+        return;
+    }
+
+    int count = other._table->keyCount;
+    if (count == 0)
+        return;
+
+    // Put the properties in the order they were added to other.
+    Entry *fixedSizeBuffer[smallMapThreshold];
+    Entry **sortedEntries;
+    if (count <= smallMapThreshold)
+        sortedEntries = fixedSizeBuffer;
+    else
+        sortedEntries = new Entry *[count];
+
+    Entry **p = sortedEntries;
+    for (int i = 0; i != other._table->size; ++i) {
+        Entry *e = &other._table->entries[i];
+        if (e->key && e->key != &UString::Rep::null)
+            *p++ = e;
+    }
+    assert(p - sortedEntries == count);
+
+    qsort(sortedEntries, p - sortedEntries, sizeof(sortedEntries[0]), comparePropertyMapEntryIndices);
+
+    for (Entry **q = sortedEntries; q != p; ++q)
+        put(Identifier((*q)->key), cloner.clone((*q)->value), (*q)->attributes);
+
+    if (sortedEntries != fixedSizeBuffer)
+        delete [] sortedEntries;
+}
+
+bool PropertyMap::isEmpty() const
+{
+    if (!_table) {
+#if USE_SINGLE_ENTRY
+        return !_singleEntry.key;
+#else
+        return true;
+#endif
+    }
+    return _table->keyCount == 0;
+}
+
 void PropertyMap::addEnumerablesToReferenceList(ReferenceList &list, const Object &base) const
 {
     if (!_table) {
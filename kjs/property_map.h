@@ -28,6 +28,7 @@
 namespace KJS {
 
     class Object;
+    class ObjectCloner;
     class ReferenceList;
     class ValueImp;
     
@@ -61,6 +62,7 @@ namespace KJS {
     class PropertyMap {
     public:
         PropertyMap();
+        PropertyMap(const PropertyMap &);
         ~PropertyMap();
 
         void clear();
@@ -77,11 +79,17 @@ namespace KJS {
         void save(SavedProperties &) const;
         void restore(const SavedProperties &p);
 
+        // Used to set up interpreters from a snapshot of the built-in objects.
+        void cloneValues(ObjectCloner &);
+        void putClones(const PropertyMap &, ObjectCloner &);
+        bool isEmpty() const;
+
     private:
         static bool keysMatch(const UString::Rep *, const UString::Rep *);
         void expand();
         
         void insert(UString::Rep *, ValueImp *value, int attributes, int index);
+        void copyTable(const PropertyMapHashTable *);
         
         void checkConsistency();
         
@@ -91,6 +99,9 @@ namespace KJS {
         Table *_table;
         
         Entry _singleEntry;
+
+        // not implemented
+        PropertyMap &operator=(const PropertyMap &);
     };
 
 }; // namespace
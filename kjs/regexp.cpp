@@ -119,9 +119,14 @@ UString RegExp::match(const UString &s, int i, int *pos, int **ovector)
     offsetVector = new int [offsetVectorSize];
   }
 
-  const CString buffer(s.UTF8String());
-  convertUTF16OffsetsToUTF8Offsets(buffer.c_str(), &i, 1);
-  const int numMatches = pcre_exec(_regex, NULL, buffer.c_str(), buffer.size(), i, 0, offsetVector, offsetVectorSize);
+  // A global match runs over the same subject again and again, so keep its
+  // UTF-8 around; if it is all ASCII the offsets need no converting either.
+  int bufferLength;
+  const char *buffer = s.cachedUTF8Data(bufferLength);
+  const bool ascii = bufferLength == s.size();
+  if (!ascii)
+    convertUTF16OffsetsToUTF8Offsets(buffer, &i, 1);
+  const int numMatches = pcre_exec(_regex, NULL, buffer, bufferLength, i, 0, offsetVector, offsetVectorSize);
 
   if (numMatches < 0) {
 #ifndef NDEBUG
@@ -133,7 +138,8 @@ UString RegExp::match(const UString &s, int i, int *pos, int **ovector)
     return UString::null();
   }
 
-  convertUTF8OffsetsToUTF16Offsets(buffer.c_str(), offsetVector, (numMatches == 0 ? 1 : numMatches) * 2);
+  if (!ascii)
+    convertUTF8OffsetsToUTF16Offsets(buffer, offsetVector, (numMatches == 0 ? 1 : numMatches) * 2);
 
   *pos = offsetVector[0];
   if (ovector)
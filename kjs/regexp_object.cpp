@@ -21,6 +21,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "value.h"
 #include "object.h"
@@ -165,6 +166,18 @@ RegExpObjectImp::RegExpObjectImp(ExecState *exec,
   putDirect(lengthPropertyName, NumberImp::two(), ReadOnly|DontDelete|DontEnum);
 }
 
+RegExpObjectImp::RegExpObjectImp(const RegExpObjectImp &other)
+  : InternalFunctionImp(other), lastString(other.lastString), lastOvector(0L),
+    lastNrSubPatterns(other.lastNrSubPatterns)
+{
+  if (other.lastOvector) {
+    // see RegExp::match()
+    int size = (lastNrSubPatterns + 1) * 3;
+    lastOvector = new int [size];
+    memcpy(lastOvector, other.lastOvector, size * sizeof(int));
+  }
+}
+
 RegExpObjectImp::~RegExpObjectImp()
 {
   delete [] lastOvector;
@@ -33,12 +33,14 @@ namespace KJS {
     RegExpPrototypeImp(ExecState *exec,
                        ObjectPrototypeImp *objProto,
                        FunctionPrototypeImp *funcProto);
+    virtual ObjectImp *clone() const { return new RegExpPrototypeImp(*this); }
   };
 
   class RegExpProtoFuncImp : public InternalFunctionImp {
   public:
     RegExpProtoFuncImp(ExecState *exec,
                        FunctionPrototypeImp *funcProto, int i, int len);
+    virtual ObjectImp *clone() const { return new RegExpProtoFuncImp(*this); }
 
     virtual bool implementsCall() const;
     virtual Value call(ExecState *exec, Object &thisObj, const List &args);
@@ -66,7 +68,9 @@ namespace KJS {
     RegExpObjectImp(ExecState *exec,
                     FunctionPrototypeImp *funcProto,
                     RegExpPrototypeImp *regProto);
+    RegExpObjectImp(const RegExpObjectImp &other);
     virtual ~RegExpObjectImp();
+    virtual ObjectImp *clone() const { return new RegExpObjectImp(*this); }
     virtual bool implementsConstruct() const;
     virtual Object construct(ExecState *exec, const List &args);
     virtual bool implementsCall() const;
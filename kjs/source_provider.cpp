@@ -0,0 +1,139 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "source_provider.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace KJS;
+
+class CopiedSourceProvider : public SourceProvider {
+public:
+  CopiedSourceProvider(char *data, unsigned int length, TextEncoding encoding)
+    : SourceProvider(data, length, encoding), _data(data) { }
+  virtual ~CopiedSourceProvider() { free(_data); }
+private:
+  char *_data;
+};
+
+class BufferSourceProvider : public SourceProvider {
+public:
+  BufferSourceProvider(const char *data, unsigned int length, TextEncoding encoding,
+                       void (*release)(const char *, void *), void *context)
+    : SourceProvider(data, length, encoding), _release(release), _context(context) { }
+  virtual ~BufferSourceProvider() { if (_release) _release(bytes(), _context); }
+private:
+  void (*_release)(const char *, void *);
+  void *_context;
+};
+
+class MappedSourceProvider : public SourceProvider {
+public:
+  MappedSourceProvider(const char *data, unsigned int length, TextEncoding encoding)
+    : SourceProvider(data, length, encoding) { }
+  // mmap() refuses empty files, so those are not mapped
+  virtual ~MappedSourceProvider() { if (length()) munmap(const_cast<char *>(bytes()), length()); }
+};
+
+SourceProvider::SourceProvider(const UString &string)
+  : _refCount(1), _string(string), _bytes(0), _length(string.size()), _encoding(Latin1Encoding)
+{
+}
+
+SourceProvider::SourceProvider(const char *bytes, unsigned int length, TextEncoding encoding)
+  : _refCount(1), _bytes(bytes), _length(length), _encoding(encoding)
+{
+}
+
+SourceProvider::~SourceProvider()
+{
+}
+
+SourceProvider *SourceProvider::create(const UString &code)
+{
+  return new SourceProvider(code);
+}
+
+SourceProvider *SourceProvider::create(const char *data, unsigned int length, TextEncoding encoding)
+{
+  char *copy = static_cast<char *>(malloc(length ? length : 1));
+  memcpy(copy, data, length);
+  return new CopiedSourceProvider(copy, length, encoding);
+}
+
+SourceProvider *SourceProvider::createWithBuffer(const char *data, unsigned int length, TextEncoding encoding,
+                                                 void (*release)(const char *, void *), void *context)
+{
+  return new BufferSourceProvider(data, length, encoding, release, context);
+}
+
+SourceProvider *SourceProvider::createFromFile(const char *path, TextEncoding encoding)
+{
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return 0;
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    close(fd);
+    return 0;
+  }
+  unsigned int length = st.st_size;
+  void *data = length ? mmap(0, length, PROT_READ, MAP_PRIVATE, fd, 0) : const_cast<char *>("");
+  close(fd);
+  if (data == MAP_FAILED)
+    return 0;
+  return new MappedSourceProvider(static_cast<const char *>(data), length, encoding);
+}
+
+SourceProvider *SourceProvider::forOtherThread()
+{
+  if (_string.isNull()) {
+    ref();
+    return this;
+  }
+  if (const char *c = _string.latin1Data())
+    return create(c, _length, Latin1Encoding);
+  return create(UString(_string.data(), _length));
+}
+
+UString SourceProvider::substring(unsigned int start, unsigned int end) const
+{
+  if (!_string.isNull())
+    return _string.substr(start, end - start);
+  return UString(_bytes + start, end - start, _encoding);
+}
+
+bool SourceProvider::equals(const SourceProvider *other) const
+{
+  if (other == this)
+    return true;
+  if (_length != other->_length || _string.isNull() != other->_string.isNull())
+    return false;
+  if (!_string.isNull())
+    return _string == other->_string;
+  return _encoding == other->_encoding && memcmp(_bytes, other->_bytes, _length) == 0;
+}
@@ -0,0 +1,134 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef _KJS_SOURCE_PROVIDER_H_
+#define _KJS_SOURCE_PROVIDER_H_
+
+#include "ustring.h"
+
+namespace KJS {
+
+  /**
+   * @short The text of a script, shared by everything parsed from it.
+   *
+   * The text is either UTF-16 or bytes in Latin-1 or UTF-8. It can live in
+   * a @ref UString, in a copy owned by the provider, in a buffer owned by
+   * the caller or in a file mapped into memory. It never changes. Text in
+   * a UString that holds it in 8 bits is handed out as Latin-1 bytes.
+   *
+   * Parsed programs refer to their provider by offsets instead of keeping
+   * copies of their text. Function bodies that are parsed lazily, the
+   * text returned by Function.prototype.toString() and the source handed to
+   * a @ref Debugger are all taken from it. So a library that is loaded from
+   * a mapped file by many interpreters is held in memory once.
+   *
+   * Providers are reference counted. The count is atomic, since a
+   * background parse (see @ref ParsedProgram) can share a provider with
+   * the thread that started it. Otherwise, like the rest of the API,
+   * providers are only used with the interpreter lock held.
+   */
+  class SourceProvider {
+  public:
+    /**
+     * Makes a provider that shares the characters of code.
+     */
+    static SourceProvider *create(const UString &code);
+    /**
+     * Makes a provider with a copy of length bytes of Latin-1 or UTF-8
+     * text.
+     */
+    static SourceProvider *create(const char *data, unsigned int length, TextEncoding encoding);
+    /**
+     * Makes a provider for a buffer the caller keeps alive and unchanged
+     * until release is called with it and context, when the last reference
+     * to the provider is dropped. release may be 0.
+     */
+    static SourceProvider *createWithBuffer(const char *data, unsigned int length, TextEncoding encoding,
+                                            void (*release)(const char *data, void *context), void *context);
+    /**
+     * Maps the file at path into memory. Returns 0 if the file cannot be
+     * read.
+     */
+    static SourceProvider *createFromFile(const char *path, TextEncoding encoding);
+
+    void ref() { __atomic_fetch_add(&_refCount, 1, __ATOMIC_RELAXED); }
+    void deref() { if (__atomic_sub_fetch(&_refCount, 1, __ATOMIC_ACQ_REL) == 0) delete this; }
+
+    /**
+     * A provider that another thread can parse while this one goes on
+     * running scripts. Text in bytes never changes, so that is this
+     * provider. The characters of a UString can move, so for those it is
+     * a new provider with a copy. The caller gets a reference.
+     */
+    SourceProvider *forOtherThread();
+
+    /**
+     * The length of the text in UTF-16 units, or in bytes if the text is
+     * in one of the 8-bit encodings. Offsets into the text count the same.
+     */
+    unsigned int length() const { return _length; }
+    /**
+     * The text if it is in UTF-16, 0 otherwise. Strings may move their
+     * characters when others that share them are appended to, so the
+     * pointer is only good until the next script runs.
+     */
+    const UChar *characters() const { return _string.isNull() || _string.latin1Data() ? 0 : _string.data(); }
+    /**
+     * The text if it is in Latin-1 or UTF-8, 0 otherwise. The same goes as
+     * for @ref characters() if the text is in a UString.
+     */
+    const char *bytes() const { return _bytes ? _bytes : _string.latin1Data(); }
+    TextEncoding encoding() const { return _encoding; }
+
+    /**
+     * The text from offset start up to end as a string. The characters are
+     * shared if the text is held in a UString, and converted otherwise.
+     */
+    UString substring(unsigned int start, unsigned int end) const;
+    UString toUString() const { return substring(0, _length); }
+
+    /**
+     * Whether both hold the same text in the same encoding.
+     */
+    bool equals(const SourceProvider *other) const;
+
+  protected:
+    SourceProvider(const UString &string);
+    SourceProvider(const char *bytes, unsigned int length, TextEncoding encoding);
+    virtual ~SourceProvider();
+
+  private:
+    int _refCount;
+    // null if the text is in bytes
+    UString _string;
+    const char *_bytes;
+    unsigned int _length;
+    TextEncoding _encoding;
+
+    // not implemented
+    SourceProvider(const SourceProvider &);
+    SourceProvider &operator=(const SourceProvider &);
+  };
+
+}; // namespace
+
+#endif
@@ -328,7 +328,12 @@ Value StringProtoFuncImp::call(ExecState *exec, Object &thisObj, const List &arg
 
       RegExpObjectImp* regExpObj = static_cast<RegExpObjectImp*>(exec->lexicalInterpreter()->builtinRegExp().imp());
       int lastIndex = 0;
-      u3 = a1.toString(exec); // replacement string
+      const UString rstr = a1.toString(exec); // replacement string
+      // The pieces of u between the matches and the replacements are
+      // appended to a builder, so each match costs its own length only.
+      // Matching goes on in u itself, past the end of the last match.
+      StringBuilder builder;
+      int copied = 0;
       // This is either a loop (if global is set) or a one-way (if not).
       do {
         int **ovector = regExpObj->registerRegexp( reg, u );
@@ -337,27 +342,29 @@ Value StringProtoFuncImp::call(ExecState *exec, Object &thisObj, const List &arg
         if (pos == -1)
           break;
         len = mstr.size();
-        UString rstr(u3);
-        bool ok;
-        // check if u3 matches $1 or $2 etc
-        for (int i = 0; (i = rstr.find(UString("$"), i)) != -1; i++) {
+        builder.reserve(u.size());
+        builder.append(u, copied, pos - copied);
+        // check if rstr contains $1 or $2 etc
+        int start = 0;
+        for (int i = 0; (i = rstr.find(UChar('$'), i)) != -1; i++) {
           if (i+1<rstr.size() && rstr[i+1] == '$') {  // "$$" -> "$"
-            rstr = rstr.substr(0,i) + "$" + rstr.substr(i+2);
+            builder.append(rstr, start, i + 1 - start);
+            start = ++i + 1;
             continue;
           }
           // Assume number part is one char exactly
-          unsigned long pos = rstr.substr(i+1,1).toULong(&ok, false /* tolerate empty string */);
-          if (ok && pos <= (unsigned)reg->subPatterns()) {
-            rstr = rstr.substr(0,i)
-                      + u.substr((*ovector)[2*pos],
-                                     (*ovector)[2*pos+1]-(*ovector)[2*pos])
-                      + rstr.substr(i+2);
-            i += (*ovector)[2*pos+1]-(*ovector)[2*pos] - 1; // -1 offsets i++
+          unsigned short c = i+1<rstr.size() ? rstr[i+1].uc : 0;
+          unsigned long n = c - '0';
+          if (c >= '0' && c <= '9' && n <= (unsigned)reg->subPatterns()) {
+            builder.append(rstr, start, i - start);
+            if ((*ovector)[2*n] >= 0)
+              builder.append(u, (*ovector)[2*n], (*ovector)[2*n+1]-(*ovector)[2*n]);
+            start = ++i + 1;
           }
         }
-        lastIndex = pos + rstr.size();
-        u = u.substr(0, pos) + rstr + u.substr(pos + len);
-        //fprintf(stderr,"pos=%d,len=%d,lastIndex=%d,u=%s\n",pos,len,lastIndex,u.ascii());
+        builder.append(rstr, start, rstr.size() - start);
+        copied = pos + len;
+        lastIndex = copied;
 
         // special case of empty match
         if (len == 0) {
@@ -367,7 +374,12 @@ Value StringProtoFuncImp::call(ExecState *exec, Object &thisObj, const List &arg
         }
       } while (global);
 
-      result = String(u);
+      if (copied == 0 && builder.isEmpty()) // nothing was replaced
+        result = String(u);
+      else {
+        builder.append(u, copied, u.size() - copied);
+        result = String(builder.release());
+      }
     } else { // First arg is a string
       u2 = a0.toString(exec);
       pos = u.find(u2);
@@ -511,16 +523,10 @@ Value StringProtoFuncImp::call(ExecState *exec, Object &thisObj, const List &arg
     }
     break;
   case ToLowerCase:
-    u = s;
-    for (i = 0; i < len; i++)
-      u[i] = u[i].toLower();
-    result = String(u);
+    result = String(s.toLower());
     break;
   case ToUpperCase:
-    u = s;
-    for (i = 0; i < len; i++)
-      u[i] = u[i].toUpper();
-    result = String(u);
+    result = String(s.toUpper());
     break;
 #ifndef KJS_PURE_ECMA
   case Big:
@@ -51,6 +51,7 @@ namespace KJS {
   public:
     StringPrototypeImp(ExecState *exec,
                        ObjectPrototypeImp *objProto);
+    virtual ObjectImp *clone() const { return new StringPrototypeImp(*this); }
     Value get(ExecState *exec, const Identifier &p) const;
     virtual const ClassInfo *classInfo() const { return &info; }
     static const ClassInfo info;
@@ -91,6 +92,7 @@ namespace KJS {
     StringObjectImp(ExecState *exec,
                     FunctionPrototypeImp *funcProto,
                     StringPrototypeImp *stringProto);
+    virtual ObjectImp *clone() const { return new StringObjectImp(*this); }
 
     virtual bool implementsConstruct() const;
     virtual Object construct(ExecState *exec, const List &args);
@@ -107,6 +109,7 @@ namespace KJS {
   class StringObjectFuncImp : public InternalFunctionImp {
   public:
     StringObjectFuncImp(ExecState *exec, FunctionPrototypeImp *funcProto);
+    virtual ObjectImp *clone() const { return new StringObjectFuncImp(*this); }
     virtual bool implementsCall() const;
     virtual Value call(ExecState *exec, Object &thisObj, const List &args);
   };
@@ -0,0 +1,425 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "string_ops.h"
+
+#include "cpu_features.h"
+
+#if KJS_X86_VECTOR
+#include <immintrin.h>
+#endif
+
+using namespace KJS;
+
+// the character as unsigned short or unsigned char
+static inline unsigned short unit(const UChar &c)
+{
+  return c.uc;
+}
+
+static inline unsigned char unit(char c)
+{
+  return c;
+}
+
+static inline void setUnit(UChar &d, unsigned short c)
+{
+  d.uc = c;
+}
+
+static inline void setUnit(char &d, unsigned short c)
+{
+  d = static_cast<char>(c);
+}
+
+// the first letter of the case that is changed to the other one
+static inline unsigned short firstLetterToChange(StringOps::Case toCase)
+{
+  return toCase == StringOps::LowerCase ? 'A' : 'a';
+}
+
+template <class Char1, class Char2>
+static inline int mismatchScalar(const Char1 *a, const Char2 *b, int i, int length)
+{
+  for (; i < length; i++)
+    if (unit(a[i]) != unit(b[i]))
+      return i;
+  return length;
+}
+
+template <class Char>
+static inline int caseRunScalar(const Char *s, int i, int length, unsigned short first)
+{
+  for (; i < length; i++) {
+    unsigned short c = unit(s[i]);
+    if (c >= 0x80 || static_cast<unsigned short>(c - first) <= 'z' - 'a')
+      return i;
+  }
+  return length;
+}
+
+template <class Char>
+static inline int convertCaseScalar(const Char *s, Char *d, int i, int length, unsigned short first)
+{
+  for (; i < length; i++) {
+    unsigned short c = unit(s[i]);
+    if (c >= 0x80)
+      return i;
+    // upper and lower case ASCII letters only differ in bit 5
+    setUnit(d[i], static_cast<unsigned short>(c - first) <= 'z' - 'a' ? c ^ 0x20 : c);
+  }
+  return length;
+}
+
+#if KJS_X86_VECTOR
+
+// The helpers take a pointer of the character type only to pick the
+// instructions for it, and a tag only to pick the vector size. The masks
+// from movemask have one bit per byte, so two for each UTF-16 unit.
+
+static inline KJS_TARGET_SSE2 __m128i load(const void *p, SSE2Vector)
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+static inline unsigned int fullMask(SSE2Vector)
+{
+  return 0xffff;
+}
+
+static inline KJS_TARGET_SSE2 unsigned int equalMask(const char *a, const char *b, SSE2Vector v)
+{
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(load(a, v), load(b, v)));
+}
+
+static inline KJS_TARGET_SSE2 unsigned int equalMask(const UChar *a, const UChar *b, SSE2Vector v)
+{
+  return _mm_movemask_epi8(_mm_cmpeq_epi16(load(a, v), load(b, v)));
+}
+
+// compares 8 bytes of a with 8 units of b
+static inline KJS_TARGET_SSE2 unsigned int equalMask(const char *a, const UChar *b, SSE2Vector v)
+{
+  __m128i wide = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a)), _mm_setzero_si128());
+  return _mm_movemask_epi8(_mm_cmpeq_epi16(wide, load(b, v)));
+}
+
+static inline KJS_TARGET_SSE2 __m128i nonASCII(const char *, __m128i v)
+{
+  return _mm_cmplt_epi8(v, _mm_setzero_si128());
+}
+
+static inline KJS_TARGET_SSE2 __m128i nonASCII(const UChar *, __m128i v)
+{
+  __m128i ascii = _mm_cmpeq_epi16(_mm_subs_epu16(v, _mm_set1_epi16(0x7f)), _mm_setzero_si128());
+  return _mm_xor_si128(ascii, _mm_set1_epi32(-1));
+}
+
+// the letters from first to first + 25, without signed compares
+static inline KJS_TARGET_SSE2 __m128i letters(const char *, __m128i v, unsigned short first)
+{
+  __m128i offset = _mm_sub_epi8(v, _mm_set1_epi8(first));
+  return _mm_cmpeq_epi8(_mm_subs_epu8(offset, _mm_set1_epi8('z' - 'a')), _mm_setzero_si128());
+}
+
+static inline KJS_TARGET_SSE2 __m128i letters(const UChar *, __m128i v, unsigned short first)
+{
+  __m128i offset = _mm_sub_epi16(v, _mm_set1_epi16(first));
+  return _mm_cmpeq_epi16(_mm_subs_epu16(offset, _mm_set1_epi16('z' - 'a')), _mm_setzero_si128());
+}
+
+static inline KJS_TARGET_SSE2 __m128i caseBit(const char *, SSE2Vector)
+{
+  return _mm_set1_epi8(0x20);
+}
+
+static inline KJS_TARGET_SSE2 __m128i caseBit(const UChar *, SSE2Vector)
+{
+  return _mm_set1_epi16(0x20);
+}
+
+// the characters at s that are not ASCII or are letters to change
+template <class Char>
+static inline KJS_TARGET_SSE2 unsigned int caseRunMask(const Char *s, unsigned short first, SSE2Vector v)
+{
+  __m128i chars = load(s, v);
+  return _mm_movemask_epi8(_mm_or_si128(nonASCII(s, chars), letters(s, chars, first)));
+}
+
+// converts a vector of characters from s to d, unless one is not ASCII
+template <class Char>
+static inline KJS_TARGET_SSE2 bool convertCaseBlock(const Char *s, Char *d, unsigned short first, SSE2Vector v)
+{
+  __m128i chars = load(s, v);
+  if (_mm_movemask_epi8(nonASCII(s, chars)))
+    return false;
+  __m128i changed = _mm_xor_si128(chars, _mm_and_si128(letters(s, chars, first), caseBit(s, v)));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(d), changed);
+  return true;
+}
+
+static inline KJS_TARGET_AVX2 __m256i load(const void *p, AVX2Vector)
+{
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+static inline unsigned int fullMask(AVX2Vector)
+{
+  return 0xffffffff;
+}
+
+static inline KJS_TARGET_AVX2 unsigned int equalMask(const char *a, const char *b, AVX2Vector v)
+{
+  return _mm256_movemask_epi8(_mm256_cmpeq_epi8(load(a, v), load(b, v)));
+}
+
+static inline KJS_TARGET_AVX2 unsigned int equalMask(const UChar *a, const UChar *b, AVX2Vector v)
+{
+  return _mm256_movemask_epi8(_mm256_cmpeq_epi16(load(a, v), load(b, v)));
+}
+
+// compares 16 bytes of a with 16 units of b
+static inline KJS_TARGET_AVX2 unsigned int equalMask(const char *a, const UChar *b, AVX2Vector v)
+{
+  __m256i wide = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a)));
+  return _mm256_movemask_epi8(_mm256_cmpeq_epi16(wide, load(b, v)));
+}
+
+static inline KJS_TARGET_AVX2 __m256i nonASCII(const char *, __m256i v)
+{
+  return _mm256_cmpgt_epi8(_mm256_setzero_si256(), v);
+}
+
+static inline KJS_TARGET_AVX2 __m256i nonASCII(const UChar *, __m256i v)
+{
+  __m256i ascii = _mm256_cmpeq_epi16(_mm256_subs_epu16(v, _mm256_set1_epi16(0x7f)), _mm256_setzero_si256());
+  return _mm256_xor_si256(ascii, _mm256_set1_epi32(-1));
+}
+
+static inline KJS_TARGET_AVX2 __m256i letters(const char *, __m256i v, unsigned short first)
+{
+  __m256i offset = _mm256_sub_epi8(v, _mm256_set1_epi8(first));
+  return _mm256_cmpeq_epi8(_mm256_subs_epu8(offset, _mm256_set1_epi8('z' - 'a')), _mm256_setzero_si256());
+}
+
+static inline KJS_TARGET_AVX2 __m256i letters(const UChar *, __m256i v, unsigned short first)
+{
+  __m256i offset = _mm256_sub_epi16(v, _mm256_set1_epi16(first));
+  return _mm256_cmpeq_epi16(_mm256_subs_epu16(offset, _mm256_set1_epi16('z' - 'a')), _mm256_setzero_si256());
+}
+
+static inline KJS_TARGET_AVX2 __m256i caseBit(const char *, AVX2Vector)
+{
+  return _mm256_set1_epi8(0x20);
+}
+
+static inline KJS_TARGET_AVX2 __m256i caseBit(const UChar *, AVX2Vector)
+{
+  return _mm256_set1_epi16(0x20);
+}
+
+template <class Char>
+static inline KJS_TARGET_AVX2 unsigned int caseRunMask(const Char *s, unsigned short first, AVX2Vector v)
+{
+  __m256i chars = load(s, v);
+  return _mm256_movemask_epi8(_mm256_or_si256(nonASCII(s, chars), letters(s, chars, first)));
+}
+
+template <class Char>
+static inline KJS_TARGET_AVX2 bool convertCaseBlock(const Char *s, Char *d, unsigned short first, AVX2Vector v)
+{
+  __m256i chars = load(s, v);
+  if (_mm256_movemask_epi8(nonASCII(s, chars)))
+    return false;
+  __m256i changed = _mm256_xor_si256(chars, _mm256_and_si256(letters(s, chars, first), caseBit(s, v)));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(d), changed);
+  return true;
+}
+
+// The functions are written once for both vector sizes; Vector is
+// SSE2Vector or AVX2Vector and only selects the overloads above. They have
+// to be inlined into the functions compiled for SSE2 or AVX2 below, for
+// the overloads to be inlined in turn.
+#define KJS_VECTOR_INLINE inline __attribute__((always_inline))
+
+// Char2 is the wider type if they differ; a vector holds as many of
+// either.
+template <class Vector, class Char1, class Char2>
+static KJS_VECTOR_INLINE int mismatchVector(const Char1 *a, const Char2 *b, int length)
+{
+  const int n = Vector::size / sizeof(Char2);
+  int i = 0;
+  for (; i + n <= length; i += n) {
+    unsigned int mask = equalMask(a + i, b + i, Vector());
+    if (mask != fullMask(Vector()))
+      return i + __builtin_ctz(~mask) / sizeof(Char2);
+  }
+  return mismatchScalar(a, b, i, length);
+}
+
+template <class Vector, class Char>
+static KJS_VECTOR_INLINE int caseRunVector(const Char *s, int length, unsigned short first)
+{
+  const int n = Vector::size / sizeof(Char);
+  int i = 0;
+  for (; i + n <= length; i += n) {
+    unsigned int mask = caseRunMask(s + i, first, Vector());
+    if (mask)
+      return i + __builtin_ctz(mask) / sizeof(Char);
+  }
+  return caseRunScalar(s, i, length, first);
+}
+
+template <class Vector, class Char>
+static KJS_VECTOR_INLINE int convertCaseVector(const Char *s, Char *d, int length, unsigned short first)
+{
+  const int n = Vector::size / sizeof(Char);
+  int i = 0;
+  for (; i + n <= length; i += n) {
+    if (!convertCaseBlock(s + i, d + i, first, Vector()))
+      break;
+  }
+  return convertCaseScalar(s, d, i, length, first);
+}
+
+template <class Char1, class Char2>
+static KJS_TARGET_SSE2 int mismatchSSE2(const Char1 *a, const Char2 *b, int length)
+{
+  return mismatchVector<SSE2Vector>(a, b, length);
+}
+
+template <class Char1, class Char2>
+static KJS_TARGET_AVX2 int mismatchAVX2(const Char1 *a, const Char2 *b, int length)
+{
+  return mismatchVector<AVX2Vector>(a, b, length);
+}
+
+template <class Char>
+static KJS_TARGET_SSE2 int caseRunSSE2(const Char *s, int length, unsigned short first)
+{
+  return caseRunVector<SSE2Vector>(s, length, first);
+}
+
+template <class Char>
+static KJS_TARGET_AVX2 int caseRunAVX2(const Char *s, int length, unsigned short first)
+{
+  return caseRunVector<AVX2Vector>(s, length, first);
+}
+
+template <class Char>
+static KJS_TARGET_SSE2 int convertCaseSSE2(const Char *s, Char *d, int length, unsigned short first)
+{
+  return convertCaseVector<SSE2Vector>(s, d, length, first);
+}
+
+template <class Char>
+static KJS_TARGET_AVX2 int convertCaseAVX2(const Char *s, Char *d, int length, unsigned short first)
+{
+  return convertCaseVector<AVX2Vector>(s, d, length, first);
+}
+
+#endif
+
+template <class Char1, class Char2>
+static inline int mismatchIn(const Char1 *a, const Char2 *b, int length)
+{
+#if KJS_X86_VECTOR
+  switch (CPUFeatures::vectorLevel()) {
+  case CPUFeatures::UseAVX2:
+    return mismatchAVX2(a, b, length);
+  case CPUFeatures::UseSSE2:
+    return mismatchSSE2(a, b, length);
+  default:
+    break;
+  }
+#endif
+  return mismatchScalar(a, b, 0, length);
+}
+
+template <class Char>
+static inline int caseRunIn(const Char *s, int length, StringOps::Case toCase)
+{
+  unsigned short first = firstLetterToChange(toCase);
+#if KJS_X86_VECTOR
+  switch (CPUFeatures::vectorLevel()) {
+  case CPUFeatures::UseAVX2:
+    return caseRunAVX2(s, length, first);
+  case CPUFeatures::UseSSE2:
+    return caseRunSSE2(s, length, first);
+  default:
+    break;
+  }
+#endif
+  return caseRunScalar(s, 0, length, first);
+}
+
+template <class Char>
+static inline int convertCaseIn(const Char *s, Char *d, int length, StringOps::Case toCase)
+{
+  unsigned short first = firstLetterToChange(toCase);
+#if KJS_X86_VECTOR
+  switch (CPUFeatures::vectorLevel()) {
+  case CPUFeatures::UseAVX2:
+    return convertCaseAVX2(s, d, length, first);
+  case CPUFeatures::UseSSE2:
+    return convertCaseSSE2(s, d, length, first);
+  default:
+    break;
+  }
+#endif
+  return convertCaseScalar(s, d, 0, length, first);
+}
+
+int StringOps::mismatch(const char *a, const char *b, int length)
+{
+  return mismatchIn(a, b, length);
+}
+
+int StringOps::mismatch(const UChar *a, const UChar *b, int length)
+{
+  return mismatchIn(a, b, length);
+}
+
+int StringOps::mismatch(const char *a, const UChar *b, int length)
+{
+  return mismatchIn(a, b, length);
+}
+
+int StringOps::caseRunLength(const char *s, int length, Case toCase)
+{
+  return caseRunIn(s, length, toCase);
+}
+
+int StringOps::caseRunLength(const UChar *s, int length, Case toCase)
+{
+  return caseRunIn(s, length, toCase);
+}
+
+int StringOps::convertCase(const char *s, char *d, int length, Case toCase)
+{
+  return convertCaseIn(s, d, length, toCase);
+}
+
+int StringOps::convertCase(const UChar *s, UChar *d, int length, Case toCase)
+{
+  return convertCaseIn(s, d, length, toCase);
+}
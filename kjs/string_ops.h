@@ -0,0 +1,71 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef _KJS_STRING_OPS_H_
+#define _KJS_STRING_OPS_H_
+
+#include "ustring.h"
+
+namespace KJS {
+
+  /**
+   * @internal
+   *
+   * Compares characters and changes the case of ASCII letters for
+   * @ref UString, a vector of characters at a time with SSE2 or AVX2,
+   * picked at runtime through @ref CPUFeatures, and one by one otherwise.
+   * Text is either Latin-1 bytes or UTF-16.
+   *
+   * The case functions only deal with ASCII and stop at the first
+   * character that is not, which the caller maps on its own.
+   */
+  class StringOps {
+  public:
+    enum Case { LowerCase, UpperCase };
+
+    /**
+     * The index of the first character that differs between a and b, or
+     * length if the first length characters are the same.
+     */
+    static int mismatch(const char *a, const char *b, int length);
+    static int mismatch(const UChar *a, const UChar *b, int length);
+    static int mismatch(const char *a, const UChar *b, int length);
+
+    /**
+     * The number of characters at the start of s that are ASCII and that
+     * changing them to toCase leaves alone.
+     */
+    static int caseRunLength(const char *s, int length, Case toCase);
+    static int caseRunLength(const UChar *s, int length, Case toCase);
+
+    /**
+     * Copies s to d with ASCII letters changed to toCase, up to the first
+     * character that is not ASCII. Returns the index of that character,
+     * or length.
+     */
+    static int convertCase(const char *s, char *d, int length, Case toCase);
+    static int convertCase(const UChar *s, UChar *d, int length, Case toCase);
+  };
+
+}; // namespace
+
+#endif
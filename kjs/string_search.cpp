@@ -0,0 +1,408 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "string_search.h"
+
+#include "cpu_features.h"
+
+#include <string.h>
+
+#if KJS_X86_VECTOR
+#include <immintrin.h>
+#endif
+
+using namespace KJS;
+
+// the character as unsigned short or unsigned char
+static inline unsigned short unit(const UChar &c)
+{
+  return c.uc;
+}
+
+static inline unsigned char unit(char c)
+{
+  return c;
+}
+
+template <class Char>
+static inline bool equalUnits(const Char *a, const Char *b, int length)
+{
+  return memcmp(a, b, length * sizeof(Char)) == 0;
+}
+
+template <class Char>
+static inline int findCharScalar(const Char *s, int length, unsigned short c, int i)
+{
+  for (; i < length; i++)
+    if (unit(s[i]) == c)
+      return i;
+  return -1;
+}
+
+template <class Char>
+static inline int rfindCharScalar(const Char *s, unsigned short c, int i)
+{
+  for (; i >= 0; i--)
+    if (unit(s[i]) == c)
+      return i;
+  return -1;
+}
+
+template <class Char>
+static inline int findScalar(const Char *s, int length, const Char *f, int flength, int i)
+{
+  unsigned short first = unit(f[0]);
+  for (; i <= length - flength; i++)
+    if (unit(s[i]) == first && equalUnits(s + i + 1, f + 1, flength - 1))
+      return i;
+  return -1;
+}
+
+template <class Char>
+static inline int rfindScalar(const Char *s, const Char *f, int flength, int i)
+{
+  unsigned short first = unit(f[0]);
+  for (; i >= 0; i--)
+    if (unit(s[i]) == first && equalUnits(s + i + 1, f + 1, flength - 1))
+      return i;
+  return -1;
+}
+
+// Boyer-Moore-Horspool. UTF-16 characters share the shift of their low
+// byte, which keeps the table small and only makes some shifts shorter.
+template <class Char>
+static int findHorspool(const Char *s, int length, const Char *f, int flength, int i)
+{
+  int last = flength - 1;
+  int shift[256];
+  for (int k = 0; k < 256; k++)
+    shift[k] = flength;
+  for (int k = 0; k < last; k++)
+    shift[unit(f[k]) & 0xff] = last - k;
+
+  unsigned short lastChar = unit(f[last]);
+  for (; i + last < length; i += shift[unit(s[i + last]) & 0xff]) {
+    if (unit(s[i + last]) == lastChar && equalUnits(s + i, f, last))
+      return i;
+  }
+  return -1;
+}
+
+#if KJS_X86_VECTOR
+
+// matches() returns a mask of the positions in the vector at p that hold
+// c, with one bit per byte, so two for each UTF-16 unit. The pointer type
+// picks the instructions for the characters, the tag the vector size.
+
+static inline KJS_TARGET_SSE2 __m128i equalTo(const UChar *p, unsigned short c, SSE2Vector)
+{
+  return _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), _mm_set1_epi16(c));
+}
+
+static inline KJS_TARGET_SSE2 __m128i equalTo(const char *p, unsigned short c, SSE2Vector)
+{
+  return _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), _mm_set1_epi8(c));
+}
+
+template <class Char>
+static inline KJS_TARGET_SSE2 unsigned int matches(const Char *p, unsigned short c, SSE2Vector v)
+{
+  return _mm_movemask_epi8(equalTo(p, c, v));
+}
+
+template <class Char>
+static inline KJS_TARGET_SSE2 unsigned int matches(const Char *p1, unsigned short c1, const Char *p2, unsigned short c2, SSE2Vector v)
+{
+  return _mm_movemask_epi8(_mm_and_si128(equalTo(p1, c1, v), equalTo(p2, c2, v)));
+}
+
+static inline KJS_TARGET_AVX2 __m256i equalTo(const UChar *p, unsigned short c, AVX2Vector)
+{
+  return _mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), _mm256_set1_epi16(c));
+}
+
+static inline KJS_TARGET_AVX2 __m256i equalTo(const char *p, unsigned short c, AVX2Vector)
+{
+  return _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), _mm256_set1_epi8(c));
+}
+
+template <class Char>
+static inline KJS_TARGET_AVX2 unsigned int matches(const Char *p, unsigned short c, AVX2Vector v)
+{
+  return _mm256_movemask_epi8(equalTo(p, c, v));
+}
+
+template <class Char>
+static inline KJS_TARGET_AVX2 unsigned int matches(const Char *p1, unsigned short c1, const Char *p2, unsigned short c2, AVX2Vector v)
+{
+  return _mm256_movemask_epi8(_mm256_and_si256(equalTo(p1, c1, v), equalTo(p2, c2, v)));
+}
+
+// The searches are written once for both vector sizes; Vector is
+// SSE2Vector or AVX2Vector and only selects the overloads above. They have
+// to be inlined into the functions compiled for SSE2 or AVX2 below, for
+// the overloads to be inlined in turn.
+#define KJS_VECTOR_INLINE inline __attribute__((always_inline))
+
+template <class Vector, class Char>
+static KJS_VECTOR_INLINE int findCharVector(const Char *s, int length, unsigned short c, int i)
+{
+  const int n = Vector::size / sizeof(Char);
+  for (; i + n <= length; i += n) {
+    unsigned int mask = matches(s + i, c, Vector());
+    if (mask)
+      return i + __builtin_ctz(mask) / sizeof(Char);
+  }
+  return findCharScalar(s, length, c, i);
+}
+
+template <class Vector, class Char>
+static KJS_VECTOR_INLINE int rfindCharVector(const Char *s, unsigned short c, int i)
+{
+  const int n = Vector::size / sizeof(Char);
+  for (; i + 1 >= n; i -= n) {
+    unsigned int mask = matches(s + i - n + 1, c, Vector());
+    if (mask)
+      return i - n + 1 + (31 - __builtin_clz(mask)) / sizeof(Char);
+  }
+  return rfindCharScalar(s, c, i);
+}
+
+template <class Vector, class Char>
+static KJS_VECTOR_INLINE int findVector(const Char *s, int length, const Char *f, int flength, int i)
+{
+  const int n = Vector::size / sizeof(Char);
+  const unsigned int unitBits = sizeof(Char) == 1 ? 1 : 3;
+  int last = flength - 1;
+  unsigned short first = unit(f[0]);
+  unsigned short lastChar = unit(f[last]);
+  for (; i + last + n <= length; i += n) {
+    unsigned int mask = matches(s + i, first, s + i + last, lastChar, Vector());
+    while (mask) {
+      int k = __builtin_ctz(mask) / sizeof(Char);
+      if (equalUnits(s + i + k + 1, f + 1, last - 1))
+        return i + k;
+      mask &= ~(unitBits << (k * sizeof(Char)));
+    }
+  }
+  return findScalar(s, length, f, flength, i);
+}
+
+template <class Vector, class Char>
+static KJS_VECTOR_INLINE int rfindVector(const Char *s, const Char *f, int flength, int i)
+{
+  const int n = Vector::size / sizeof(Char);
+  const unsigned int unitBits = sizeof(Char) == 1 ? 1 : 3;
+  int last = flength - 1;
+  unsigned short first = unit(f[0]);
+  unsigned short lastChar = unit(f[last]);
+  for (; i + 1 >= n; i -= n) {
+    const Char *p = s + i - n + 1;
+    unsigned int mask = matches(p, first, p + last, lastChar, Vector());
+    while (mask) {
+      int k = (31 - __builtin_clz(mask)) / sizeof(Char);
+      if (equalUnits(p + k + 1, f + 1, last - 1))
+        return i - n + 1 + k;
+      mask &= ~(unitBits << (k * sizeof(Char)));
+    }
+  }
+  return rfindScalar(s, f, flength, i);
+}
+
+template <class Char>
+static KJS_TARGET_SSE2 int findCharSSE2(const Char *s, int length, unsigned short c, int i)
+{
+  return findCharVector<SSE2Vector>(s, length, c, i);
+}
+
+template <class Char>
+static KJS_TARGET_AVX2 int findCharAVX2(const Char *s, int length, unsigned short c, int i)
+{
+  return findCharVector<AVX2Vector>(s, length, c, i);
+}
+
+template <class Char>
+static KJS_TARGET_SSE2 int rfindCharSSE2(const Char *s, unsigned short c, int i)
+{
+  return rfindCharVector<SSE2Vector>(s, c, i);
+}
+
+template <class Char>
+static KJS_TARGET_AVX2 int rfindCharAVX2(const Char *s, unsigned short c, int i)
+{
+  return rfindCharVector<AVX2Vector>(s, c, i);
+}
+
+template <class Char>
+static KJS_TARGET_SSE2 int findSSE2(const Char *s, int length, const Char *f, int flength, int i)
+{
+  return findVector<SSE2Vector>(s, length, f, flength, i);
+}
+
+template <class Char>
+static KJS_TARGET_AVX2 int findAVX2(const Char *s, int length, const Char *f, int flength, int i)
+{
+  return findVector<AVX2Vector>(s, length, f, flength, i);
+}
+
+template <class Char>
+static KJS_TARGET_SSE2 int rfindSSE2(const Char *s, const Char *f, int flength, int i)
+{
+  return rfindVector<SSE2Vector>(s, f, flength, i);
+}
+
+template <class Char>
+static KJS_TARGET_AVX2 int rfindAVX2(const Char *s, const Char *f, int flength, int i)
+{
+  return rfindVector<AVX2Vector>(s, f, flength, i);
+}
+
+// Set by useVectors() while a benchmark runs the scalar code. Each search
+// reads it once, so one that is under way keeps to the path it started on.
+static bool vectorsOff = false;
+
+static inline CPUFeatures::VectorLevel currentVectorLevel()
+{
+  return __atomic_load_n(&vectorsOff, __ATOMIC_RELAXED) ? CPUFeatures::Scalar : CPUFeatures::vectorLevel();
+}
+
+#endif
+
+template <class Char>
+static inline int findCharIn(const Char *s, int length, unsigned short c, int start)
+{
+#if KJS_X86_VECTOR
+  switch (currentVectorLevel()) {
+  case CPUFeatures::UseAVX2:
+    return findCharAVX2(s, length, c, start);
+  case CPUFeatures::UseSSE2:
+    return findCharSSE2(s, length, c, start);
+  default:
+    break;
+  }
+#endif
+  return findCharScalar(s, length, c, start);
+}
+
+template <class Char>
+static inline int rfindCharIn(const Char *s, unsigned short c, int start)
+{
+#if KJS_X86_VECTOR
+  switch (currentVectorLevel()) {
+  case CPUFeatures::UseAVX2:
+    return rfindCharAVX2(s, c, start);
+  case CPUFeatures::UseSSE2:
+    return rfindCharSSE2(s, c, start);
+  default:
+    break;
+  }
+#endif
+  return rfindCharScalar(s, c, start);
+}
+
+template <class Char>
+static inline int findIn(const Char *s, int length, const Char *f, int flength, int start)
+{
+  if (flength == 1)
+    return findCharIn(s, length, unit(f[0]), start);
+#if KJS_X86_VECTOR
+  if (flength < StringSearch::longNeedleLength) {
+    switch (currentVectorLevel()) {
+    case CPUFeatures::UseAVX2:
+      return findAVX2(s, length, f, flength, start);
+    case CPUFeatures::UseSSE2:
+      return findSSE2(s, length, f, flength, start);
+    default:
+      break;
+    }
+  }
+#endif
+  // one character at a time, skipping pays off from quite short needles
+  if (flength >= 8)
+    return findHorspool(s, length, f, flength, start);
+  return findScalar(s, length, f, flength, start);
+}
+
+template <class Char>
+static inline int rfindIn(const Char *s, const Char *f, int flength, int start)
+{
+  if (flength == 1)
+    return rfindCharIn(s, unit(f[0]), start);
+#if KJS_X86_VECTOR
+  switch (currentVectorLevel()) {
+  case CPUFeatures::UseAVX2:
+    return rfindAVX2(s, f, flength, start);
+  case CPUFeatures::UseSSE2:
+    return rfindSSE2(s, f, flength, start);
+  default:
+    break;
+  }
+#endif
+  return rfindScalar(s, f, flength, start);
+}
+
+int StringSearch::findChar(const UChar *s, int length, unsigned short c, int start)
+{
+  return findCharIn(s, length, c, start);
+}
+
+int StringSearch::findChar(const char *s, int length, unsigned short c, int start)
+{
+  return c > 0xff ? -1 : findCharIn(s, length, c, start);
+}
+
+int StringSearch::rfindChar(const UChar *s, unsigned short c, int start)
+{
+  return rfindCharIn(s, c, start);
+}
+
+int StringSearch::rfindChar(const char *s, unsigned short c, int start)
+{
+  return c > 0xff ? -1 : rfindCharIn(s, c, start);
+}
+
+int StringSearch::find(const UChar *s, int length, const UChar *f, int flength, int start)
+{
+  return findIn(s, length, f, flength, start);
+}
+
+int StringSearch::find(const char *s, int length, const char *f, int flength, int start)
+{
+  return findIn(s, length, f, flength, start);
+}
+
+int StringSearch::rfind(const UChar *s, const UChar *f, int flength, int start)
+{
+  return rfindIn(s, f, flength, start);
+}
+
+int StringSearch::rfind(const char *s, const char *f, int flength, int start)
+{
+  return rfindIn(s, f, flength, start);
+}
+
+void StringSearch::useVectors(bool use)
+{
+#if KJS_X86_VECTOR
+  __atomic_store_n(&vectorsOff, !use, __ATOMIC_RELAXED);
+#endif
+}
@@ -0,0 +1,73 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef _KJS_STRING_SEARCH_H_
+#define _KJS_STRING_SEARCH_H_
+
+#include "ustring.h"
+
+namespace KJS {
+
+  /**
+   * @internal
+   *
+   * Finds characters and substrings for @ref UString::find() and
+   * @ref UString::rfind(). Text and needle are both UTF-16 or both
+   * Latin-1; the caller converts the needle if they differ.
+   *
+   * With SSE2 or AVX2, picked at runtime through @ref CPUFeatures, a
+   * vector of positions is checked at once for the first and the last
+   * character of the needle, and only the positions where both match are
+   * compared in full. Needles of at least @ref longNeedleLength characters,
+   * or of 8 without vectors, are searched for forwards with
+   * Boyer-Moore-Horspool instead, which skips ahead by up to their length.
+   *
+   * The functions return the index of the match, or -1 if there is none.
+   * Searching forwards starts at start; searching backwards starts at
+   * start and goes down to 0, and start must leave room for the needle.
+   */
+  class StringSearch {
+  public:
+    enum { longNeedleLength = 64 };
+
+    static int findChar(const UChar *s, int length, unsigned short c, int start);
+    static int findChar(const char *s, int length, unsigned short c, int start);
+    static int rfindChar(const UChar *s, unsigned short c, int start);
+    static int rfindChar(const char *s, unsigned short c, int start);
+
+    static int find(const UChar *s, int length, const UChar *f, int flength, int start);
+    static int find(const char *s, int length, const char *f, int flength, int start);
+    static int rfind(const UChar *s, const UChar *f, int flength, int start);
+    static int rfind(const char *s, const char *f, int flength, int start);
+
+    /**
+     * Turns the vector code off, or back on where @ref CPUFeatures found
+     * it, so that a benchmark can compare both. Other threads may be
+     * searching meanwhile; searches that have started finish on the path
+     * they started on.
+     */
+    static void useVectors(bool use);
+  };
+
+}; // namespace
+
+#endif
@@ -20,13 +20,20 @@
  *
  */
 
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/time.h>
 
 #include "value.h"
 #include "object.h"
 #include "types.h"
 #include "interpreter.h"
+#include "internal.h"
+#include "nodes.h"
+#include "parsed_program.h"
+#include "source_provider.h"
+#include "string_search.h"
 
 using namespace KJS;
 
@@ -62,6 +69,212 @@ public:
   virtual UString className() const { return "global"; }
 };
 
+static double currentTime()
+{
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec + t.tv_usec / 1000000.0;
+}
+
+// Parses each file a number of times from a UTF-16 copy, from the file as
+// it is, and from the file without lazily parsed function bodies, and
+// prints the throughput of the fastest run of each.
+static int benchmarkParsers(int argc, char **argv)
+{
+  const int Runs = 20;
+  const char *names[3] = { "UTF-16", "bytes", "bytes, eager bodies" };
+
+  Interpreter::lock();
+  for (int i = 2; i < argc; i++) {
+    SourceProvider *source = SourceProvider::createFromFile(argv[i], Latin1Encoding);
+    if (!source) {
+      fprintf(stderr, "Error opening %s.\n", argv[i]);
+      Interpreter::unlock();
+      return 2;
+    }
+    unsigned int size = source->length();
+    UString code = source->toUString();
+
+    double best[3];
+    for (int p = 0; p < 3; p++) {
+      Parser::lazyFunctionBodies = p != 2;
+      best[p] = 1e9;
+      for (int run = 0; run < Runs; run++) {
+        double start = currentTime();
+        ProgramNode *prog = p == 0
+          ? Parser::parse(argv[i], 1, code.data(), code.size())
+          : Parser::parse(argv[i], 1, source);
+        double time = currentTime() - start;
+        if (!prog) {
+          fprintf(stderr, "%s: parse error parsing from %s\n", argv[i], names[p]);
+          break;
+        }
+        prog->ref();
+        prog->deref();
+        if (time < best[p])
+          best[p] = time;
+      }
+    }
+    Parser::lazyFunctionBodies = true;
+    source->deref();
+
+    printf("%s: %u bytes", argv[i], size);
+    for (int p = 0; p < 3; p++)
+      printf(", %s %.1f MB/s", names[p], size / best[p] / 1000000.0);
+    printf("\n");
+  }
+  Interpreter::unlock();
+  return 0;
+}
+
+// Searches each file, as Latin-1 and as UTF-16 text, for all the lines,
+// for all the occurrences of a word forwards and backwards, and from a
+// script with indexOf() and split(), first with the vector code and then
+// with the scalar code, and prints the throughput of the fastest run of
+// each. Both must find the same.
+enum SearchTest { FindChar, FindWord, RfindWord, IndexOf, Split, SearchTests };
+
+static int search(Interpreter &interp, const UString &text, int test)
+{
+  static const char *scripts[SearchTests] = { 0, 0, 0,
+    "var n = 0, i = -1; while ((i = text.indexOf('return', i + 1)) >= 0) n++; n",
+    "text.split('\\n').length" };
+  const UString word("return");
+  int n = 0;
+  int i;
+  switch (test) {
+  case FindChar:
+    for (i = -1; (i = text.find(UChar('\n'), i + 1)) >= 0; n++)
+      ;
+    return n;
+  case FindWord:
+    for (i = -1; (i = text.find(word, i + 1)) >= 0; n++)
+      ;
+    return n;
+  case RfindWord:
+    for (i = text.size(); i > 0 && (i = text.rfind(word, i - 1)) >= 0; n++)
+      ;
+    return n;
+  default:
+    ExecState *exec = interp.globalExec();
+    interp.globalObject().put(exec, Identifier("text"), String(text));
+    Completion comp = interp.evaluate(scripts[test]);
+    return comp.complType() == Normal ? comp.value().toInt32(exec) : -1;
+  }
+}
+
+static int benchmarkSearch(int argc, char **argv)
+{
+  const int Runs = 10;
+  const char *tests[SearchTests] = { "find '\\n'", "find", "rfind", "indexOf", "split" };
+
+  Interpreter::lock();
+  Object global(new GlobalImp());
+  Interpreter interp(global);
+  int failures = 0;
+  for (int i = 2; i < argc; i++) {
+    SourceProvider *source = SourceProvider::createFromFile(argv[i], Latin1Encoding);
+    if (!source) {
+      fprintf(stderr, "Error opening %s.\n", argv[i]);
+      Interpreter::unlock();
+      return 2;
+    }
+    UString texts[2] = { source->toUString(), source->toUString() };
+    source->deref();
+    // the file is converted anew each time, so widening the second string
+    // in place leaves the first in Latin-1
+    texts[1].data();
+    unsigned int size = texts[0].size();
+
+    for (int t = 0; t < 2; t++) {
+      printf("%s: %u characters, %s\n", argv[i], size, t ? "UTF-16" : "Latin-1");
+      for (int test = 0; test < SearchTests; test++) {
+        double best[2];
+        int found[2];
+        for (int v = 0; v < 2; v++) {
+          StringSearch::useVectors(v == 0);
+          best[v] = 1e9;
+          for (int run = 0; run < Runs; run++) {
+            double start = currentTime();
+            found[v] = search(interp, texts[t], test);
+            double time = currentTime() - start;
+            if (time < best[v])
+              best[v] = time;
+          }
+        }
+        StringSearch::useVectors(true);
+        if (found[0] != found[1]) {
+          fprintf(stderr, "%s: %s found %d with vectors, %d without\n",
+                  argv[i], tests[test], found[0], found[1]);
+          failures++;
+        }
+        printf("  %-12s %6d found, vectors %.1f MB/s, scalar %.1f MB/s\n", tests[test], found[0],
+               size / best[0] / 1000000.0, size / best[1] / 1000000.0);
+      }
+    }
+  }
+  Interpreter::unlock();
+  return failures ? 3 : 0;
+}
+
+// Threads intern and drop the same names at once, so that they keep
+// finding strings whose count another thread has just dropped to 0. Each
+// round ends with every thread holding all the names, which must then be
+// the same strings on all of them.
+const int InternThreads = 8;
+const int InternNames = 64;
+const int InternRounds = 50;
+const int InternIterations = 200;
+
+static Identifier internedNames[InternThreads][InternNames];
+
+static void *internNames(void *arg)
+{
+  Identifier *held = static_cast<Identifier *>(arg);
+  char name[16];
+  for (int i = 0; i < InternIterations; i++) {
+    for (int n = 0; n < InternNames; n++) {
+      sprintf(name, "name%d", n);
+      Identifier a(name);
+      Identifier b = Identifier(UString(name));
+      if (a != b || a.size() != (int)strlen(name))
+        fprintf(stderr, "%s was interned twice\n", name);
+    }
+  }
+  for (int n = 0; n < InternNames; n++) {
+    sprintf(name, "name%d", n);
+    held[n] = Identifier(name);
+  }
+  return 0;
+}
+
+static int testInterning()
+{
+  int failures = 0;
+  for (int round = 0; round < InternRounds; round++) {
+    pthread_t threads[InternThreads];
+    for (int t = 0; t < InternThreads; t++)
+      pthread_create(&threads[t], 0, internNames, internedNames[t]);
+    for (int t = 0; t < InternThreads; t++)
+      pthread_join(threads[t], 0);
+
+    for (int t = 1; t < InternThreads; t++)
+      for (int n = 0; n < InternNames; n++)
+        if (internedNames[t][n] != internedNames[0][n])
+          failures++;
+    for (int t = 0; t < InternThreads; t++)
+      for (int n = 0; n < InternNames; n++)
+        internedNames[t][n] = Identifier::null();
+  }
+
+  if (failures) {
+    fprintf(stderr, "%d names were interned more than once.\n", failures);
+    return 3;
+  }
+  fprintf(stderr, "OK.\n");
+  return 0;
+}
+
 int main(int argc, char **argv)
 {
   // expecting a filename
@@ -70,10 +283,44 @@ int main(int argc, char **argv)
     return -1;
   }
 
+  if (strcmp(argv[1], "-parse") == 0)
+    return benchmarkParsers(argc, argv);
+  if (strcmp(argv[1], "-search") == 0)
+    return benchmarkSearch(argc, argv);
+  if (strcmp(argv[1], "-intern") == 0)
+    return testInterning();
+
+  // With -background every file is parsed on a thread of its own first, the
+  // way a browser loads the scripts of a page, and each one runs when its
+  // turn comes while the later ones are still being parsed.
+  bool background = strcmp(argv[1], "-background") == 0;
+
   bool ret = true;
   {
     Interpreter::lock();
 
+    ParsedProgram **programs = 0;
+    if (background) {
+      programs = new ParsedProgram *[argc];
+      for (int i = 2; i < argc; i++) {
+        programs[i] = 0;
+        if (strcmp(argv[i], "-f") == 0)
+          continue;
+        SourceProvider *source = SourceProvider::createFromFile(argv[i], Latin1Encoding);
+        if (!source) {
+          fprintf(stderr, "Error opening %s.\n", argv[i]);
+          // wait for the parses already started
+          for (int j = 2; j < i; j++)
+            delete programs[j];
+          delete [] programs;
+          Interpreter::unlock();
+          return 2;
+        }
+        programs[i] = ParsedProgram::parseInBackground(argv[i], 1, source);
+        source->deref();
+      }
+    }
+
     Object global(new GlobalImp());
 
     // create interpreter
@@ -85,27 +332,27 @@ int main(int argc, char **argv)
     // add "version" for compatibility with the mozilla js shell 
     global.put(interp.globalExec(), Identifier("version"), Object(new VersionFunctionImp()));
 
-    const int BufferSize = 200000;
-    char code[BufferSize];
-
-    for (int i = 1; i < argc; i++) {
+    for (int i = background ? 2 : 1; i < argc; i++) {
       const char *file = argv[i];
       if (strcmp(file, "-f") == 0)
 	continue;
-      FILE *f = fopen(file, "r");
-      if (!f) {
-        fprintf(stderr, "Error opening %s.\n", file);
-        return 2;
-      }
-      int num = fread(code, 1, BufferSize, f);
-      code[num] = '\0';
-      if(num >= BufferSize)
-        fprintf(stderr, "Warning: File may have been too long.\n");
 
-      // run
-      Completion comp(interp.evaluate(file, 1, code));
+      Completion comp;
+      if (background) {
+        comp = interp.evaluate(*programs[i]);
+        delete programs[i];
+      } else {
+        // files are taken to be in Latin-1, and are mapped into memory
+        SourceProvider *source = SourceProvider::createFromFile(file, Latin1Encoding);
+        if (!source) {
+          fprintf(stderr, "Error opening %s.\n", file);
+          return 2;
+        }
 
-      fclose(f);
+        // run
+        comp = interp.evaluate(file, 1, source);
+        source->deref();
+      }
 
       if (comp.complType() == Throw) {
         ExecState *exec = interp.globalExec();
@@ -129,6 +376,7 @@ int main(int argc, char **argv)
       }
     }
 
+    delete [] programs;
     Interpreter::unlock();
   } // end block, so that Interpreter and global get deleted
 
@@ -0,0 +1,98 @@
+// -*- c-basic-offset: 2 -*-
+/*
+ *  This file is part of the KDE libraries
+ *  Copyright (C) 2004 Apple Computer, Inc.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this library; see the file COPYING.LIB.  If not, write to
+ *  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef _KJS_TOKENS_H_
+#define _KJS_TOKENS_H_
+
+namespace KJS {
+
+  class Identifier;
+  class UString;
+
+  /**
+   * @internal
+   *
+   * The tokens the @ref Lexer hands to the @ref DescentParser. Punctuators
+   * of a single character are returned as that character and the end of the
+   * code as 0, so the others start above the range of characters.
+   */
+  enum Token {
+    /* literals */
+    NULLTOKEN = 258, TRUETOKEN, FALSETOKEN,
+    STRING, NUMBER,
+
+    /* keywords */
+    BREAK, CASE, DEFAULT, FOR, NEW, VAR, CONTINUE,
+    FUNCTION, RETURN, VOID, DELETE,
+    IF, THIS, DO, WHILE, ELSE, IN, INSTANCEOF, TYPEOF,
+    SWITCH, WITH, RESERVED,
+    THROW, TRY, CATCH, FINALLY,
+
+    /* punctuators */
+    EQEQ, NE,                     /* == and != */
+    STREQ, STRNEQ,                /* === and !== */
+    LE, GE,                       /* < and > */
+    OR, AND,                      /* || and && */
+    PLUSPLUS, MINUSMINUS,         /* ++ and --  */
+    LSHIFT,                       /* << */
+    RSHIFT, URSHIFT,              /* >> and >>> */
+    PLUSEQUAL, MINUSEQUAL,        /* += and -= */
+    MULTEQUAL, DIVEQUAL,          /* *= and /= */
+    LSHIFTEQUAL,                  /* <<= */
+    RSHIFTEQUAL, URSHIFTEQUAL,    /* >>= and >>>= */
+    ANDEQUAL, MODEQUAL,           /* &= and %= */
+    XOREQUAL, OREQUAL,            /* ^= and |= */
+
+    IDENT,
+
+    /* ++ and -- after a line terminator, before which a semicolon is inserted */
+    AUTOPLUSPLUS, AUTOMINUSMINUS
+  };
+
+  /**
+   * @internal
+   *
+   * The value of an IDENT, STRING or NUMBER token. The lexer owns the
+   * identifiers and strings until the parse is done.
+   */
+  union TokenValue {
+    double dval;
+    UString *ustr;
+    Identifier *ident;
+  };
+
+  /**
+   * @internal
+   *
+   * Where a token is. The columns are the offsets in the code where the
+   * token starts and where it ends.
+   */
+  struct TokenLocation {
+    int first_line;
+    int first_column;
+    int last_line;
+    int last_column;
+  };
+
+}; // namespace
+
+#endif
@@ -38,7 +38,11 @@
 #include "ustring.h"
 #include "operations.h"
 #include "identifier.h"
+#include "number_format.h"
+#include "string_ops.h"
+#include "string_search.h"
 #include <math.h>
+#include <pthread.h>
 #include "dtoa.h"
 
 #if APPLE_CHANGES
@@ -56,6 +60,7 @@ extern const double Inf;
 CString::CString(const char *c)
 {
   length = strlen(c);
+  capacity = length;
   data = new char[length+1];
   memcpy(data, c, length + 1);
 }
@@ -63,6 +68,7 @@ CString::CString(const char *c)
 CString::CString(const char *c, int len)
 {
   length = len;
+  capacity = len;
   data = new char[len+1];
   memcpy(data, c, len);
   data[len] = 0;
@@ -71,12 +77,14 @@ CString::CString(const char *c, int len)
 CString::CString(const CString &b)
 {
   length = b.length;
+  capacity = length;
   if (length > 0 && b.data) {
     data = new char[length+1];
     memcpy(data, b.data, length + 1);
   }
   else {
     data = 0;
+    capacity = 0;
   }
 }
 
@@ -87,17 +95,20 @@ CString::~CString()
 
 CString &CString::append(const CString &t)
 {
-  char *n;
-  n = new char[length+t.length+1];
-  if (length)
-    memcpy(n, data, length);
+  int newLength = length + t.length;
+  if (newLength > capacity || !data) {
+    int newCapacity = newLength < 2 * capacity ? 2 * capacity : newLength;
+    char *n = new char[newCapacity+1];
+    if (length)
+      memcpy(n, data, length);
+    delete [] data;
+    data = n;
+    capacity = newCapacity;
+  }
   if (t.length)
-    memcpy(n+length, t.data, t.length);
-  length += t.length;
-  n[length] = 0;
-
-  delete [] data;
-  data = n;
+    memcpy(data+length, t.data, t.length);
+  length = newLength;
+  data[length] = 0;
 
   return *this;
 }
@@ -107,6 +118,7 @@ CString &CString::operator=(const char *c)
   if (data)
     delete [] data;
   length = strlen(c);
+  capacity = length;
   data = new char[length+1];
   memcpy(data, c, length + 1);
 
@@ -121,12 +133,14 @@ CString &CString::operator=(const CString &str)
   if (data)
     delete [] data;
   length = str.length;
+  capacity = length;
   if (length > 0 && str.data) {
     data = new char[length + 1];
     memcpy(data, str.data, length + 1);
   }
   else {
     data = 0;
+    capacity = 0;
   }
 
   return *this;
@@ -138,12 +152,71 @@ bool KJS::operator==(const KJS::CString& c1, const KJS::CString& c2)
   return len == c2.size() && (len == 0 || memcmp(c1.c_str(), c2.c_str(), len) == 0);
 }
 
-UString::Rep UString::Rep::null = { 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0 };
-UString::Rep UString::Rep::empty = { 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0 };
+UString::Rep UString::Rep::null = { 0, 0, 1, 0, 0, 0, 0, 0, -1, 0, 0, 0, 0, 0, 0 };
+UString::Rep UString::Rep::empty = { 0, 0, 1, 0, 0, 0, 0, 0, -1, 0, 0, 0, 0, 0, 0 };
+// Concatenations shorter than this are copied right away.
+const int minRopeLength = 128;
+// Ropes this deep are flattened before being concatenated again, which
+// bounds the stack flatten() and destroy() need, and keeps the depth in
+// Rep::ropeDepth.
+const int maxRopeDepth = 255;
 const int normalStatBufferSize = 4096;
 static char *statBuffer = 0;
 static int statBufferSize = 0;
 
+// Strings hold their characters either as UChar or, if they are all
+// Latin-1, as char. These let the same code handle both.
+
+static inline unsigned short charCode(UChar c)
+{
+  return c.uc;
+}
+
+static inline unsigned short charCode(char c)
+{
+  return static_cast<unsigned char>(c);
+}
+
+static inline void copyChars(UChar *d, const UChar *s, int length)
+{
+  memcpy(d, s, length * sizeof(UChar));
+}
+
+static inline void copyChars(char *d, const char *s, int length)
+{
+  memcpy(d, s, length);
+}
+
+static inline void copyChars(UChar *d, const char *s, int length)
+{
+  for (int i = 0; i < length; i++)
+    d[i].uc = static_cast<unsigned char>(s[i]);
+}
+
+static inline void copyChars(char *d, const UChar *s, int length)
+{
+  for (int i = 0; i < length; i++)
+    d[i] = static_cast<char>(s[i].uc);
+}
+
+static inline bool equalChars(const UChar *a, const UChar *b, int length)
+{
+  return memcmp(a, b, length * sizeof(UChar)) == 0;
+}
+
+static inline bool equalChars(const char *a, const char *b, int length)
+{
+  return memcmp(a, b, length) == 0;
+}
+
+static bool allLatin1(const UChar *s, int length)
+{
+  for (int i = 0; i < length; i++)
+    if (s[i].uc > 0xFF)
+      return false;
+  return true;
+}
+
 UChar UChar::toLower() const
 {
   // ### properly support unicode tolower
@@ -164,8 +237,10 @@ UChar UChar::toUpper() const
 UCharReference& UCharReference::operator=(UChar c)
 {
   str->detach();
-  if (offset < str->rep->len)
+  if (offset < str->rep->len) {
     *(str->rep->data() + offset) = c;
+    str->rep->charactersChanged();
+  }
   /* TODO: lengthen string ? */
   return *this;
 }
@@ -188,6 +263,10 @@ UString::Rep *UString::Rep::create(UChar *d, int l)
   r->rc = 1;
   r->_hash = 0;
   r->isIdentifier = 0;
+  r->smallInteger = -1;
+  r->latin1 = false;
+  r->hasUTF8 = false;
+  r->ropeDepth = 0;
   r->baseString = 0;
   r->buf = d;
   r->usedCapacity = l;
@@ -197,10 +276,34 @@ UString::Rep *UString::Rep::create(UChar *d, int l)
   return r;
 }
 
+UString::Rep *UString::Rep::createLatin1(char *d, int l)
+{
+  Rep *r = new Rep;
+  r->offset = 0;
+  r->len = l;
+  r->rc = 1;
+  r->_hash = 0;
+  r->isIdentifier = 0;
+  r->smallInteger = -1;
+  r->latin1 = true;
+  r->hasUTF8 = false;
+  r->ropeDepth = 0;
+  r->baseString = 0;
+  r->buf8 = d;
+  r->usedCapacity = l;
+  r->capacity = l;
+  r->usedPreCapacity = 0;
+  r->preCapacity = 0;
+  return r;
+}
+
 UString::Rep *UString::Rep::create(Rep *base, int offset, int length)
 {
   assert(base);
 
+  if (base->isRope())
+    base->flatten();
+
   int baseOffset = base->offset;
 
   if (base->baseString) {
@@ -216,6 +319,10 @@ UString::Rep *UString::Rep::create(Rep *base, int offset, int length)
   r->rc = 1;
   r->_hash = 0;
   r->isIdentifier = 0;
+  r->smallInteger = -1;
+  r->latin1 = false;
+  r->hasUTF8 = false;
+  r->ropeDepth = 0;
   r->baseString = base;
   base->ref();
   r->buf = 0;
@@ -226,11 +333,230 @@ UString::Rep *UString::Rep::create(Rep *base, int offset, int length)
   return r;
 }
 
+UString::Rep *UString::Rep::createRope(Rep *left, Rep *right)
+{
+  assert(left->ropeDepth < maxRopeDepth && right->ropeDepth < maxRopeDepth);
+
+  Rep *r = new Rep;
+  r->offset = 0;
+  r->len = left->len + right->len;
+  r->rc = 1;
+  r->_hash = 0;
+  r->isIdentifier = 0;
+  r->smallInteger = -1;
+  r->latin1 = left->isLatin1() && right->isLatin1();
+  r->hasUTF8 = false;
+  r->ropeDepth = (left->ropeDepth > right->ropeDepth ? left->ropeDepth : right->ropeDepth) + 1;
+  r->ropeLeft = left;
+  left->ref();
+  r->ropeRight = right;
+  right->ref();
+  r->usedCapacity = 0;
+  r->capacity = 0;
+  r->usedPreCapacity = 0;
+  r->preCapacity = 0;
+  return r;
+}
+
+template <class CharType> void UString::Rep::copyCharacters(CharType *d) const
+{
+  if (!isRope()) {
+    if (isLatin1())
+      copyChars(d, latin1Data(), len);
+    else
+      copyChars(d, data(), len);
+    return;
+  }
+
+  // Copy the pieces from the right end backwards. Going down a rope, its
+  // right half is put aside and its left half is copied first; there is
+  // never more than one right half put aside per level.
+  const Rep *pending[maxRopeDepth];
+  CharType *pendingEnd[maxRopeDepth];
+  int pendingCount = 0;
+  const Rep *r = this;
+  CharType *end = d + len;
+  while (1) {
+    while (r->isRope()) {
+      pending[pendingCount] = r->ropeRight;
+      pendingEnd[pendingCount] = end;
+      ++pendingCount;
+      end -= r->ropeRight->len;
+      r = r->ropeLeft;
+    }
+    r->copyCharacters(end - r->len);
+    if (pendingCount == 0)
+      break;
+    --pendingCount;
+    r = pending[pendingCount];
+    end = pendingEnd[pendingCount];
+  }
+}
+
+void UString::Rep::flatten() const
+{
+  assert(isRope());
+
+  // the buffer takes the place of the halves
+  Rep *self = const_cast<Rep *>(this);
+  Rep *left = ropeLeft;
+  Rep *right = ropeRight;
+  if (latin1) {
+    char *d = static_cast<char *>(malloc(len));
+    copyCharacters(d);
+    self->buf8 = d;
+  } else {
+    UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * len));
+    copyCharacters(d);
+    self->buf = d;
+  }
+  self->baseString = 0;
+  self->ropeDepth = 0;
+  left->deref();
+  right->deref();
+
+  self->usedCapacity = len;
+  self->capacity = len;
+}
+
+void UString::Rep::widen() const
+{
+  Rep *r = const_cast<Rep *>(baseString ? baseString : this);
+  if (r->isIdentifier)
+    Identifier::widen(r);
+  else
+    r->widenBuffer();
+}
+
+void UString::Rep::widenBuffer()
+{
+  assert(latin1);
+
+  int size = preCapacity + capacity;
+  int start = preCapacity - usedPreCapacity;
+  UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * (size ? size : 1)));
+  copyChars(d + start, buf8 + start, usedPreCapacity + usedCapacity);
+  free(buf8);
+  buf = d;
+  latin1 = false;
+}
+
+bool UString::Rep::fitsLatin1() const
+{
+  if (isLatin1())
+    return true;
+  // finding out would take flattening the rope
+  if (isRope())
+    return false;
+  return allLatin1(data(), len);
+}
+
+// The UTF-8 forms cachedUTF8Data() keeps, found by the address of their
+// string. Few strings ever have one, so they are kept here rather than in
+// every Rep, which only has the flag hasUTF8. Strings go away on whatever
+// thread drops them last, so the table has a lock of its own.
+
+struct UTF8Entry {
+  const void *rep;
+  // as many bytes as characters means they are all ASCII
+  char *data;
+  int length;
+};
+
+static const int minUTF8TableSize = 16;
+static UTF8Entry *utf8Table;
+static int utf8TableSize;
+static int utf8TableCount;
+static pthread_mutex_t utf8TableLock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline int utf8Index(const void *rep)
+{
+  // the low bits of an allocation are mostly the same
+  unsigned long p = reinterpret_cast<unsigned long>(rep);
+  return static_cast<unsigned>((p >> 4) * 0x9e3779b9U) & (utf8TableSize - 1);
+}
+
+static UTF8Entry *findUTF8(const void *rep)
+{
+  int i = utf8Index(rep);
+  while (utf8Table[i].rep != rep)
+    i = (i + 1) & (utf8TableSize - 1);
+  return &utf8Table[i];
+}
+
+static void insertUTF8(const UTF8Entry &entry)
+{
+  int i = utf8Index(entry.rep);
+  while (utf8Table[i].rep)
+    i = (i + 1) & (utf8TableSize - 1);
+  utf8Table[i] = entry;
+}
+
+static void rehashUTF8(int newTableSize)
+{
+  UTF8Entry *oldTable = utf8Table;
+  int oldTableSize = utf8TableSize;
+  utf8Table = static_cast<UTF8Entry *>(calloc(newTableSize, sizeof(UTF8Entry)));
+  utf8TableSize = newTableSize;
+  for (int i = 0; i < oldTableSize; i++)
+    if (oldTable[i].rep)
+      insertUTF8(oldTable[i]);
+  free(oldTable);
+}
+
+static void addUTF8(const void *rep, char *data, int length)
+{
+  if ((utf8TableCount + 1) * 2 > utf8TableSize)
+    rehashUTF8(utf8TableSize ? utf8TableSize * 2 : minUTF8TableSize);
+  UTF8Entry entry = { rep, data, length };
+  insertUTF8(entry);
+  ++utf8TableCount;
+}
+
+static void removeUTF8(const void *rep)
+{
+  pthread_mutex_lock(&utf8TableLock);
+  UTF8Entry *entry = findUTF8(rep);
+  free(entry->data);
+  entry->rep = 0;
+  --utf8TableCount;
+
+  if (utf8TableCount * 6 < utf8TableSize && utf8TableSize > minUTF8TableSize) {
+    rehashUTF8(utf8TableSize / 2);
+  } else {
+    // reinsert the rest of the cluster, which may have passed the slot
+    int i = entry - utf8Table;
+    while (1) {
+      i = (i + 1) & (utf8TableSize - 1);
+      if (!utf8Table[i].rep)
+        break;
+      UTF8Entry moved = utf8Table[i];
+      utf8Table[i].rep = 0;
+      insertUTF8(moved);
+    }
+  }
+  pthread_mutex_unlock(&utf8TableLock);
+}
+
+void UString::Rep::charactersChanged()
+{
+  _hash = 0;
+  if (hasUTF8) {
+    removeUTF8(this);
+    hasUTF8 = false;
+  }
+}
+
 void UString::Rep::destroy()
 {
   if (isIdentifier)
     Identifier::remove(this);
-  if (baseString) {
+  if (hasUTF8)
+    removeUTF8(this);
+  if (isRope()) {
+    ropeLeft->deref();
+    ropeRight->deref();
+  } else if (baseString) {
     baseString->deref();
   } else {
     free(buf);
@@ -245,6 +571,7 @@ const unsigned PHI = 0x9e3779b9U;
 // This hash algorithm comes from:
 // http://burtleburtle.net/bob/hash/hashfaq.html
 // http://burtleburtle.net/bob/hash/doobs.html
+// The 8-bit version must give the same results for the same characters.
 unsigned UString::Rep::computeHash(const UChar *s, int length)
 {
     int prefixLength = length < 8 ? length : 8;
@@ -279,9 +606,8 @@ unsigned UString::Rep::computeHash(const UChar *s, int length)
 // This hash algorithm comes from:
 // http://burtleburtle.net/bob/hash/hashfaq.html
 // http://burtleburtle.net/bob/hash/doobs.html
-unsigned UString::Rep::computeHash(const char *s)
+unsigned UString::Rep::computeHash(const char *s, int length)
 {
-    int length = strlen(s);
     int prefixLength = length < 8 ? length : 8;
     int suffixPosition = length < 16 ? 8 : length - 8;
 
@@ -311,6 +637,11 @@ unsigned UString::Rep::computeHash(const char *s)
     return h;
 }
 
+unsigned UString::Rep::computeHash(const char *s)
+{
+    return computeHash(s, strlen(s));
+}
+
 // put these early so they can be inlined
 inline int UString::expandedSize(int size, int otherSize) const
 {
@@ -321,14 +652,15 @@ inline int UString::expandedSize(int size, int otherSize) const
   return s;
 }
 
+// a rope has neither
 inline int UString::usedCapacity() const
 {
-  return rep->baseString ? rep->baseString->usedCapacity : rep->usedCapacity;
+  return rep->baseString && !rep->isRope() ? rep->baseString->usedCapacity : rep->usedCapacity;
 }
 
 inline int UString::usedPreCapacity() const
 {
-  return rep->baseString ? rep->baseString->usedPreCapacity : rep->usedPreCapacity;
+  return rep->baseString && !rep->isRope() ? rep->baseString->usedPreCapacity : rep->usedPreCapacity;
 }
 
 void UString::expandCapacity(int requiredLength)
@@ -337,7 +669,8 @@ void UString::expandCapacity(int requiredLength)
 
   if (requiredLength > r->capacity) {
     int newCapacity = expandedSize(requiredLength, r->preCapacity);
-    r->buf = static_cast<UChar *>(realloc(r->buf, newCapacity * sizeof(UChar)));
+    int charSize = r->latin1 ? 1 : sizeof(UChar);
+    r->buf8 = static_cast<char *>(realloc(r->buf8, newCapacity * charSize));
     r->capacity = newCapacity - r->preCapacity;
   }
   if (requiredLength > r->usedCapacity) {
@@ -352,11 +685,12 @@ void UString::expandPreCapacity(int requiredPreCap)
   if (requiredPreCap > r->preCapacity) {
     int newCapacity = expandedSize(requiredPreCap, r->capacity);
     int delta = newCapacity - r->capacity - r->preCapacity;
+    int charSize = r->latin1 ? 1 : sizeof(UChar);
 
-    UChar *newBuf = static_cast<UChar *>(malloc(newCapacity * sizeof(UChar)));
-    memcpy(newBuf + delta, r->buf, (r->capacity + r->preCapacity) * sizeof(UChar));
-    free(r->buf);
-    r->buf = newBuf;
+    char *newBuf = static_cast<char *>(malloc(newCapacity * charSize));
+    memcpy(newBuf + delta * charSize, r->buf8, (r->capacity + r->preCapacity) * charSize);
+    free(r->buf8);
+    r->buf8 = newBuf;
 
     r->preCapacity = newCapacity - r->capacity;
   }
@@ -373,9 +707,9 @@ UString::UString()
 
 UString::UString(char c)
 {
-    UChar *d = static_cast<UChar *>(malloc(sizeof(UChar)));
+    char *d = static_cast<char *>(malloc(1));
     d[0] = c;
-    rep = Rep::create(d, 1);
+    rep = Rep::createLatin1(d, 1);
 }
 
 UString::UString(const char *c)
@@ -389,29 +723,92 @@ UString::UString(const char *c)
     attach(&Rep::empty);
     return;
   }
-  UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * length));
-  for (int i = 0; i < length; i++)
-    d[i].uc = c[i];
-  rep = Rep::create(d, length);
+  char *d = static_cast<char *>(malloc(length));
+  memcpy(d, c, length);
+  rep = Rep::createLatin1(d, length);
 }
 
 UString::UString(const UChar *c, int length)
 {
-  if (length == 0) {
+  if (length <= 0) {
     attach(&Rep::empty);
     return;
   }
+  if (allLatin1(c, length)) {
+    char *d = static_cast<char *>(malloc(length));
+    copyChars(d, c, length);
+    rep = Rep::createLatin1(d, length);
+    return;
+  }
   UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) *length));
   memcpy(d, c, length * sizeof(UChar));
   rep = Rep::create(d, length);
 }
 
+UString::UString(const char *c, int length, TextEncoding encoding)
+{
+  if (length <= 0) {
+    attach(&Rep::empty);
+    return;
+  }
+  int i = 0;
+  if (encoding == UTF8Encoding) {
+    while (i < length && !(c[i] & 0x80))
+      i++;
+  }
+  if (encoding == Latin1Encoding || i == length) {
+    char *d = static_cast<char *>(malloc(length));
+    memcpy(d, c, length);
+    rep = Rep::createLatin1(d, length);
+    return;
+  }
+  // no character takes more UTF-16 units than UTF-8 bytes
+  UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * length));
+  copyChars(d, c, i);
+  int l = i;
+  while (i < length) {
+    unsigned char b = c[i];
+    if (b < 0x80) {
+      d[l++].uc = b;
+      i++;
+      continue;
+    }
+    int sequenceLength;
+    int u = decodeUTF8Sequence(c + i, length - i, sequenceLength);
+    i += sequenceLength;
+    if (u < 0) {
+      d[l++].uc = 0xFFFD;
+    } else if (u >= 0x10000) {
+      d[l++].uc = 0xD800 | ((u - 0x10000) >> 10);
+      d[l++].uc = 0xDC00 | ((u - 0x10000) & 0x3FF);
+    } else {
+      d[l++].uc = u;
+    }
+  }
+  if (allLatin1(d, l)) {
+    char *d8 = static_cast<char *>(malloc(static_cast<unsigned>(l)));
+    copyChars(d8, d, l);
+    free(d);
+    rep = Rep::createLatin1(d8, l);
+    return;
+  }
+  rep = Rep::create(d, l);
+}
+
 UString::UString(UChar *c, int length, bool copy)
 {
-  if (length == 0) {
+  if (length <= 0) {
     attach(&Rep::empty);
     return;
   }
+  if (allLatin1(c, length)) {
+    char *d = static_cast<char *>(malloc(length));
+    copyChars(d, c, length);
+    if (!copy)
+      free(c);
+    rep = Rep::createLatin1(d, length);
+    return;
+  }
   UChar *d;
   if (copy) {
     d = static_cast<UChar *>(malloc(sizeof(UChar) * length));
@@ -423,6 +820,12 @@ UString::UString(UChar *c, int length, bool copy)
 
 UString::UString(const UString &a, const UString &b)
 {
+  // once flat, a is usually the end of its buffer and can be extended
+  if (a.rep->ropeDepth >= maxRopeDepth)
+    a.rep->flatten();
+  if (b.rep->ropeDepth >= maxRopeDepth)
+    b.rep->flatten();
+
   int aSize = a.size();
   int aOffset = a.rep->offset;
   int bSize = b.size();
@@ -437,30 +840,50 @@ UString::UString(const UString &a, const UString &b)
   } else if (bSize == 0) {
     // b is empty
     attach(a.rep);
-  } else if (aOffset + aSize == a.usedCapacity() && 4 * aSize >= bSize &&
-	     (-bOffset != b.usedPreCapacity() || aSize >= bSize)) {
+  } else if (!a.rep->isRope() && aOffset + aSize == a.usedCapacity() && 4 * aSize >= bSize &&
+	     (-bOffset != b.usedPreCapacity() || aSize >= bSize) &&
+	     (!a.rep->isLatin1() || b.rep->fitsLatin1())) {
     // - a reaches the end of its buffer so it qualifies for shared append
     // - also, it's at least a quarter the length of b - appending to a much shorter
     //   string does more harm than good
     // - however, if b qualifies for prepend and is longer than a, we'd rather prepend
+    // - an 8-bit buffer is not widened for the sake of one string
     UString x(a);
     x.expandCapacity(aOffset + length);
-    memcpy(const_cast<UChar *>(a.data() + aSize), b.data(), bSize * sizeof(UChar));
+    if (a.rep->isLatin1())
+      b.rep->copyCharacters(a.rep->latin1Data() + aSize);
+    else
+      b.rep->copyCharacters(a.rep->data() + aSize);
     rep = Rep::create(a.rep, 0, length);
-  } else if (-bOffset == b.usedPreCapacity() && 4 * bSize >= aSize) {
+  } else if (!b.rep->isRope() && -bOffset == b.usedPreCapacity() && 4 * bSize >= aSize &&
+	     (!b.rep->isLatin1() || a.rep->fitsLatin1())) {
     // - b reaches the beginning of its buffer so it qualifies for shared prepend
     // - also, it's at least a quarter the length of a - prepending to a much shorter
     //   string does more harm than good
     UString y(b);
     y.expandPreCapacity(-bOffset + aSize);
-    memcpy(const_cast<UChar *>(b.data() - aSize), a.data(), aSize * sizeof(UChar));
+    if (b.rep->isLatin1())
+      a.rep->copyCharacters(b.rep->latin1Data() - aSize);
+    else
+      a.rep->copyCharacters(b.rep->data() - aSize);
     rep = Rep::create(b.rep, -aSize, length);
-  } else {
+  } else if (length >= minRopeLength) {
+    // neither qualifies, but rather than copying both now, make a rope and
+    // copy them once if its characters are ever needed
+    rep = Rep::createRope(a.rep, b.rep);
+  } else if (a.rep->fitsLatin1() && b.rep->fitsLatin1()) {
     // a does not qualify for append, and b does not qualify for prepend, gotta make a whole new string
+    int newCapacity = expandedSize(length, 0);
+    char *d = static_cast<char *>(malloc(newCapacity));
+    a.rep->copyCharacters(d);
+    b.rep->copyCharacters(d + aSize);
+    rep = Rep::createLatin1(d, length);
+    rep->capacity = newCapacity;
+  } else {
     int newCapacity = expandedSize(length, 0);
     UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * newCapacity));
-    memcpy(d, a.data(), aSize * sizeof(UChar));
-    memcpy(d + aSize, b.data(), bSize * sizeof(UChar));
+    a.rep->copyCharacters(d);
+    b.rep->copyCharacters(d + aSize);
     rep = Rep::create(d, length);
     rep->capacity = newCapacity;
   }
@@ -472,6 +895,50 @@ const UString &UString::null()
   return n;
 }
 
+// UString::from() keeps the strings of the integers below this, interned as
+// identifiers, so that array indexes are not formatted and looked up in the
+// identifier table again on every access by number.
+static const unsigned smallIntegerCacheSize = 65536;
+
+static void **smallIntegerReps;
+static pthread_once_t smallIntegerRepsOnce = PTHREAD_ONCE_INIT;
+
+static void allocateSmallIntegerReps()
+{
+  smallIntegerReps = static_cast<void **>(calloc(smallIntegerCacheSize, sizeof(void *)));
+}
+
+UString::Rep *UString::smallIntegerRep(unsigned u)
+{
+  assert(u < smallIntegerCacheSize);
+
+  pthread_once(&smallIntegerRepsOnce, allocateSmallIntegerReps);
+  Rep **reps = reinterpret_cast<Rep **>(smallIntegerReps);
+
+  Rep *r = __atomic_load_n(&reps[u], __ATOMIC_ACQUIRE);
+  if (!r) {
+    char buf[10];
+    char *end = buf + 10;
+    char *p = end;
+    unsigned n = u;
+    do {
+      *--p = (char)((n % 10) + '0');
+      n /= 10;
+    } while (n);
+    // the reference taken here is the cache's, and is never given up
+    Identifier identifier(UString(p, end - p, Latin1Encoding));
+    r = identifier.ustring().rep;
+    r->ref();
+    r->smallInteger = u;
+    // threads that race here all get the same identifier, and all but one
+    // give their reference back
+    Rep *expected = 0;
+    if (!__atomic_compare_exchange_n(&reps[u], &expected, r, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+      r->deref();
+  }
+  return r;
+}
+
 UString UString::from(int i)
 {
   return from((long)i);
@@ -479,27 +946,33 @@ UString UString::from(int i)
 
 UString UString::from(unsigned int u)
 {
-  UChar buf[20];
-  UChar *end = buf + 20;
-  UChar *p = end;
+  if (u < smallIntegerCacheSize)
+    return UString(smallIntegerRep(u));
+
+  char buf[20];
+  char *end = buf + 20;
+  char *p = end;
   
   if (u == 0) {
     *--p = '0';
   } else {
     while (u) {
-      *--p = (unsigned short)((u % 10) + '0');
+      *--p = (char)((u % 10) + '0');
       u /= 10;
     }
   }
   
-  return UString(p, end - p);
+  return UString(p, end - p, Latin1Encoding);
 }
 
 UString UString::from(long l)
 {
-  UChar buf[20];
-  UChar *end = buf + 20;
-  UChar *p = end;
+  if (l >= 0 && (unsigned long)l < smallIntegerCacheSize)
+    return UString(smallIntegerRep(l));
+
+  char buf[20];
+  char *end = buf + 20;
+  char *p = end;
   
   if (l == 0) {
     *--p = '0';
@@ -514,7 +987,7 @@ UString UString::from(long l)
       l = -l;
     }
     while (l) {
-      *--p = (unsigned short)((l % 10) + '0');
+      *--p = (char)((l % 10) + '0');
       l /= 10;
     }
     if (negative) {
@@ -522,20 +995,27 @@ UString UString::from(long l)
     }
   }
   
-  return UString(p, end - p);
+  return UString(p, end - p, Latin1Encoding);
 }
 
 UString UString::from(double d)
 {
+  // -0 is written as 0 too
+  if (d >= 0 && d < smallIntegerCacheSize && d == (unsigned)d)
+    return UString(smallIntegerRep((unsigned)d));
+
+  if (isNaN(d))
+    return "NaN";
+  if (isInf(d))
+    return d > 0 ? "Infinity" : "-Infinity";
+
   char buf[80];
   int decimalPoint;
-  int sign;
-  
-  char *result = kjs_dtoa(d, 0, 0, &decimalPoint, &sign, NULL);
-  int length = strlen(result);
+  char result[NumberFormat::maxShortestDigits + 1];
+  int length = NumberFormat::shortestDigits(d < 0 ? -d : d, result, decimalPoint);
   
   int i = 0;
-  if (sign) {
+  if (d < 0) {
     buf[i++] = '-';
   }
   
@@ -560,8 +1040,6 @@ UString UString::from(double d)
       buf[i++] = '.';
       strcpy(buf + i, result + decimalPoint);
     }
-  } else if (result[0] < '0' || result[0] > '9') {
-    strcpy(buf + i, result);
   } else {
     buf[i++] = result[0];
     if (length > 1) {
@@ -588,13 +1066,16 @@ UString UString::from(double d)
     buf[i++] = '\0';
   }
   
-  kjs_freedtoa(result);
-  
   return UString(buf);
 }
 
 UString &UString::append(const UString &t)
 {
+  if (rep->ropeDepth >= maxRopeDepth)
+    rep->flatten();
+  if (t.rep->ropeDepth >= maxRopeDepth)
+    t.rep->flatten();
+
   int thisSize = size();
   int thisOffset = rep->offset;
   int tSize = t.size();
@@ -606,25 +1087,53 @@ UString &UString::append(const UString &t)
     *this = t;
   } else if (tSize == 0) {
     // t is empty
-  } else if (!rep->baseString && rep->rc == 1) {
-    // this is direct and has refcount of 1 (so we can just alter it directly)
+  } else if (rep->isRope()) {
+    // this has not been copied yet, so don't copy t either
+    Rep *newRep = Rep::createRope(rep, t.rep);
+    release();
+    rep = newRep;
+  } else if (!rep->baseString && rep->hasOneRef() && !rep->isIdentifier) {
+    // this is direct, has refcount of 1 and is not an identifier that the
+    // table could hand out (so we can just alter it directly)
+    if (rep->latin1 && !t.rep->fitsLatin1())
+      rep->widen();
     expandCapacity(thisOffset + length);
-    memcpy(const_cast<UChar *>(data() + thisSize), t.data(), tSize * sizeof(UChar));
+    if (rep->latin1)
+      t.rep->copyCharacters(rep->latin1Data() + thisSize);
+    else
+      t.rep->copyCharacters(rep->data() + thisSize);
     rep->len = length;
-    rep->_hash = 0;
-  } else if (thisOffset + thisSize == usedCapacity()) {
+    rep->charactersChanged();
+  } else if (thisOffset + thisSize == usedCapacity() && (!rep->isLatin1() || t.rep->fitsLatin1())) {
     // this reaches the end of the buffer - extend it
-    expandCapacity(length);
-    memcpy(const_cast<UChar *>(data() + thisSize), t.data(), tSize * sizeof(UChar));
+    expandCapacity(thisOffset + length);
+    if (rep->isLatin1())
+      t.rep->copyCharacters(rep->latin1Data() + thisSize);
+    else
+      t.rep->copyCharacters(rep->data() + thisSize);
     Rep *newRep = Rep::create(rep, 0, length);
     release();
     rep = newRep;
-  } else {
+  } else if (length >= minRopeLength) {
+    // this is shared with someone using more capacity, make a rope rather
+    // than a copy
+    Rep *newRep = Rep::createRope(rep, t.rep);
+    release();
+    rep = newRep;
+  } else if (rep->fitsLatin1() && t.rep->fitsLatin1()) {
     // this is shared with someone using more capacity, gotta make a whole new string
+    int newCapacity = expandedSize(length, 0);
+    char *d = static_cast<char *>(malloc(newCapacity));
+    rep->copyCharacters(d);
+    t.rep->copyCharacters(d + thisSize);
+    release();
+    rep = Rep::createLatin1(d, length);
+    rep->capacity = newCapacity;
+  } else {
     int newCapacity = expandedSize(length, 0);
     UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * newCapacity));
-    memcpy(d, data(), thisSize * sizeof(UChar));
-    memcpy(const_cast<UChar *>(d + thisSize), t.data(), tSize * sizeof(UChar));
+    rep->copyCharacters(d);
+    t.rep->copyCharacters(d + thisSize);
     release();
     rep = Rep::create(d, length);
     rep->capacity = newCapacity;
@@ -635,6 +1144,9 @@ UString &UString::append(const UString &t)
 
 UString &UString::append(const char *t)
 {
+  if (rep->isRope())
+    rep->flatten();
+
   int thisSize = size();
   int thisOffset = rep->offset;
   int tSize = strlen(t);
@@ -646,30 +1158,40 @@ UString &UString::append(const char *t)
     *this = t;
   } else if (tSize == 0) {
     // t is empty, we'll just return *this below.
-  } else if (!rep->baseString && rep->rc == 1) {
-    // this is direct and has refcount of 1 (so we can just alter it directly)
+  } else if (!rep->baseString && rep->hasOneRef() && !rep->isIdentifier) {
+    // this is direct, has refcount of 1 and is not an identifier that the
+    // table could hand out (so we can just alter it directly)
     expandCapacity(thisOffset + length);
-    UChar *d = const_cast<UChar *>(data());
-    for (int i = 0; i < tSize; ++i)
-      d[thisSize+i] = t[i];
+    if (rep->latin1)
+      copyChars(rep->latin1Data() + thisSize, t, tSize);
+    else
+      copyChars(rep->data() + thisSize, t, tSize);
     rep->len = length;
-    rep->_hash = 0;
+    rep->charactersChanged();
   } else if (thisOffset + thisSize == usedCapacity()) {
     // this string reaches the end of the buffer - extend it
     expandCapacity(thisOffset + length);
-    UChar *d = const_cast<UChar *>(data());
-    for (int i = 0; i < tSize; ++i)
-      d[thisSize+i] = t[i];
+    if (rep->isLatin1())
+      copyChars(rep->latin1Data() + thisSize, t, tSize);
+    else
+      copyChars(rep->data() + thisSize, t, tSize);
     Rep *newRep = Rep::create(rep, 0, length);
     release();
     rep = newRep;
-  } else {
+  } else if (rep->isLatin1()) {
     // this is shared with someone using more capacity, gotta make a whole new string
+    int newCapacity = expandedSize(length, 0);
+    char *d = static_cast<char *>(malloc(newCapacity));
+    copyChars(d, rep->latin1Data(), thisSize);
+    copyChars(d + thisSize, t, tSize);
+    release();
+    rep = Rep::createLatin1(d, length);
+    rep->capacity = newCapacity;
+  } else {
     int newCapacity = expandedSize(length, 0);
     UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * newCapacity));
-    memcpy(d, data(), thisSize * sizeof(UChar));
-    for (int i = 0; i < tSize; ++i)
-      d[thisSize+i] = t[i];
+    copyChars(d, rep->data(), thisSize);
+    copyChars(d + thisSize, t, tSize);
     release();
     rep = Rep::create(d, length);
     rep->capacity = newCapacity;
@@ -680,6 +1202,9 @@ UString &UString::append(const char *t)
 
 UString &UString::append(unsigned short c)
 {
+  if (rep->isRope())
+    rep->flatten();
+
   int thisOffset = rep->offset;
   int length = size();
 
@@ -687,34 +1212,55 @@ UString &UString::append(unsigned short c)
   if (length == 0) {
     // this is empty - must make a new rep because we don't want to pollute the shared empty one 
     int newCapacity = expandedSize(1, 0);
-    UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * newCapacity));
-    d[0] = c;
     release();
-    rep = Rep::create(d, 1);
+    if (c <= 0xFF) {
+      char *d = static_cast<char *>(malloc(newCapacity));
+      d[0] = static_cast<char>(c);
+      rep = Rep::createLatin1(d, 1);
+    } else {
+      UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * newCapacity));
+      d[0] = c;
+      rep = Rep::create(d, 1);
+    }
     rep->capacity = newCapacity;
-  } else if (!rep->baseString && rep->rc == 1) {
-    // this is direct and has refcount of 1 (so we can just alter it directly)
+  } else if (!rep->baseString && rep->hasOneRef() && !rep->isIdentifier) {
+    // this is direct, has refcount of 1 and is not an identifier that the
+    // table could hand out (so we can just alter it directly)
+    if (rep->latin1 && c > 0xFF)
+      rep->widen();
     expandCapacity(thisOffset + length + 1);
-    UChar *d = const_cast<UChar *>(data());
-    d[length] = c;
+    if (rep->latin1)
+      rep->latin1Data()[length] = static_cast<char>(c);
+    else
+      rep->data()[length] = c;
     rep->len = length + 1;
-    rep->_hash = 0;
-  } else if (thisOffset + length == usedCapacity()) {
+    rep->charactersChanged();
+  } else if (thisOffset + length == usedCapacity() && (!rep->isLatin1() || c <= 0xFF)) {
     // this reaches the end of the string - extend it and share
     expandCapacity(thisOffset + length + 1);
-    UChar *d = const_cast<UChar *>(data());
-    d[length] = c;
+    if (rep->isLatin1())
+      rep->latin1Data()[length] = static_cast<char>(c);
+    else
+      rep->data()[length] = c;
     Rep *newRep = Rep::create(rep, 0, length + 1);
     release();
     rep = newRep;
-  } else {
+  } else if (rep->isLatin1() && c <= 0xFF) {
     // this is shared with someone using more capacity, gotta make a whole new string
+    int newCapacity = expandedSize((length + 1), 0);
+    char *d = static_cast<char *>(malloc(newCapacity));
+    copyChars(d, rep->latin1Data(), length);
+    d[length] = static_cast<char>(c);
+    release();
+    rep = Rep::createLatin1(d, length + 1);
+    rep->capacity = newCapacity;
+  } else {
     int newCapacity = expandedSize((length + 1), 0);
     UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * newCapacity));
-    memcpy(d, data(), length * sizeof(UChar));
+    rep->copyCharacters(d);
     d[length] = c;
     release();
-    rep = Rep::create(d, length);
+    rep = Rep::create(d, length + 1);
     rep->capacity = newCapacity;
   }
 
@@ -741,6 +1287,12 @@ char *UString::ascii() const
     statBufferSize = neededSize;
   }
   
+  if (rep->isLatin1()) {
+    memcpy(statBuffer, rep->latin1Data(), length);
+    statBuffer[length] = '\0';
+    return statBuffer;
+  }
+
   const UChar *p = data();
   char *q = statBuffer;
   const UChar *limit = p + length;
@@ -766,17 +1318,14 @@ void UString::globalClear()
 UString &UString::operator=(const char *c)
 {
   int l = c ? strlen(c) : 0;
-  UChar *d;
-  if (rep->rc == 1 && l <= rep->capacity && !rep->baseString && rep->offset == 0 && rep->preCapacity == 0) {
-    d = rep->buf;
-    rep->_hash = 0;
+  if (rep->hasOneRef() && !rep->isIdentifier && l <= rep->capacity && rep->latin1 && !rep->baseString && !rep->isRope() && rep->offset == 0 && rep->preCapacity == 0) {
+    rep->len = l;
+    rep->charactersChanged();
   } else {
     release();
-    d = static_cast<UChar *>(malloc(sizeof(UChar) * l));
-    rep = Rep::create(d, l);
+    rep = Rep::createLatin1(static_cast<char *>(malloc(l)), l);
   }
-  for (int i = 0; i < l; i++)
-    d[i].uc = c[i];
+  memcpy(rep->buf8, c, l);
 
   return *this;
 }
@@ -792,6 +1341,9 @@ UString &UString::operator=(const UString &str)
 
 bool UString::is8Bit() const
 {
+  if (rep->isLatin1())
+    return true;
+
   const UChar *u = data();
   const UChar *limit = u + size();
   while (u < limit) {
@@ -807,6 +1359,8 @@ UChar UString::operator[](int pos) const
 {
   if (pos >= size())
     return '\0';
+  if (rep->isLatin1())
+    return static_cast<unsigned char>(rep->latin1Data()[pos]);
   return data()[pos];
 }
 
@@ -816,43 +1370,27 @@ UCharReference UString::operator[](int pos)
   return UCharReference(this, pos);
 }
 
-double UString::toDouble(bool tolerateTrailingJunk, bool tolerateEmptyString) const
+static double parseNumber(const char *c, const char *end, bool tolerateTrailingJunk, bool tolerateEmptyString)
 {
   double d;
 
-  // FIXME: If tolerateTrailingJunk is true, then we want to tolerate non-8-bit junk
-  // after the number, so is8Bit is too strict a check.
-  if (!is8Bit())
-    return NaN;
-
-  const char *c = ascii();
-
   // skip leading white space
-  while (isspace(*c))
+  while (c != end && isspace(*c))
     c++;
 
   // empty string ?
-  if (*c == '\0')
+  if (c == end)
     return tolerateEmptyString ? 0.0 : NaN;
 
   // hex number ?
-  if (*c == '0' && (*(c+1) == 'x' || *(c+1) == 'X')) {
-    c++;
-    d = 0.0;
-    while (*(++c)) {
-      if (*c >= '0' && *c <= '9')
-	d = d * 16.0 + *c - '0';
-      else if ((*c >= 'A' && *c <= 'F') || (*c >= 'a' && *c <= 'f'))
-	d = d * 16.0 + (*c & 0xdf) - 'A' + 10.0;
-      else
-	break;
-    }
+  if (*c == '0' && end - c > 1 && (*(c+1) == 'x' || *(c+1) == 'X')) {
+    d = NumberFormat::parseBinaryRadix(c + 2, end, 16, c);
   } else {
     // regular number ?
-    char *end;
-    d = kjs_strtod(c, &end);
-    if ((d != 0.0 || end != c) && d != HUGE_VAL && d != -HUGE_VAL) {
-      c = end;
+    const char *numberEnd;
+    d = NumberFormat::parseDecimal(c, end, numberEnd);
+    if (numberEnd != c) {
+      c = numberEnd;
     } else {
       // infinity ?
       d = 1.0;
@@ -862,7 +1400,7 @@ double UString::toDouble(bool tolerateTrailingJunk, bool tolerateEmptyString) co
 	d = -1.0;
 	c++;
       }
-      if (strncmp(c, "Infinity", 8) != 0)
+      if (end - c < 8 || strncmp(c, "Infinity", 8) != 0)
 	return NaN;
       d = d * Inf;
       c += 8;
@@ -870,15 +1408,41 @@ double UString::toDouble(bool tolerateTrailingJunk, bool tolerateEmptyString) co
   }
 
   // allow trailing white space
-  while (isspace(*c))
+  while (c != end && isspace(*c))
     c++;
   // don't allow anything after - unless tolerant=true
-  if (!tolerateTrailingJunk && *c != '\0')
+  if (!tolerateTrailingJunk && c != end)
     d = NaN;
 
   return d;
 }
 
+double UString::toDouble(bool tolerateTrailingJunk, bool tolerateEmptyString) const
+{
+  // FIXME: If tolerateTrailingJunk is true, then we want to tolerate non-8-bit junk
+  // after the number, so is8Bit is too strict a check.
+  if (!is8Bit())
+    return NaN;
+
+  // Latin-1 strings are read where they are. Others are copied to 8 bits,
+  // not into the buffer of ascii(), since the parser calls this on threads
+  // of its own.
+  int length = size();
+  if (rep->isLatin1()) {
+    const char *c = rep->latin1Data();
+    return parseNumber(c, c + length, tolerateTrailingJunk, tolerateEmptyString);
+  }
+  char buffer[64];
+  char *c = length <= (int)sizeof(buffer) ? buffer : static_cast<char *>(malloc(length));
+  const UChar *u = data();
+  for (int i = 0; i != length; ++i)
+    c[i] = static_cast<char>(u[i].uc);
+  double d = parseNumber(c, c + length, tolerateTrailingJunk, tolerateEmptyString);
+  if (c != buffer)
+    free(c);
+  return d;
+}
+
 double UString::toDouble(bool tolerateTrailingJunk) const
 {
   return toDouble(tolerateTrailingJunk, true);
@@ -926,17 +1490,10 @@ uint32_t UString::toUInt32(bool *ok) const
   return static_cast<uint32_t>(d);
 }
 
-uint32_t UString::toStrictUInt32(bool *ok) const
+template <class CharType>
+static uint32_t parseStrictUInt32(const CharType *p, int len, bool *ok)
 {
-  if (ok)
-    *ok = false;
-
-  // Empty string is not OK.
-  int len = rep->len;
-  if (len == 0)
-    return 0;
-  const UChar *p = rep->data();
-  unsigned short c = p->unicode();
+  unsigned short c = charCode(*p);
 
   // If the first digit is 0, only 0 itself is OK.
   if (c == '0') {
@@ -972,8 +1529,28 @@ uint32_t UString::toStrictUInt32(bool *ok) const
     }
     
     // Get next character.
-    c = (++p)->unicode();
+    c = charCode(*++p);
+  }
+}
+
+uint32_t UString::toStrictUInt32(bool *ok) const
+{
+  if (ok)
+    *ok = false;
+
+  if (rep->smallInteger >= 0) {
+    if (ok)
+      *ok = true;
+    return rep->smallInteger;
   }
+
+  // Empty string is not OK.
+  int len = rep->len;
+  if (len == 0)
+    return 0;
+  if (rep->isLatin1())
+    return parseStrictUInt32(rep->latin1Data(), len, ok);
+  return parseStrictUInt32(rep->data(), len, ok);
 }
 
 // Rule from ECMA 15.2 about what an array index is.
@@ -986,6 +1563,25 @@ unsigned UString::toArrayIndex(bool *ok) const
   return i;
 }
 
+// The characters of a needle in the width of the string searched for it,
+// for StringSearch, which wants both in the same width. Short needles are
+// copied into the object itself.
+template <class CharType>
+class SearchNeedle {
+public:
+  template <class OtherType> SearchNeedle(const OtherType *f, int length)
+    : chars(length <= inlineLength ? inlineChars : static_cast<CharType *>(malloc(sizeof(CharType) * length)))
+  {
+    copyChars(chars, f, length);
+  }
+  ~SearchNeedle() { if (chars != inlineChars) free(chars); }
+
+  CharType *chars;
+private:
+  enum { inlineLength = 64 };
+  CharType inlineChars[inlineLength];
+};
+
 int UString::find(const UString &f, int pos) const
 {
   int sz = size();
@@ -996,26 +1592,29 @@ int UString::find(const UString &f, int pos) const
     pos = 0;
   if (fsz == 0)
     return pos;
-  const UChar *end = data() + sz - fsz;
-  long fsizeminusone = (fsz - 1) * sizeof(UChar);
-  const UChar *fdata = f.data();
-  for (const UChar *c = data() + pos; c <= end; c++)
-    if (*c == *fdata && !memcmp(c + 1, fdata + 1, fsizeminusone))
-      return (c-data());
-
-  return -1;
+  if (rep->isLatin1()) {
+    if (f.rep->isLatin1())
+      return StringSearch::find(rep->latin1Data(), sz, f.rep->latin1Data(), fsz, pos);
+    // a needle with characters beyond Latin-1 cannot be in here
+    if (!allLatin1(f.rep->data(), fsz))
+      return -1;
+    SearchNeedle<char> needle(f.rep->data(), fsz);
+    return StringSearch::find(rep->latin1Data(), sz, needle.chars, fsz, pos);
+  }
+  if (f.rep->isLatin1()) {
+    SearchNeedle<UChar> needle(f.rep->latin1Data(), fsz);
+    return StringSearch::find(rep->data(), sz, needle.chars, fsz, pos);
+  }
+  return StringSearch::find(rep->data(), sz, f.rep->data(), fsz, pos);
 }
 
 int UString::find(UChar ch, int pos) const
 {
   if (pos < 0)
     pos = 0;
-  const UChar *end = data() + size();
-  for (const UChar *c = data() + pos; c < end; c++)
-    if (*c == ch)
-      return (c-data());
-
-  return -1;
+  if (rep->isLatin1())
+    return StringSearch::findChar(rep->latin1Data(), size(), ch.uc, pos);
+  return StringSearch::findChar(data(), size(), ch.uc, pos);
 }
 
 int UString::rfind(const UString &f, int pos) const
@@ -1030,14 +1629,19 @@ int UString::rfind(const UString &f, int pos) const
     pos = sz - fsz;
   if (fsz == 0)
     return pos;
-  long fsizeminusone = (fsz - 1) * sizeof(UChar);
-  const UChar *fdata = f.data();
-  for (const UChar *c = data() + pos; c >= data(); c--) {
-    if (*c == *fdata && !memcmp(c + 1, fdata + 1, fsizeminusone))
-      return (c-data());
+  if (rep->isLatin1()) {
+    if (f.rep->isLatin1())
+      return StringSearch::rfind(rep->latin1Data(), f.rep->latin1Data(), fsz, pos);
+    if (!allLatin1(f.rep->data(), fsz))
+      return -1;
+    SearchNeedle<char> needle(f.rep->data(), fsz);
+    return StringSearch::rfind(rep->latin1Data(), needle.chars, fsz, pos);
   }
-
-  return -1;
+  if (f.rep->isLatin1()) {
+    SearchNeedle<UChar> needle(f.rep->latin1Data(), fsz);
+    return StringSearch::rfind(rep->data(), needle.chars, fsz, pos);
+  }
+  return StringSearch::rfind(rep->data(), f.rep->data(), fsz, pos);
 }
 
 int UString::rfind(UChar ch, int pos) const
@@ -1046,12 +1650,9 @@ int UString::rfind(UChar ch, int pos) const
     return -1;
   if (pos + 1 >= size())
     pos = size() - 1;
-  for (const UChar *c = data() + pos; c >= data(); c--) {
-    if (*c == ch)
-      return (c-data());
-  }
-
-  return -1;
+  if (rep->isLatin1())
+    return StringSearch::rfindChar(rep->latin1Data(), ch.uc, pos);
+  return StringSearch::rfindChar(data(), ch.uc, pos);
 }
 
 UString UString::substr(int pos, int len) const
@@ -1072,6 +1673,68 @@ UString UString::substr(int pos, int len) const
   return result;
 }
 
+static inline void setChar(UChar &d, UChar c)
+{
+  d = c;
+}
+
+static inline void setChar(char &d, UChar c)
+{
+  d = static_cast<char>(c.uc);
+}
+
+// Copies s with the case of its letters changed from start on. ASCII is
+// converted a vector at a time, the rest by UChar, which maps Latin-1 to
+// Latin-1.
+template <class CharType>
+static CharType *convertCase(const CharType *s, int length, int start, StringOps::Case toCase)
+{
+  CharType *d = static_cast<CharType *>(malloc(sizeof(CharType) * length));
+  copyChars(d, s, start);
+  for (int i = start; i < length; i++) {
+    i += StringOps::convertCase(s + i, d + i, length - i, toCase);
+    if (i < length) {
+      UChar c(charCode(s[i]));
+      setChar(d[i], toCase == StringOps::LowerCase ? c.toLower() : c.toUpper());
+    }
+  }
+  return d;
+}
+
+UString UString::convertCase(bool upper) const
+{
+  StringOps::Case toCase = upper ? StringOps::UpperCase : StringOps::LowerCase;
+  int length = size();
+  if (rep->isLatin1()) {
+    const char *s = rep->latin1Data();
+    int start = StringOps::caseRunLength(s, length, toCase);
+    if (start == length)
+      return *this;
+    Rep *r = Rep::createLatin1(KJS::convertCase(s, length, start, toCase), length);
+    UString result(r);
+    r->deref();
+    return result;
+  }
+  const UChar *s = data();
+  int start = StringOps::caseRunLength(s, length, toCase);
+  if (start == length)
+    return *this;
+  Rep *r = Rep::create(KJS::convertCase(s, length, start, toCase), length);
+  UString result(r);
+  r->deref();
+  return result;
+}
+
+UString UString::toLower() const
+{
+  return convertCase(false);
+}
+
+UString UString::toUpper() const
+{
+  return convertCase(true);
+}
+
 void UString::attach(Rep *r)
 {
   rep = r;
@@ -1080,10 +1743,10 @@ void UString::attach(Rep *r)
 
 void UString::detach()
 {
-  if (rep->rc > 1 || rep->baseString) {
+  if (!rep->hasOneRef() || rep->isIdentifier || (rep->baseString && !rep->isRope())) {
     int l = size();
     UChar *n = static_cast<UChar *>(malloc(sizeof(UChar) * l));
-    memcpy(n, data(), l * sizeof(UChar));
+    rep->copyCharacters(n);
     release();
     rep = Rep::create(n, l);
   }
@@ -1096,11 +1759,32 @@ void UString::release()
 
 bool KJS::operator==(const UString& s1, const UString& s2)
 {
-  if (s1.rep->len != s2.rep->len)
+  const UString::Rep *r1 = s1.rep;
+  const UString::Rep *r2 = s2.rep;
+  int length = r1->len;
+  if (length != r2->len)
     return false;
+  if (r1 == r2)
+    return true;
 
-  return (memcmp(s1.rep->data(), s2.rep->data(),
-		 s1.rep->len * sizeof(UChar)) == 0);
+  if (r1->isLatin1()) {
+    if (r2->isLatin1())
+      return equalChars(r1->latin1Data(), r2->latin1Data(), length);
+    return StringOps::mismatch(r1->latin1Data(), r2->data(), length) == length;
+  }
+  if (r2->isLatin1())
+    return StringOps::mismatch(r2->latin1Data(), r1->data(), length) == length;
+  return equalChars(r1->data(), r2->data(), length);
+}
+
+template <class CharType>
+static bool equalsCString(const CharType *u, int length, const char *s)
+{
+  for (int i = 0; i < length; i++) {
+    if (!s[i] || charCode(u[i]) != static_cast<unsigned char>(s[i]))
+      return false;
+  }
+  return s[length] == 0;
 }
 
 bool KJS::operator==(const UString& s1, const char *s2)
@@ -1109,16 +1793,33 @@ bool KJS::operator==(const UString& s1, const char *s2)
     return s1.isEmpty();
   }
 
-  const UChar *u = s1.data();
-  const UChar *uend = u + s1.size();
-  while (u != uend && *s2) {
-    if (u->uc != (unsigned char)*s2)
-      return false;
-    s2++;
-    u++;
+  if (const char *c = s1.latin1Data())
+    return equalsCString(c, s1.size(), s2);
+  return equalsCString(s1.data(), s1.size(), s2);
+}
+
+// How many characters at the start of both strings are the same, up to
+// length. If that is less than length, d1 and d2 are set to the first
+// characters that differ.
+static int commonPrefixLength(const UString &s1, const UString &s2, int length,
+                              unsigned short &d1, unsigned short &d2)
+{
+  const char *c1 = s1.latin1Data();
+  const char *c2 = s2.latin1Data();
+  int l;
+  if (c1 && c2)
+    l = StringOps::mismatch(c1, c2, length);
+  else if (c1)
+    l = StringOps::mismatch(c1, s2.data(), length);
+  else if (c2)
+    l = StringOps::mismatch(c2, s1.data(), length);
+  else
+    l = StringOps::mismatch(s1.data(), s2.data(), length);
+  if (l < length) {
+    d1 = c1 ? static_cast<unsigned char>(c1[l]) : s1.data()[l].uc;
+    d2 = c2 ? static_cast<unsigned char>(c2[l]) : s2.data()[l].uc;
   }
-
-  return u == uend && *s2 == 0;
+  return l;
 }
 
 bool KJS::operator<(const UString& s1, const UString& s2)
@@ -1126,16 +1827,10 @@ bool KJS::operator<(const UString& s1, const UString& s2)
   const int l1 = s1.size();
   const int l2 = s2.size();
   const int lmin = l1 < l2 ? l1 : l2;
-  const UChar *c1 = s1.data();
-  const UChar *c2 = s2.data();
-  int l = 0;
-  while (l < lmin && *c1 == *c2) {
-    c1++;
-    c2++;
-    l++;
-  }
+  unsigned short c1, c2;
+  int l = commonPrefixLength(s1, s2, lmin, c1, c2);
   if (l < lmin)
-    return (c1->uc < c2->uc);
+    return (c1 < c2);
 
   return (l1 < l2);
 }
@@ -1145,16 +1840,10 @@ int KJS::compare(const UString& s1, const UString& s2)
   const int l1 = s1.size();
   const int l2 = s2.size();
   const int lmin = l1 < l2 ? l1 : l2;
-  const UChar *c1 = s1.data();
-  const UChar *c2 = s2.data();
-  int l = 0;
-  while (l < lmin && *c1 == *c2) {
-    c1++;
-    c2++;
-    l++;
-  }
+  unsigned short c1, c2;
+  int l = commonPrefixLength(s1, s2, lmin, c1, c2);
   if (l < lmin)
-    return (c1->uc > c2->uc) ? 1 : -1;
+    return (c1 > c2) ? 1 : -1;
 
   if (l1 == l2) {
     return 0;
@@ -1162,6 +1851,139 @@ int KJS::compare(const UString& s1, const UString& s2)
   return (l1 < l2) ? 1 : -1;
 }
 
+StringBuilder::StringBuilder(int c)
+  : buf8(0), len(0), capacity(0), latin1(true)
+{
+  reserve(c);
+}
+
+StringBuilder::~StringBuilder()
+{
+  free(buf8);
+}
+
+void StringBuilder::reserve(int c)
+{
+  if (c <= capacity)
+    return;
+  int charSize = latin1 ? 1 : sizeof(UChar);
+  buf8 = static_cast<char *>(realloc(buf8, c * charSize));
+  capacity = c;
+}
+
+inline void StringBuilder::expandCapacity(int requiredLength)
+{
+  if (requiredLength > capacity)
+    reserve(requiredLength < 2 * capacity ? 2 * capacity : (requiredLength < 16 ? 16 : requiredLength));
+}
+
+void StringBuilder::widen()
+{
+  assert(latin1);
+  UChar *d = static_cast<UChar *>(malloc(sizeof(UChar) * (capacity ? capacity : 1)));
+  copyChars(d, buf8, len);
+  free(buf8);
+  buf = d;
+  latin1 = false;
+}
+
+void StringBuilder::append(const UString &s)
+{
+  UString::Rep *r = s.rep;
+  if (latin1 && !r->fitsLatin1())
+    widen();
+  expandCapacity(len + r->len);
+  // a rope is copied piece by piece rather than flattened
+  if (latin1)
+    r->copyCharacters(buf8 + len);
+  else
+    r->copyCharacters(buf + len);
+  len += r->len;
+}
+
+void StringBuilder::append(const UString &s, int pos, int length)
+{
+  int size = s.size();
+  if (pos < 0)
+    pos = 0;
+  else if (pos > size)
+    pos = size;
+  if (length < 0 || length > size - pos)
+    length = size - pos;
+  if (length == 0)
+    return;
+
+  if (s.rep->isLatin1()) {
+    const char *d = s.rep->latin1Data() + pos;
+    expandCapacity(len + length);
+    if (latin1)
+      copyChars(buf8 + len, d, length);
+    else
+      copyChars(buf + len, d, length);
+    len += length;
+  } else
+    append(s.rep->data() + pos, length);
+}
+
+void StringBuilder::append(const char *s)
+{
+  append(s, strlen(s));
+}
+
+void StringBuilder::append(const char *s, int length)
+{
+  expandCapacity(len + length);
+  if (latin1)
+    copyChars(buf8 + len, s, length);
+  else
+    copyChars(buf + len, s, length);
+  len += length;
+}
+
+void StringBuilder::append(const UChar *s, int length)
+{
+  if (latin1 && !allLatin1(s, length))
+    widen();
+  expandCapacity(len + length);
+  if (latin1)
+    copyChars(buf8 + len, s, length);
+  else
+    copyChars(buf + len, s, length);
+  len += length;
+}
+
+void StringBuilder::append(unsigned short c)
+{
+  if (latin1 && c > 0xFF)
+    widen();
+  expandCapacity(len + 1);
+  if (latin1)
+    buf8[len] = static_cast<char>(c);
+  else
+    buf[len].uc = c;
+  ++len;
+}
+
+UString StringBuilder::release()
+{
+  if (len == 0)
+    return UString("");
+
+  // give back what was reserved but not used
+  int charSize = latin1 ? 1 : sizeof(UChar);
+  if (capacity > len)
+    buf8 = static_cast<char *>(realloc(buf8, len * charSize));
+  UString::Rep *r = latin1 ? UString::Rep::createLatin1(buf8, len) : UString::Rep::create(buf, len);
+  UString result(r);
+  r->deref();
+
+  buf8 = 0;
+  len = 0;
+  capacity = 0;
+  latin1 = true;
+  return result;
+}
+
 inline int inlineUTF8SequenceLengthNonASCII(char b0)
 {
   if ((b0 & 0xC0) != 0xC0)
@@ -1260,6 +2082,33 @@ int decodeUTF8Sequence(const char *sequence)
   return -1;
 }
 
+int decodeUTF8Sequence(const char *sequence, int length, int &sequenceLength)
+{
+  sequenceLength = 1;
+  const unsigned char b0 = sequence[0];
+  const int l = inlineUTF8SequenceLength(b0);
+  if (l == 0 || l > length)
+    return -1;
+  if (l == 1)
+    return b0;
+
+  int c = b0 & (0xFF >> (l + 1));
+  for (int i = 1; i < l; i++) {
+    const unsigned char b = sequence[i];
+    if ((b & 0xC0) != 0x80)
+      return -1;
+    c = (c << 6) | (b & 0x3F);
+  }
+
+  // no overlong forms, UTF-16 surrogates or characters past U+10FFFF
+  static const int smallest[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+  if (c < smallest[l] || (c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF)
+    return -1;
+
+  sequenceLength = l;
+  return c;
+}
+
 CString UString::UTF8String() const
 {
   // Allocate a buffer big enough to hold all the characters.
@@ -1275,25 +2124,38 @@ CString UString::UTF8String() const
 
   // Convert to runs of 8-bit characters.
   char *p = buffer;
-  const UChar *d = data();
-  for (int i = 0; i != length; ++i) {
-    unsigned short c = d[i].unicode();
-    if (c < 0x80) {
-      *p++ = (char)c;
-    } else if (c < 0x800) {
-      *p++ = (char)((c >> 6) | 0xC0); // C0 is the 2-byte flag for UTF-8
-      *p++ = (char)((c | 0x80) & 0xBF); // next 6 bits, with high bit set
-    } else if (c >= 0xD800 && c <= 0xDBFF && i < length && d[i+1].uc >= 0xDC00 && d[i+2].uc <= 0xDFFF) {
-      unsigned sc = 0x10000 + (((c & 0x3FF) << 10) | (d[i+1].uc & 0x3FF));
-      *p++ = (char)((sc >> 18) | 0xF0); // F0 is the 4-byte flag for UTF-8
-      *p++ = (char)(((sc >> 12) | 0x80) & 0xBF); // next 6 bits, with high bit set
-      *p++ = (char)(((sc >> 6) | 0x80) & 0xBF); // next 6 bits, with high bit set
-      *p++ = (char)((sc | 0x80) & 0xBF); // next 6 bits, with high bit set
-      ++i;
-    } else {
-      *p++ = (char)((c >> 12) | 0xE0); // E0 is the 3-byte flag for UTF-8
-      *p++ = (char)(((c >> 6) | 0x80) & 0xBF); // next 6 bits, with high bit set
-      *p++ = (char)((c | 0x80) & 0xBF); // next 6 bits, with high bit set
+  if (rep->isLatin1()) {
+    const char *d = rep->latin1Data();
+    for (int i = 0; i != length; ++i) {
+      unsigned char c = d[i];
+      if (c < 0x80) {
+        *p++ = (char)c;
+      } else {
+        *p++ = (char)((c >> 6) | 0xC0);
+        *p++ = (char)((c | 0x80) & 0xBF);
+      }
+    }
+  } else {
+    const UChar *d = data();
+    for (int i = 0; i != length; ++i) {
+      unsigned short c = d[i].unicode();
+      if (c < 0x80) {
+        *p++ = (char)c;
+      } else if (c < 0x800) {
+        *p++ = (char)((c >> 6) | 0xC0); // C0 is the 2-byte flag for UTF-8
+        *p++ = (char)((c | 0x80) & 0xBF); // next 6 bits, with high bit set
+      } else if (c >= 0xD800 && c <= 0xDBFF && i < length && d[i+1].uc >= 0xDC00 && d[i+2].uc <= 0xDFFF) {
+        unsigned sc = 0x10000 + (((c & 0x3FF) << 10) | (d[i+1].uc & 0x3FF));
+        *p++ = (char)((sc >> 18) | 0xF0); // F0 is the 4-byte flag for UTF-8
+        *p++ = (char)(((sc >> 12) | 0x80) & 0xBF); // next 6 bits, with high bit set
+        *p++ = (char)(((sc >> 6) | 0x80) & 0xBF); // next 6 bits, with high bit set
+        *p++ = (char)((sc | 0x80) & 0xBF); // next 6 bits, with high bit set
+        ++i;
+      } else {
+        *p++ = (char)((c >> 12) | 0xE0); // E0 is the 3-byte flag for UTF-8
+        *p++ = (char)(((c >> 6) | 0x80) & 0xBF); // next 6 bits, with high bit set
+        *p++ = (char)((c | 0x80) & 0xBF); // next 6 bits, with high bit set
+      }
     }
   }
 
@@ -1305,6 +2167,25 @@ CString UString::UTF8String() const
   return result;
 }
 
+const char *UString::cachedUTF8Data(int &length) const
+{
+  if (!rep->hasUTF8) {
+    CString converted = UTF8String();
+    char *data = static_cast<char *>(malloc(converted.size() + 1));
+    memcpy(data, converted.c_str(), converted.size() + 1);
+    pthread_mutex_lock(&utf8TableLock);
+    addUTF8(rep, data, converted.size());
+    pthread_mutex_unlock(&utf8TableLock);
+    rep->hasUTF8 = true;
+  }
+  pthread_mutex_lock(&utf8TableLock);
+  UTF8Entry *entry = findUTF8(rep);
+  const char *data = entry->data;
+  length = entry->length;
+  pthread_mutex_unlock(&utf8TableLock);
+  return data;
+}
+
 struct StringOffset {
     int offset;
     int locationInOffsetsArray;
@@ -164,12 +164,18 @@ namespace KJS {
 
   inline UChar::UChar(const UCharReference &c) : uc(c.unicode()) { }
 
+  /**
+   * The 8-bit encodings text can be given in besides UTF-16, see
+   * @ref Interpreter::evaluate().
+   */
+  enum TextEncoding { Latin1Encoding, UTF8Encoding };
+
   /**
    * @short 8 bit char based string class
    */
   class CString {
   public:
-    CString() : data(0), length(0) { }
+    CString() : data(0), length(0), capacity(0) { }
     CString(const char *c);
     CString(const char *c, int len);
     CString(const CString &);
@@ -186,6 +192,9 @@ namespace KJS {
   private:
     char *data;
     int length;
+    // room for this many characters before the terminating null, so that
+    // repeated appends do not copy the whole string each time
+    int capacity;
   };
 
   /**
@@ -197,6 +206,7 @@ namespace KJS {
     friend class Identifier;
     friend class PropertyMap;
     friend class PropertyMapHashTableEntry;
+    friend class StringBuilder;
 
     /**
      * @internal
@@ -206,18 +216,43 @@ namespace KJS {
       friend bool operator==(const UString&, const UString&);
       
       static Rep *create(UChar *d, int l);
+      static Rep *createLatin1(char *d, int l);
       static Rep *create(Rep *base, int offset, int length);
+      static Rep *createRope(Rep *left, Rep *right);
       void destroy();
       
-      UChar *data() const { return baseString ? (baseString->buf + baseString->preCapacity + offset) : (buf + preCapacity + offset); }
+      // widens the buffer if it holds 8-bit characters
+      UChar *data() const { if (isRope()) flatten(); if (isLatin1()) widen(); return baseString ? (baseString->buf + baseString->preCapacity + offset) : (buf + preCapacity + offset); }
+      // only for strings with isLatin1()
+      char *latin1Data() const { if (isRope()) flatten(); return baseString ? (baseString->buf8 + baseString->preCapacity + offset) : (buf8 + preCapacity + offset); }
+      bool isLatin1() const { return baseString && !isRope() ? baseString->latin1 : latin1; }
       int size() const { return len; }
       
-      unsigned hash() const { if (_hash == 0) _hash = computeHash(data(), len); return _hash; }
+      unsigned hash() const { if (_hash == 0) _hash = isLatin1() ? computeHash(latin1Data(), len) : computeHash(data(), len); return _hash; }
       static unsigned computeHash(const UChar *, int length);
+      static unsigned computeHash(const char *, int length);
       static unsigned computeHash(const char *);
 
-      void ref() { ++rc; }
-      void deref() { if (--rc == 0) destroy(); }
+      // strings are shared between threads through the identifier table,
+      // so the count is changed atomically
+      void ref() { __atomic_fetch_add(&rc, 1, __ATOMIC_RELAXED); }
+      void deref() { if (__atomic_sub_fetch(&rc, 1, __ATOMIC_ACQ_REL) == 0) destroy(); }
+      // whether the caller holds the only reference, so that no other
+      // thread can be using the string
+      bool hasOneRef() const { return __atomic_load_n(&rc, __ATOMIC_ACQUIRE) == 1; }
+      // forgets what was worked out from the characters, after they changed
+      void charactersChanged();
+
+      bool isRope() const { return ropeDepth != 0; }
+      // copies the characters of a rope into a buffer of its own
+      void flatten() const;
+      // converts an 8-bit buffer to UTF-16, for all the strings sharing it
+      void widen() const;
+      void widenBuffer();
+      // copies len characters, as char only if they are all Latin-1
+      template <class CharType> void copyCharacters(CharType *d) const;
+      // whether all the characters are Latin-1, without flattening a rope
+      bool fitsLatin1() const;
 
       // unshared data
       int offset;
@@ -225,10 +260,32 @@ namespace KJS {
       int rc;
       mutable unsigned _hash;
       bool isIdentifier;
-      UString::Rep *baseString;
+      // whether the buffer holds one byte per character; strings sharing
+      // the buffer of baseString go by its flag
+      bool latin1;
+      // whether cachedUTF8Data() has kept the characters in UTF-8, which
+      // it does aside from the string
+      mutable bool hasUTF8;
+      // for a rope, how many levels of ropes there are below it, plus one;
+      // 0 for any other string
+      unsigned char ropeDepth;
+      // the value, for the strings of small integers UString::from() keeps;
+      // -1 for any other string, which toArrayIndex() has to parse
+      int smallInteger;
+      // A rope is a concatenation whose characters have not been copied
+      // yet, of ropeLeft and ropeRight. It has no buffer, so those take the
+      // place of baseString and buf.
+      union {
+        UString::Rep *baseString;
+        UString::Rep *ropeRight;
+      };
 
       // potentially shared data
-      UChar *buf;
+      union {
+        UChar *buf;
+        char *buf8;
+        UString::Rep *ropeLeft;
+      };
       int usedCapacity;
       int capacity;
       int usedPreCapacity;
@@ -256,6 +313,11 @@ namespace KJS {
      * length.
      */
     UString(const UChar *c, int length);
+    /**
+     * Constructs a string from Latin-1 or UTF-8 text of the specified length
+     * in bytes. Every byte of an invalid UTF-8 sequence becomes U+FFFD.
+     */
+    UString(const char *c, int length, TextEncoding encoding);
     /**
      * If copy is false the string data will be adopted.
      * That means that the data will NOT be copied and the pointer will
@@ -336,6 +398,15 @@ namespace KJS {
      * be otherwise valid.
      */
     CString UTF8String() const;
+    /**
+     * The string in UTF-8 like @ref UTF8String(), but converted only once
+     * and then kept with the string, until it is changed or destroyed.
+     * For strings that are converted over and over, like the subject of a
+     * global regular expression match. length is set to the number of
+     * bytes; if that is @ref size() all the characters are ASCII, and
+     * offsets are the same in both forms.
+     */
+    const char *cachedUTF8Data(int &length) const;
 
     /**
      * @see UString(const QString&).
@@ -362,9 +433,18 @@ namespace KJS {
     UString &operator+=(const char *s) { return append(s); }
 
     /**
-     * @return A pointer to the internal Unicode data.
+     * @return A pointer to the internal Unicode data. A string held in 8
+     * bits is converted to 16 bits for good, along with the strings
+     * sharing its buffer.
      */
     const UChar* data() const { return rep->data(); }
+    /**
+     * @return The characters as Latin-1 if the string holds them in 8 bits,
+     * 0 otherwise. Strings are kept in 8 bits until a character that does
+     * not fit is added or @ref data() is called. The pointer is only good
+     * until then.
+     */
+    const char *latin1Data() const { return rep->isLatin1() && rep->len ? rep->latin1Data() : 0; }
     /**
      * @return True if null.
      */
@@ -441,6 +521,16 @@ namespace KJS {
      * @return The sub string starting at position pos and length len.
      */
     UString substr(int pos = 0, int len = -1) const;
+    /**
+     * @return The string with its letters in lower case. Letters beyond
+     * ASCII are converted by @ref UChar::toLower(). The string itself is
+     * returned if there is nothing to convert.
+     */
+    UString toLower() const;
+    /**
+     * @return The string with its letters in upper case, like @ref toLower().
+     */
+    UString toUpper() const;
     /**
      * Static instance of a null string.
      */
@@ -453,7 +543,11 @@ namespace KJS {
 #endif
   private:
     UString(Rep *r) { attach(r); }
+    // takes over a reference the caller holds
+    enum AdoptTag { Adopt };
+    UString(Rep *r, AdoptTag) : rep(r) { }
     void attach(Rep *r);
+    static Rep *smallIntegerRep(unsigned u);
     void detach();
     void release();
     int expandedSize(int size, int otherSize) const;
@@ -461,6 +555,7 @@ namespace KJS {
     int usedPreCapacity() const;
     void expandCapacity(int requiredLength);
     void expandPreCapacity(int requiredPreCap);
+    UString convertCase(bool upper) const;
 
     Rep *rep;
   };
@@ -490,6 +585,70 @@ namespace KJS {
   
   int compare(const UString &, const UString &);
 
+  /**
+   * @short Builds a string out of many pieces.
+   *
+   * Appending to a @ref UString again and again copies its characters
+   * each time the buffer is shared or full, or builds up a rope. A builder
+   * fills a single buffer that grows geometrically instead, and hands it
+   * over to the string returned by @ref release() without copying it.
+   *
+   * Like a UString the buffer holds one byte per character until a
+   * character that does not fit in Latin-1 is appended. Call
+   * @ref reserve() with the final length when it can be estimated.
+   */
+  class StringBuilder {
+  public:
+    StringBuilder() : buf8(0), len(0), capacity(0), latin1(true) { }
+    explicit StringBuilder(int capacity);
+    ~StringBuilder();
+
+    /**
+     * Makes room for capacity characters in all.
+     */
+    void reserve(int capacity);
+
+    void append(const UString &s);
+    /**
+     * Appends length characters of s starting at pos, without making a
+     * substring.
+     */
+    void append(const UString &s, int pos, int length);
+    void append(const char *s);
+    /**
+     * Appends length bytes of Latin-1 text.
+     */
+    void append(const char *s, int length);
+    void append(const UChar *s, int length);
+    void append(unsigned short c);
+    void append(char c) { append(static_cast<unsigned short>(static_cast<unsigned char>(c))); }
+    void append(UChar c) { append(c.uc); }
+
+    int size() const { return len; }
+    bool isEmpty() const { return len == 0; }
+
+    /**
+     * @return The string built so far. The builder is left empty.
+     */
+    UString release();
+
+  private:
+    void expandCapacity(int requiredLength);
+    void widen();
+
+    union {
+      UChar *buf;
+      char *buf8;
+    };
+    int len;
+    int capacity;
+    bool latin1;
+
+    // not implemented
+    StringBuilder(const StringBuilder &);
+    StringBuilder &operator=(const StringBuilder &);
+  };
+
   // Given a first byte, gives the length of the UTF-8 sequence it begins.
   // Returns 0 for bytes that are not legal starts of UTF-8 sequences.
   // Only allows sequences of up to 4 bytes, since that works for all Unicode characters (U-00000000 to U-0010FFFF).
@@ -500,6 +659,11 @@ namespace KJS {
   // Returns -1 if the sequence is not valid (including presence of extra bytes).
   int decodeUTF8Sequence(const char *);
 
+  // Decodes the UTF-8 sequence at the start of a buffer holding length bytes, which need not be null-terminated,
+  // and stores the number of bytes it takes in sequenceLength.
+  // Returns -1, with a sequenceLength of 1, if the sequence is not valid.
+  int decodeUTF8Sequence(const char *, int length, int &sequenceLength);
+
   // Given a UTF-8 string, converts offsets from the UTF-16 form of the string into offsets into the UTF-8 string.
   // Note: This function can overrun the buffer if the string contains a partial UTF-8 sequence, so it should
   // not be called with strings that might contain such sequences.
@@ -0,0 +1,185 @@
+/*
+* The contents of this file are subject to the Netscape Public
+* License Version 1.1 (the "License"); you may not use this file
+* except in compliance with the License. You may obtain a copy of
+* the License at http://www.mozilla.org/NPL/
+*
+* Software distributed under the License is distributed on an "AS IS"
+* basis, WITHOUT WARRANTY OF ANY KIND, either expressed
+* or implied. See the License for the specific language governing
+* rights and limitations under the License.
+*
+* The Original Code is mozilla.org code.
+*
+* The Initial Developer of the Original Code is Netscape
+* Communications Corporation.  Portions created by Netscape are
+* Copyright (C) 1998 Netscape Communications Corporation. All
+* Rights Reserved.
+*
+* Contributor(s):
+* Date: 18 October 2026
+*
+* SUMMARY: Strings and literals turned into numbers
+*
+* ToNumber applied to a string (ECMA3 Section 9.3.1), parseFloat() (ECMA3
+* Section 15.1.2.3) and numeric literals (ECMA3 Section 7.8.3) must give
+* the number closest to the decimal or hexadecimal value, rounding ties to
+* even, however many digits there are.
+*/
+//-----------------------------------------------------------------------------
+var UBound = 0;
+var bug = '(none)';
+var summary = 'Strings and literals turned into numbers';
+var status = '';
+var statusitems = [];
+var actual = '';
+var actualvalues = [];
+var expect= '';
+var expectedvalues = [];
+
+
+status = inSection(1);
+actual = Number('42') + ',' + Number('  42  ') + ',' + Number('\n\t-42\n') + ',' + Number('+42');
+expect = '42,42,-42,42';
+addThis();
+
+status = inSection(2);
+actual = Number('') + ',' + Number('  ') + ',' + Number('\n');
+expect = '0,0,0';
+addThis();
+
+status = inSection(3);
+actual = Number('0.1') == 0.1 && Number('.1') == 0.1 && Number('1.') == 1 && Number('1e3') == 1000 && Number('1E+3') == 1000;
+expect = true;
+addThis();
+
+status = inSection(4);
+actual = String(Number('.')) + ',' + Number('e5') + ',' + Number('5e') + ',' + Number('1e+') + ',' + Number('--1') + ',' + Number('1 2');
+expect = 'NaN,NaN,NaN,NaN,NaN,NaN';
+addThis();
+
+status = inSection(5);
+actual = Number('017') + ',' + Number('0017.5') + ',' + Number('1_000') + ',' + Number('1,000');
+expect = '17,17.5,NaN,NaN';
+addThis();
+
+status = inSection(6);
+actual = Number('0x1F') + ',' + Number('0X1f') + ',' + Number('0x1g') + ',' + Number('-0x10');
+expect = '31,31,NaN,NaN';
+addThis();
+
+status = inSection(7);
+actual = Number('0x100000000') + ',' + Number('0xFFFFFFFFFFFFFFFF') + ',' + Number('0x20000000000001');
+expect = '4294967296,18446744073709552000,9007199254740992';
+addThis();
+
+status = inSection(8);
+actual = Number('Infinity') + ',' + Number('-Infinity') + ',' + Number('+Infinity') + ',' + Number('infinity') + ',' + Number('Infinityx');
+expect = 'Infinity,-Infinity,Infinity,NaN,NaN';
+addThis();
+
+status = inSection(9);
+actual = Number('1e999') + ',' + Number('-1e999') + ',' + Number('1e-999') + ',' + (1/Number('-1e-999'));
+expect = 'Infinity,-Infinity,0,-Infinity';
+addThis();
+
+status = inSection(10);
+actual = (1/Number('-0')) + ',' + (1/Number('-0.0e5')) + ',' + (1/Number('0'));
+expect = '-Infinity,-Infinity,Infinity';
+addThis();
+
+status = inSection(11);
+actual = Number('9007199254740993') + ',' + Number('9007199254740995') + ',' + Number('12345678901234567890');
+expect = '9007199254740992,9007199254740996,12345678901234567000';
+addThis();
+
+status = inSection(12);
+actual = Number('1.7976931348623157e308') + ',' + Number('1.7976931348623158e308') + ',' + Number('1.7976931348623159e308');
+expect = '1.7976931348623157e+308,1.7976931348623157e+308,Infinity';
+addThis();
+
+status = inSection(13);
+actual = Number('4.9e-324') + ',' + Number('2.4703282292062328e-324') + ',' + Number('2.4703282292062327e-324');
+expect = '5e-324,5e-324,0';
+addThis();
+
+status = inSection(14);
+actual = Number('2.2250738585072011e-308') + ',' + Number('2.2250738585072012e-308');
+expect = '2.225073858507201e-308,2.2250738585072014e-308';
+addThis();
+
+status = inSection(15);
+actual = Number('0.1000000000000000055511151231257827') == 0.1 && Number('0.1000000000000000055511151231257828') == 0.1;
+expect = true;
+addThis();
+
+status = inSection(16);
+actual = Number('9007199254740992.5') + ',' + Number('9007199254740993.0000000000000000001') + ',' + Number('00000000000000000000001');
+expect = '9007199254740992,9007199254740994,1';
+addThis();
+
+status = inSection(17);
+actual = Number('3.' + '0000000000000000000000000000000000000001') + ',' + Number('1' + '000000000000000000000000000000');
+expect = '3,1e+30';
+addThis();
+
+status = inSection(18);
+actual = 0x100000000 + ',' + 0xFFFFFFFFFFFFFFFFF + ',' + 0x20000000000001 + ',' + 0x20000000000003;
+expect = '4294967296,295147905179352830000,9007199254740992,9007199254740996';
+addThis();
+
+status = inSection(19);
+actual = 1e999 + ',' + 1e-999 + ',' + 9007199254740993 + ',' + .5e1 + ',' + 1.e1;
+expect = 'Infinity,0,9007199254740992,5,10';
+addThis();
+
+status = inSection(20);
+actual = parseFloat('3.14abc') + ',' + parseFloat('  -.5e1x') + ',' + parseFloat('1e') + ',' + parseFloat('1e+x') + ',' + parseFloat('12.5.6');
+expect = '3.14,-5,1,1,12.5';
+addThis();
+
+status = inSection(21);
+actual = parseFloat('Infinityx') + ',' + parseFloat('-Infinity') + ',' + parseFloat('.') + ',' + parseFloat('e5');
+expect = 'Infinity,-Infinity,NaN,NaN';
+addThis();
+
+status = inSection(22);
+actual = (1/parseFloat('-0')) + ',' + parseFloat('1e999') + ',' + parseFloat('1e-999') + ',' + parseFloat('9007199254740993');
+expect = '-Infinity,Infinity,0,9007199254740992';
+addThis();
+
+status = inSection(23);
+actual = '42' * 1 + ',' + ('0x10' - 0) + ',' + (+'  1.5  ') + ',' + ('1e3' / 10) + ',' + (+'abc');
+expect = '42,16,1.5,100,NaN';
+addThis();
+
+
+
+//-----------------------------------------------------------------------------
+test();
+//-----------------------------------------------------------------------------
+
+
+
+function addThis()
+{
+  statusitems[UBound] = status;
+  actualvalues[UBound] = actual;
+  expectedvalues[UBound] = expect;
+  UBound++;
+}
+
+
+function test()
+{
+  enterFunc('test');
+  printBugNumber(bug);
+  printStatus(summary);
+
+  for (var i=0; i<UBound; i++)
+  {
+    reportCompare(expectedvalues[i], actualvalues[i], statusitems[i]);
+  }
+
+  exitFunc ('test');
+}
@@ -0,0 +1,175 @@
+/*
+* The contents of this file are subject to the Netscape Public
+* License Version 1.1 (the "License"); you may not use this file
+* except in compliance with the License. You may obtain a copy of
+* the License at http://www.mozilla.org/NPL/
+*
+* Software distributed under the License is distributed on an "AS IS"
+* basis, WITHOUT WARRANTY OF ANY KIND, either expressed
+* or implied. See the License for the specific language governing
+* rights and limitations under the License.
+*
+* The Original Code is mozilla.org code.
+*
+* The Initial Developer of the Original Code is Netscape
+* Communications Corporation.  Portions created by Netscape are
+* Copyright (C) 1998 Netscape Communications Corporation. All
+* Rights Reserved.
+*
+* Contributor(s):
+* Date: 18 October 2026
+*
+* SUMMARY: Numbers turned into strings
+*
+* ToString(Number) gives the fewest digits that read back as the same
+* number, in the decimal or the exponential form (ECMA3 Section 9.8.1).
+* Number.prototype.toString(radix) gives the number in that radix, sign and
+* fraction included (ECMA3 Section 15.7.4.2).
+*/
+//-----------------------------------------------------------------------------
+var UBound = 0;
+var bug = '(none)';
+var summary = 'Numbers turned into strings';
+var status = '';
+var statusitems = [];
+var actual = '';
+var actualvalues = [];
+var expect= '';
+var expectedvalues = [];
+
+
+status = inSection(1);
+actual = String(0) + ',' + String(-0) + ',' + (1/Number(String(-0)));
+expect = '0,0,Infinity';
+addThis();
+
+status = inSection(2);
+actual = String(1) + ',' + String(-1) + ',' + String(100) + ',' + String(123456789);
+expect = '1,-1,100,123456789';
+addThis();
+
+status = inSection(3);
+actual = String(0.1) + ',' + String(0.5) + ',' + String(-4.35) + ',' + String(1/3);
+expect = '0.1,0.5,-4.35,0.3333333333333333';
+addThis();
+
+status = inSection(4);
+actual = String(0.1 + 0.2) + ',' + String(1.1 * 1.1) + ',' + String(100 / 3);
+expect = '0.30000000000000004,1.2100000000000002,33.333333333333336';
+addThis();
+
+status = inSection(5);
+actual = String(1e20) + ',' + String(1e21) + ',' + String(123e19) + ',' + String(-1e21);
+expect = '100000000000000000000,1e+21,1.23e+21,-1e+21';
+addThis();
+
+status = inSection(6);
+actual = String(123456789012345680000) + ',' + String(2e20 + 1);
+expect = '123456789012345680000,200000000000000000000';
+addThis();
+
+status = inSection(7);
+actual = String(9007199254740992) + ',' + String(9007199254740993) + ',' + String(9007199254740995);
+expect = '9007199254740992,9007199254740992,9007199254740996';
+addThis();
+
+status = inSection(8);
+actual = String(0.000001) + ',' + String(0.0000001) + ',' + String(0.00000123) + ',' + String(-1.5e-7);
+expect = '0.000001,1e-7,0.00000123,-1.5e-7';
+addThis();
+
+status = inSection(9);
+actual = String(1.7976931348623157e308) + ',' + String(-1.7976931348623157e308);
+expect = '1.7976931348623157e+308,-1.7976931348623157e+308';
+addThis();
+
+status = inSection(10);
+actual = String(5e-324) + ',' + String(2.2250738585072014e-308) + ',' + String(2.225073858507201e-308);
+expect = '5e-324,2.2250738585072014e-308,2.225073858507201e-308';
+addThis();
+
+status = inSection(11);
+actual = String(1e23) + ',' + String(5e-7) + ',' + String(123.456) + ',' + String(1234.5e-10);
+expect = '1e+23,5e-7,123.456,1.2345e-7';
+addThis();
+
+status = inSection(12);
+actual = String(0/0) + ',' + String(1/0) + ',' + String(-1/0);
+expect = 'NaN,Infinity,-Infinity';
+addThis();
+
+status = inSection(13);
+actual = Math.pow(2, 70) + '' + ',' + Math.pow(2, -20) + '';
+expect = '1.1805916207174113e+21,9.5367431640625e-7';
+addThis();
+
+status = inSection(14);
+actual = (25).toString() + ',' + (25).toString(10) + ',' + (25).toString(undefined);
+expect = '25,25,25';
+addThis();
+
+status = inSection(15);
+actual = (255).toString(16) + ',' + (255).toString(2) + ',' + (-255).toString(16) + ',' + (35).toString(36);
+expect = 'ff,11111111,-ff,z';
+addThis();
+
+status = inSection(16);
+actual = (4294967296).toString(16) + ',' + (4294967297).toString(2) + ',' + (-4294967296).toString(36);
+expect = '100000000,100000000000000000000000000000001,-1z141z4';
+addThis();
+
+status = inSection(17);
+actual = Math.pow(2, 53).toString(2).length + ',' + Math.pow(2, 60).toString(16) + ',' + (1e21).toString(16);
+expect = '54,1000000000000000,3635c9adc5dea00000';
+addThis();
+
+status = inSection(18);
+actual = (0.5).toString(2) + ',' + (255.5).toString(16) + ',' + (-0.25).toString(2) + ',' + (0.75).toString(4);
+expect = '0.1,ff.8,-0.01,0.3';
+addThis();
+
+status = inSection(19);
+actual = (0).toString(2) + ',' + (-0).toString(16) + ',' + (0/0).toString(2) + ',' + (1/0).toString(16) + ',' + (-1/0).toString(36);
+expect = '0,0,NaN,Infinity,-Infinity';
+addThis();
+
+status = inSection(20);
+actual = Number('0.' + (0.1).toString(3).substr(2)) > 0;
+expect = true;
+addThis();
+
+status = inSection(21);
+actual = parseInt((0.1).toString(2).substr(2, 20), 2);
+expect = 104857;
+addThis();
+
+
+
+//-----------------------------------------------------------------------------
+test();
+//-----------------------------------------------------------------------------
+
+
+
+function addThis()
+{
+  statusitems[UBound] = status;
+  actualvalues[UBound] = actual;
+  expectedvalues[UBound] = expect;
+  UBound++;
+}
+
+
+function test()
+{
+  enterFunc('test');
+  printBugNumber(bug);
+  printStatus(summary);
+
+  for (var i=0; i<UBound; i++)
+  {
+    reportCompare(expectedvalues[i], actualvalues[i], statusitems[i]);
+  }
+
+  exitFunc ('test');
+}
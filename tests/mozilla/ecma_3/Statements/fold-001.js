@@ -0,0 +1,366 @@
+/*
+* The contents of this file are subject to the Netscape Public
+* License Version 1.1 (the "License"); you may not use this file
+* except in compliance with the License. You may obtain a copy of
+* the License at http://www.mozilla.org/NPL/
+*
+* Software distributed under the License is distributed on an "AS IS"
+* basis, WITHOUT WARRANTY OF ANY KIND, either expressed
+* or implied. See the License for the specific language governing
+* rights and limitations under the License.
+*
+* The Original Code is mozilla.org code.
+*
+* The Initial Developer of the Original Code is Netscape
+* Communications Corporation.  Portions created by Netscape are
+* Copyright (C) 1998 Netscape Communications Corporation. All
+* Rights Reserved.
+*
+* Contributor(s):
+* Date: 18 October 2026
+*
+* SUMMARY: Constant expressions and branches that are never taken
+*
+* Expressions of literals may be computed once, before the code runs, and
+* an if statement whose condition is a literal may lose the branch that is
+* never taken. Neither may change what the code does: the values must be
+* the ones computed at run time, and variables declared in a dropped
+* branch must still be declared (ECMA3 Section 10.1.3).
+*/
+//-----------------------------------------------------------------------------
+var UBound = 0;
+var bug = '(none)';
+var summary = 'Constant expressions and branches that are never taken';
+var status = '';
+var statusitems = [];
+var actual = '';
+var actualvalues = [];
+var expect= '';
+var expectedvalues = [];
+
+
+status = inSection(1);
+actual = 60*60*1000;
+expect = 3600000;
+addThis();
+
+status = inSection(2);
+actual = 'a' + 'b' + 'c';
+expect = 'abc';
+addThis();
+
+status = inSection(3);
+actual = 'a' + 1 + 2;
+expect = 'a12';
+addThis();
+
+status = inSection(4);
+actual = 1 + 2 + 'a';
+expect = '3a';
+addThis();
+
+status = inSection(5);
+actual = 0.1 + 0.2;
+expect = 0.30000000000000004;
+addThis();
+
+status = inSection(6);
+actual = 1/-0;
+expect = -Infinity;
+addThis();
+
+status = inSection(7);
+actual = 1/(0 * -1);
+expect = -Infinity;
+addThis();
+
+status = inSection(8);
+actual = 1/(-0 + 0);
+expect = Infinity;
+addThis();
+
+status = inSection(9);
+actual = '3' * '4';
+expect = 12;
+addThis();
+
+status = inSection(10);
+actual = '3' - 1;
+expect = 2;
+addThis();
+
+status = inSection(11);
+actual = isNaN(0/0);
+expect = true;
+addThis();
+
+status = inSection(12);
+actual = (0/0 == 0/0);
+expect = false;
+addThis();
+
+status = inSection(13);
+actual = ('10' < '9');
+expect = true;
+addThis();
+
+status = inSection(14);
+actual = (10 < '9');
+expect = false;
+addThis();
+
+status = inSection(15);
+actual = (null == undefined) + ',' + (null === undefined);
+expect = 'true,false';
+addThis();
+
+status = inSection(16);
+actual = 0 || '' || 'x';
+expect = 'x';
+addThis();
+
+status = inSection(17);
+actual = 'a' && 0 && 'b';
+expect = 0;
+addThis();
+
+status = inSection(18);
+actual = typeof (1 + 2);
+expect = 'number';
+addThis();
+
+status = inSection(19);
+actual = -(-2147483648);
+expect = 2147483648;
+addThis();
+
+status = inSection(20);
+actual = (1 << 31) + ',' + (-1 >>> 0) + ',' + (5 >> 1) + ',' + (~0);
+expect = '-2147483648,4294967295,2,-1';
+addThis();
+
+status = inSection(21);
+actual = 7 % -3 + ',' + (-7 % 3) + ',' + (1/(-4 % 2));
+expect = '1,-1,-Infinity';
+addThis();
+
+status = inSection(22);
+actual = !'' + ',' + !'0' + ',' + !0 + ',' + !(0/0);
+expect = 'true,false,true,true';
+addThis();
+
+// a literal gives a value of its own each time it is evaluated
+status = inSection(23);
+actual = (literalObject() === literalObject()) + ',' + (literalArray() === literalArray());
+expect = 'false,false';
+addThis();
+
+status = inSection(24);
+actual = literalString() === literalString();
+expect = true;
+addThis();
+
+status = inSection(25);
+var literal = literalString();
+literal.property = 1;
+actual = typeof literal.property;
+expect = 'undefined';
+addThis();
+
+status = inSection(26);
+var count = 0;
+for (var i = 0; i < 3; i++)
+  count += 2 * 3;
+actual = count;
+expect = 18;
+addThis();
+
+
+// variables declared in a branch that is never taken are local to the
+// function, so assigning to them leaves the global object alone
+status = inSection(27);
+actual = droppedThen();
+expect = 'undefined,1';
+addThis();
+
+status = inSection(28);
+actual = droppedElse();
+expect = 2;
+addThis();
+
+status = inSection(29);
+actual = droppedNested();
+expect = '3,4';
+addThis();
+
+status = inSection(30);
+actual = droppedSingle();
+expect = '5,6';
+addThis();
+
+status = inSection(31);
+actual = droppedSwitch();
+expect = 7;
+addThis();
+
+status = inSection(32);
+actual = typeof dropped1 + typeof dropped2 + typeof dropped3 + typeof dropped4 +
+         typeof dropped5 + typeof dropped6 + typeof dropped7 + typeof dropped8;
+expect = 'undefinedundefinedundefinedundefinedundefinedundefinedundefinedundefined';
+addThis();
+
+if (1 + 1 == 2)
+  takenFunction = function() {};
+else
+  droppedFunction = function() {};
+
+status = inSection(33);
+actual = (typeof takenFunction) + ',' + (typeof droppedFunction);
+expect = 'function,undefined';
+addThis();
+
+status = inSection(34);
+actual = (function() { if (false) return 'taken'; else return 'not taken'; })();
+expect = 'not taken';
+addThis();
+
+status = inSection(35);
+actual = (function() { if (true) return 'taken'; else return 'not taken'; })();
+expect = 'taken';
+addThis();
+
+status = inSection(36);
+actual = (function() { var r = 'before'; if (1 - 1) r = 'taken'; return r; })();
+expect = 'before';
+addThis();
+
+status = inSection(37);
+actual = (function() { if ('') return 'taken'; return 'not taken'; })();
+expect = 'not taken';
+addThis();
+
+status = inSection(38);
+actual = (function() { if ('0') return 'taken'; return 'not taken'; })();
+expect = 'taken';
+addThis();
+
+status = inSection(39);
+actual = (function() { if (0/0) return 'taken'; return 'not taken'; })();
+expect = 'not taken';
+addThis();
+
+
+
+//-----------------------------------------------------------------------------
+test();
+//-----------------------------------------------------------------------------
+
+
+
+function literalObject()
+{
+  return {a: 1};
+}
+
+
+function literalArray()
+{
+  return [1, 2];
+}
+
+
+function literalString()
+{
+  return 'abc';
+}
+
+
+function droppedThen()
+{
+  var before = typeof dropped1;
+  if (false) {
+    var dropped1;
+  }
+  dropped1 = 1;
+  return before + ',' + dropped1;
+}
+
+
+function droppedElse()
+{
+  if (true) {
+  } else {
+    var dropped2 = 0;
+  }
+  dropped2 = 2;
+  return dropped2;
+}
+
+
+function droppedNested()
+{
+  if (0) {
+    for (var dropped3 = 0; dropped3 < 1; dropped3++) {
+      while (false) {
+        var dropped4 = 0;
+      }
+    }
+  }
+  dropped3 = 3;
+  dropped4 = 4;
+  return dropped3 + ',' + dropped4;
+}
+
+
+function droppedSingle()
+{
+  if (null)
+    var dropped5;
+  else
+    var dropped6 = 6;
+  dropped5 = 5;
+  return dropped5 + ',' + dropped6;
+}
+
+
+function droppedSwitch()
+{
+  if ('') {
+    switch (0) {
+    case 0:
+      var dropped7;
+    default:
+      try {
+        var dropped8;
+      } catch (e) {
+      }
+    }
+  }
+  dropped7 = 7;
+  dropped8 = 8;
+  return dropped7;
+}
+
+
+function addThis()
+{
+  statusitems[UBound] = status;
+  actualvalues[UBound] = actual;
+  expectedvalues[UBound] = expect;
+  UBound++;
+}
+
+
+function test()
+{
+  enterFunc('test');
+  printBugNumber(bug);
+  printStatus(summary);
+
+  for (var i=0; i<UBound; i++)
+  {
+    reportCompare(expectedvalues[i], actualvalues[i], statusitems[i]);
+  }
+
+  exitFunc ('test');
+}
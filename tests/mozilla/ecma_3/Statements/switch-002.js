@@ -0,0 +1,463 @@
+/*
+* The contents of this file are subject to the Netscape Public
+* License Version 1.1 (the "License"); you may not use this file
+* except in compliance with the License. You may obtain a copy of
+* the License at http://www.mozilla.org/NPL/
+*
+* Software distributed under the License is distributed on an "AS IS"
+* basis, WITHOUT WARRANTY OF ANY KIND, either expressed
+* or implied. See the License for the specific language governing
+* rights and limitations under the License.
+*
+* The Original Code is mozilla.org code.
+*
+* The Initial Developer of the Original Code is Netscape
+* Communications Corporation.  Portions created by Netscape are
+* Copyright (C) 1998 Netscape Communications Corporation. All
+* Rights Reserved.
+*
+* Contributor(s):
+* Date: 18 October 2026
+*
+* SUMMARY: Switch statements whose labels are all literals
+*
+* A switch whose case labels are literals may be dispatched through a
+* table instead of comparing against each label in turn. It must still
+* take the first label that is strictly equal to the value (ECMA3 Section
+* 12.11), whatever the types, -0 and NaN included, and fall through the
+* clauses after it in the order they are written, default included.
+*/
+//-----------------------------------------------------------------------------
+var UBound = 0;
+var bug = '(none)';
+var summary = 'Switch statements whose labels are all literals';
+var status = '';
+var statusitems = [];
+var actual = '';
+var actualvalues = [];
+var expect= '';
+var expectedvalues = [];
+
+
+// the first of duplicate labels is taken
+status = inSection(1);
+actual = duplicates(1) + duplicates(2) + duplicates('a') + duplicates(3);
+expect = 'first 1,first 2,first a,default,';
+addThis();
+
+// -0 and 0 are strictly equal
+status = inSection(2);
+actual = zeros(0) + zeros(-0) + zeros(0 * -1);
+expect = 'zero,zero,zero,';
+addThis();
+
+status = inSection(3);
+actual = negativeZeroFirst(0) + negativeZeroFirst(-0);
+expect = 'negative zero,negative zero,';
+addThis();
+
+// NaN equals nothing, not even a NaN label
+status = inSection(4);
+actual = nan(0/0) + nan(Number.NaN) + nan('NaN') + nan(0);
+expect = 'default,default,string NaN,zero,';
+addThis();
+
+// no conversions between types
+status = inSection(5);
+actual = mixed(1) + mixed('1') + mixed(true) + mixed(null) + mixed(undefined) +
+         mixed(0) + mixed('') + mixed(false) + mixed(new Number(1)) + mixed('01');
+expect = 'number,string,boolean,null,undefined,zero,empty,false,default,default,';
+addThis();
+
+// fall-through across default
+status = inSection(6);
+actual = defaultInMiddle(1) + defaultInMiddle(2) + defaultInMiddle(3) + defaultInMiddle(4);
+expect = 'adb,b,b3,db,';
+addThis();
+
+status = inSection(7);
+actual = defaultFirst(1) + defaultFirst(2) + defaultFirst(5);
+expect = 'ab,b,dab,';
+addThis();
+
+status = inSection(8);
+actual = defaultLast(1) + defaultLast(2) + defaultLast(5);
+expect = 'abd,bd,d,';
+addThis();
+
+status = inSection(9);
+actual = noDefault(1) + noDefault(2) + noDefault(5);
+expect = 'ab,b,,';
+addThis();
+
+// dense integer labels, with values around them and between them
+status = inSection(10);
+actual = '';
+for (var i = -2; i < 14; i++)
+  actual += dense(i);
+expect = 'd,d,0,1,2,3,4,5,6,7,8,9,d,11,d,d,';
+addThis();
+
+status = inSection(11);
+actual = dense(1.5) + dense('1') + dense(2147483648) + dense(4294967297) + dense(-4294967296);
+expect = 'd,d,d,d,d,';
+addThis();
+
+// sparse numbers
+status = inSection(12);
+actual = sparse(-1) + sparse(1e9) + sparse(0.5) + sparse(2147483648) + sparse(4294967296) +
+         sparse(Infinity) + sparse(-Infinity) + sparse(1e9 + 1) + sparse(0);
+expect = 'minus one,billion,half,2^31,2^32,infinity,minus infinity,d,d,';
+addThis();
+
+// many strings
+status = inSection(13);
+actual = '';
+var names = ['GET', 'PUT', 'POST', 'HEAD', 'DELETE', 'OPTIONS', 'TRACE', 'CONNECT', 'PATCH',
+             'get', '', 'GET ', 'G', 'GETGET', 'POST', 'P\u0100ST'];
+for (var i = 0; i < names.length; i++)
+  actual += method(names[i]);
+expect = '1,2,3,4,5,6,7,8,9,d,empty,d,d,d,3,wide,';
+addThis();
+
+status = inSection(14);
+actual = method('PO' + 'ST') + method(['P', 'U', 'T'].join('')) + method('xPUT'.substring(1)) +
+         method(new String('GET'));
+expect = '3,2,2,d,';
+addThis();
+
+// a label that is not a literal is evaluated in its turn
+status = inSection(15);
+var evaluated = '';
+actual = notAllLiterals(2) + notAllLiterals(3) + notAllLiterals(4);
+expect = 'two,three,d,';
+addThis();
+
+status = inSection(16);
+actual = evaluated;
+expect = '3,3,';
+addThis();
+
+// leaving the switch from inside it
+status = inSection(17);
+actual = loop();
+expect = '01b2c3ce4';
+addThis();
+
+status = inSection(18);
+actual = nested(1, 'x') + nested(1, 'y') + nested(2, 'x');
+expect = '1x,1d,2,';
+addThis();
+
+status = inSection(19);
+actual = empty(1) + empty(2);
+expect = 'after,after,';
+addThis();
+
+
+
+//-----------------------------------------------------------------------------
+test();
+//-----------------------------------------------------------------------------
+
+
+
+function duplicates(x)
+{
+  switch (x) {
+  case 1:
+    return 'first 1,';
+  case 'a':
+    return 'first a,';
+  case 2:
+    return 'first 2,';
+  case 1:
+    return 'second 1,';
+  case 'a':
+    return 'second a,';
+  case 2:
+    return 'second 2,';
+  default:
+    return 'default,';
+  }
+}
+
+
+function zeros(x)
+{
+  switch (x) {
+  case 0:
+    return 'zero,';
+  case -0:
+    return 'negative zero,';
+  default:
+    return 'default,';
+  }
+}
+
+
+function negativeZeroFirst(x)
+{
+  switch (x) {
+  case -0:
+    return 'negative zero,';
+  case 0:
+    return 'zero,';
+  default:
+    return 'default,';
+  }
+}
+
+
+function nan(x)
+{
+  switch (x) {
+  case NaN:
+    return 'NaN,';
+  case 'NaN':
+    return 'string NaN,';
+  case 0/0:
+    return 'computed NaN,';
+  case 0:
+    return 'zero,';
+  default:
+    return 'default,';
+  }
+}
+
+
+function mixed(x)
+{
+  switch (x) {
+  case 1:
+    return 'number,';
+  case '1':
+    return 'string,';
+  case true:
+    return 'boolean,';
+  case null:
+    return 'null,';
+  case undefined:
+    return 'undefined,';
+  case 0:
+    return 'zero,';
+  case '':
+    return 'empty,';
+  case false:
+    return 'false,';
+  default:
+    return 'default,';
+  }
+}
+
+
+function defaultInMiddle(x)
+{
+  var r = '';
+  switch (x) {
+  case 1:
+    r += 'a';
+  default:
+    r += 'd';
+  case 2:
+    r += 'b';
+    break;
+  case 3:
+    r += 'b3';
+  }
+  return r + ',';
+}
+
+
+function defaultFirst(x)
+{
+  var r = '';
+  switch (x) {
+  default:
+    r += 'd';
+  case 1:
+    r += 'a';
+  case 2:
+    r += 'b';
+  }
+  return r + ',';
+}
+
+
+function defaultLast(x)
+{
+  var r = '';
+  switch (x) {
+  case 1:
+    r += 'a';
+  case 2:
+    r += 'b';
+  default:
+    r += 'd';
+  }
+  return r + ',';
+}
+
+
+function noDefault(x)
+{
+  var r = '';
+  switch (x) {
+  case 1:
+    r += 'a';
+  case 2:
+    r += 'b';
+  }
+  return r + ',';
+}
+
+
+function dense(x)
+{
+  switch (x) {
+  case 0: return '0,';
+  case 1: return '1,';
+  case 2: return '2,';
+  case 3: return '3,';
+  case 4: return '4,';
+  case 5: return '5,';
+  case 6: return '6,';
+  case 7: return '7,';
+  case 8: return '8,';
+  case 9: return '9,';
+  case 11: return '11,';
+  default: return 'd,';
+  }
+}
+
+
+function sparse(x)
+{
+  switch (x) {
+  case -1: return 'minus one,';
+  case 1e9: return 'billion,';
+  case 0.5: return 'half,';
+  case 2147483648: return '2^31,';
+  case 4294967296: return '2^32,';
+  case Infinity: return 'infinity,';
+  case -Infinity: return 'minus infinity,';
+  default: return 'd,';
+  }
+}
+
+
+function method(x)
+{
+  switch (x) {
+  case 'GET': return '1,';
+  case 'PUT': return '2,';
+  case 'POST': return '3,';
+  case 'HEAD': return '4,';
+  case 'DELETE': return '5,';
+  case 'OPTIONS': return '6,';
+  case 'TRACE': return '7,';
+  case 'CONNECT': return '8,';
+  case 'PATCH': return '9,';
+  case '': return 'empty,';
+  case 'P\u0100ST': return 'wide,';
+  default: return 'd,';
+  }
+}
+
+
+function notAllLiterals(x)
+{
+  switch (x) {
+  case 1:
+    return 'one,';
+  case 2:
+    return 'two,';
+  case (evaluated += '3,', 3):
+    return 'three,';
+  default:
+    return 'd,';
+  }
+}
+
+
+function loop()
+{
+  var r = '';
+  for (var i = 0; i < 10; i++) {
+    r += i;
+    switch (i) {
+    case 1:
+      r += 'b';
+      continue;
+    case 2:
+    case 3:
+      r += 'c';
+      break;
+    case 4:
+      return r;
+    default:
+      if (i == 0)
+        break;
+      r += 'x';
+    }
+    if (i == 3)
+      r += 'e';
+  }
+  return r;
+}
+
+
+function nested(x, y)
+{
+  var r = '';
+  switch (x) {
+  case 1:
+    r += '1';
+    switch (y) {
+    case 'x':
+      r += 'x';
+      break;
+    default:
+      r += 'd';
+    }
+    break;
+  case 2:
+    r += '2';
+  }
+  return r + ',';
+}
+
+
+function empty(x)
+{
+  switch (x) {
+  case 1:
+  }
+  switch (x) {
+  }
+  return 'after,';
+}
+
+
+function addThis()
+{
+  statusitems[UBound] = status;
+  actualvalues[UBound] = actual;
+  expectedvalues[UBound] = expect;
+  UBound++;
+}
+
+
+function test()
+{
+  enterFunc('test');
+  printBugNumber(bug);
+  printStatus(summary);
+
+  for (var i=0; i<UBound; i++)
+  {
+    reportCompare(expectedvalues[i], actualvalues[i], statusitems[i]);
+  }
+
+  exitFunc ('test');
+}
@@ -0,0 +1,151 @@
+/*
+* The contents of this file are subject to the Netscape Public
+* License Version 1.1 (the "License"); you may not use this file
+* except in compliance with the License. You may obtain a copy of
+* the License at http://www.mozilla.org/NPL/
+*
+* Software distributed under the License is distributed on an "AS IS"
+* basis, WITHOUT WARRANTY OF ANY KIND, either expressed
+* or implied. See the License for the specific language governing
+* rights and limitations under the License.
+*
+* The Original Code is mozilla.org code.
+*
+* The Initial Developer of the Original Code is Netscape
+* Communications Corporation.  Portions created by Netscape are
+* Copyright (C) 1998 Netscape Communications Corporation. All
+* Rights Reserved.
+*
+* Contributor(s):
+* Date: 18 October 2026
+*
+* SUMMARY: Strings built by concatenation
+*
+* Concatenated strings may be kept as their pieces until their characters
+* are needed. That must not show: the characters, substr, indexOf,
+* lastIndexOf, split and comparisons must give the same as for a string
+* in one piece, across the places where the pieces meet too, and pieces
+* appended to after being concatenated must not change what was built.
+*/
+//-----------------------------------------------------------------------------
+var UBound = 0;
+var bug = '(none)';
+var summary = 'Strings built by concatenation';
+var status = '';
+var statusitems = [];
+var actual = '';
+var actualvalues = [];
+var expect= '';
+var expectedvalues = [];
+
+var wide = '\u0100';
+var latin1 = '\u00ff';
+
+
+// appending and prepending
+status = inSection(1);
+var appended = '';
+var prepended = '';
+for (var i = 0; i < 2000; i++) {
+  appended += 'ab' + i;
+  prepended = 'ab' + (1999 - i) + prepended;
+}
+actual = (appended == prepended) + ',' + appended.length;
+expect = 'true,' + (2000 * 2 + 10 + 90 * 2 + 900 * 3 + 1000 * 4);
+addThis();
+
+status = inSection(2);
+actual = appended.substr(0, 8) + '|' + appended.substr(appended.length - 8) + '|' +
+         prepended.substring(10, 20);
+expect = 'ab0ab1ab|98ab1999|b3ab4ab5ab';
+addThis();
+
+status = inSection(3);
+actual = appended.indexOf('ab1000') + ',' + prepended.indexOf('ab1000') + ',' +
+         appended.lastIndexOf('ab1') + ',' + appended.indexOf('ab2000');
+expect = '4890,4890,' + (appended.length - 6) + ',-1';
+addThis();
+
+status = inSection(4);
+var pieces = appended.split('ab');
+actual = pieces.length + ',' + pieces[0] + ',' + pieces[1] + ',' + pieces[2000];
+expect = '2001,,0,1999';
+addThis();
+
+// pieces that are added to after being concatenated
+status = inSection(5);
+var base = 'left';
+var joined = base + 'right';
+base += 'LEFT';
+joined += '!';
+actual = base + ',' + joined + ',' + (base + joined).length;
+expect = 'leftLEFT,leftright!,18';
+addThis();
+
+status = inSection(6);
+var shared = 'x';
+var first = shared + 'a';
+var second = shared + 'b';
+first += 'c';
+second += 'd';
+actual = first + second + shared;
+expect = 'xacxbdx';
+addThis();
+
+// a string concatenated with itself over and over
+status = inSection(7);
+var doubled = 'ab';
+for (var i = 0; i < 16; i++)
+  doubled = doubled + doubled;
+actual = doubled.length + ',' + doubled.charAt(131071) + ',' + doubled.lastIndexOf('ba') + ',' +
+         doubled.indexOf('aa');
+expect = '131072,b,131069,-1';
+addThis();
+
+// pieces as property names and in comparisons
+status = inSection(8);
+var object = {};
+object['na' + 'me'] = 1;
+object[['na', 'me'].join('')] += 1;
+var key = 'n';
+key += 'ame';
+actual = object[key] + ',' + ('name' == key) + ',' + ('nam' + 'e' < 'namf') + ',' + ('name' in object);
+expect = '2,true,true,true';
+addThis();
+
+// String.prototype.concat
+status = inSection(9);
+actual = 'a'.concat('b', 1, wide, null).length + ',' + ''.concat(latin1, wide).charCodeAt(1) + ',' +
+         appended.concat(wide).indexOf(wide);
+expect = '8,256,' + appended.length;
+addThis();
+
+
+//-----------------------------------------------------------------------------
+test();
+//-----------------------------------------------------------------------------
+
+
+
+function addThis()
+{
+  statusitems[UBound] = status;
+  actualvalues[UBound] = actual;
+  expectedvalues[UBound] = expect;
+  UBound++;
+}
+
+
+function test()
+{
+  enterFunc('test');
+  printBugNumber(bug);
+  printStatus(summary);
+
+  for (var i=0; i<UBound; i++)
+  {
+    reportCompare(expectedvalues[i], actualvalues[i], statusitems[i]);
+  }
+
+  exitFunc ('test');
+}
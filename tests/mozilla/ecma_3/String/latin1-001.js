@@ -0,0 +1,113 @@
+/*
+* The contents of this file are subject to the Netscape Public
+* License Version 1.1 (the "License"); you may not use this file
+* except in compliance with the License. You may obtain a copy of
+* the License at http://www.mozilla.org/NPL/
+*
+* Software distributed under the License is distributed on an "AS IS"
+* basis, WITHOUT WARRANTY OF ANY KIND, either expressed
+* or implied. See the License for the specific language governing
+* rights and limitations under the License.
+*
+* The Original Code is mozilla.org code.
+*
+* The Initial Developer of the Original Code is Netscape
+* Communications Corporation.  Portions created by Netscape are
+* Copyright (C) 1998 Netscape Communications Corporation. All
+* Rights Reserved.
+*
+* Contributor(s):
+* Date: 18 October 2026
+*
+* SUMMARY: Strings in 8 and in 16 bits
+*
+* Strings whose characters all fit in 8 bits may be kept in 8 bits, and
+* are widened when a character that does not fit is added. Strings of
+* either width, and pieces of both, must compare, search, cut and split
+* the same.
+*/
+//-----------------------------------------------------------------------------
+var UBound = 0;
+var bug = '(none)';
+var summary = 'Strings in 8 and in 16 bits';
+var status = '';
+var statusitems = [];
+var actual = '';
+var actualvalues = [];
+var expect= '';
+var expectedvalues = [];
+
+var wide = '\u0100';
+var latin1 = '\u00ff';
+
+
+// 8-bit and 16-bit pieces
+status = inSection(1);
+var mixed = 'abc' + wide + 'def';
+actual = mixed.length + ',' + mixed.charCodeAt(3) + ',' + mixed.indexOf('d') + ',' +
+         mixed.indexOf(wide) + ',' + mixed.lastIndexOf('c' + wide + 'd');
+expect = '7,256,4,3,2';
+addThis();
+
+status = inSection(2);
+actual = mixed.substr(4) + ',' + mixed.substr(0, 3) + ',' + (mixed.substr(4) + 'x' == 'defx') + ',' +
+         mixed.substring(3, 4).charCodeAt(0);
+expect = 'def,abc,true,256';
+addThis();
+
+status = inSection(3);
+actual = ('abc' + latin1).indexOf(wide) + ',' + ('abc' + wide).indexOf(latin1) + ',' +
+         ('abc' + latin1).indexOf(latin1) + ',' + (latin1 + 'abc').indexOf('\u01ff');
+expect = '-1,-1,3,-1';
+addThis();
+
+status = inSection(4);
+actual = ('a' + latin1 + 'b' == 'a\u00ffb') + ',' + ('a' + wide + 'b' == 'a\u0100b') + ',' +
+         ('a' + latin1 < 'a' + wide) + ',' + ('a' + wide + 'b' < 'a' + latin1 + 'c');
+expect = 'true,true,true,false';
+addThis();
+
+status = inSection(5);
+var parts = ('one' + wide + 'two' + wide + 'three').split(wide);
+actual = parts.length + ',' + parts.join('|') + ',' + ('one,two').split(wide).length + ',' +
+         ('a' + latin1 + 'b' + latin1).split(latin1).join('|');
+expect = '3,one|two|three,1,a|b|';
+addThis();
+
+// a 16-bit string whose 16-bit character is cut off
+status = inSection(6);
+var cut = mixed.substr(4);
+actual = (cut == 'def') + ',' + cut.indexOf('ef') + ',' + (cut + latin1).lastIndexOf(latin1) + ',' +
+         (cut + 'g').split('e').join('|');
+expect = 'true,1,3,d|fg';
+addThis();
+
+
+//-----------------------------------------------------------------------------
+test();
+//-----------------------------------------------------------------------------
+
+
+
+function addThis()
+{
+  statusitems[UBound] = status;
+  actualvalues[UBound] = actual;
+  expectedvalues[UBound] = expect;
+  UBound++;
+}
+
+
+function test()
+{
+  enterFunc('test');
+  printBugNumber(bug);
+  printStatus(summary);
+
+  for (var i=0; i<UBound; i++)
+  {
+    reportCompare(expectedvalues[i], actualvalues[i], statusitems[i]);
+  }
+
+  exitFunc ('test');
+}
@@ -0,0 +1,193 @@
+/*
+* The contents of this file are subject to the Netscape Public
+* License Version 1.1 (the "License"); you may not use this file
+* except in compliance with the License. You may obtain a copy of
+* the License at http://www.mozilla.org/NPL/
+*
+* Software distributed under the License is distributed on an "AS IS"
+* basis, WITHOUT WARRANTY OF ANY KIND, either expressed
+* or implied. See the License for the specific language governing
+* rights and limitations under the License.
+*
+* The Original Code is mozilla.org code.
+*
+* The Initial Developer of the Original Code is Netscape
+* Communications Corporation.  Portions created by Netscape are
+* Copyright (C) 1998 Netscape Communications Corporation. All
+* Rights Reserved.
+*
+* Contributor(s):
+* Date: 18 October 2026
+*
+* SUMMARY: Global replace with $n and with empty matches
+*
+* String.prototype.replace() with a global regular expression puts
+* together the pieces between the matches and the replacements (ECMA3
+* Section 15.5.4.11). This checks the pieces where they meet: $n, $$,
+* groups that did not take part in the match, matches of nothing, and
+* replacements of all of a long string.
+*/
+//-----------------------------------------------------------------------------
+var UBound = 0;
+var bug = '(none)';
+var summary = 'Global replace with $n and with empty matches';
+var status = '';
+var statusitems = [];
+var actual = '';
+var actualvalues = [];
+var expect= '';
+var expectedvalues = [];
+
+
+status = inSection(1);
+actual = 'John Smith, Jane Doe'.replace(/(\w+) (\w+)/g, '$2 $1');
+expect = 'Smith John, Doe Jane';
+addThis();
+
+status = inSection(2);
+actual = 'a1b2c3'.replace(/([a-z])(\d)/g, '$2$1$2');
+expect = '1a12b23c3';
+addThis();
+
+status = inSection(3);
+actual = 'price: 5, 10'.replace(/(\d+)/g, '$$$1.00');
+expect = 'price: $5.00, $10.00';
+addThis();
+
+status = inSection(4);
+actual = 'aaa'.replace(/a/g, '$$');
+expect = '$$$';
+addThis();
+
+status = inSection(5);
+actual = 'abc'.replace(/b/g, '[$1]');
+expect = 'a[$1]c';
+addThis();
+
+status = inSection(6);
+actual = 'abcabc'.replace(/(a)(x)?/g, '<$1$2>');
+expect = '<a>bc<a>bc';
+addThis();
+
+status = inSection(7);
+actual = 'abc'.replace(/(b)/g, '$3$');
+expect = 'a$3$c';
+addThis();
+
+status = inSection(8);
+actual = 'x-y'.replace(/-/g, '$');
+expect = 'x$y';
+addThis();
+
+// matches of nothing
+status = inSection(9);
+actual = 'abc'.replace(/x*/g, '-');
+expect = '-a-b-c-';
+addThis();
+
+status = inSection(10);
+actual = ''.replace(/x*/g, '-');
+expect = '-';
+addThis();
+
+status = inSection(11);
+actual = 'abc'.replace(/$/g, '!') + ',' + 'abc'.replace(/^/g, '!');
+expect = 'abc!,!abc';
+addThis();
+
+status = inSection(12);
+actual = 'a\nb'.replace(/\b/g, '|');
+expect = '|a|\n|b|';
+addThis();
+
+status = inSection(13);
+actual = 'abc'.replace(/(x?)/g, '[$1]');
+expect = '[]a[]b[]c[]';
+addThis();
+
+status = inSection(14);
+actual = 'aXbX'.replace(/(X)|/g, '<$1>');
+expect = '<>a<X><>b<X><>';
+addThis();
+
+// matches at both ends, next to each other, and nowhere
+status = inSection(15);
+actual = 'aaXaa'.replace(/a/g, 'b') + ',' + 'XaaX'.replace(/a/g, '') + ',' + 'xyz'.replace(/a/g, 'b');
+expect = 'bbXbb,XX,xyz';
+addThis();
+
+status = inSection(16);
+actual = 'aaaa'.replace(/aa/g, 'a') + ',' + 'aaaaa'.replace(/aa/g, 'b');
+expect = 'aa,bba';
+addThis();
+
+status = inSection(17);
+actual = 'abc'.replace(/abc/g, '') + ',' + 'abc'.replace(/abc/g, '').length;
+expect = ',0';
+addThis();
+
+// not global: only the first
+status = inSection(18);
+actual = 'a1b2'.replace(/(\d)/, '<$1>') + ',' + 'abc'.replace(/x*/, '-');
+expect = 'a<1>b2,-abc';
+addThis();
+
+// 16-bit text and replacements
+status = inSection(19);
+actual = 'a\u0100b\u0100'.replace(new RegExp('\u0100', 'g'), '$$') + ',' +
+         'abc'.replace(/(b)/g, '\u0100$1').length;
+expect = 'a$b$,4';
+addThis();
+
+status = inSection(20);
+actual = 'x\u00ffy'.replace(new RegExp('(\u00ff)', 'g'), '$1\u0100$1');
+expect = 'x\u00ff\u0100\u00ffy';
+addThis();
+
+// a long string, replaced all over
+status = inSection(21);
+var line = 'key=value;';
+var text = '';
+for (var i = 0; i < 5000; i++)
+  text += line;
+var replaced = text.replace(/(\w+)=(\w+);/g, '$2:$1,');
+actual = replaced.length + ',' + replaced.substr(0, 20) + ',' + replaced.lastIndexOf('value:key,');
+expect = '50000,value:key,value:key,,49990';
+addThis();
+
+status = inSection(22);
+actual = text.replace(/;/g, '').length + ',' + text.replace(/x*/g, '').length + ',' +
+         text.replace(/k/g, 'kk').split('kk').length;
+expect = '45000,50000,5001';
+addThis();
+
+
+
+//-----------------------------------------------------------------------------
+test();
+//-----------------------------------------------------------------------------
+
+
+
+function addThis()
+{
+  statusitems[UBound] = status;
+  actualvalues[UBound] = actual;
+  expectedvalues[UBound] = expect;
+  UBound++;
+}
+
+
+function test()
+{
+  enterFunc('test');
+  printBugNumber(bug);
+  printStatus(summary);
+
+  for (var i=0; i<UBound; i++)
+  {
+    reportCompare(expectedvalues[i], actualvalues[i], statusitems[i]);
+  }
+
+  exitFunc ('test');
+}
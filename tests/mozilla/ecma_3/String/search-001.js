@@ -0,0 +1,121 @@
+/*
+* The contents of this file are subject to the Netscape Public
+* License Version 1.1 (the "License"); you may not use this file
+* except in compliance with the License. You may obtain a copy of
+* the License at http://www.mozilla.org/NPL/
+*
+* Software distributed under the License is distributed on an "AS IS"
+* basis, WITHOUT WARRANTY OF ANY KIND, either expressed
+* or implied. See the License for the specific language governing
+* rights and limitations under the License.
+*
+* The Original Code is mozilla.org code.
+*
+* The Initial Developer of the Original Code is Netscape
+* Communications Corporation.  Portions created by Netscape are
+* Copyright (C) 1998 Netscape Communications Corporation. All
+* Rights Reserved.
+*
+* Contributor(s):
+* Date: 18 October 2026
+*
+* SUMMARY: Searching strings
+*
+* indexOf, lastIndexOf and split may look at many characters at once and
+* skip ahead on long needles. They must find the same as a search one
+* character at a time: near the start and the end of the text, with
+* needles longer than the text, empty needles, and 16-bit characters in the
+* text or the needle.
+*/
+//-----------------------------------------------------------------------------
+var UBound = 0;
+var bug = '(none)';
+var summary = 'Searching strings';
+var status = '';
+var statusitems = [];
+var actual = '';
+var actualvalues = [];
+var expect= '';
+var expectedvalues = [];
+
+var wide = '\u0100';
+var latin1 = '\u00ff';
+var doubled = 'ab';
+for (var i = 0; i < 16; i++)
+  doubled = doubled + doubled;
+
+
+status = inSection(1);
+var wideText = '';
+var latin1Text = '';
+for (var i = 0; i < 300; i++) {
+  wideText += (i == 150 ? wide : 'x') + 'y';
+  latin1Text += (i == 150 ? latin1 : 'x') + 'y';
+}
+actual = wideText.indexOf(wide) + ',' + latin1Text.indexOf(latin1) + ',' +
+         wideText.indexOf('xy' + wide) + ',' + wideText.lastIndexOf(wide + 'yx') + ',' +
+         wideText.indexOf('y', 301) + ',' + wideText.lastIndexOf('x', 299);
+expect = '300,300,298,300,301,298';
+addThis();
+
+status = inSection(2);
+actual = wideText.split('y').length + ',' + wideText.split(wide).length + ',' +
+         wideText.split('').length + ',' + wideText.substr(298, 5);
+expect = '301,2,600,xy' + wide + 'yx';
+addThis();
+
+// needles longer than a vector, and as long as the text
+status = inSection(3);
+var longNeedle = '';
+for (var i = 0; i < 100; i++)
+  longNeedle += String.fromCharCode(97 + i % 26);
+var longText = doubled.substr(0, 1000) + longNeedle + doubled.substr(0, 1000);
+actual = longText.indexOf(longNeedle) + ',' + longText.lastIndexOf(longNeedle) + ',' +
+         (longText + wide).indexOf(longNeedle) + ',' + longText.indexOf(longNeedle + 'b') + ',' +
+         longNeedle.indexOf(longNeedle) + ',' + longNeedle.indexOf(longNeedle + wide);
+expect = '1000,1000,1000,-1,0,-1';
+addThis();
+
+status = inSection(4);
+var wideNeedle = longNeedle.substr(0, 70) + wide;
+actual = (longText + wideNeedle).indexOf(wideNeedle) + ',' + (longText + wideNeedle).lastIndexOf(wideNeedle) + ',' +
+         longText.indexOf(wideNeedle);
+expect = '2100,2100,-1';
+addThis();
+
+// empty pieces and empty needles
+status = inSection(5);
+actual = ('' + '' + 'a' + '').length + ',' + ('abc' + '').indexOf('') + ',' + ('abc' + '').indexOf('', 2) + ',' +
+         ('abc' + wide).lastIndexOf('') + ',' + ('' + '').split('').length + ',' + ('' + '').split('x').length;
+expect = '1,0,2,4,0,1';
+addThis();
+
+
+//-----------------------------------------------------------------------------
+test();
+//-----------------------------------------------------------------------------
+
+
+
+function addThis()
+{
+  statusitems[UBound] = status;
+  actualvalues[UBound] = actual;
+  expectedvalues[UBound] = expect;
+  UBound++;
+}
+
+
+function test()
+{
+  enterFunc('test');
+  printBugNumber(bug);
+  printStatus(summary);
+
+  for (var i=0; i<UBound; i++)
+  {
+    reportCompare(expectedvalues[i], actualvalues[i], statusitems[i]);
+  }
+
+  exitFunc ('test');
+}